@@ -25,6 +25,17 @@ void main() {
 }
 @end
 
+// same as offscreen_vs, for sampling a level texture laid out column-major
+@vs transposed_vs
+layout(location=0) in vec2 in_pos;
+out vec2 uv;
+
+void main() {
+    gl_Position = vec4(in_pos * 2.0 - 1.0, 0.5, 1.0);
+    uv = vec2(1.0 - in_pos.y, in_pos.x);
+}
+@end
+
 @vs display_vs
 @glsl_options flip_vert_y
 layout(location=0) in vec2 in_pos;
@@ -50,4 +61,5 @@ void main() {
 @end
 
 @program offscreen offscreen_vs offscreen_fs
+@program transposed transposed_vs offscreen_fs
 @program display display_vs display_fs
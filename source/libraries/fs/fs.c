@@ -8763,11 +8763,16 @@ static size_t fs_memory_stream_duplicate_alloc_size_internal(fs_stream* pStream)
 static fs_result fs_memory_stream_duplicate_internal(fs_stream* pStream, fs_stream* pDuplicatedStream)
 {
     fs_memory_stream* pMemoryStream;
+    fs_memory_stream* pDuplicatedMemoryStream;
 
     pMemoryStream = (fs_memory_stream*)pStream;
     FS_ASSERT(pMemoryStream != NULL);
 
-    *pDuplicatedStream = *pStream;
+    pDuplicatedMemoryStream = (fs_memory_stream*)pDuplicatedStream;
+    FS_ASSERT(pDuplicatedMemoryStream != NULL);
+
+    /* The whole memory stream needs to be copied, not just the base stream, and the data pointers must then point into the duplicate. */
+    *pDuplicatedMemoryStream = *pMemoryStream;
 
     /* Slightly special handling for write mode. Need to make a copy of the output buffer. */
     if (pMemoryStream->write.pData != NULL) {
@@ -8778,13 +8783,13 @@ static fs_result fs_memory_stream_duplicate_internal(fs_stream* pStream, fs_stre
 
         FS_COPY_MEMORY(pNewData, pMemoryStream->write.pData, pMemoryStream->write.dataSize);
 
-        pMemoryStream->write.pData = pNewData;
+        pDuplicatedMemoryStream->write.pData = pNewData;
 
-        pMemoryStream->ppData    = &pMemoryStream->write.pData;
-        pMemoryStream->pDataSize = &pMemoryStream->write.dataSize;
+        pDuplicatedMemoryStream->ppData    = &pDuplicatedMemoryStream->write.pData;
+        pDuplicatedMemoryStream->pDataSize = &pDuplicatedMemoryStream->write.dataSize;
     } else {
-        pMemoryStream->ppData    = (void**)&pMemoryStream->readonly.pData;
-        pMemoryStream->pDataSize = &pMemoryStream->readonly.dataSize;
+        pDuplicatedMemoryStream->ppData    = (void**)&pDuplicatedMemoryStream->readonly.pData;
+        pDuplicatedMemoryStream->pDataSize = &pDuplicatedMemoryStream->readonly.dataSize;
     }
 
     return FS_SUCCESS;
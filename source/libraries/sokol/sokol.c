@@ -14,6 +14,9 @@
 #include "sokol_memtrack.h"
 #include "sokol_args.h"
 #include "sokol_time.h"
+
+// The headless build has no window, GPU or audio device
+#if !defined(MUD_HEADLESS)
 #include "sokol_gfx.h"
 #include "sokol_app.h"
 #include "sokol_glue.h"
@@ -40,4 +43,6 @@
 #endif
 #include "nuklear.h"
 
-#include "sokol_nuklear.h"
\ No newline at end of file
+#include "sokol_nuklear.h"
+
+#endif
@@ -47,11 +47,14 @@
 #include "console/c_console.h"
 #include "doom/d_deh.h"
 #include "doom/doomstat.h"
+#include "game/g_demo.h"
 #include "game/g_game.h"
+#include "game/g_rewind.h"
 #include "hud/hu_stuff.h"
 #include "math/math_colors.h"
 #include "system/i_controller.h"
 #include "system/i_input.h"
+#include "system/i_perfstats.h"
 #include "system/i_system.h"
 #include "system/i_timer.h"
 #include "doom/d_cheat.h"
@@ -75,6 +78,7 @@
 #include "render/v_video.h"
 #include "system/i_version.h"
 #include "wad/w_wad.h"
+#include "utils/z_zone.h"
 
 #define ALIASCMDFORMAT                                                         \
     BOLDITALICS("alias")                                                       \
@@ -113,6 +117,9 @@
     BOLDITALICS("xy")                                                         \
     "|" BOLDITALICS("title") "|" BOLD("first") "|" BOLD("previous") "|" BOLD( \
     "next") "|" BOLD("last") "|" BOLD("random")
+#define DEMOCMDFORMAT BOLDITALICS("filename") "[" BOLD(DEMOEXTENSION) "]"
+#define PERFSTATSCMDFORMAT \
+    "[" BOLDITALICS("filename") "[" BOLD(".csv") "]|" BOLD("off") "]"
 #define PLAYCMDFORMAT BOLDITALICS("soundeffect") "|" BOLDITALICS("music")
 #define NAMECMDFORMAT \
     "[[" BOLD("un") "]" BOLD("friendly") " ]" BOLDITALICS("monster") " " BOLDITALICS("name")
@@ -127,6 +134,7 @@
     BOLD("player")                                                          \
     "|" BOLD("all") "|[[" BOLD("un") "]" BOLD("friendly") " ]" BOLDITALICS( \
     "monster")
+#define REWINDCMDFORMAT BOLDITALICS("seconds")
 #define SAVECMDFORMAT \
     BOLD("1")         \
     ".." BOLD("8") "|" BOLDITALICS("filename") "[" BOLD(".save") "]"
@@ -139,6 +147,7 @@
     "weapons") "|" BOLD("powerups") "|" BOLD("all") "|" BOLDITALICS("item")
 #define TELEPORTCMDFORMAT \
     BOLDITALICS("x") " " BOLDITALICS("y") "[ " BOLDITALICS("z") "]"
+#define TIMEDEMOCMDFORMAT DEMOCMDFORMAT " [" BOLD("nodraw") "]"
 #define TIMERCMDFORMAT BOLDITALICS("minutes")
 #define TOGGLECMDFORMAT BOLDITALICS("CVAR")
 #define UNBINDCMDFORMAT BOLDITALICS("control") "|" BOLDITALICS("+action")
@@ -481,13 +490,17 @@ static void newgame_func2(char* cmd, char* parms);
 static void noclip_func2(char* cmd, char* parms);
 static void nomonsters_func2(char* cmd, char* parms);
 static void notarget_func2(char* cmd, char* parms);
+static void perfstats_func2(char* cmd, char* parms);
 static void pistolstart_func2(char* cmd, char* parms);
 static bool play_func1(char* cmd, char* parms);
 static void play_func2(char* cmd, char* parms);
+static void playdemo_func2(char* cmd, char* parms);
 static void playerstats_func2(char* cmd, char* parms);
+static void pools_func2(char* cmd, char* parms);
 static void print_func2(char* cmd, char* parms);
 static void quit_func2(char* cmd, char* parms);
 static void readme_func2(char* cmd, char* parms);
+static void record_func2(char* cmd, char* parms);
 static void regenhealth_func2(char* cmd, char* parms);
 static void releasenotes_func2(char* cmd, char* parms);
 static void reset_func2(char* cmd, char* parms);
@@ -497,14 +510,17 @@ static void respawnmonsters_func2(char* cmd, char* parms);
 static void restartmap_func2(char* cmd, char* parms);
 static bool resurrect_func1(char* cmd, char* parms);
 static void resurrect_func2(char* cmd, char* parms);
+static void rewind_func2(char* cmd, char* parms);
 static void save_func2(char* cmd, char* parms);
 static bool spawn_func1(char* cmd, char* parms);
 static void spawn_func2(char* cmd, char* parms);
+static void stopdemo_func2(char* cmd, char* parms);
 static bool take_func1(char* cmd, char* parms);
 static void take_func2(char* cmd, char* parms);
 static bool teleport_func1(char* cmd, char* parms);
 static void teleport_func2(char* cmd, char* parms);
 static void thinglist_func2(char* cmd, char* parms);
+static void timedemo_func2(char* cmd, char* parms);
 static void timer_func2(char* cmd, char* parms);
 static void toggle_func2(char* cmd, char* parms);
 static void unbind_func2(char* cmd, char* parms);
@@ -552,6 +568,7 @@ static bool r_blood_func1(char* cmd, char* parms);
 static void r_blood_func2(char* cmd, char* parms);
 static void r_bloodsplats_translucency_func2(char* cmd, char* parms);
 static void r_brightmaps_func2(char* cmd, char* parms);
+static void r_columnmajor_func2(char* cmd, char* parms);
 static void r_corpses_mirrored_func2(char* cmd, char* parms);
 static bool r_detail_func1(char* cmd, char* parms);
 static void r_detail_func2(char* cmd, char* parms);
@@ -1002,6 +1019,9 @@ consolecmd_t consolecmds[] = {
     NOVALUEALIAS,
     "The color of your crosshair (" BOLD("0") " to " BOLD("255") ")."),
     CCMD(cvarlist, "", "", null_func1, cvarlist_func2, true, "[" BOLDITALICS("searchstring") "]", "Lists all console variables."),
+    CVAR_BOOL(dormancy, "", "", bool_cvars_func1, bool_cvars_func2, CF_NONE, BOOLVALUEALIAS, "Toggles putting monsters to sleep while they can't see or hear you."),
+    CVAR_INT(dormancy_asleep, "", "", int_cvars_func1, int_cvars_func2, CF_READONLY, NOVALUEALIAS, "The number of monsters asleep in the current map."),
+    CVAR_INT(dormancy_awake, "", "", int_cvars_func1, int_cvars_func2, CF_READONLY, NOVALUEALIAS, "The number of monsters awake in the current map."),
     CCMD(endgame, "", "", null_func1, endgame_func2, false, "", "Ends the game."),
     CVAR_BOOL(english,
     "",
@@ -1229,8 +1249,10 @@ consolecmd_t consolecmds[] = {
     CCMD(nomonsters, "", "", null_func1, nomonsters_func2, true, "[" BOLD("on") "|" BOLD("off") "]", "Toggles the presence of monsters in maps."),
     CCMD(notarget, "", "", game_ccmd_func1, notarget_func2, true, "[" BOLD("on") "|" BOLD("off") "]", "Toggles monsters not targeting you."),
     CVAR_BOOL(obituaries, "", "", bool_cvars_func1, bool_cvars_func2, CF_NONE, BOOLVALUEALIAS, "Toggles displaying obituaries when you or monsters are killed."),
+    CCMD(perfstats, "", "", null_func1, perfstats_func2, true, PERFSTATSCMDFORMAT, "Shows how long each part of the last frames took, or logs it to a CSV file."),
     CCMD(pistolstart, "", "", null_func1, pistolstart_func2, true, "[" BOLD("on") "|" BOLD("off") "]", "Toggles you starting each map with 100% health, no armor, and only your pistol with 50 bullets."),
     CCMD(play, "", "", play_func1, play_func2, true, PLAYCMDFORMAT, "Plays a " BOLDITALICS("sound effect") " or " BOLDITALICS("music") " lump."),
+    CCMD(playdemo, "", "", null_func1, playdemo_func2, true, DEMOCMDFORMAT, "Plays back a demo."),
     CVAR_INT(playergender,
     "",
     "",
@@ -1241,6 +1263,7 @@ consolecmd_t consolecmds[] = {
     "Your gender (" BOLD("male") ", " BOLD("female") " or " BOLD("other") ")."),
     CVAR_STR(playername, "", "", null_func1, str_cvars_func2, CF_NONE, 16, "Your name."),
     CCMD(playerstats, "", "", null_func1, playerstats_func2, false, "", "Shows stats about you."),
+    CCMD(pools, "", "", null_func1, pools_func2, false, "", "Shows how much memory the things, thinkers, blood splats and the rest of the current map are using."),
     CCMD(print, "", "", game_ccmd_func1, print_func2, true, PRINTCMDFORMAT, "Prints a player \"" BOLDITALICS("message") "\"."),
     CCMD(quit, "", exit, null_func1, quit_func2, false, "", "Quits to the " DESKTOP "."),
     CVAR_BOOL(r_althud, "", "", bool_cvars_func1, bool_cvars_func2, CF_NONE, BOOLVALUEALIAS, "Toggles an alternate heads-up display when in widescreen."),
@@ -1288,6 +1311,7 @@ consolecmd_t consolecmds[] = {
     "Toggles the translucency of blood splats."),
     CVAR_BOOL(r_brightmaps, "", "", bool_cvars_func1, r_brightmaps_func2, CF_NONE, BOOLVALUEALIAS, "Toggles brightmaps on some wall textures."),
     CVAR_BOOL(r_buildnodes, "", "", bool_cvars_func1, bool_cvars_func2, CF_NONE, BOOLVALUEALIAS, "Toggles building nodes at runtime via NanoBSP."),
+    CVAR_BOOL(r_columnmajor, "", "", bool_cvars_func1, r_columnmajor_func2, CF_NONE, BOOLVALUEALIAS, "Toggles drawing the view into a framebuffer laid out column by column."),
     CVAR_BOOL(r_corpses_color, r_corpses_colour, "", bool_cvars_func1, bool_cvars_func2, CF_NONE, BOOLVALUEALIAS, "Toggles randomly colored marine corpses."),
     CVAR_BOOL(r_corpses_gib, "", "", bool_cvars_func1, bool_cvars_func2, CF_NONE, BOOLVALUEALIAS, "Toggles some corpses gibbing when barrels or rockets explode nearby."),
     CVAR_BOOL(r_corpses_mirrored, "", "", bool_cvars_func1, r_corpses_mirrored_func2, CF_NONE, BOOLVALUEALIAS, "Toggles randomly mirrored corpses."),
@@ -1408,7 +1432,9 @@ consolecmd_t consolecmds[] = {
     BOOLVALUEALIAS,
     "Toggles the translucency of certain " ITALICS(
     "BOOM-") "compatible wall textures."),
+    CVAR_INT(r_threads, "", "", int_cvars_func1, int_cvars_func2, CF_NONE, NOVALUEALIAS, "The number of threads the player's view is rendered on (" BOLD("1") " to " BOLD("16") ")."),
     CCMD(readme, "", "", null_func1, readme_func2, false, "", "Shows the accompanying readme file for the currently loaded PWAD."),
+    CCMD(record, "", "", null_func1, record_func2, true, DEMOCMDFORMAT, "Restarts the current map and records a demo of it."),
     CCMD(regenhealth, "", "", game_ccmd_func1, regenhealth_func2, true, "[" BOLD("on") "|" BOLD("off") "]", "Toggles regenerating your health by 1% every second when it's less than 100%."),
     CCMD(releasenotes,
     "",
@@ -1445,6 +1471,8 @@ consolecmd_t consolecmds[] = {
     RESURRECTCMDFORMAT,
     "Resurrects the " BOLD("player") ", " BOLD(
     "all") " monsters, or a type of " BOLDITALICS("monster") "."),
+    CCMD(rewind, "", "", game_ccmd_func1, rewind_func2, true, REWINDCMDFORMAT, "Rewinds the current map by a number of " BOLDITALICS("seconds") "."),
+    CVAR_INT(rewindinterval, "", "", int_cvars_func1, int_cvars_func2, CF_NONE, NOVALUEALIAS, "How many tics apart snapshots of the current map are taken, to rewind to (" BOLD("0") " to " BOLD("350") ")."),
     CMD_CHEAT(ryhan, false),
     CVAR_INT(s_channels,
     "",
@@ -1520,6 +1548,7 @@ consolecmd_t consolecmds[] = {
     NOVALUEALIAS,
     "The amount your view and weapon bob up and down when you stand still "
     "(" BOLD("0%") " to " BOLD("100%") ")."),
+    CCMD(stopdemo, "", "", null_func1, stopdemo_func2, false, "", "Stops recording or playing back a demo."),
     CVAR_INT(sucktime,
     "",
     "",
@@ -1552,6 +1581,7 @@ consolecmd_t consolecmds[] = {
     "Teleports you to (" BOLDITALICS("x") ", " BOLDITALICS(
     "y") ", " BOLDITALICS("z") ") in the current map."),
     CCMD(thinglist, "", "", game_ccmd_func1, thinglist_func2, false, "", "Lists all things in the current map."),
+    CCMD(timedemo, "", "", null_func1, timedemo_func2, true, TIMEDEMOCMDFORMAT, "Plays back a demo as fast as possible and shows how long it took."),
     CCMD(timer,
     "",
     "",
@@ -1731,6 +1761,7 @@ consolecmd_t consolecmds[] = {
     "The screen's resolution when fullscreen (" BOLD("desktop") " or " BOLD(
     ITALICS("width") "\xD7" ITALICS("height")) ")."),
     CVAR_BOOL(vid_showfps, "", "", bool_cvars_func1, vid_showfps_func2, CF_NONE, BOOLVALUEALIAS, "Toggles showing the number of frames per second."),
+    CVAR_INT(vid_uploadedbytes, "", "", int_cvars_func1, int_cvars_func2, CF_READONLY, NOVALUEALIAS, "The number of bytes uploaded to the GPU in the last frame."),
 #if defined(__APPLE__)
     CVAR_INT(vid_vsync,
     "",
@@ -6827,6 +6858,55 @@ static void notarget_func2(char* cmd, char* parms)
     }
 }
 
+//
+// perfstats CCMD
+//
+static void perfstats_func2(char* cmd, char* parms)
+{
+    const int tabs[MAXTABS] = { 100, 160, 220 };
+    int frames;
+    char* temp;
+
+    if(M_StringCompare(parms, "off"))
+    {
+        if(I_PerfLogging())
+        {
+            I_StopPerfLog();
+            C_Output("Timings are no longer being logged.");
+        }
+
+        return;
+    }
+
+    if(*parms)
+    {
+        char filename[MAX_PATH];
+
+        M_snprintf(filename, sizeof(filename), "%s" DIR_SEPARATOR_S "%s%s",
+        M_GetAppDataFolder(), parms, (strchr(parms, '.') ? "" : ".csv"));
+
+        if(I_StartPerfLog(filename))
+            C_Output("Timings of each frame are now being logged to " BOLD("%s") ".", filename);
+        else
+            C_Warning(0, BOLD("%s") " couldn't be created.", filename);
+
+        return;
+    }
+
+    if(!(frames = I_GetPerfFrames()))
+        return;
+
+    temp = commify(frames);
+    C_Output("How many microseconds each part of the last %s frames took:", temp);
+    free(temp);
+
+    C_TabbedOutput(tabs, "\t" BOLD("p50") "\t" BOLD("p95") "\t" BOLD("p99"));
+
+    for(int i = 0; i < NUMPERFSTATS; i++)
+        C_TabbedOutput(tabs, INDENT "%s\t%i\t%i\t%i", perfstatnames[i],
+        I_GetPerfPercentile(i, 50), I_GetPerfPercentile(i, 95), I_GetPerfPercentile(i, 99));
+}
+
 //
 // pistolstart CCMD
 //
@@ -7212,6 +7292,22 @@ char* C_DistanceTraveled(double feet, bool allowzero)
     return M_StringDuplicate(result);
 }
 
+//
+// playdemo CCMD
+//
+static void playdemo_func2(char* cmd, char* parms)
+{
+    if(!*parms)
+    {
+        const int i = C_GetIndex(cmd);
+
+        C_ShowFormat(i);
+        C_ShowDescription(i);
+    }
+    else if(G_PlayDemo(parms, false, false, false))
+        C_HideConsole();
+}
+
 //
 // playerstats CCMD
 //
@@ -8211,6 +8307,31 @@ static void playerstats_func2(char* cmd, char* parms)
         C_PlayerStats_NoGame();
 }
 
+//
+// pools CCMD
+//
+static void pools_func2(char* cmd, char* parms)
+{
+    const int tabs[MAXTABS] = { 120, 200, 280 };
+    size_t used;
+    size_t size;
+    char* temp1;
+    char* temp2;
+
+    C_TabbedOutput(tabs, "\t" BOLD("used") "\t" BOLD("most") "\t" BOLD("capacity"));
+
+    for(zpool_t* pool = Z_GetPools(); pool; pool = pool->nextpool)
+        C_TabbedOutput(tabs, INDENT "%s\t%i\t%i\t%i", pool->name, pool->used, pool->highwater,
+        pool->numslabs * POOLSLABBLOCKS);
+
+    size  = Z_GetArenaSize(PU_LEVEL, PU_NANOBSP, &used);
+    temp1 = commify(used / 1024);
+    temp2 = commify(size / 1024);
+    C_Output("The rest of the current map is using %sKB of the %sKB allocated for it.", temp1, temp2);
+    free(temp1);
+    free(temp2);
+}
+
 //
 // print CCMD
 //
@@ -8257,6 +8378,25 @@ static void readme_func2(char* cmd, char* parms)
     }
 }
 
+//
+// record CCMD
+//
+static void record_func2(char* cmd, char* parms)
+{
+    if(!*parms)
+    {
+        const int i = C_GetIndex(cmd);
+
+        C_ShowFormat(i);
+        C_ShowDescription(i);
+    }
+    else
+    {
+        G_RecordDemo(parms, game.skill, game.episode, game.map);
+        C_HideConsole();
+    }
+}
+
 //
 // regenhealth CCMD
 //
@@ -9117,6 +9257,54 @@ static void resurrect_func2(char* cmd, char* parms)
     }
 }
 
+//
+// rewind CCMD
+//
+static void rewind_func2(char* cmd, char* parms)
+{
+    int seconds;
+
+    if(!*parms)
+    {
+        const int i = C_GetIndex(cmd);
+
+        C_ShowFormat(i);
+        C_ShowDescription(i);
+
+        if(!rewindinterval)
+            C_Output("No snapshots are being taken, since " BOLD("rewindinterval") " is " BOLD("0") ".");
+        else if(G_RewindSnapshots())
+        {
+            char* temp1 = commify(G_RewindSnapshots());
+            char* temp2 = commify(G_RewindSeconds());
+            char* temp3 = commify((G_RewindMemory() + 1023) / 1024);
+
+            C_Output("There are %s snapshots going back %s second%s, using %sKB of memory. "
+                "Each snapshot took %i microseconds on average, and the last one %i.",
+                temp1, temp2, (G_RewindSeconds() == 1 ? "" : "s"), temp3,
+                (int)(G_RewindSnapshotTime(true) / 1000), (int)(G_RewindSnapshotTime(false) / 1000));
+
+            free(temp1);
+            free(temp2);
+            free(temp3);
+        }
+
+        return;
+    }
+
+    M_StringReplaceAll(parms, ",", "", false);
+
+    if(sscanf(parms, "%10i", &seconds) != 1 || seconds < 0)
+        return;
+
+    if(demorecording || demoplayback)
+        C_Warning(0, "The map can't be rewound while a demo is being %s.", (demorecording ? "recorded" : "played back"));
+    else if(!G_Rewind(seconds))
+        C_Warning(0, "There's nothing to rewind to yet.");
+    else
+        C_HideConsoleFast();
+}
+
 //
 // save CCMD
 //
@@ -9382,6 +9570,19 @@ static void spawn_func2(char* cmd, char* parms)
     }
 }
 
+//
+// stopdemo CCMD
+//
+static void stopdemo_func2(char* cmd, char* parms)
+{
+    const bool playback = demoplayback;
+
+    G_StopDemo();
+
+    if(playback)
+        D_StartTitle(1);
+}
+
 //
 // take CCMD
 //
@@ -9942,6 +10143,25 @@ static void thinglist_func2(char* cmd, char* parms)
     }
 }
 
+//
+// timedemo CCMD
+//
+static void timedemo_func2(char* cmd, char* parms)
+{
+    char name[MAX_PATH];
+    char option[16] = "";
+
+    if(!*parms || sscanf(parms, "%259s %15s", name, option) < 1)
+    {
+        const int i = C_GetIndex(cmd);
+
+        C_ShowFormat(i);
+        C_ShowDescription(i);
+    }
+    else if(G_PlayDemo(name, true, M_StringCompare(option, "nodraw"), false))
+        C_HideConsole();
+}
+
 //
 // timer CCMD
 //
@@ -11383,6 +11603,45 @@ static void r_brightmaps_func2(char* cmd, char* parms)
     }
 }
 
+//
+// r_columnmajor CVAR
+//
+static void r_columnmajor_func2(char* cmd, char* parms)
+{
+    if(*parms)
+    {
+        const int value = C_LookupValueFromAlias(parms, BOOLVALUEALIAS);
+
+        if((value == 0 || value == 1) && value != r_columnmajor)
+        {
+            r_columnmajor = value;
+            M_SaveCVARs();
+            R_InitBuffer();
+        }
+    }
+    else
+    {
+        char* temp1 = C_LookupAliasFromValue(r_columnmajor, BOOLVALUEALIAS);
+        const int i = C_GetIndex(cmd);
+
+        C_ShowDescription(i);
+
+        if(r_columnmajor == r_columnmajor_default)
+            C_Output(INTEGERCVARISDEFAULT, temp1);
+        else
+        {
+            char* temp2 = C_LookupAliasFromValue(r_columnmajor_default, BOOLVALUEALIAS);
+
+            C_Output(INTEGERCVARWITHDEFAULT, temp1, temp2);
+            free(temp2);
+        }
+
+        free(temp1);
+
+        C_ShowWarning(i);
+    }
+}
+
 //
 // r_corpses_mirrored CVAR
 //
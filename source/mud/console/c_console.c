@@ -56,6 +56,7 @@
 #include "menu/m_menu.h"
 #include "utils/m_misc.h"
 #include "playsim/p_spec.h"
+#include "render/r_plane.h"
 #include "sound/s_sound.h"
 #include "render/v_draw.h"
 #include "render/v_video.h"
@@ -1661,6 +1662,24 @@ void C_UpdateFPSOverlay(void)
     C_DrawOverlayText(v_screens[0], video.screen_width, x - C_OverlayWidth(temp, true) - 3,
     graphy, tinttab, temp, color, true, shadowcolor);
     free(temp);
+
+    if(game.state == GS_LEVEL && !automapactive)
+    {
+        char buffer[64];
+        char* drawntemp;
+        int found;
+        int drawn;
+
+        R_GetVisplaneCounts(&found, &drawn);
+        temp      = commify(found);
+        drawntemp = commify(drawn);
+        M_snprintf(buffer, sizeof(buffer), "%s/%s visplanes", drawntemp, temp);
+        C_DrawOverlayText(v_screens[0], video.screen_width,
+        graphx - C_OverlayWidth(buffer, true) - 6, OVERLAYTEXTY + 1, tinttab,
+        buffer, color, true, shadowcolor);
+        free(drawntemp);
+        free(temp);
+    }
 }
 
 void C_UpdateTimerOverlay(void)
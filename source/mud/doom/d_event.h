@@ -73,7 +73,9 @@ typedef enum
     ga_victory,
     ga_worlddone,
     ga_autoloadgame,
-    ga_autosavegame
+    ga_autosavegame,
+    ga_playdemo,
+    ga_rewind
 } gameaction_t;
 
 //
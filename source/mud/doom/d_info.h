@@ -339,6 +339,9 @@ typedef enum
     SG_END
 } splashgroup_t;
 
+// The column drawers' parameters, defined in r_draw.h
+typedef struct rendercontext_s rendercontext_t;
+
 typedef struct
 {
     int doomednum;
@@ -391,8 +394,8 @@ typedef struct
     char name3[64];
     char plural3[64];
 
-    void (*colfunc)(void);
-    void (*altcolfunc)(void);
+    void (*colfunc)(rendercontext_t* rc);
+    void (*altcolfunc)(rendercontext_t* rc);
     byte automapcolor;
     bool dehacked;
 } mobjinfo_t;
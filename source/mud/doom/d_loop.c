@@ -35,8 +35,10 @@
 
 #include "doom/d_main.h"
 #include "doom/doomstat.h"
+#include "game/g_demo.h"
 #include "game/g_game.h"
 #include "system/i_input.h"
+#include "system/i_perfstats.h"
 #include "system/i_timer.h"
 #include "system/i_config.h"
 #include "menu/m_menu.h"
@@ -54,10 +56,15 @@ void TryRunTics(void)
     static uint64_t lastmadetic;
     uint64_t newtics = I_GetTime() - lastmadetic;
     int runtics;
+    uint64_t starttime;
 
     lastmadetic += newtics;
     fractionaltic = ((I_GetTimeMS() * TICRATE) % 1000) * FRACUNIT / 1000;
 
+    // A timedemo runs a tic whenever it's asked to, however long it's been
+    if(timingdemo)
+        newtics = 1;
+
     while(newtics--)
     {
         if(maketic - game.time > 2)
@@ -69,6 +76,8 @@ void TryRunTics(void)
     if(!(runtics = maketic - game.time))
         return;
 
+    starttime = I_GetTimeNS();
+
     while(runtics--)
     {
         if(advancetitle)
@@ -85,4 +94,6 @@ void TryRunTics(void)
     }
 
     S_UpdateSounds(); // move positional sounds
+
+    I_AddPerfTime(PERF_TICS, starttime);
 }
@@ -42,10 +42,12 @@
 #include "doom/doomstat.h"
 #include "intermission/f_finale.h"
 #include "render/r_wipe.h"
+#include "game/g_demo.h"
 #include "game/g_game.h"
 #include "hud/hu_stuff.h"
 #include "math/math_colors.h"
 #include "system/i_input.h"
+#include "system/i_perfstats.h"
 #include "math/math_swap.h"
 #include "system/i_system.h"
 #include "system/i_timer.h"
@@ -166,6 +168,10 @@ void D_FadeScreenToBlack(void)
 // wipegamestate can be set to -1 to force a wipe on the next draw
 gamestate_t wipegamestate = GS_TITLESCREEN;
 
+// The frame rate D_Display wants capped to, applied by D_DoomTick once the
+// frame has been timed
+static int fpscap;
+
 void D_Display(void)
 {
     static bool pausedstate;
@@ -175,6 +181,8 @@ void D_Display(void)
     uint64_t wipestart;
     bool done;
 
+    fpscap = 0;
+
     // TODO: FIXME
     memset(v_screens[0], 255, video.screen_area);    
 
@@ -288,11 +296,13 @@ void D_Display(void)
     if(loadaction != ga_nothing)
         G_LoadedGameMessage();
 
+#if !defined(MUD_HEADLESS)
     if (vid_showfps)
     {
         double frame_time = sapp_frame_duration();  // seconds per frame
         framespersecond = (int) (frame_time > 0.0) ? (1.0 / frame_time) : 0.0;    
     }        
+#endif
 
     if(!dowipe || !melt)
     {
@@ -334,9 +344,9 @@ void D_Display(void)
 
         if((!vid_capfps || vid_capfps > 60 || (vid_vsync && refreshrate > 60)) &&
         (game.state != GS_LEVEL || menuactive || consoleactive || paused))
-            I_CapFPS(60);
+            fpscap = 60;
         else if(vid_capfps >= TICRATE && !vid_vsync)
-            I_CapFPS(vid_capfps);
+            fpscap = vid_capfps;
 
         return;
     }
@@ -369,11 +379,35 @@ void D_Display(void)
 //
 void D_DoomTick(void)
 {
+    uint64_t starttime = I_GetTimeNS();
+
     I_InputProcessEventQueue();
+    I_AddPerfTime(PERF_INPUT, starttime);
 
     TryRunTics(); // will run at least one tic
 
+    // A timedemo that isn't drawn runs as many tics as fit in a frame
+    if(nodrawdemo)
+    {
+        const uint64_t frameend = I_GetTimeMS() + 50;
+
+        while(nodrawdemo && I_GetTimeMS() < frameend)
+            TryRunTics();
+
+        return;
+    }
+
+#if !defined(MUD_HEADLESS)
+    starttime = I_GetTimeNS();
     D_Display(); // update display, next frame, with current state
+    I_AddPerfTime(PERF_HUD, starttime);
+
+    if(timingdemo)
+        G_TimeDemoFrame();
+
+    if(fpscap)
+        I_CapFPS(fpscap);
+#endif
 }
 
 //
@@ -52,10 +52,12 @@
 #include "doom/d_iwad.h"
 #include "doom/d_main.h"
 #include "doom/doomstat.h"
+#include "game/g_demo.h"
 #include "game/g_game.h"
 #include "hud/hu_stuff.h"
 #include "math/math_colors.h"
 #include "system/i_input.h"
+#include "system/i_perfstats.h"
 #include "math/math_swap.h"
 #include "system/i_system.h"
 #include "system/i_video.h"
@@ -348,6 +350,7 @@ static void D_DoomMainSetup(void)
     char* iwadfile;
     int startloadgame;
     const char* resourcefolder = M_GetResourceFolder();
+    const char* perfstats;
 
     I_TimeInit();
 
@@ -405,6 +408,15 @@ static void D_DoomMainSetup(void)
                                   "100%% health, no armor, "
                                   "and only a pistol with 50 bullets.");
 
+    if(*(perfstats = M_GetParm("perfstats")))
+    {
+        if(I_StartPerfLog(perfstats))
+            C_Output("A " BOLD("perfstats") " parameter was found on the command-line. "
+                     "The timings of each frame will now be logged to " BOLD("%s") ".", perfstats);
+        else
+            C_Warning(0, BOLD("%s") " couldn't be created.", perfstats);
+    }
+
     if((fastparm = M_CheckParm("fast")))
         C_Output("A " BOLD("fast") " parameter was found on the command-line. "
                                     "Monsters will now be fast.");
@@ -464,6 +476,27 @@ static void D_DoomMainSetup(void)
     else
         G_SetMovementSpeed(turbo);
 
+    // render thread count option
+    if(M_CheckParm("rthreads"))
+    {
+        p = M_GetParm("rthreads");
+
+        if(*p != '\0')
+        {
+            const int threads = strtol(p, NULL, 10);
+
+            if(threads >= r_threads_min && threads <= r_threads_max)
+            {
+                r_threads = threads;
+
+                C_Output(
+                "A " BOLD("-rthreads") " parameter was found on the command-line. "
+                                       "The player's view will now be rendered on %i thread%s.",
+                r_threads, (r_threads == 1 ? "" : "s"));
+            }
+        }
+    }
+
     // init subsystems
     if(!R_ResizeRenderState(r_scale))  // Initialize render state before V_Init needs it
         I_Error("Failed to initialize render state");
@@ -1129,7 +1162,20 @@ static void D_DoomMainSetup(void)
 
     if(game.action != ga_loadgame)
     {
-        if(autostart)
+        if(*(p = M_GetParm("timedemo")) || *(p = M_GetParm("playdemo")))
+        {
+            menuactive = false;
+
+            if(!G_PlayDemo(p, M_CheckParm("timedemo"), M_CheckParm("nodraw"), true))
+                I_Quit(false);
+        }
+        else if(*(p = M_GetParm("record")))
+        {
+            menuactive = false;
+            I_InitKeyboard();
+            G_RecordDemo(p, startskill, startepisode, startmap);
+        }
+        else if(autostart)
         {
             menuactive   = false;
             I_InitKeyboard();
@@ -52,3 +52,10 @@ typedef uint8_t byte;
 #endif
 
 #define arrlen(array) (sizeof(array) / sizeof(*array))
+
+// Storage class for state that each render thread keeps its own copy of
+#if defined(_MSC_VER) && !defined(__clang__)
+#define THREADLOCAL __declspec(thread)
+#else
+#define THREADLOCAL _Thread_local
+#endif
@@ -0,0 +1,434 @@
+//
+// g_demo.c - Recording and playing back demos of ticcmds
+//
+// A demo is a header describing how the game was started, followed by one
+// record per tic. Each record is a byte of flags saying which fields of the
+// ticcmd changed since the tic before, followed by just those fields, so a
+// tic where nothing changed takes a single byte. The RNG is seeded from the
+// header rather than the clock while a demo is recorded or played back.
+//
+
+#include <time.h>
+
+#include "console/c_console.h"
+#include "doom/d_main.h"
+#include "doom/doomstat.h"
+#include "game/g_demo.h"
+#include "game/g_game.h"
+#include "system/i_config.h"
+#include "system/i_filesystem.h"
+#include "system/i_system.h"
+#include "system/i_timer.h"
+#include "utils/m_misc.h"
+
+#define DEMOMAGIC           "MUDDEMO"
+#define DEMOVERSION         1
+#define DEMOHEADERSIZE      (sizeof(DEMOMAGIC) + 9)
+
+#define DEMOMARKER          0x80
+
+#define DEMO_FORWARDMOVE    1
+#define DEMO_SIDEMOVE       2
+#define DEMO_ANGLETURN      4
+#define DEMO_BUTTONS        8
+#define DEMO_LOOKDIR        16
+
+bool demorecording;
+bool demoplayback;
+bool timingdemo;
+bool nodrawdemo;
+
+// The CVARs and command-line parameters that change how the playsim behaves,
+// stored in the header and restored once playback ends
+static bool* const democvars[] = {
+    &autoaim, &fastparm, &freelook, &infighting, &nomonsters, &pistolstart,
+    &r_blood_gibs, &r_corpses_gib, &r_corpses_mirrored, &r_corpses_moreblood,
+    &r_corpses_nudge, &r_corpses_slide, &r_floatbob, &r_randomstartframes,
+    &r_rockettrails, &respawnmonsters, &tossdrop, &weaponrecoil, &dormancy
+};
+
+#define NUMDEMOCVARS    arrlen(democvars)
+
+static bool         savedcvars[NUMDEMOCVARS];
+
+static char         demoname[MAX_PATH];
+static byte*        demobuffer;
+static size_t       demolength;
+static size_t       demosize;
+static size_t       demopos;
+static bool         recordpending;
+static bool         quitafterdemo;
+static unsigned int demoseed;
+static ticcmd_t     democmd;
+
+static uint64_t     demostarttime;
+static uint64_t     lastframetime;
+static uint64_t     worstframetime;
+static int          demoframes;
+static int          demostarttic;
+
+//
+// G_DemoPath
+// Demos without a folder are kept in the app data folder.
+//
+static void G_DemoPath(char* path, const size_t size, const char* name)
+{
+    const char* extension = (strchr(name, '.') ? "" : DEMOEXTENSION);
+
+    if(strchr(name, '/') || strchr(name, '\\'))
+        M_snprintf(path, size, "%s%s", name, extension);
+    else
+        M_snprintf(path, size, "%s" DIR_SEPARATOR_S "%s%s", M_GetAppDataFolder(), name, extension);
+}
+
+static void G_DemoWrite(const void* data, const size_t length)
+{
+    if(demolength + length > demosize)
+    {
+        demosize   = demosize * 2 + length + 4096;
+        demobuffer = I_Realloc(demobuffer, demosize);
+    }
+
+    memcpy(&demobuffer[demolength], data, length);
+    demolength += length;
+}
+
+static void G_DemoWriteByte(const byte value)
+{
+    G_DemoWrite(&value, 1);
+}
+
+static void G_DemoWriteLong(const int value)
+{
+    const byte bytes[4] = { value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, (value >> 24) & 0xFF };
+
+    G_DemoWrite(bytes, 4);
+}
+
+static byte G_DemoReadByte(void)
+{
+    return (demopos < demolength ? demobuffer[demopos++] : DEMOMARKER);
+}
+
+static int G_DemoReadLong(void)
+{
+    unsigned int value = G_DemoReadByte();
+
+    value |= G_DemoReadByte() << 8;
+    value |= G_DemoReadByte() << 16;
+    value |= (unsigned int)G_DemoReadByte() << 24;
+
+    return (int)value;
+}
+
+//
+// G_RecordDemo
+// Starts a new game on the given map, and records it until G_StopDemo is
+// called.
+//
+void G_RecordDemo(const char* name, const skill_t skill, const int episode, const int map)
+{
+    G_DemoPath(demoname, sizeof(demoname), name);
+    recordpending = true;
+    G_DeferredInitNew(skill, MAX(1, episode), MAX(1, map));
+}
+
+//
+// G_BeginRecording
+// Called by G_DoNewGame once a game that is to be recorded is started.
+//
+void G_BeginRecording(const int skill, const int episode, const int map)
+{
+    unsigned int flags = 0;
+
+    // Any other new game ends the demo being recorded or played back
+    G_StopDemo();
+
+    if(!recordpending)
+        return;
+
+    recordpending = false;
+    demoseed      = (unsigned int)time(NULL);
+    demolength    = 0;
+    memset(&democmd, 0, sizeof(democmd));
+
+    for(int i = 0; i < NUMDEMOCVARS; i++)
+        if(*democvars[i])
+            flags |= (1 << i);
+
+    G_DemoWrite(DEMOMAGIC, sizeof(DEMOMAGIC));
+    G_DemoWriteByte(DEMOVERSION);
+    G_DemoWriteByte(skill);
+    G_DemoWriteByte(episode);
+    G_DemoWriteByte(map);
+    G_DemoWriteLong(demoseed);
+    G_DemoWriteLong(flags);
+
+    demorecording = true;
+    C_Output("Recording a demo to " BOLD("%s") "...", demoname);
+}
+
+//
+// G_WriteDemoTiccmd
+//
+void G_WriteDemoTiccmd(const ticcmd_t* cmd)
+{
+    byte flags  = 0;
+    int buttons = cmd->buttons;
+
+    // Saving the game isn't something to repeat on playback
+    if((buttons & BT_SPECIAL) && (buttons & BT_SPECIALMASK) == BTS_SAVEGAME)
+        buttons = 0;
+
+    if(cmd->forwardmove != democmd.forwardmove)
+        flags |= DEMO_FORWARDMOVE;
+
+    if(cmd->sidemove != democmd.sidemove)
+        flags |= DEMO_SIDEMOVE;
+
+    if(cmd->angleturn != democmd.angleturn)
+        flags |= DEMO_ANGLETURN;
+
+    if(buttons != democmd.buttons)
+        flags |= DEMO_BUTTONS;
+
+    if(cmd->lookdir != democmd.lookdir)
+        flags |= DEMO_LOOKDIR;
+
+    G_DemoWriteByte(flags);
+
+    if(flags & DEMO_FORWARDMOVE)
+        G_DemoWriteByte(cmd->forwardmove);
+
+    if(flags & DEMO_SIDEMOVE)
+        G_DemoWriteByte(cmd->sidemove);
+
+    if(flags & DEMO_ANGLETURN)
+    {
+        G_DemoWriteByte(cmd->angleturn & 0xFF);
+        G_DemoWriteByte((cmd->angleturn >> 8) & 0xFF);
+    }
+
+    if(flags & DEMO_BUTTONS)
+        G_DemoWriteLong(buttons);
+
+    if(flags & DEMO_LOOKDIR)
+        G_DemoWriteLong(cmd->lookdir);
+
+    democmd         = *cmd;
+    democmd.buttons = buttons;
+}
+
+//
+// G_PlayDemo
+// Loads a demo to be played back by G_DoPlayDemo on the next tic.
+//
+bool G_PlayDemo(const char* name, const bool timedemo, const bool nodraw, const bool quit)
+{
+    fs_file_info info;
+    fs_file* file;
+
+    G_StopDemo();
+    G_DemoPath(demoname, sizeof(demoname), name);
+
+    if(FS_GetInfo(&info, demoname, FS_TRUE) != FS_SUCCESS || !(file = FS_OpenFile(demoname, FS_READ, FS_TRUE)))
+    {
+        C_Warning(0, BOLD("%s") " couldn't be found.", demoname);
+        return false;
+    }
+
+    if((demolength = (size_t)info.size) > demosize)
+    {
+        demosize   = demolength;
+        demobuffer = I_Realloc(demobuffer, demosize);
+    }
+
+    demolength = FS_Read(demobuffer, 1, demolength, file);
+    FS_CloseFile(file);
+
+    if(demolength < DEMOHEADERSIZE || memcmp(demobuffer, DEMOMAGIC, sizeof(DEMOMAGIC))
+        || demobuffer[sizeof(DEMOMAGIC)] != DEMOVERSION)
+    {
+        C_Warning(0, BOLD("%s") " isn't a valid demo.", demoname);
+        demolength = 0;
+        return false;
+    }
+
+    timingdemo    = timedemo;
+#if defined(MUD_HEADLESS)
+    nodrawdemo    = timedemo; // nothing is ever drawn
+#else
+    nodrawdemo    = (timedemo && nodraw);
+#endif
+    quitafterdemo = quit;
+    game.action   = ga_playdemo;
+    return true;
+}
+
+//
+// G_DoPlayDemo
+//
+void G_DoPlayDemo(void)
+{
+    int skill;
+    int episode;
+    int map;
+    unsigned int flags;
+
+    demopos  = sizeof(DEMOMAGIC) + 1;
+    skill    = G_DemoReadByte();
+    episode  = G_DemoReadByte();
+    map      = G_DemoReadByte();
+    demoseed = (unsigned int)G_DemoReadLong();
+    flags    = (unsigned int)G_DemoReadLong();
+
+    for(int i = 0; i < NUMDEMOCVARS; i++)
+    {
+        savedcvars[i] = *democvars[i];
+        *democvars[i] = !!(flags & (1 << i));
+    }
+
+    memset(&democmd, 0, sizeof(democmd));
+    demoplayback = true;
+    game.action  = ga_nothing;
+
+    G_InitNew(skill, episode, map);
+
+    demostarttime  = I_GetTimeUS();
+    lastframetime  = demostarttime;
+    worstframetime = 0;
+    demoframes     = 0;
+    demostarttic   = game.time;
+}
+
+//
+// G_ReadDemoTiccmd
+//
+void G_ReadDemoTiccmd(ticcmd_t* cmd)
+{
+    const byte flags = G_DemoReadByte();
+
+    if(flags == DEMOMARKER)
+    {
+        G_StopDemo();
+        D_StartTitle(1);
+        memset(cmd, 0, sizeof(*cmd));
+        return;
+    }
+
+    if(flags & DEMO_FORWARDMOVE)
+        democmd.forwardmove = (signed char)G_DemoReadByte();
+
+    if(flags & DEMO_SIDEMOVE)
+        democmd.sidemove = (signed char)G_DemoReadByte();
+
+    if(flags & DEMO_ANGLETURN)
+    {
+        const int low = G_DemoReadByte();
+
+        democmd.angleturn = (signed short)(low | (G_DemoReadByte() << 8));
+    }
+
+    if(flags & DEMO_BUTTONS)
+        democmd.buttons = G_DemoReadLong();
+
+    if(flags & DEMO_LOOKDIR)
+        democmd.lookdir = G_DemoReadLong();
+
+    *cmd = democmd;
+}
+
+//
+// G_TimeDemoFrame
+// Called once a frame of a timedemo has been drawn.
+//
+void G_TimeDemoFrame(void)
+{
+    const uint64_t now = I_GetTimeUS();
+
+    if(now - lastframetime > worstframetime)
+        worstframetime = now - lastframetime;
+
+    lastframetime  = now;
+    demoframes++;
+}
+
+static void G_TimeDemoResults(void)
+{
+    const double    seconds = (I_GetTimeUS() - demostarttime) / 1000000.0;
+    const int       tics    = game.time - demostarttic;
+    char*           temp1   = commify(tics);
+    char*           temp2   = commify(demoframes);
+
+    if(nodrawdemo)
+        C_Output("%s tics were run in %.3f seconds (%.1f tics per second).",
+            temp1, seconds, (seconds > 0.0 ? tics / seconds : 0.0));
+    else
+        C_Output("%s tics and %s frames were run in %.3f seconds (%.1f tics and %.1f frames per second). "
+            "The slowest frame took %.2f milliseconds.",
+            temp1, temp2, seconds, (seconds > 0.0 ? tics / seconds : 0.0),
+            (seconds > 0.0 ? demoframes / seconds : 0.0), worstframetime / 1000.0);
+
+    free(temp1);
+    free(temp2);
+}
+
+//
+// G_StopDemo
+// Finishes any demo that is being recorded or played back.
+//
+void G_StopDemo(void)
+{
+    if(demorecording)
+    {
+        fs_file* file;
+
+        demorecording = false;
+        G_DemoWriteByte(DEMOMARKER);
+
+        if((file = FS_OpenFile(demoname, FS_WRITE | FS_TRUNCATE, FS_TRUE)))
+        {
+            const bool written = (FS_Write(demobuffer, 1, demolength, file) == demolength);
+
+            FS_CloseFile(file);
+
+            if(written)
+            {
+                char* temp = commify(demolength);
+
+                C_Output("A demo of %s bytes was recorded to " BOLD("%s") ".", temp, demoname);
+                free(temp);
+            }
+            else
+                C_Warning(0, BOLD("%s") " couldn't be written.", demoname);
+        }
+        else
+            C_Warning(0, BOLD("%s") " couldn't be created.", demoname);
+    }
+
+    if(demoplayback)
+    {
+        demoplayback = false;
+
+        for(int i = 0; i < NUMDEMOCVARS; i++)
+            *democvars[i] = savedcvars[i];
+
+        if(timingdemo)
+            G_TimeDemoResults();
+
+        timingdemo = false;
+        nodrawdemo = false;
+
+        if(quitafterdemo)
+            I_Quit(false);
+    }
+}
+
+//
+// G_DemoSeed
+// The seed for the RNGs at the start of each map.
+//
+unsigned int G_DemoSeed(void)
+{
+    return (demorecording || demoplayback ? demoseed : (unsigned int)time(NULL));
+}
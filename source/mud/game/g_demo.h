@@ -0,0 +1,29 @@
+//
+// g_demo.h - Recording and playing back demos of ticcmds
+//
+
+#pragma once
+
+#include "doom/d_ticcmd.h"
+#include "doom/doomdef.h"
+#include "doom/doomtype.h"
+
+#define DEMOEXTENSION   ".demo"
+
+extern bool demorecording;
+extern bool demoplayback;
+extern bool timingdemo;
+extern bool nodrawdemo;
+
+void G_RecordDemo(const char* name, const skill_t skill, const int episode, const int map);
+bool G_PlayDemo(const char* name, const bool timedemo, const bool nodraw, const bool quit);
+void G_StopDemo(void);
+
+void G_BeginRecording(const int skill, const int episode, const int map);
+void G_DoPlayDemo(void);
+
+void G_ReadDemoTiccmd(ticcmd_t* cmd);
+void G_WriteDemoTiccmd(const ticcmd_t* cmd);
+
+unsigned int G_DemoSeed(void);
+void G_TimeDemoFrame(void);
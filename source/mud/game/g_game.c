@@ -38,8 +38,10 @@
 #include "doom/d_deh.h"
 #include "doom/doomstat.h"
 #include "intermission/f_finale.h"
+#include "game/g_demo.h"
 #include "game/g_event.h"
 #include "game/g_game.h"
+#include "game/g_rewind.h"
 #include "hud/hu_stuff.h"
 #include "math/math_colors.h"
 #include "system/i_controller.h"
@@ -208,6 +210,7 @@ void G_DoLoadLevel(void)
     P_MapName(ep, game.map);
 
     P_SetupLevel(ep, game.map);
+    G_ClearRewind();
 
     // [BH] Reset player's health, armor, weapons and ammo on pistol start
     if(resetplayer && game.map != 1)
@@ -316,6 +319,14 @@ void G_Ticker(void)
             G_DoWorldDone();
             break;
 
+        case ga_playdemo:
+            G_DoPlayDemo();
+            break;
+
+        case ga_rewind:
+            G_DoRewind();
+            break;
+
         default:
             break;
         }
@@ -324,6 +335,11 @@ void G_Ticker(void)
     // and build new consistency check
     memcpy(&viewplayer->cmd, &localcmds[game.time % BACKUPTICS], sizeof(ticcmd_t));
 
+    if(demoplayback)
+        G_ReadDemoTiccmd(&viewplayer->cmd);
+    else if(demorecording)
+        G_WriteDemoTiccmd(&viewplayer->cmd);
+
     // check for special buttons
     if(viewplayer->cmd.buttons & BT_SPECIAL)
     {
@@ -382,6 +398,7 @@ void G_Ticker(void)
     {
     case GS_LEVEL:
         P_Ticker();
+        G_TakeRewindSnapshot();
         ST_Ticker();
         AM_Ticker();
         HU_Ticker();
@@ -807,7 +824,7 @@ void G_DoLoadGame(void)
     !M_StringStartsWith(console[numconsolestrings - 1].string, "load "))
         C_Input("load %s", savename);
 
-    if(!(save_stream = FS_OpenFile(savename, FS_READ, FS_TRUE)))
+    if(!P_OpenSaveGame(savename))
     {
         menuactive = false;
         C_ShowConsole(false);
@@ -818,11 +835,14 @@ void G_DoLoadGame(void)
 
     if(!P_ReadSaveGameHeader(savedescription))
     {
-        FS_CloseFile(save_stream);
+        P_CloseSaveGame();
         loadaction = ga_nothing;
         return;
     }
 
+    // Loading a game ends the demo being recorded or played back
+    G_StopDemo();
+
     savedmaptime = game.stats.maptime;
 
     // load a base level
@@ -849,7 +869,7 @@ void G_DoLoadGame(void)
 
     P_ReadSaveGameFooter();
 
-    FS_CloseFile(save_stream);
+    P_CloseSaveGame();
 
     if(setsizeneeded)
         R_ExecuteSetViewSize();
@@ -970,54 +990,39 @@ void G_SaveGame(const int slot, const char* description, const char* name)
 
 static void G_DoSaveGame(void)
 {
-    char* temp_savegame_file = P_TempSaveGameFile();
     char* savegame_file =
     (consoleactive || !*savedescription ? savename : P_SaveGameFile(savegameslot));
 
-    // Open the savegame file for writing. We write to a temporary file
-    // and then rename it at the end if it was successfully written.
-    // This prevents an existing savegame from being overwritten by
-    // a corrupted one, or if a savegame buffer overrun occurs.
-    if(!(save_stream = FS_OpenFile(temp_savegame_file, FS_WRITE, FS_TRUE)))
+    if(game.action == ga_autosavegame)
     {
-        menuactive = false;
-        C_ShowConsole(false);
-        C_Warning(0, BOLD("%s") " couldn't be saved.", savegame_file);
+        M_UpdateSaveGameName(quicksaveslot);
+        M_StringCopy(savedescription, savegamestrings[quicksaveslot],
+        sizeof(savedescription));
     }
-    else
-    {
-        char* backup_savegame_file = M_StringJoin(savegame_file, ".bak", NULL);
 
-        if(game.action == ga_autosavegame)
-        {
-            M_UpdateSaveGameName(quicksaveslot);
-            M_StringCopy(savedescription, savegamestrings[quicksaveslot],
-            sizeof(savedescription));
-        }
-
-        P_WriteSaveGameHeader(savedescription);
-
-        P_ArchivePlayer();
-        P_ArchiveWorld();
-        P_ArchiveThinkers();
-        P_ArchiveSpecials();
-        P_ArchiveMap();
+    // Archive everything in memory, and then write it out in the background
+    P_CreateSaveGame();
 
-        P_WriteSaveGameEOF();
+    P_WriteSaveGameHeader(savedescription);
 
-        P_WriteSaveGameFooter();
+    P_ArchivePlayer();
+    P_ArchiveWorld();
+    P_ArchiveThinkers();
+    P_ArchiveSpecials();
+    P_ArchiveMap();
 
-        // Finish up, close the savegame file.
-        FS_CloseFile(save_stream);
+    P_WriteSaveGameEOF();
 
-        // Now rename the temporary savegame file to the actual savegame
-        // file, backing up the old savegame if there was one there.
-        remove(backup_savegame_file);
-        rename(savegame_file, backup_savegame_file);
-        rename(temp_savegame_file, savegame_file);
-
-        free(backup_savegame_file);
+    P_WriteSaveGameFooter();
 
+    if(!P_WriteSaveGame(savegame_file, P_TempSaveGameFile()))
+    {
+        menuactive = false;
+        C_ShowConsole(false);
+        C_Warning(0, BOLD("%s") " couldn't be saved.", savegame_file);
+    }
+    else
+    {
         if(savegameslot >= 0)
             savegames = true;
 
@@ -1108,6 +1113,7 @@ static void G_DoNewGame(void)
     I_SetPalette(PLAYPAL);
 
     st_facecount = ST_STRAIGHTFACECOUNT;
+    G_BeginRecording(d_skill, d_episode, d_map);
     G_InitNew(d_skill, d_episode, d_map);
     game.action = ga_nothing;
     infight    = false;
@@ -0,0 +1,290 @@
+//
+// g_rewind.c - Rewinding the current map to an earlier snapshot
+//
+// Every rewindinterval tics the current map is archived to memory, the same
+// way a savegame is, into a ring of up to REWINDSNAPSHOTS snapshots. Only the
+// newest snapshot is kept whole. When a new one is taken, the one before it
+// is replaced by the XOR of the two, which is mostly zeros and so compresses
+// to very little, and can be undone by XORing it with the newer snapshot
+// again. Rewinding walks back from the newest snapshot to the one wanted and
+// puts the map back the way it was, without loading it again.
+//
+
+#include <string.h>
+
+#include "console/c_console.h"
+#include "doom/doomstat.h"
+#include "game/g_demo.h"
+#include "game/g_game.h"
+#include "game/g_rewind.h"
+#include "playsim/p_saveg.h"
+#include "system/i_config.h"
+#include "system/i_perfstats.h"
+#include "system/i_system.h"
+#include "system/i_timer.h"
+#include "utils/m_lz.h"
+
+typedef struct
+{
+    byte*   delta;          // compressed XOR with the next snapshot, or NULL
+    size_t  deltalength;
+    size_t  length;         // length of the snapshot itself
+    int     maptime;
+} rewindsnapshot_t;
+
+static rewindsnapshot_t snapshots[REWINDSNAPSHOTS];
+static int              oldestsnapshot;
+static int              numsnapshots;
+static size_t           snapshotmemory;
+
+// The newest snapshot, whole
+static byte*            latest;
+static size_t           latestsize;
+
+// Where the next snapshot is written, and deltas are compressed
+static byte*            scratch;
+static size_t           scratchsize;
+static byte*            packed;
+static size_t           packedsize;
+static unsigned int     packtable[LZHASHTABLESIZE];
+
+static int              lastmaptime = -1;
+static int              rewindtics;
+
+static uint64_t         lastsnapshottime;
+static uint64_t         totalsnapshottime;
+static int              timedsnapshots;
+
+#define SNAPSHOT(i)     (&snapshots[(oldestsnapshot + (i)) % REWINDSNAPSHOTS])
+
+//
+// G_ReserveRewindBuffer
+//
+static void G_ReserveRewindBuffer(byte** buffer, size_t* size, const size_t length)
+{
+    if(*size < length)
+    {
+        *buffer = I_Realloc(*buffer, length);
+        *size   = length;
+    }
+}
+
+//
+// G_SwapRewindBuffers
+//
+static void G_SwapRewindBuffers(void)
+{
+    byte*           buffer = latest;
+    const size_t    size   = latestsize;
+
+    latest      = scratch;
+    latestsize  = scratchsize;
+    scratch     = buffer;
+    scratchsize = size;
+}
+
+//
+// G_DropOldestSnapshot
+//
+static void G_DropOldestSnapshot(void)
+{
+    rewindsnapshot_t* snapshot = SNAPSHOT(0);
+
+    if(snapshot->delta)
+    {
+        free(snapshot->delta);
+        snapshotmemory -= snapshot->deltalength;
+    }
+
+    memset(snapshot, 0, sizeof(*snapshot));
+    oldestsnapshot = (oldestsnapshot + 1) % REWINDSNAPSHOTS;
+    numsnapshots--;
+}
+
+//
+// G_DropNewestSnapshot
+//
+static void G_DropNewestSnapshot(void)
+{
+    rewindsnapshot_t* snapshot = SNAPSHOT(--numsnapshots);
+
+    if(snapshot->delta)
+    {
+        free(snapshot->delta);
+        snapshotmemory -= snapshot->deltalength;
+    }
+
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+//
+// G_ClearRewind
+// Forgets every snapshot, when a map is loaded.
+//
+void G_ClearRewind(void)
+{
+    while(numsnapshots)
+        G_DropNewestSnapshot();
+
+    oldestsnapshot = 0;
+    snapshotmemory = 0;
+    lastmaptime    = -1;
+    rewindtics     = 0;
+}
+
+//
+// G_TakeRewindSnapshot
+// Called every tic the current map is being played. Takes a snapshot every
+// rewindinterval tics of maptime, other than while a demo is being recorded
+// or played back.
+//
+void G_TakeRewindSnapshot(void)
+{
+    const int           maptime = game.stats.maptime;
+    uint64_t            starttime;
+    size_t              length;
+    rewindsnapshot_t*   snapshot;
+
+    if(!rewindinterval || demorecording || demoplayback
+        || maptime == lastmaptime || maptime % rewindinterval)
+        return;
+
+    starttime   = I_GetTimeNS();
+    lastmaptime = maptime;
+    length      = P_ArchiveSnapshot(&scratch, &scratchsize);
+
+    if(numsnapshots)
+    {
+        // Replace the previous snapshot with its XOR with this one
+        snapshot = SNAPSHOT(numsnapshots - 1);
+
+        for(size_t i = 0, common = (length < snapshot->length ? length : snapshot->length); i < common; i++)
+            latest[i] ^= scratch[i];
+
+        G_ReserveRewindBuffer(&packed, &packedsize, M_LZBound(snapshot->length));
+        snapshot->deltalength = M_LZCompress(latest, snapshot->length, packed, packtable);
+        snapshot->delta       = I_Malloc(snapshot->deltalength);
+        memcpy(snapshot->delta, packed, snapshot->deltalength);
+        snapshotmemory += snapshot->deltalength;
+    }
+
+    // The newest snapshot becomes the one kept whole
+    G_SwapRewindBuffers();
+
+    if(numsnapshots == REWINDSNAPSHOTS)
+        G_DropOldestSnapshot();
+
+    while(numsnapshots > 1 && snapshotmemory > REWINDMEMORY)
+        G_DropOldestSnapshot();
+
+    snapshot          = SNAPSHOT(numsnapshots++);
+    snapshot->delta   = NULL;
+    snapshot->length  = length;
+    snapshot->maptime = maptime;
+
+    I_AddPerfTime(PERF_REWIND, starttime);
+    lastsnapshottime   = I_GetTimeNS() - starttime;
+    totalsnapshottime += lastsnapshottime;
+    timedsnapshots++;
+}
+
+//
+// G_Rewind
+// Rewinds the current map by seconds, once the current tic has finished.
+// Returns false if there's no snapshot to rewind to.
+//
+bool G_Rewind(const int seconds)
+{
+    if(!numsnapshots || demorecording || demoplayback)
+        return false;
+
+    rewindtics  = seconds * TICRATE;
+    game.action = ga_rewind;
+    return true;
+}
+
+//
+// G_DoRewind
+//
+void G_DoRewind(void)
+{
+    const int   maptime = game.stats.maptime - rewindtics;
+    int         target  = numsnapshots - 1;
+
+    game.action = ga_nothing;
+    rewindtics  = 0;
+
+    if(!numsnapshots)
+        return;
+
+    // Find the newest snapshot at or before maptime, or else the oldest
+    while(target > 0 && SNAPSHOT(target)->maptime > maptime)
+        target--;
+
+    // Undo each delta in turn until the snapshot wanted is in latest
+    while(numsnapshots - 1 > target)
+    {
+        rewindsnapshot_t*   snapshot = SNAPSHOT(numsnapshots - 2);
+        const size_t        length   = SNAPSHOT(numsnapshots - 1)->length;
+
+        G_ReserveRewindBuffer(&scratch, &scratchsize, snapshot->length);
+
+        if(!M_LZDecompress(snapshot->delta, snapshot->deltalength, scratch, snapshot->length))
+        {
+            C_Warning(0, "The map couldn't be rewound.");
+            G_ClearRewind();
+            return;
+        }
+
+        for(size_t i = 0, common = (length < snapshot->length ? length : snapshot->length); i < common; i++)
+            scratch[i] ^= latest[i];
+
+        G_SwapRewindBuffers();
+        G_DropNewestSnapshot();
+
+        free(snapshot->delta);
+        snapshotmemory       -= snapshot->deltalength;
+        snapshot->delta       = NULL;
+        snapshot->deltalength = 0;
+    }
+
+    P_UnarchiveSnapshot(latest, SNAPSHOT(target)->length);
+    lastmaptime = game.stats.maptime;
+}
+
+//
+// G_RewindSnapshots
+//
+int G_RewindSnapshots(void)
+{
+    return numsnapshots;
+}
+
+//
+// G_RewindSeconds
+// How far back the oldest snapshot is.
+//
+int G_RewindSeconds(void)
+{
+    return (numsnapshots ? (game.stats.maptime - SNAPSHOT(0)->maptime) / TICRATE : 0);
+}
+
+//
+// G_RewindMemory
+//
+size_t G_RewindMemory(void)
+{
+    return snapshotmemory + latestsize + scratchsize + packedsize;
+}
+
+//
+// G_RewindSnapshotTime
+// How many nanoseconds the last snapshot took, or all of them on average.
+//
+uint64_t G_RewindSnapshotTime(const bool average)
+{
+    if(average)
+        return (timedsnapshots ? totalsnapshottime / timedsnapshots : 0);
+
+    return lastsnapshottime;
+}
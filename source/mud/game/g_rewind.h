@@ -0,0 +1,22 @@
+//
+// g_rewind.h - Rewinding the current map to an earlier snapshot
+//
+
+#pragma once
+
+#include "doom/doomtype.h"
+
+// How many snapshots are kept, and roughly how much memory they may use
+#define REWINDSNAPSHOTS 64
+#define REWINDMEMORY    (8 * 1024 * 1024)
+
+void G_ClearRewind(void);
+void G_TakeRewindSnapshot(void);
+
+bool G_Rewind(const int seconds);
+void G_DoRewind(void);
+
+int G_RewindSnapshots(void);
+int G_RewindSeconds(void);
+size_t G_RewindMemory(void);
+uint64_t G_RewindSnapshotTime(const bool average);
@@ -34,8 +34,14 @@
 */
 
 #include "math/math_colors.h"
+#include "math/math_md5.h"
 #include "math/math_swap.h"
+#include "system/i_filesystem.h"
+#include "system/i_system.h"
+#include "system/i_version.h"
+#include "utils/m_misc.h"
 #include "wad/w_wad.h"
+#include "thread.h"
 
 #define R 1
 #define W 2
@@ -130,20 +136,25 @@ byte* white75;
 
 byte luminance[256];
 
+// From <https://www.compuphase.com/cmetric.htm>
+static inline int ColorDifference(const byte* color, const byte red, const byte green, const byte blue)
+{
+    const int rmean = (red + color[0]) / 2;
+    const int r     = red - color[0];
+    const int g     = green - color[1];
+    const int b     = blue - color[2];
+
+    return ((((512 + rmean) * r * r) >> 8) + 4 * g * g + (((767 - rmean) * b * b) >> 8));
+}
+
 int FindNearestColor(byte* palette, const byte red, const byte green, const byte blue)
 {
     int bestdiff  = INT_MAX;
     int bestcolor = 0;
 
-    for(int i = 0; i < 256; i++)
+    for(int i = 0; i < 256; i++, palette += 3)
     {
-        // From <https://www.compuphase.com/cmetric.htm>
-        const int rmean = (red + *palette) / 2;
-        const int r     = red - *palette++;
-        const int g     = green - *palette++;
-        const int b     = blue - *palette++;
-        const int diff =
-        (((512 + rmean) * r * r) >> 8) + 4 * g * g + (((767 - rmean) * b * b) >> 8);
+        const int diff = ColorDifference(palette, red, green, blue);
 
         if(!diff)
             return i;
@@ -291,98 +302,304 @@ int FindDominantEdgeColor(patch_t* patch)
     return color;
 }
 
-static byte* GenerateTintTable(byte* palette, int percent, int colors)
+//
+// COLOR CUBE
+// The RGB color cube is split into cells, and each cell has a list of the
+// only colors in the palette that can be the nearest to any color in it.
+// A color is left out if, even at its closest to the cell, it's further
+// away than some other color is at its furthest. The difference between
+// two colors is between 2 and 3 times the square of the difference of
+// their reds, plus 4 times that of their greens, plus between 2 and 3
+// times that of their blues, which gives those bounds. The colors in each
+// list are in the order they're in the palette, so searching a list finds
+// the same color FindNearestColor would.
+//
+#define CUBESHIFT   4
+#define CUBESIZE    (256 >> CUBESHIFT)
+#define CUBECELLS   (CUBESIZE * CUBESIZE * CUBESIZE)
+
+typedef struct
+{
+    const byte* palette;
+    int         cells[CUBECELLS + 1];   // where each cell's colors start
+    byte*       colors;
+} colorcube_t;
+
+static int ChannelDistance(const int value, const int low, const int high, const bool furthest)
 {
-    byte* result = malloc((size_t)256 * 256);
+    if(furthest)
+        return MAX(value - low, high - value);
+
+    return (value < low ? low - value : (value > high ? value - high : 0));
+}
 
-    if(result)
+static void InitColorCube(colorcube_t* cube, const byte* palette)
+{
+    int numcolors = 0;
+    int maxcolors = CUBECELLS * 16;
+
+    cube->palette = palette;
+    cube->colors  = I_Malloc(maxcolors);
+
+    for(int cell = 0; cell < CUBECELLS; cell++)
     {
-        for(int foreground = 0; foreground < 256; foreground++)
-            if((filter[foreground] & colors) || colors == ALL)
-                for(int background = 0; background < 256; background++)
-                {
-                    byte* color1 = &palette[background * 3];
-                    byte* color2 = &palette[foreground * 3];
-                    const byte r =
-                    ((byte)color1[0] * percent + (byte)color2[0] * (100 - percent)) / 100;
-                    const byte g =
-                    ((byte)color1[1] * percent + (byte)color2[1] * (100 - percent)) / 100;
-                    const byte b =
-                    ((byte)color1[2] * percent + (byte)color2[2] * (100 - percent)) / 100;
-
-                    result[(background << 8) + foreground] =
-                    FindNearestColor(palette, r, g, b);
-                }
-            else
-                for(int background = 0; background < 256; background++)
-                    result[(background << 8) + foreground] = foreground;
+        const int lowred    = (cell / (CUBESIZE * CUBESIZE)) << CUBESHIFT;
+        const int lowgreen  = ((cell / CUBESIZE) % CUBESIZE) << CUBESHIFT;
+        const int lowblue   = (cell % CUBESIZE) << CUBESHIFT;
+        const int highred   = lowred + (1 << CUBESHIFT) - 1;
+        const int highgreen = lowgreen + (1 << CUBESHIFT) - 1;
+        const int highblue  = lowblue + (1 << CUBESHIFT) - 1;
+        int furthest        = INT_MAX;
+
+        for(int i = 0; i < 256; i++)
+        {
+            const int r = ChannelDistance(palette[i * 3], lowred, highred, true);
+            const int g = ChannelDistance(palette[i * 3 + 1], lowgreen, highgreen, true);
+            const int b = ChannelDistance(palette[i * 3 + 2], lowblue, highblue, true);
+
+            furthest = MIN(furthest, 3 * r * r + 4 * g * g + 3 * b * b);
+        }
+
+        if(numcolors + 256 > maxcolors)
+            cube->colors = I_Realloc(cube->colors, (maxcolors *= 2));
+
+        cube->cells[cell] = numcolors;
+
+        for(int i = 0; i < 256; i++)
+        {
+            const int r = ChannelDistance(palette[i * 3], lowred, highred, false);
+            const int g = ChannelDistance(palette[i * 3 + 1], lowgreen, highgreen, false);
+            const int b = ChannelDistance(palette[i * 3 + 2], lowblue, highblue, false);
+
+            if(2 * r * r + 4 * g * g + 2 * b * b <= furthest)
+                cube->colors[numcolors++] = i;
+        }
     }
 
-    return result;
+    cube->cells[CUBECELLS] = numcolors;
 }
 
-static byte* GenerateAdditiveTintTable(byte* palette, int colors)
+static byte FindNearestColorInCube(const colorcube_t* cube, const byte red, const byte green,
+    const byte blue)
 {
-    byte* result = malloc((size_t)256 * 256);
+    const int cell   = (((red >> CUBESHIFT) * CUBESIZE + (green >> CUBESHIFT)) * CUBESIZE)
+        + (blue >> CUBESHIFT);
+    const byte* end  = &cube->colors[cube->cells[cell + 1]];
+    int bestdiff     = INT_MAX;
+    byte bestcolor   = 0;
 
-    if(result)
+    for(const byte* color = &cube->colors[cube->cells[cell]]; color < end; color++)
     {
-        for(int foreground = 0; foreground < 256; foreground++)
-            if((filter[foreground] & colors) || colors == ALL)
-                for(int background = 0; background < 256; background++)
+        const int diff = ColorDifference(&cube->palette[*color * 3], red, green, blue);
+
+        if(!diff)
+            return *color;
+        else if(diff < bestdiff)
+        {
+            bestcolor = *color;
+            bestdiff  = diff;
+        }
+    }
+
+    return bestcolor;
+}
+
+//
+// TINT TABLES
+// Generating them takes a while, so they're generated across threads the
+// first time a palette is used, and then kept in DOOMRETRO_TINTTABLESFILE
+// in the app data folder until a different palette is.
+//
+#define TINTTABLESIZE           (256 * 256)
+#define TINTTABLESMAGIC         "MUDTINT"
+#define TINTTABLESVERSION       1
+#define TINTTABLESHEADERSIZE    (sizeof(TINTTABLESMAGIC) + 1 + 16)
+
+#define ADDITIVE                -1
+
+// Every tint table, in the order they're kept in DOOMRETRO_TINTTABLESFILE
+static const struct
+{
+    byte**  table;
+    int     percent;    // or ADDITIVE
+    int     colors;
+} tinttables[] = {
+    { &tinttab4,          4,        ALL                        },
+    { &tinttab5,          5,        ALL                        },
+    { &tinttab10,         10,       ALL                        },
+    { &tinttab15,         15,       ALL                        },
+    { &tinttab20,         20,       ALL                        },
+    { &tinttab25,         25,       ALL                        },
+    { &tinttab30,         30,       ALL                        },
+    { &tinttab33,         33,       ALL                        },
+    { &tinttab40,         40,       ALL                        },
+    { &tinttab45,         45,       ALL                        },
+    { &tinttab50,         50,       ALL                        },
+    { &tinttab60,         60,       ALL                        },
+    { &tinttab66,         66,       ALL                        },
+    { &tinttab70,         70,       ALL                        },
+    { &tinttab75,         75,       ALL                        },
+    { &tinttab80,         80,       ALL                        },
+    { &tinttab90,         90,       ALL                        },
+    { &tinttabadditive,   ADDITIVE, ALL                        },
+    { &tinttabred,        ADDITIVE, REDS                       },
+    { &tinttabredwhite1,  ADDITIVE, (REDS | WHITES)            },
+    { &tinttabredwhite2,  ADDITIVE, (REDS | WHITES | EXTRAS)   },
+    { &tinttabgreen,      ADDITIVE, GREENS                     },
+    { &tinttabblue,       ADDITIVE, BLUES                      },
+    { &tinttabred33,      33,       REDS                       },
+    { &tinttabredwhite50, 50,       (REDS | WHITES)            },
+    { &tinttabgreen33,    33,       GREENS                     },
+    { &tinttabblue25,     25,       BLUES                      }
+};
+
+static colorcube_t          tintcube;
+static thread_atomic_int_t  nexttinttable;
+
+static void GenerateTintTable(byte* result, const int percent, const int colors)
+{
+    const byte* palette = tintcube.palette;
+
+    for(int foreground = 0; foreground < 256; foreground++)
+        if((filter[foreground] & colors) || colors == ALL)
+            for(int background = 0; background < 256; background++)
+            {
+                const byte* color1 = &palette[background * 3];
+                const byte* color2 = &palette[foreground * 3];
+                byte r, g, b;
+
+                if(percent == ADDITIVE)
+                {
+                    r = MIN(color1[0] + color2[0], 255);
+                    g = MIN(color1[1] + color2[1], 255);
+                    b = MIN(color1[2] + color2[2], 255);
+                }
+                else
                 {
-                    const byte* color1 = &palette[background * 3];
-                    const byte* color2 = &palette[foreground * 3];
-                    const byte r       = MIN(color1[0] + color2[0], 255);
-                    const byte g       = MIN(color1[1] + color2[1], 255);
-                    const byte b       = MIN(color1[2] + color2[2], 255);
-
-                    result[(background << 8) + foreground] =
-                    FindNearestColor(palette, r, g, b);
+                    r = (color1[0] * percent + color2[0] * (100 - percent)) / 100;
+                    g = (color1[1] * percent + color2[1] * (100 - percent)) / 100;
+                    b = (color1[2] * percent + color2[2] * (100 - percent)) / 100;
                 }
-            else
-                for(int background = 0; background < 256; background++)
-                    result[(background << 8) + foreground] = foreground;
+
+                result[(background << 8) + foreground] = FindNearestColorInCube(&tintcube, r, g, b);
+            }
+        else
+            for(int background = 0; background < 256; background++)
+                result[(background << 8) + foreground] = foreground;
+}
+
+static int GenerateTintTablesThreadProc(void* data)
+{
+    int i;
+
+    while((i = thread_atomic_int_inc(&nexttinttable)) < (int)arrlen(tinttables))
+        GenerateTintTable(*tinttables[i].table, tinttables[i].percent, tinttables[i].colors);
+
+    return 0;
+}
+
+//
+// GenerateTintTables
+// Generates the tint tables on the calling thread and as many others as
+// there are tables left for, up to r_threads_max.
+//
+static void GenerateTintTables(byte* palette)
+{
+    thread_ptr_t threads[r_threads_max];
+    int numthreads = 0;
+
+    InitColorCube(&tintcube, palette);
+    thread_atomic_int_store(&nexttinttable, 0);
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    while(numthreads < r_threads_max
+        && (threads[numthreads] = thread_create(&GenerateTintTablesThreadProc, NULL, THREAD_STACK_SIZE_DEFAULT)))
+        numthreads++;
+#endif
+
+    GenerateTintTablesThreadProc(NULL);
+
+    for(int i = 0; i < numthreads; i++)
+    {
+        thread_join(threads[i]);
+        thread_destroy(threads[i]);
     }
 
+    free(tintcube.colors);
+}
+
+//
+// LoadTintTables
+// Reads the tint tables from DOOMRETRO_TINTTABLESFILE, if they were generated
+// from the same palette.
+//
+static bool LoadTintTables(const char* filename, byte* tables, const byte digest[16])
+{
+    byte header[TINTTABLESHEADERSIZE];
+    fs_file_info info;
+    fs_file* file;
+    bool result = false;
+
+    if(FS_GetInfo(&info, filename, FS_TRUE) != FS_SUCCESS
+        || info.size != TINTTABLESHEADERSIZE + arrlen(tinttables) * TINTTABLESIZE
+        || !(file = FS_OpenFile(filename, FS_READ, FS_TRUE)))
+        return false;
+
+    if(FS_Read(header, 1, TINTTABLESHEADERSIZE, file) == TINTTABLESHEADERSIZE
+        && !memcmp(header, TINTTABLESMAGIC, sizeof(TINTTABLESMAGIC))
+        && header[sizeof(TINTTABLESMAGIC)] == TINTTABLESVERSION
+        && !memcmp(&header[sizeof(TINTTABLESMAGIC) + 1], digest, 16))
+        result = (FS_Read(tables, 1, arrlen(tinttables) * TINTTABLESIZE, file)
+            == arrlen(tinttables) * TINTTABLESIZE);
+
+    FS_CloseFile(file);
+
     return result;
 }
 
+static void SaveTintTables(const char* filename, const byte* tables, const byte digest[16])
+{
+    byte header[TINTTABLESHEADERSIZE];
+    fs_file* file;
+
+    if(!(file = FS_OpenFile(filename, FS_WRITE | FS_TRUNCATE, FS_TRUE)))
+        return;
+
+    memcpy(header, TINTTABLESMAGIC, sizeof(TINTTABLESMAGIC));
+    header[sizeof(TINTTABLESMAGIC)] = TINTTABLESVERSION;
+    memcpy(&header[sizeof(TINTTABLESMAGIC) + 1], digest, 16);
+
+    FS_Write(header, 1, TINTTABLESHEADERSIZE, file);
+    FS_Write(tables, 1, arrlen(tinttables) * TINTTABLESIZE, file);
+    FS_CloseFile(file);
+}
+
 void I_InitTintTables(byte* palette)
 {
     const int lump = W_CheckNumForName("TRANMAP");
+    byte* tables   = I_Malloc(arrlen(tinttables) * TINTTABLESIZE);
+    byte digest[16];
+    char* filename;
+    MD5Context md5;
 
-    tinttab4  = GenerateTintTable(palette, 4, ALL);
-    tinttab5  = GenerateTintTable(palette, 5, ALL);
-    tinttab10 = GenerateTintTable(palette, 10, ALL);
-    tinttab15 = GenerateTintTable(palette, 15, ALL);
-    tinttab20 = GenerateTintTable(palette, 20, ALL);
-    tinttab25 = GenerateTintTable(palette, 25, ALL);
-    tinttab30 = GenerateTintTable(palette, 30, ALL);
-    tinttab33 = GenerateTintTable(palette, 33, ALL);
-    tinttab40 = GenerateTintTable(palette, 40, ALL);
-    tinttab45 = GenerateTintTable(palette, 45, ALL);
-    tinttab50 = GenerateTintTable(palette, 50, ALL);
-    tinttab60 = GenerateTintTable(palette, 60, ALL);
-    tinttab66 = GenerateTintTable(palette, 66, ALL);
-    tinttab70 = GenerateTintTable(palette, 70, ALL);
-    tinttab75 = GenerateTintTable(palette, 75, ALL);
-    tinttab80 = GenerateTintTable(palette, 80, ALL);
-    tinttab90 = GenerateTintTable(palette, 90, ALL);
+    for(int i = 0; i < (int)arrlen(tinttables); i++)
+        *tinttables[i].table = &tables[i * TINTTABLESIZE];
 
-    tranmap = (lump != -1 ? W_CacheLumpNum(lump) : tinttab50);
+    MD5Init(&md5);
+    MD5Update(&md5, palette, 256 * 3);
+    MD5Final(digest, &md5);
+
+    filename = M_StringJoin(M_GetAppDataFolder(), DIR_SEPARATOR_S, DOOMRETRO_TINTTABLESFILE, NULL);
 
-    tinttabadditive  = GenerateAdditiveTintTable(palette, ALL);
-    tinttabred       = GenerateAdditiveTintTable(palette, REDS);
-    tinttabredwhite1 = GenerateAdditiveTintTable(palette, (REDS | WHITES));
-    tinttabredwhite2 = GenerateAdditiveTintTable(palette, (REDS | WHITES | EXTRAS));
-    tinttabgreen = GenerateAdditiveTintTable(palette, GREENS);
-    tinttabblue  = GenerateAdditiveTintTable(palette, BLUES);
-
-    tinttabred33      = GenerateTintTable(palette, 33, REDS);
-    tinttabredwhite50 = GenerateTintTable(palette, 50, (REDS | WHITES));
-    tinttabgreen33    = GenerateTintTable(palette, 33, GREENS);
-    tinttabblue25     = GenerateTintTable(palette, 25, BLUES);
+    if(!LoadTintTables(filename, tables, digest))
+    {
+        GenerateTintTables(palette);
+        SaveTintTables(filename, tables, digest);
+    }
+
+    free(filename);
+
+    tranmap = (lump != -1 ? W_CacheLumpNum(lump) : tinttab50);
 }
 
 static void HSVtoRGB(vector_t* hsv, vector_t* rgb)
@@ -39,8 +39,8 @@
 
 unsigned int seed;
 unsigned int bigseed;
-unsigned int fuzz1seed;
-unsigned int fuzz2seed;
+THREADLOCAL unsigned int fuzz1seed;
+THREADLOCAL unsigned int fuzz2seed;
 
 // MBF21: [XA] Common random formulas used by codepointers
 
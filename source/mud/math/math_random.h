@@ -63,8 +63,8 @@ static const unsigned char rndtable[] = { 0, 8, 109, 220, 222, 241, 149, 107,
 
 extern unsigned int seed;
 extern unsigned int bigseed;
-extern unsigned int fuzz1seed;
-extern unsigned int fuzz2seed;
+extern THREADLOCAL unsigned int fuzz1seed;
+extern THREADLOCAL unsigned int fuzz2seed;
 
 int P_RandomHitscanAngle(const fixed_t spread);
 int P_RandomHitscanSlope(const fixed_t spread);
@@ -718,6 +718,8 @@ static void M_ReadSaveStrings(void)
 {
     savegames = false;
 
+    P_FinishSaveGame();
+
     for(int i = 0; i < load_end; i++)
     {
         fs_file* handle = FS_OpenFile(P_SaveGameFile(i), FS_READ, FS_TRUE);
@@ -759,10 +761,12 @@ static byte saveg_read8(fs_file* file)
 //
 static bool M_CheckSaveGame(int* ep, int* map, int slot)
 {
-    fs_file* file = FS_OpenFile(P_SaveGameFile(slot), FS_READ, FS_TRUE);
+    fs_file* file;
     int mission;
 
-    if(!file)
+    P_FinishSaveGame();
+
+    if(!(file = FS_OpenFile(P_SaveGameFile(slot), FS_READ, FS_TRUE)))
         return false;
 
     for(int i = 0; i < SAVESTRINGSIZE + VERSIONSIZE + 1; i++)
@@ -1309,6 +1313,8 @@ static void M_DeleteSaveGameResponse(int key)
         M_StringCopy(buffer, P_SaveGameFile(itemon), sizeof(buffer));
         temp = titlecase(savegamestrings[itemon]);
 
+        P_FinishSaveGame();
+
         if(remove(buffer))
         {
             C_Warning(0, "\"%s\" couldn't be deleted.", temp);
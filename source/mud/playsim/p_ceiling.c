@@ -44,6 +44,8 @@
 // the list of ceilings currently moving, including crushers
 ceilinglist_t* activeceilings;
 
+zpool_t ceilingpool = ZPOOL("ceilings", ceiling_t, PU_LEVSPEC);
+
 static void P_GradualLightingToCeiling(ceiling_t* ceiling)
 {
     sector_t* sector    = ceiling->sector;
@@ -267,7 +269,7 @@ bool EV_DoCeiling(const line_t* line, ceiling_e type)
 
         // new ceiling thinker
         rtn     = true;
-        ceiling = Z_Calloc(1, sizeof(*ceiling), PU_LEVSPEC, NULL);
+        ceiling = Z_PoolCalloc(&ceilingpool);
 
         ceiling->thinker.function = &T_MoveCeiling;
         P_AddThinker(&ceiling->thinker);
@@ -45,6 +45,8 @@
 #include "sound/s_sound.h"
 #include "utils/z_zone.h"
 
+zpool_t doorpool = ZPOOL("doors", vldoor_t, PU_LEVSPEC);
+
 static void T_GradualLightingToDoor(vldoor_t* door)
 {
     sector_t* sec       = door->sector;
@@ -418,7 +420,7 @@ bool EV_DoDoor(line_t* line, vldoor_e type, fixed_t speed)
 
         // new door thinker
         rtn  = true;
-        door = Z_Calloc(1, sizeof(*door), PU_LEVSPEC, NULL);
+        door = Z_PoolCalloc(&doorpool);
 
         door->thinker.function = &T_VerticalDoor;
         P_AddThinker(&door->thinker);
@@ -727,7 +729,7 @@ void EV_VerticalDoor(line_t* line, mobj_t* thing)
     }
 
     // new door thinker
-    door = Z_Calloc(1, sizeof(*door), PU_LEVSPEC, NULL);
+    door = Z_PoolCalloc(&doorpool);
 
     door->thinker.function = &T_VerticalDoor;
     P_AddThinker(&door->thinker);
@@ -790,7 +792,7 @@ void EV_VerticalDoor(line_t* line, mobj_t* thing)
 //
 void P_SpawnDoorCloseIn30(sector_t* sec)
 {
-    vldoor_t* door = Z_Calloc(1, sizeof(*door), PU_LEVSPEC, NULL);
+    vldoor_t* door = Z_PoolCalloc(&doorpool);
 
     door->thinker.function = &T_VerticalDoor;
     P_AddThinker(&door->thinker);
@@ -809,7 +811,7 @@ void P_SpawnDoorCloseIn30(sector_t* sec)
 //
 void P_SpawnDoorRaiseIn5Mins(sector_t* sec)
 {
-    vldoor_t* door = Z_Calloc(1, sizeof(*door), PU_LEVSPEC, NULL);
+    vldoor_t* door = Z_PoolCalloc(&doorpool);
 
     door->thinker.function = &T_VerticalDoor;
     P_AddThinker(&door->thinker);
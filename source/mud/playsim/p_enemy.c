@@ -39,6 +39,7 @@
 #include "doom/doomstat.h"
 #include "game/g_game.h"
 #include "system/i_controller.h"
+#include "system/i_system.h"
 #include "system/i_timer.h"
 #include "math/math_bbox.h"
 #include "system/i_config.h"
@@ -57,6 +58,7 @@ uint64_t shake    = 0;
 int shakeduration = 0;
 
 void A_Fall(mobj_t* actor, player_t* player, pspdef_t* psp);
+void A_Look(mobj_t* actor, player_t* player, pspdef_t* psp);
 
 //
 // ENEMY THINKING
@@ -66,46 +68,36 @@ void A_Fall(mobj_t* actor, player_t* player, pspdef_t* psp);
 // but some can be made preaware
 //
 
+static sector_t** soundqueue;
+static int soundqueuesize;
+
 //
-// P_RecursiveSound
-// Called by P_NoiseAlert.
-// Recursively traverse adjacent sectors,
-// sound blocking lines cut off traversal.
-//
-// killough 05/05/98: reformatted, cleaned up
+// P_AlertSector
+// Marks a sector as having heard soundtarget, through soundblocks lines that
+// block sound.
 //
-static void P_RecursiveSound(sector_t* sec, const int soundblocks, mobj_t* soundtarget)
+static void P_AlertSector(sector_t* sec, const int soundblocks, mobj_t* soundtarget)
 {
-    // wake up all monsters in this sector
-    if(sec->validcount == validcount && sec->soundtraversed <= soundblocks + 1)
-        return; // already flooded
-
     sec->validcount     = validcount;
     sec->soundtraversed = soundblocks + 1;
     P_SetTarget(&sec->soundtarget, soundtarget);
+}
 
-    for(int i = 0; i < sec->linecount; i++)
-    {
-        line_t* line    = sec->lines[i];
-        const int flags = line->flags;
-
-        if(!(flags & ML_TWOSIDED))
-            continue;
+//
+// P_SoundCanPass
+// Returns true if sound can get through a sector's link to its neighbor.
+// Closed doors stop it.
+//
+static bool P_SoundCanPass(const soundlink_t* link)
+{
+    const line_t* line = link->line;
 
-        P_LineOpening(line);
+    if(!(line->flags & ML_TWOSIDED))
+        return false;
 
-        if(openrange <= 0)
-            continue; // closed door
+    P_LineOpening(line);
 
-        if(!(flags & ML_SOUNDBLOCK))
-            P_RecursiveSound(
-            sides[line->sidenum[(sides[line->sidenum[0]].sector == sec)]].sector,
-            soundblocks, soundtarget);
-        else if(!soundblocks)
-            P_RecursiveSound(
-            sides[line->sidenum[(sides[line->sidenum[0]].sector == sec)]].sector,
-            1, soundtarget);
-    }
+    return (openrange > 0);
 }
 
 //
@@ -113,14 +105,91 @@ static void P_RecursiveSound(sector_t* sec, const int soundblocks, mobj_t* sound
 // If a monster yells at the player,
 // it will alert other monsters to the player.
 //
+// Sound floods through two-sided lines that aren't closed, and through at
+// most one line that blocks sound. This is done breadth-first over the links
+// built by P_GroupLines: first through lines that don't block sound, then on
+// from each sector that was only reached through one that does. The sectors
+// alerted, and their soundtraversed values, are the same as when this was
+// done recursively.
+//
 void P_NoiseAlert(mobj_t* target, mobj_t* emitter)
 {
+    sector_t* sec;
+    int head = 0;
+    int tail = 0;
+    int blockedtail;
+
     // [BH] don't alert if notarget CCMD is enabled
     if(target->player && (viewplayer->cheats & CF_NOTARGET))
         return;
 
+    // The first half of the queue is for sectors reached without crossing
+    // a line that blocks sound, the second half for those that did
+    if(soundqueuesize < numsectors * 2)
+    {
+        soundqueuesize = numsectors * 2;
+        soundqueue     = I_Realloc(soundqueue, soundqueuesize * sizeof(*soundqueue));
+    }
+
+    blockedtail = numsectors;
+
     validcount++;
-    P_RecursiveSound(emitter->subsector->sector, 0, target);
+
+    sec = emitter->subsector->sector;
+    P_AlertSector(sec, 0, target);
+    soundqueue[tail++] = sec;
+
+    while(head < tail)
+    {
+        sec = soundqueue[head++];
+
+        for(int i = 0; i < sec->soundlinkcount; i++)
+        {
+            const soundlink_t* link = &sec->soundlinks[i];
+            sector_t* other         = link->sector;
+
+            if(!P_SoundCanPass(link))
+                continue;
+
+            if(!(link->line->flags & ML_SOUNDBLOCK))
+            {
+                if(other->validcount != validcount || other->soundtraversed > 1)
+                {
+                    P_AlertSector(other, 0, target);
+                    soundqueue[tail++] = other;
+                }
+            }
+            else if(other->validcount != validcount)
+            {
+                P_AlertSector(other, 1, target);
+                soundqueue[blockedtail++] = other;
+            }
+        }
+    }
+
+    head = numsectors;
+
+    while(head < blockedtail)
+    {
+        sec = soundqueue[head++];
+
+        // reached without crossing a line that blocks sound after all
+        if(sec->soundtraversed == 1)
+            continue;
+
+        for(int i = 0; i < sec->soundlinkcount; i++)
+        {
+            const soundlink_t* link = &sec->soundlinks[i];
+            sector_t* other         = link->sector;
+
+            if(other->validcount != validcount && !(link->line->flags & ML_SOUNDBLOCK) &&
+            P_SoundCanPass(link))
+            {
+                P_AlertSector(other, 1, target);
+                soundqueue[blockedtail++] = other;
+            }
+        }
+    }
 }
 
 //
@@ -860,6 +929,75 @@ static void P_SpawnBloodOnMelee(mobj_t* target, const int damage)
         target->z + M_RandomInt(4, 16) * FRACUNIT, 0, damage, target);
 }
 
+//
+// P_MobjIsAsleep
+// Returns true if a monster waiting in A_Look can skip its thinker this tic.
+// It has no target, is standing still, its sector hasn't heard a noise, and
+// REJECT says it can't see the player's sector, so A_Look would find nothing.
+// Any noise, damage or the player moving into view wakes it again.
+//
+bool P_MobjIsAsleep(const mobj_t* mobj, const sector_t* playersector)
+{
+    const sector_t* sector = mobj->subsector->sector;
+    const int       pnum   = sector->id * numsectors + playersector->id;
+
+    if(mobj->state->action != &A_Look || !sentient(mobj) || mobj->player ||
+    mobj->target || mobj->lastenemy || (mobj->flags & (MF_FRIEND | MF_SKULLFLY)) ||
+    (mobj->flags2 & MF2_FEETARECLIPPED) || mobj->nudge || mobj->gibtimer)
+        return false;
+
+    // P_MobjSleep() only counts down its tics, so it mustn't be about to enter
+    // a state that does more than A_Look, or be able to respawn in nightmare
+    if(mobj->tics == -1)
+    {
+        if((mobj->flags & MF_COUNTKILL) && (game.skill == sk_nightmare || respawnmonsters))
+            return false;
+    }
+    else if(mobj->tics == 1)
+    {
+        const state_t* next = &states[mobj->state->nextstate];
+
+        if(next->action != &A_Look || next->tics <= 0)
+            return false;
+    }
+
+    if(mobj->momx || mobj->momy || mobj->momz || mobj->z != mobj->floorz)
+        return false;
+
+    // Don't freeze something the renderer is still interpolating
+    if(mobj->interpolate != 1 || mobj->oldx != mobj->x || mobj->oldy != mobj->y ||
+    mobj->oldz != mobj->z || mobj->oldangle != mobj->angle)
+        return false;
+
+    if(sector->soundtarget || (sector->special & KILL_MONSTERS_MASK) || infight)
+        return false;
+
+    return (rejectmatrix[pnum >> 3] & (1 << (pnum & 7)));
+}
+
+//
+// P_MobjSleep
+// Runs a tic of a monster that P_MobjIsAsleep() says is asleep. Its tics are
+// counted down and its state changed just as its thinker would, so it wakes
+// in the same frame it would have been in had it never slept. A_Look isn't
+// called as it enters the next state, since it would find nothing, but what
+// it resets is reset.
+//
+void P_MobjSleep(mobj_t* mobj)
+{
+    if(mobj->tics != -1 && !--mobj->tics)
+    {
+        state_t* st = &states[mobj->state->nextstate];
+
+        mobj->state       = st;
+        mobj->tics        = st->tics;
+        mobj->sprite      = st->sprite;
+        mobj->frame       = st->frame;
+        mobj->threshold   = 0;
+        mobj->pursuecount = 0;
+    }
+}
+
 //
 // ACTION ROUTINES
 //
@@ -1289,6 +1427,7 @@ void A_SkelMissile(mobj_t* actor, player_t* player, pspdef_t* psp)
 
     mo->x += mo->momx;
     mo->y += mo->momy;
+    P_UpdateBlockThing(mo);
     P_SetTarget(&mo->tracer, target);
 }
 
@@ -1693,6 +1832,7 @@ void A_VileAttack(mobj_t* actor, player_t* player, pspdef_t* psp)
     an      = actor->angle >> ANGLETOFINESHIFT;
     fire->x = target->x - FixedMul(24 * FRACUNIT, finecosine[an]);
     fire->y = target->y - FixedMul(24 * FRACUNIT, finesine[an]);
+    P_UpdateBlockThing(fire);
     P_RadiusAttack(fire, actor, 70, 70, true);
 }
 
@@ -2704,6 +2844,7 @@ void A_MonsterProjectile(mobj_t* actor, player_t* player, pspdef_t* psp)
     mo->x += FixedMul(actor->state->args[3], finecosine[an]);
     mo->y += FixedMul(actor->state->args[3], finesine[an]);
     mo->z += actor->state->args[4];
+    P_UpdateBlockThing(mo);
 
     // always set the 'tracer' field, so this pointer
     // can be used to fire seeker missiles at will.
@@ -49,4 +49,6 @@ extern uint64_t shake;
 extern int shakeduration;
 
 void P_NoiseAlert(mobj_t* target, mobj_t* emitter);
+bool P_MobjIsAsleep(const mobj_t* mobj, const sector_t* playersector);
+void P_MobjSleep(mobj_t* mobj);
 bool P_CheckMeleeRange(mobj_t* actor);
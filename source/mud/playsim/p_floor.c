@@ -41,6 +41,9 @@
 #include "sound/s_sound.h"
 #include "utils/z_zone.h"
 
+zpool_t floorpool    = ZPOOL("floors", floormove_t, PU_LEVSPEC);
+zpool_t elevatorpool = ZPOOL("elevators", elevator_t, PU_LEVSPEC);
+
 //
 // FLOORS
 //
@@ -55,6 +58,8 @@ const bool crush,
 const int floororceiling,
 const int direction)
 {
+    P_ClearSightCache();
+
     switch(floororceiling)
     {
     case 0:
@@ -378,7 +383,7 @@ bool EV_DoFloor(const line_t* line, const floor_e floortype)
 
         // new floor thinker
         rtn   = true;
-        floor = Z_Calloc(1, sizeof(*floor), PU_LEVSPEC, NULL);
+        floor = Z_PoolCalloc(&floorpool);
 
         floor->thinker.function = &T_MoveFloor;
         P_AddThinker(&floor->thinker);
@@ -596,8 +601,8 @@ void P_CheckTerrainType(sector_t* sector)
     {
         if(sector->terraintype >= LIQUID)
         {
-            for(bloodsplat_t* splat = sector->splatlist; splat; splat = splat->next)
-                P_UnsetBloodSplatPosition(splat);
+            while(sector->splatlist)
+                P_UnsetBloodSplatPosition(sector->splatlist);
 
             for(msecnode_t* node = sector->touching_thinglist; node; node = node->m_snext)
             {
@@ -726,7 +731,7 @@ bool EV_BuildStairs(const line_t* line, const fixed_t speed, const fixed_t stair
 
         // new floor thinker
         rtn   = true;
-        floor = Z_Calloc(1, sizeof(*floor), PU_LEVSPEC, NULL);
+        floor = Z_PoolCalloc(&floorpool);
 
         floor->thinker.function = &T_MoveFloor;
         P_AddThinker(&floor->thinker);
@@ -770,7 +775,7 @@ bool EV_BuildStairs(const line_t* line, const fixed_t speed, const fixed_t stair
 
                 sec    = tsec;
                 secnum = tsec->id;
-                floor  = Z_Calloc(1, sizeof(*floor), PU_LEVSPEC, NULL);
+                floor  = Z_PoolCalloc(&floorpool);
 
                 floor->thinker.function = &T_MoveFloor;
                 P_AddThinker(&floor->thinker);
@@ -822,7 +827,7 @@ bool EV_DoElevator(const line_t* line, const elevator_e elevtype)
             continue;
 
         // create and initialize new elevator thinker
-        if(!(elevator = Z_Calloc(1, sizeof(*elevator), PU_LEVSPEC, NULL)))
+        if(!(elevator = Z_PoolCalloc(&elevatorpool)))
             return false;
 
         rtn                        = true;
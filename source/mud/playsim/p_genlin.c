@@ -108,7 +108,7 @@ bool EV_DoGenFloor(line_t* line)
 
         // new floor thinker
         rtn   = true;
-        floor = Z_Calloc(1, sizeof(*floor), PU_LEVSPEC, NULL);
+        floor = Z_PoolCalloc(&floorpool);
 
         floor->thinker.function = &T_MoveFloor;
         P_AddThinker(&floor->thinker);
@@ -316,7 +316,7 @@ bool EV_DoGenCeiling(line_t* line)
 
         // new ceiling thinker
         rtn     = true;
-        ceiling = Z_Calloc(1, sizeof(*ceiling), PU_LEVSPEC, NULL);
+        ceiling = Z_PoolCalloc(&ceilingpool);
 
         ceiling->thinker.function = &T_MoveCeiling;
         P_AddThinker(&ceiling->thinker);
@@ -527,7 +527,7 @@ bool EV_DoGenLift(line_t* line)
 
         // Setup the plat thinker
         rtn  = true;
-        plat = Z_Calloc(1, sizeof(*plat), PU_LEVSPEC, NULL);
+        plat = Z_PoolCalloc(&platpool);
 
         plat->thinker.function = &T_PlatRaise;
         P_AddThinker(&plat->thinker);
@@ -686,7 +686,7 @@ bool EV_DoGenStairs(line_t* line)
 
         // new floor thinker
         rtn   = true;
-        floor = Z_Calloc(1, sizeof(*floor), PU_LEVSPEC, NULL);
+        floor = Z_PoolCalloc(&floorpool);
 
         floor->thinker.function = &T_MoveFloor;
         P_AddThinker(&floor->thinker);
@@ -793,7 +793,7 @@ bool EV_DoGenStairs(line_t* line)
 
                 sec    = tsec;
                 secnum = newsecnum;
-                floor  = Z_Calloc(1, sizeof(*floor), PU_LEVSPEC, NULL);
+                floor  = Z_PoolCalloc(&floorpool);
 
                 floor->thinker.function = &T_MoveFloor;
                 P_AddThinker(&floor->thinker);
@@ -889,7 +889,7 @@ bool EV_DoGenCrusher(line_t* line)
 
         // new ceiling thinker
         rtn     = true;
-        ceiling = Z_Calloc(1, sizeof(*ceiling), PU_LEVSPEC, NULL);
+        ceiling = Z_PoolCalloc(&ceilingpool);
 
         ceiling->thinker.function = &T_MoveCeiling;
         P_AddThinker(&ceiling->thinker);
@@ -998,7 +998,7 @@ bool EV_DoGenLockedDoor(line_t* line)
 
         // new door thinker
         rtn  = true;
-        door = Z_Calloc(1, sizeof(*door), PU_LEVSPEC, NULL);
+        door = Z_PoolCalloc(&doorpool);
 
         door->thinker.function = &T_VerticalDoor;
         P_AddThinker(&door->thinker);
@@ -1115,7 +1115,7 @@ bool EV_DoGenDoor(line_t* line)
 
         // new door thinker
         rtn  = true;
-        door = Z_Calloc(1, sizeof(*door), PU_LEVSPEC, NULL);
+        door = Z_PoolCalloc(&doorpool);
 
         door->thinker.function = &T_VerticalDoor;
         P_AddThinker(&door->thinker);
@@ -40,6 +40,11 @@
 #include "playsim/p_tick.h"
 #include "utils/z_zone.h"
 
+zpool_t fireflickerpool = ZPOOL("fireflickers", fireflicker_t, PU_LEVSPEC);
+zpool_t lightflashpool  = ZPOOL("lightflashes", lightflash_t, PU_LEVSPEC);
+zpool_t strobepool      = ZPOOL("strobes", strobe_t, PU_LEVSPEC);
+zpool_t glowpool        = ZPOOL("glows", glow_t, PU_LEVSPEC);
+
 //
 // FIRELIGHT FLICKER
 //
@@ -69,7 +74,7 @@ void T_FireFlicker(fireflicker_t* flick)
 //
 void P_SpawnFireFlicker(sector_t* sector)
 {
-    fireflicker_t* flick = Z_Malloc(sizeof(*flick), PU_LEVSPEC, NULL);
+    fireflicker_t* flick = Z_PoolCalloc(&fireflickerpool);
 
     flick->thinker.function = &T_FireFlicker;
     flick->thinker.menu     = true;
@@ -113,7 +118,7 @@ void T_LightFlash(lightflash_t* flash)
 //
 void P_SpawnLightFlash(sector_t* sector)
 {
-    lightflash_t* flash = Z_Malloc(sizeof(*flash), PU_LEVSPEC, NULL);
+    lightflash_t* flash = Z_PoolCalloc(&lightflashpool);
 
     flash->thinker.function = &T_LightFlash;
     flash->thinker.menu     = true;
@@ -158,7 +163,7 @@ void T_StrobeFlash(strobe_t* strobe)
 //
 void P_SpawnStrobeFlash(sector_t* sector, int fastorslow, bool insync)
 {
-    strobe_t* strobe = Z_Malloc(sizeof(*strobe), PU_LEVSPEC, NULL);
+    strobe_t* strobe = Z_PoolCalloc(&strobepool);
 
     strobe->thinker.function = &T_StrobeFlash;
     strobe->thinker.menu     = true;
@@ -278,7 +283,7 @@ void T_Glow(glow_t* glow)
 
 void P_SpawnGlowingLight(sector_t* sector)
 {
-    glow_t* glow = Z_Malloc(sizeof(*glow), PU_LEVSPEC, NULL);
+    glow_t* glow = Z_PoolCalloc(&glowpool);
 
     glow->thinker.function = &T_Glow;
     glow->thinker.menu     = true;
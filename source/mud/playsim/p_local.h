@@ -50,6 +50,7 @@
 #include "doom/d_main.h"
 #include "system/i_config.h"
 #include "render/r_local.h"
+#include "utils/z_zone.h"
 
 // Include focused playsim headers
 #include "playsim/p_user.h"
@@ -136,6 +137,10 @@ void P_SetPlayerViewHeight(void);
 void P_LookForCards(void);
 void P_InitCards(void);
 
+extern zpool_t mobjpool;
+extern zpool_t bloodsplatpool;
+
+mobj_t* P_AllocMobj(void);
 mobj_t* P_SpawnMobj(const fixed_t x, const fixed_t y, const fixed_t z, const mobjtype_t type);
 void P_SetShadowColumnFunction(mobj_t* mobj);
 mobjtype_t P_FindDoomedNum(const int type);
@@ -184,6 +189,26 @@ extern fixed_t bmaporgx;
 extern fixed_t bmaporgy;    // origin of blockmap
 extern mobj_t** blocklinks; // for thing chains
 
+// A compact copy of the position and size of each thing linked into a block,
+// so searches can rule out a whole block without touching the things in it.
+// radius is at least as big as any radius PIT_CheckThing or PIT_RadiusAttack
+// will use for the thing.
+typedef struct
+{
+    fixed_t x, y;
+    fixed_t radius;
+    mobj_t* mobj;
+} blockthing_t;
+
+typedef struct
+{
+    blockthing_t* things;
+    int count;
+    int capacity;
+} blockcell_t;
+
+extern blockcell_t* blockcells; // parallel to blocklinks
+
 // MAES: extensions to support 512x512 blockmaps.
 extern int blockmapxneg;
 extern int blockmapyneg;
@@ -825,6 +825,8 @@ bool P_CheckPosition(mobj_t* thing, const fixed_t x, const fixed_t y)
     int yh;
     const sector_t* newsec;
     fixed_t radius = thing->radius;
+    int64_t reach;
+    fixed_t range;
 
     tmthing = thing;
 
@@ -865,10 +867,18 @@ bool P_CheckPosition(mobj_t* thing, const fixed_t x, const fixed_t y)
     yl = P_GetSafeBlockY(tmbbox[BOXBOTTOM] - bmaporgy - MAXRADIUS);
     yh = P_GetSafeBlockY(tmbbox[BOXTOP] - bmaporgy + MAXRADIUS);
 
+    // PIT_CheckThing() does nothing with a thing unless it's within the
+    // thing's radius of tmthing's new position, or 16 units of where tmthing
+    // is now. Rippers are left unfiltered, as they keep going after damaging
+    // something, and that can change tmthing.
+    reach = (int64_t)radius + MAX(llabs((int64_t)x - thing->x), llabs((int64_t)y - thing->y));
+    range = ((tmthing->mbf21flags & MF_MBF21_RIP) || reach > INT_MAX ? -1 : (fixed_t)reach);
+
     for(int bx = xl; bx <= xh; bx++)
         for(int by = yl; by <= yh; by++)
-            if(!P_BlockThingsIterator(
-               bx, by, &PIT_CheckThing, !(tmthing->mbf21flags & MF_MBF21_RIP)))
+            if(!P_BlockThingsIteratorNear(bx, by, &PIT_CheckThing,
+               !(tmthing->mbf21flags & MF_MBF21_RIP), x, y,
+               (tmthing == thing && tmx == x && tmy == y ? range : -1)))
                 return false;
 
     // check lines
@@ -2154,9 +2164,14 @@ void P_RadiusAttack(mobj_t* spot, mobj_t* source, const int damage, const int di
     bombdistance    = distance;
     bombverticality = verticality;
 
+    // PIT_RadiusAttack() ignores anything more than distance plus its radius
+    // away. Don't filter once a nested call has replaced bombspot.
+    const fixed_t range = (distance >= 0 && distance < 32768 ? distance << FRACBITS : -1);
+
     for(int y = yl; y <= yh; y++)
         for(int x = xl; x <= xh; x++)
-            P_BlockThingsIterator(x, y, &PIT_RadiusAttack, false);
+            P_BlockThingsIteratorNear(x, y, &PIT_RadiusAttack, false, spot->x, spot->y,
+            (bombspot == spot && bombdistance == distance ? range : -1));
 }
 
 //
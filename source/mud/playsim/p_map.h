@@ -70,6 +70,7 @@ bool P_CheckLineSide(const mobj_t* actor, const fixed_t x, const fixed_t y);
 bool P_TeleportMove(mobj_t* thing, const fixed_t x, const fixed_t y, const fixed_t z, const bool boss);
 void P_SlideMove(mobj_t* mo);
 bool P_CheckSight(mobj_t* t1, mobj_t* t2);
+void P_ClearSightCache(void);
 bool P_CheckFOV(const mobj_t* t1, const mobj_t* t2, const angle_t fov);
 bool P_DoorClosed(const line_t* line);
 void P_UseLines(void);
@@ -171,6 +171,104 @@ void P_LineOpening(const line_t* line)
 // THING POSITION SETTING
 //
 
+//
+// P_BlockThingRadius
+// The radius kept for a thing in blockcells. PIT_CheckThing uses the radius
+// from its mobjinfo or its pickup radius, and nudges corpses within 16 units.
+//
+static fixed_t P_BlockThingRadius(const mobj_t* thing)
+{
+    const mobjinfo_t* info = thing->info;
+    fixed_t radius         = MAX(thing->radius, info->radius);
+
+    radius = MAX(radius, info->pickupradius);
+
+    return MAX(radius, 16 * FRACUNIT);
+}
+
+//
+// P_LinkBlockThing
+// Adds a thing's entry to the end of a block's array.
+//
+static void P_LinkBlockThing(mobj_t* thing, const int index)
+{
+    blockcell_t* cell = &blockcells[index];
+    blockthing_t* entry;
+
+    if(cell->count == cell->capacity)
+    {
+        cell->capacity = (cell->capacity ? cell->capacity * 2 : 4);
+        cell->things   = I_Realloc(cell->things, cell->capacity * sizeof(*cell->things));
+    }
+
+    entry         = &cell->things[cell->count];
+    entry->x      = thing->x;
+    entry->y      = thing->y;
+    entry->radius = P_BlockThingRadius(thing);
+    entry->mobj   = thing;
+
+    thing->blockcell = index;
+    thing->blockslot = cell->count++;
+}
+
+//
+// P_UnlinkBlockThing
+// Removes a thing's entry from its block, moving the last entry into its place.
+//
+static void P_UnlinkBlockThing(mobj_t* thing)
+{
+    blockcell_t* cell = &blockcells[thing->blockcell];
+    const int slot    = thing->blockslot;
+
+    if(slot != --cell->count)
+    {
+        cell->things[slot]                 = cell->things[cell->count];
+        cell->things[slot].mobj->blockslot = slot;
+    }
+
+    thing->blockcell = -1;
+}
+
+//
+// P_UpdateBlockThing
+// Called when a thing is moved without being unlinked and linked again.
+//
+void P_UpdateBlockThing(const mobj_t* thing)
+{
+    if(thing->bprev && thing->blockcell >= 0)
+    {
+        blockthing_t* entry = &blockcells[thing->blockcell].things[thing->blockslot];
+
+        entry->x      = thing->x;
+        entry->y      = thing->y;
+        entry->radius = P_BlockThingRadius(thing);
+    }
+}
+
+//
+// P_ClearBlockCells
+// Empties every block, and frees them too when the blockmap is about to go.
+//
+void P_ClearBlockCells(const bool freecells)
+{
+    if(!blockcells)
+        return;
+
+    for(int i = 0; i < bmapwidth * bmapheight; i++)
+    {
+        if(freecells)
+            free(blockcells[i].things);
+        else
+            blockcells[i].count = 0;
+    }
+
+    if(freecells)
+    {
+        free(blockcells);
+        blockcells = NULL;
+    }
+}
+
 //
 // P_UnsetThingPosition
 // Unlinks a thing from blockmap and sectors. On each position change, BLOCKMAP and other
@@ -223,11 +321,15 @@ void P_UnsetThingPosition(mobj_t* thing)
 
         if(bprev && (*bprev = bnext = thing->bnext)) // unlink from blockmap
             bnext->bprev = bprev;
+
+        if(bprev && thing->blockcell >= 0)
+            P_UnlinkBlockThing(thing);
     }
 }
 
 //
 // P_UnsetBloodSplatPosition
+// Unlinks a blood splat from its sector, and frees it.
 //
 void P_UnsetBloodSplatPosition(bloodsplat_t* splat)
 {
@@ -238,6 +340,7 @@ void P_UnsetBloodSplatPosition(bloodsplat_t* splat)
         next->prev = prev;
 
     r_bloodsplats_total--;
+    Z_Free(splat);
 }
 
 //
@@ -302,12 +405,15 @@ void P_SetThingPosition(mobj_t* thing)
 
             thing->bprev = link;
             *link        = thing;
+
+            P_LinkBlockThing(thing, blocky * bmapwidth + blockx);
         }
         else
         {
             // thing is off the map
-            thing->bnext = NULL;
-            thing->bprev = NULL;
+            thing->bnext     = NULL;
+            thing->bprev     = NULL;
+            thing->blockcell = -1;
         }
     }
 }
@@ -366,78 +472,114 @@ bool P_BlockLinesIterator(const int x, const int y, bool func(line_t*))
     }
 }
 
+//
+// P_BlockCellIsNear
+// Returns false if nothing in the block at index can be within range of
+// (x, y), going by blockcells alone. A range below 0 matches everything.
+//
+static bool P_BlockCellIsNear(const int index, const fixed_t x, const fixed_t y, const fixed_t range)
+{
+    const blockcell_t* cell = &blockcells[index];
+
+    if(range < 0)
+        return true;
+
+    for(int i = 0; i < cell->count; i++)
+    {
+        const blockthing_t* thing = &cell->things[i];
+        const int64_t reach       = (int64_t)thing->radius + range;
+
+        if(llabs((int64_t)thing->x - x) < reach && llabs((int64_t)thing->y - y) < reach)
+            return true;
+    }
+
+    return false;
+}
+
 //
 // P_BlockThingsIterator
 //
 bool P_BlockThingsIterator(const int x, const int y, bool func(mobj_t*), bool blockmapfix)
 {
+    return P_BlockThingsIteratorNear(x, y, func, blockmapfix, 0, 0, -1);
+}
+
+//
+// P_BlockThingsIteratorNear
+// As P_BlockThingsIterator, but skips any block with nothing in it that could
+// be within range of (nearx, neary). func must return true without doing
+// anything for a thing further away than that, plus the thing's radius.
+//
+bool P_BlockThingsIteratorNear(const int x, const int y, bool func(mobj_t*), bool blockmapfix,
+const fixed_t nearx, const fixed_t neary, const fixed_t range)
+{
+    int index;
+
     if(x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
         return true;
 
-    for(mobj_t* mobj = blocklinks[y * bmapwidth + x]; mobj; mobj = mobj->bnext)
-        if(!func(mobj))
-            return false;
+    index = y * bmapwidth + x;
+
+    if(P_BlockCellIsNear(index, nearx, neary, range))
+        for(mobj_t* mobj = blocklinks[index]; mobj; mobj = mobj->bnext)
+            if(!func(mobj))
+                return false;
 
     // Blockmap bug fix by Terry Hearst
     if(blockmapfix)
     {
         // (-1, -1)
-        if(x > 0 && y > 0)
-            for(mobj_t* mobj = blocklinks[(y - 1) * bmapwidth + x - 1]; mobj;
-            mobj             = mobj->bnext)
+        if(x > 0 && y > 0 && P_BlockCellIsNear((index = (y - 1) * bmapwidth + x - 1), nearx, neary, range))
+            for(mobj_t* mobj = blocklinks[index]; mobj; mobj = mobj->bnext)
                 if(x == (mobj->x + mobj->radius - bmaporgx) >> MAPBLOCKSHIFT &&
                 y == (mobj->y + mobj->radius - bmaporgy) >> MAPBLOCKSHIFT && !func(mobj))
                     return false;
 
         // (0, -1)
-        if(y > 0)
-            for(mobj_t* mobj = blocklinks[(y - 1) * bmapwidth + x]; mobj;
-            mobj             = mobj->bnext)
+        if(y > 0 && P_BlockCellIsNear((index = (y - 1) * bmapwidth + x), nearx, neary, range))
+            for(mobj_t* mobj = blocklinks[index]; mobj; mobj = mobj->bnext)
                 if(y == (mobj->y + mobj->radius - bmaporgy) >> MAPBLOCKSHIFT && !func(mobj))
                     return false;
 
         // (1, -1)
-        if(x < bmapwidth - 1 && y > 0)
-            for(mobj_t* mobj = blocklinks[(y - 1) * bmapwidth + x + 1]; mobj;
-            mobj             = mobj->bnext)
+        if(x < bmapwidth - 1 && y > 0 &&
+        P_BlockCellIsNear((index = (y - 1) * bmapwidth + x + 1), nearx, neary, range))
+            for(mobj_t* mobj = blocklinks[index]; mobj; mobj = mobj->bnext)
                 if(x == (mobj->x - mobj->radius - bmaporgx) >> MAPBLOCKSHIFT &&
                 y == (mobj->y + mobj->radius - bmaporgy) >> MAPBLOCKSHIFT && !func(mobj))
                     return false;
 
         // (1, 0)
-        if(x < bmapwidth - 1)
-            for(mobj_t* mobj = blocklinks[y * bmapwidth + x + 1]; mobj;
-            mobj             = mobj->bnext)
+        if(x < bmapwidth - 1 && P_BlockCellIsNear((index = y * bmapwidth + x + 1), nearx, neary, range))
+            for(mobj_t* mobj = blocklinks[index]; mobj; mobj = mobj->bnext)
                 if(x == (mobj->x - mobj->radius - bmaporgx) >> MAPBLOCKSHIFT && !func(mobj))
                     return false;
 
         // (1, 1)
-        if(x < bmapwidth - 1 && y < bmapheight - 1)
-            for(mobj_t* mobj = blocklinks[(y + 1) * bmapwidth + x + 1]; mobj;
-            mobj             = mobj->bnext)
+        if(x < bmapwidth - 1 && y < bmapheight - 1 &&
+        P_BlockCellIsNear((index = (y + 1) * bmapwidth + x + 1), nearx, neary, range))
+            for(mobj_t* mobj = blocklinks[index]; mobj; mobj = mobj->bnext)
                 if(x == (mobj->x - mobj->radius - bmaporgx) >> MAPBLOCKSHIFT &&
                 y == (mobj->y - mobj->radius - bmaporgy) >> MAPBLOCKSHIFT && !func(mobj))
                     return false;
 
         // (0, 1)
-        if(y < bmapheight - 1)
-            for(mobj_t* mobj = blocklinks[(y + 1) * bmapwidth + x]; mobj;
-            mobj             = mobj->bnext)
+        if(y < bmapheight - 1 && P_BlockCellIsNear((index = (y + 1) * bmapwidth + x), nearx, neary, range))
+            for(mobj_t* mobj = blocklinks[index]; mobj; mobj = mobj->bnext)
                 if(y == (mobj->y - mobj->radius - bmaporgy) >> MAPBLOCKSHIFT && !func(mobj))
                     return false;
 
         // (-1, 1)
-        if(x > 0 && y < bmapheight - 1)
-            for(mobj_t* mobj = blocklinks[(y + 1) * bmapwidth + x - 1]; mobj;
-            mobj             = mobj->bnext)
+        if(x > 0 && y < bmapheight - 1 &&
+        P_BlockCellIsNear((index = (y + 1) * bmapwidth + x - 1), nearx, neary, range))
+            for(mobj_t* mobj = blocklinks[index]; mobj; mobj = mobj->bnext)
                 if(x == (mobj->x + mobj->radius - bmaporgx) >> MAPBLOCKSHIFT &&
                 y == (mobj->y - mobj->radius - bmaporgy) >> MAPBLOCKSHIFT && !func(mobj))
                     return false;
 
         // (-1, 0)
-        if(x > 0)
-            for(mobj_t* mobj = blocklinks[y * bmapwidth + x - 1]; mobj;
-            mobj             = mobj->bnext)
+        if(x > 0 && P_BlockCellIsNear((index = y * bmapwidth + x - 1), nearx, neary, range))
+            for(mobj_t* mobj = blocklinks[index]; mobj; mobj = mobj->bnext)
                 if(x == (mobj->x + mobj->radius - bmaporgx) >> MAPBLOCKSHIFT && !func(mobj))
                     return false;
     }
@@ -78,6 +78,8 @@ void P_LineOpening(const line_t* line);
 
 bool P_BlockLinesIterator(const int x, const int y, bool func(line_t*));
 bool P_BlockThingsIterator(const int x, const int y, bool func(mobj_t*), bool blockmapfix);
+bool P_BlockThingsIteratorNear(const int x, const int y, bool func(mobj_t*), bool blockmapfix,
+const fixed_t nearx, const fixed_t neary, const fixed_t range);
 
 #define PT_ADDLINES 1
 #define PT_ADDTHINGS 2
@@ -90,5 +92,7 @@ void P_UnsetThingPosition(mobj_t* thing);
 void P_UnsetBloodSplatPosition(bloodsplat_t* splat);
 void P_SetThingPosition(mobj_t* thing);
 void P_SetBloodSplatPosition(bloodsplat_t* splat);
+void P_UpdateBlockThing(const mobj_t* thing);
+void P_ClearBlockCells(const bool freecells);
 
 void P_CheckIntercepts(void);
@@ -52,6 +52,11 @@
 #include "wad/w_wad.h"
 #include "utils/z_zone.h"
 
+zpool_t mobjpool       = ZPOOL("mobjs", mobj_t, PU_LEVEL);
+zpool_t bloodsplatpool = ZPOOL("bloodsplats", bloodsplat_t, PU_LEVEL);
+
+static unsigned int mobjserial;
+
 //
 // P_SetMobjState
 // Returns true if the mobj is still present.
@@ -824,12 +829,24 @@ void P_SetShadowColumnFunction(mobj_t* mobj)
         (r_shadows_translucency ? &R_DrawShadowColumn : &R_DrawSolidShadowColumn);
 }
 
+//
+// P_AllocMobj
+// Allocates a cleared mobj, giving it the next serial number.
+//
+mobj_t* P_AllocMobj(void)
+{
+    mobj_t* mobj = Z_PoolCalloc(&mobjpool);
+
+    mobj->serial = ++mobjserial;
+    return mobj;
+}
+
 //
 // P_SpawnMobj
 //
 mobj_t* P_SpawnMobj(const fixed_t x, const fixed_t y, const fixed_t z, const mobjtype_t type)
 {
-    mobj_t* mobj     = Z_Calloc(1, sizeof(*mobj), PU_LEVEL, NULL);
+    mobj_t* mobj     = P_AllocMobj();
     mobjinfo_t* info = &mobjinfo[type];
     state_t* st      = &states[info->spawnstate];
     sector_t* sector;
@@ -973,8 +990,8 @@ void P_RemoveBloodMobj(mobj_t* mobj)
 void P_RemoveBloodSplats(void)
 {
     for(int i = 0; i < numsectors; i++)
-        for(bloodsplat_t* splat = sectors[i].splatlist; splat; splat = splat->next)
-            P_UnsetBloodSplatPosition(splat);
+        while(sectors[i].splatlist)
+            P_UnsetBloodSplatPosition(sectors[i].splatlist);
 }
 
 //
@@ -1473,7 +1490,7 @@ mobj_t* P_SpawnMapThing(mapthing_t* mthing, const bool spawnmonsters)
 //
 void P_SpawnPuff(const fixed_t x, const fixed_t y, const fixed_t z, const angle_t angle)
 {
-    mobj_t* th       = Z_Calloc(1, sizeof(*th), PU_LEVEL, NULL);
+    mobj_t* th       = P_AllocMobj();
     mobjinfo_t* info = &mobjinfo[MT_PUFF];
     state_t* st      = &states[info->spawnstate];
     sector_t* sector;
@@ -1560,7 +1577,7 @@ void P_SpawnBlood(const fixed_t x, const fixed_t y, const fixed_t z, angle_t ang
 
         for(int i = (damage >> 2) + 1; i > 0; i--)
         {
-            mobj_t* th = Z_Calloc(1, sizeof(*th), PU_LEVEL, NULL);
+            mobj_t* th = P_AllocMobj();
             sector_t* sector;
 
             th->type   = MT_BLOOD;
@@ -1673,7 +1690,7 @@ mobj_t* target)
         (!usemaxheight || sec->interpfloorheight <= maxheight) &&
         (!checklineside || !P_CheckLineSide(target, x, y)))
         {
-            bloodsplat_t* splat = malloc(sizeof(*splat));
+            bloodsplat_t* splat = Z_PoolCalloc(&bloodsplatpool);
 
             if(splat)
             {
@@ -1712,6 +1729,7 @@ bool P_CheckMissileSpawn(mobj_t* th)
     th->x += (th->momx >> 1);
     th->y += (th->momy >> 1);
     th->z += (th->momz >> 1);
+    P_UpdateBlockThing(th);
 
     // killough 08/12/98: for non-missile objects (e.g. grenades)
     if(!(th->flags & MF_MISSILE))
@@ -411,6 +411,10 @@ typedef struct mobj_s
     struct mobj_s* bnext;
     struct mobj_s** bprev; // killough 08/11/98: change to ptr-to-ptr
 
+    // Where this thing's entry is in blockcells, or -1 if it has none
+    int blockcell;
+    int blockslot;
+
     struct subsector_s* subsector;
 
     // The closest interval over all contacted Sectors.
@@ -470,9 +474,9 @@ typedef struct mobj_s
     // For bobbing up and down.
     int floatbob;
 
-    void (*colfunc)(void);
-    void (*altcolfunc)(void);
-    void (*shadowcolfunc)(void);
+    void (*colfunc)(rendercontext_t* rc);
+    void (*altcolfunc)(rendercontext_t* rc);
+    void (*shadowcolfunc)(rendercontext_t* rc);
 
     int shadowoffset;
 
@@ -501,6 +505,10 @@ typedef struct mobj_s
     int id;
     int musicid;
 
+    // Different for every mobj allocated, unlike its address, which is
+    // reused once it's freed
+    unsigned int serial;
+
     char name[33];
 
     bool madesound;
@@ -520,7 +528,7 @@ typedef struct bloodsplat_s
     struct sector_s* sector;
     int color;
     int viscolor;
-    void (*viscolfunc)(void);
+    void (*viscolfunc)(rendercontext_t* rc);
 } bloodsplat_t;
 
 extern int prevnumframes;
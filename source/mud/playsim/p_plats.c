@@ -42,6 +42,8 @@
 
 platlist_t* activeplats; // killough 02/14/98: made global again
 
+zpool_t platpool = ZPOOL("plats", plat_t, PU_LEVSPEC);
+
 void T_PlatStay(plat_t* plat)
 {
 }
@@ -200,7 +202,7 @@ bool EV_DoPlat(line_t* line, plattype_e type, int amount)
 
         // Find lowest and highest floors around sector
         rtn  = true;
-        plat = Z_Calloc(1, sizeof(*plat), PU_LEVSPEC, NULL);
+        plat = Z_PoolCalloc(&platpool);
 
         plat->thinker.function = &T_PlatRaise;
         P_AddThinker(&plat->thinker);
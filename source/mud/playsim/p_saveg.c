@@ -51,7 +51,9 @@
 #include "hud/st_stuff.h"
 #include "system/i_version.h"
 #include "wad/w_wad.h"
+#include "utils/m_lz.h"
 #include "utils/z_zone.h"
+#include "thread.h"
 // clang-format off
 #include "playsim/p_saveg.h"
 // clang-format on
@@ -59,7 +61,26 @@
 #define SAVEGAME_EOF 0x1D
 #define TARGETLIMIT 4192
 
-fs_file* save_stream = NULL;
+#define SAVEHEADERSIZE  (SAVESTRINGSIZE + VERSIONSIZE + 7)
+#define SAVECHUNKSIZE   65536
+
+// The savegame being written or read, all of it in memory
+static byte* savebuffer;
+static size_t savebuffersize;
+static size_t savelength;
+static size_t saveposition;
+
+// A savegame handed to savethread to be compressed and written
+typedef struct
+{
+    byte*       buffer;
+    size_t      length;
+    fs_file*    file;
+    char*       filename;
+    char*       tempfilename;
+} pendingsave_t;
+
+static thread_ptr_t savethread;
 
 static char savegameversion[VERSIONSIZE];
 
@@ -98,61 +119,277 @@ char* P_SaveGameFile(int slot)
     return filename;
 }
 
+// Makes room for size more bytes to be written to savebuffer
+static byte* saveg_reserve(const size_t size)
+{
+    byte* p;
+
+    if(savelength + size > savebuffersize)
+    {
+        while(savelength + size > savebuffersize)
+            savebuffersize = (savebuffersize ? savebuffersize * 2 : SAVECHUNKSIZE);
+
+        savebuffer = I_Realloc(savebuffer, savebuffersize);
+    }
+
+    p = savebuffer + savelength;
+    savelength += size;
+    return p;
+}
+
+//
+// P_OpenSaveGame
+// Reads a savegame into memory, decompressing it if need be, so it can be
+// unarchived. Returns false if it can't be opened or is corrupt.
+//
+bool P_OpenSaveGame(const char* filename)
+{
+    fs_file* file;
+    size_t length;
+
+    P_FinishSaveGame();
+
+    if(!(file = FS_OpenFile(filename, FS_READ, FS_TRUE)))
+        return false;
+
+    savelength   = 0;
+    saveposition = 0;
+
+    do
+    {
+        length = FS_Read(saveg_reserve(SAVECHUNKSIZE), 1, SAVECHUNKSIZE, file);
+        savelength -= SAVECHUNKSIZE - length;
+    } while(length == SAVECHUNKSIZE);
+
+    FS_CloseFile(file);
+
+    // Everything after the header may have been compressed by P_WriteSaveGame()
+    if(savelength >= SAVEHEADERSIZE + 4
+        && !strncmp((char*)savebuffer + SAVESTRINGSIZE, DOOMRETRO_SAVEGAMEVERSION_LZ, VERSIONSIZE))
+    {
+        const byte* p           = savebuffer + SAVEHEADERSIZE;
+        const size_t bodylength = (p[0] | (p[1] << 8) | (p[2] << 16) | ((size_t)p[3] << 24));
+        byte* buffer            = malloc(SAVEHEADERSIZE + bodylength);
+
+        if(!buffer || !M_LZDecompress(p + 4, savelength - SAVEHEADERSIZE - 4,
+            buffer + SAVEHEADERSIZE, bodylength))
+        {
+            free(buffer);
+            P_CloseSaveGame();
+            return false;
+        }
+
+        // Give the header back the version of the savegame that was compressed,
+        // which is what the rest of it is checked against as it's unarchived
+        memcpy(buffer, savebuffer, SAVEHEADERSIZE);
+        memset(buffer + SAVESTRINGSIZE, 0, VERSIONSIZE);
+        strcpy((char*)buffer + SAVESTRINGSIZE, DOOMRETRO_SAVEGAMEVERSIONSTRING);
+        free(savebuffer);
+        savebuffer     = buffer;
+        savebuffersize = SAVEHEADERSIZE + bodylength;
+        savelength     = savebuffersize;
+    }
+
+    return true;
+}
+
+//
+// P_CloseSaveGame
+//
+void P_CloseSaveGame(void)
+{
+    free(savebuffer);
+    savebuffer     = NULL;
+    savebuffersize = 0;
+    savelength     = 0;
+    saveposition   = 0;
+}
+
+//
+// P_CreateSaveGame
+// Starts a new savegame in memory, for P_WriteSaveGame() to write out once
+// everything has been archived.
+//
+void P_CreateSaveGame(void)
+{
+    savelength   = 0;
+    saveposition = 0;
+}
+
+//
+// P_SaveGameThreadProc
+// Compresses everything after the header of a savegame, unless that
+// doesn't make it any smaller, writes it to a temporary file and then
+// renames that to the real file, backing up the old savegame if there was
+// one there.
+//
+static int P_SaveGameThreadProc(void* data)
+{
+    pendingsave_t* save     = data;
+    const size_t bodylength = save->length - SAVEHEADERSIZE;
+    byte* compressed        = malloc(SAVEHEADERSIZE + 4 + M_LZBound(bodylength));
+    unsigned int* table     = malloc(LZHASHTABLESIZE * sizeof(*table));
+    char* backupfilename    = M_StringJoin(save->filename, ".bak", NULL);
+    size_t length;
+
+    if(compressed && table && (length = M_LZCompress(save->buffer + SAVEHEADERSIZE, bodylength,
+        compressed + SAVEHEADERSIZE + 4, table)) + 4 < bodylength)
+    {
+        byte* p = compressed + SAVEHEADERSIZE;
+
+        memcpy(compressed, save->buffer, SAVEHEADERSIZE);
+        memset(compressed + SAVESTRINGSIZE, 0, VERSIONSIZE);
+        strcpy((char*)compressed + SAVESTRINGSIZE, DOOMRETRO_SAVEGAMEVERSION_LZ);
+
+        p[0] = bodylength & 0xFF;
+        p[1] = (bodylength >> 8) & 0xFF;
+        p[2] = (bodylength >> 16) & 0xFF;
+        p[3] = (bodylength >> 24) & 0xFF;
+
+        FS_Write(compressed, 1, SAVEHEADERSIZE + 4 + length, save->file);
+    }
+    else
+        FS_Write(save->buffer, 1, save->length, save->file);
+
+    FS_CloseFile(save->file);
+
+    remove(backupfilename);
+    rename(save->filename, backupfilename);
+    rename(save->tempfilename, save->filename);
+
+    free(backupfilename);
+    free(table);
+    free(compressed);
+    free(save->buffer);
+    free(save->filename);
+    free(save->tempfilename);
+    free(save);
+
+    return 0;
+}
+
+//
+// P_WriteSaveGame
+// Hands the savegame built since P_CreateSaveGame() over to be written to
+// filename in the background. Returns false if it can't be written.
+//
+bool P_WriteSaveGame(const char* filename, const char* tempfilename)
+{
+    pendingsave_t* save;
+    fs_file* file;
+
+    // Only one savegame is written at a time
+    P_FinishSaveGame();
+
+    // Write to a temporary file and then rename it at the end if it was
+    // successfully written. This prevents an existing savegame from being
+    // overwritten by a corrupted one.
+    if(!(file = FS_OpenFile(tempfilename, FS_WRITE, FS_TRUE)))
+        return false;
+
+    save               = I_Malloc(sizeof(*save));
+    save->buffer       = savebuffer;
+    save->length       = savelength;
+    save->file         = file;
+    save->filename     = M_StringDuplicate(filename);
+    save->tempfilename = M_StringDuplicate(tempfilename);
+
+    savebuffer     = NULL;
+    savebuffersize = 0;
+    savelength     = 0;
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    P_SaveGameThreadProc(save);
+#else
+    if(!(savethread = thread_create(&P_SaveGameThreadProc, save, THREAD_STACK_SIZE_DEFAULT)))
+        P_SaveGameThreadProc(save);
+#endif
+
+    return true;
+}
+
+//
+// P_FinishSaveGame
+// Waits for a savegame being written in the background, if there is one.
+//
+void P_FinishSaveGame(void)
+{
+    if(savethread)
+    {
+        thread_join(savethread);
+        thread_destroy(savethread);
+        savethread = NULL;
+    }
+}
+
 // Endian-safe integer read/write functions
 static byte saveg_read8(void)
 {
-    byte result;
-
-    if(FS_Read(&result, 1, 1, save_stream) < 1)
+    if(saveposition >= savelength)
         return 0;
 
-    return result;
+    return savebuffer[saveposition++];
 }
 
 static void saveg_write8(byte value)
 {
-    FS_Write(&value, 1, 1, save_stream);
+    *saveg_reserve(1) = value;
 }
 
 static short saveg_read16(void)
 {
-    short result = saveg_read8();
+    const byte* p = savebuffer + saveposition;
 
-    return (result | (saveg_read8() << 8));
+    if(savelength - saveposition < 2)
+    {
+        short result = saveg_read8();
+
+        return (result | (saveg_read8() << 8));
+    }
+
+    saveposition += 2;
+    return (short)(p[0] | (p[1] << 8));
 }
 
 static void saveg_write16(short value)
 {
-    saveg_write8(value & 0xFF);
-    saveg_write8((value >> 8) & 0xFF);
+    byte* p = saveg_reserve(2);
+
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
 }
 
 static int saveg_read32(void)
 {
-    int result = saveg_read8();
+    const byte* p = savebuffer + saveposition;
 
-    result |= (saveg_read8() << 8);
-    result |= (saveg_read8() << 16);
+    if(savelength - saveposition < 4)
+    {
+        int result = saveg_read8();
+
+        result |= (saveg_read8() << 8);
+        result |= (saveg_read8() << 16);
 
-    return (result | (saveg_read8() << 24));
+        return (result | (saveg_read8() << 24));
+    }
+
+    saveposition += 4;
+    return (int)(p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24));
 }
 
 static void saveg_write32(int value)
 {
-    saveg_write8(value & 0xFF);
-    saveg_write8((value >> 8) & 0xFF);
-    saveg_write8((value >> 16) & 0xFF);
-    saveg_write8((value >> 24) & 0xFF);
+    byte* p = saveg_reserve(4);
+
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    p[2] = (value >> 16) & 0xFF;
+    p[3] = (value >> 24) & 0xFF;
 }
 
 static void saveg_writedouble(double value)
 {
-    unsigned char buf[8];
-
-    memcpy(buf, &value, 8);
-
-    for(int i = 0; i < 8; i++)
-        saveg_write8(buf[i]);
+    memcpy(saveg_reserve(8), &value, 8);
 }
 
 static double saveg_readdouble(void)
@@ -1326,6 +1563,8 @@ void P_UnarchiveWorld(void)
             }
         }
     }
+
+    P_ClearSightCache();
 }
 
 //
@@ -1409,7 +1648,7 @@ void P_UnarchiveThinkers(void)
         {
         case tc_mobj:
         {
-            mobj_t* mobj = Z_Calloc(1, sizeof(*mobj), PU_LEVEL, NULL);
+            mobj_t* mobj = P_AllocMobj();
 
             saveg_read_mobj_t(mobj);
 
@@ -1436,7 +1675,7 @@ void P_UnarchiveThinkers(void)
 
         case tc_bloodsplat:
         {
-            bloodsplat_t* splat = malloc(sizeof(*splat));
+            bloodsplat_t* splat = Z_PoolCalloc(&bloodsplatpool);
 
             if(splat)
             {
@@ -1614,7 +1853,7 @@ void P_UnarchiveSpecials(void)
         {
         case tc_ceiling:
         {
-            ceiling_t* ceiling = Z_Calloc(1, sizeof(*ceiling), PU_LEVSPEC, NULL);
+            ceiling_t* ceiling = Z_PoolCalloc(&ceilingpool);
 
             saveg_read_ceiling_t(ceiling);
             ceiling->sector->ceilingdata = ceiling;
@@ -1626,7 +1865,7 @@ void P_UnarchiveSpecials(void)
 
         case tc_door:
         {
-            vldoor_t* door = Z_Calloc(1, sizeof(*door), PU_LEVSPEC, NULL);
+            vldoor_t* door = Z_PoolCalloc(&doorpool);
 
             saveg_read_vldoor_t(door);
             door->sector->ceilingdata = door;
@@ -1637,7 +1876,7 @@ void P_UnarchiveSpecials(void)
 
         case tc_floor:
         {
-            floormove_t* floor = Z_Calloc(1, sizeof(*floor), PU_LEVSPEC, NULL);
+            floormove_t* floor = Z_PoolCalloc(&floorpool);
 
             saveg_read_floormove_t(floor);
             floor->sector->floordata = floor;
@@ -1648,7 +1887,7 @@ void P_UnarchiveSpecials(void)
 
         case tc_plat:
         {
-            plat_t* plat = Z_Calloc(1, sizeof(*plat), PU_LEVSPEC, NULL);
+            plat_t* plat = Z_PoolCalloc(&platpool);
 
             saveg_read_plat_t(plat);
             plat->sector->floordata = plat;
@@ -1659,7 +1898,7 @@ void P_UnarchiveSpecials(void)
 
         case tc_flash:
         {
-            lightflash_t* flash = Z_Calloc(1, sizeof(*flash), PU_LEVSPEC, NULL);
+            lightflash_t* flash = Z_PoolCalloc(&lightflashpool);
 
             saveg_read_lightflash_t(flash);
             flash->thinker.function = &T_LightFlash;
@@ -1670,7 +1909,7 @@ void P_UnarchiveSpecials(void)
 
         case tc_strobe:
         {
-            strobe_t* strobe = Z_Calloc(1, sizeof(*strobe), PU_LEVSPEC, NULL);
+            strobe_t* strobe = Z_PoolCalloc(&strobepool);
 
             saveg_read_strobe_t(strobe);
             strobe->thinker.function = &T_StrobeFlash;
@@ -1681,7 +1920,7 @@ void P_UnarchiveSpecials(void)
 
         case tc_glow:
         {
-            glow_t* glow = Z_Calloc(1, sizeof(*glow), PU_LEVSPEC, NULL);
+            glow_t* glow = Z_PoolCalloc(&glowpool);
 
             saveg_read_glow_t(glow);
             glow->thinker.function = &T_Glow;
@@ -1692,7 +1931,7 @@ void P_UnarchiveSpecials(void)
 
         case tc_fireflicker:
         {
-            fireflicker_t* flick = Z_Calloc(1, sizeof(*flick), PU_LEVSPEC, NULL);
+            fireflicker_t* flick = Z_PoolCalloc(&fireflickerpool);
 
             saveg_read_fireflicker_t(flick);
             flick->thinker.function = &T_FireFlicker;
@@ -1703,7 +1942,7 @@ void P_UnarchiveSpecials(void)
 
         case tc_elevator:
         {
-            elevator_t* elevator = Z_Calloc(1, sizeof(*elevator), PU_LEVSPEC, NULL);
+            elevator_t* elevator = Z_PoolCalloc(&elevatorpool);
 
             saveg_read_elevator_t(elevator);
             elevator->sector->ceilingdata = elevator;
@@ -1809,3 +2048,124 @@ void P_UnarchiveMap(void)
         }
     }
 }
+
+//
+// P_ArchiveSnapshot
+// Writes the player, world, thinkers and specials of the current map the
+// same way a savegame does, to *buffer, growing it and *size as needed, and
+// returns how many bytes were written.
+//
+size_t P_ArchiveSnapshot(byte** buffer, size_t* size)
+{
+    byte* oldbuffer         = savebuffer;
+    const size_t oldsize    = savebuffersize;
+    const size_t oldlength  = savelength;
+    size_t length;
+
+    savebuffer     = *buffer;
+    savebuffersize = *size;
+    savelength     = 0;
+
+    saveg_write32(game.stats.maptime);
+    saveg_write32(seed);
+    saveg_write32(bigseed);
+
+    P_ArchivePlayer();
+    P_ArchiveWorld();
+    P_ArchiveThinkers();
+    P_ArchiveSpecials();
+
+    *buffer = savebuffer;
+    *size   = savebuffersize;
+    length  = savelength;
+
+    savebuffer     = oldbuffer;
+    savebuffersize = oldsize;
+    savelength     = oldlength;
+
+    return length;
+}
+
+//
+// P_RemoveAllThinkers
+// Frees every thinker, blood splat and special of the current map, without
+// the side effects of removing them one at a time.
+//
+static void P_RemoveAllThinkers(void)
+{
+    thinker_t* th = thinkers[th_all].next;
+
+    S_StopSounds();
+    P_RemoveBloodSplats();
+
+    while(th != &thinkers[th_all])
+    {
+        thinker_t* next = th->next;
+
+        if(th->function == &P_MobjThinker || th->function == &MusInfoThinker)
+        {
+            P_UnsetThingPosition((mobj_t*)th);
+
+            if(sector_list)
+            {
+                P_DelSeclist(sector_list);
+                sector_list = NULL;
+            }
+        }
+
+        Z_Free(th);
+        th = next;
+    }
+
+    P_InitThinkers();
+
+    for(int i = 0; i < numsectors; i++)
+    {
+        sectors[i].floordata   = NULL;
+        sectors[i].ceilingdata = NULL;
+    }
+
+    P_RemoveAllActiveCeilings();
+    P_RemoveAllActivePlats();
+
+    for(int i = 0; i < maxbuttons; i++)
+        memset(&buttonlist[i], 0, sizeof(button_t));
+}
+
+//
+// P_UnarchiveSnapshot
+// Puts the current map back the way it was when P_ArchiveSnapshot() wrote
+// buffer, without loading the map again.
+//
+void P_UnarchiveSnapshot(byte* buffer, const size_t length)
+{
+    byte* oldbuffer         = savebuffer;
+    const size_t oldsize    = savebuffersize;
+    const size_t oldlength  = savelength;
+
+    savebuffer     = buffer;
+    savebuffersize = length;
+    savelength     = length;
+    saveposition   = 0;
+
+    memset(savegameversion, 0, sizeof(savegameversion));
+    strcpy(savegameversion, DOOMRETRO_SAVEGAMEVERSIONSTRING);
+
+    P_RemoveAllThinkers();
+
+    game.stats.maptime = saveg_read32();
+    seed               = saveg_read32();
+    bigseed            = saveg_read32();
+
+    P_UnarchivePlayer();
+    P_UnarchiveWorld();
+    P_UnarchiveThinkers();
+    P_UnarchiveSpecials();
+    P_RestoreTargets();
+    P_MapEnd();
+
+    savebuffer     = oldbuffer;
+    savebuffersize = oldsize;
+    savelength     = oldlength;
+    saveposition   = 0;
+}
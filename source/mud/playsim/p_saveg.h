@@ -73,6 +73,13 @@ char* P_TempSaveGameFile(void);
 // filename to use for a savegame slot
 char* P_SaveGameFile(int slot);
 
+// Savegames are read and written in memory
+bool P_OpenSaveGame(const char* filename);
+void P_CloseSaveGame(void);
+void P_CreateSaveGame(void);
+bool P_WriteSaveGame(const char* filename, const char* tempfilename);
+void P_FinishSaveGame(void);
+
 // Savegame file header read/write functions
 bool P_ReadSaveGameHeader(char* description);
 void P_WriteSaveGameHeader(const char* description);
@@ -100,4 +107,6 @@ void P_UnarchiveMap(void);
 
 void P_RestoreTargets(void);
 
-extern fs_file* save_stream;
+// Snapshots of the current map, for rewinding
+size_t P_ArchiveSnapshot(byte** buffer, size_t* size);
+void P_UnarchiveSnapshot(byte* buffer, const size_t length);
@@ -41,6 +41,7 @@
 #include "console/c_console.h"
 #include "doom/d_deh.h"
 #include "doom/doomstat.h"
+#include "game/g_demo.h"
 #include "math/math_swap.h"
 #include "system/i_system.h"
 #include "utils/m_argv.h"
@@ -223,6 +224,7 @@ fixed_t bmaporgy;
 
 // for thing chains
 mobj_t** blocklinks;
+blockcell_t* blockcells;
 
 // MAES: extensions to support 512x512 blockmaps.
 // They represent the maximum negative number which represents
@@ -1837,8 +1839,8 @@ static void P_LoadThings(int map, int lump)
         }
     }
 
-    M_Seed((unsigned int)time(NULL));
-    M_BigSeed((unsigned int)time(NULL));
+    M_Seed(G_DemoSeed());
+    M_BigSeed(G_DemoSeed());
     M_Fuzz1Seed((unsigned int)time(NULL));
     M_Fuzz2Seed((unsigned int)time(NULL));
     W_ReleaseLumpNum(lump);
@@ -2487,7 +2489,8 @@ static void P_LoadBlockMap(int lump)
     // Clear out mobj chains
     blocklinks = calloc_IfSameLevel(
     blocklinks, (size_t)bmapwidth * bmapheight, sizeof(*blocklinks));
-    blockmap = blockmaplump + 4;
+    blockcells = calloc((size_t)bmapwidth * bmapheight, sizeof(*blockcells));
+    blockmap   = blockmaplump + 4;
 
     // MAES: set blockmapxneg and blockmapyneg
     // E.g. for a full 512x512 map, they should be both
@@ -2520,6 +2523,96 @@ static void RejectOverrun(int lump, const byte** matrix)
     }
 }
 
+static int P_FindRejectGroup(int* groups, int i)
+{
+    while(groups[i] != i)
+        i = groups[i] = groups[groups[i]];
+
+    return i;
+}
+
+static void P_JoinRejectGroups(int* groups, const sector_t* sector1, const sector_t* sector2)
+{
+    const int group1 = P_FindRejectGroup(groups, sector1->id);
+    const int group2 = P_FindRejectGroup(groups, sector2->id);
+
+    if(group1 != group2)
+        groups[MAX(group1, group2)] = MIN(group1, group2);
+}
+
+//
+// P_BuildReject
+// Many PWADs ship an empty or all-zero REJECT lump, which leaves every
+// P_CheckSight call to trace the BSP. Sight can't pass through a one-sided
+// line, so any two sectors not joined by a chain of two-sided lines can never
+// see each other, and are marked as such here.
+//
+static void P_BuildReject(int lump, const byte** matrix)
+{
+    const size_t required = ((size_t)numsectors * numsectors + 7) / 8;
+    int* groups;
+    byte* newreject;
+    bool joined = true;
+
+    for(size_t i = 0; i < required; i++)
+        if((*matrix)[i])
+            return;
+
+    groups = I_Malloc(numsectors * sizeof(*groups));
+
+    for(int i = 0; i < numsectors; i++)
+        groups[i] = i;
+
+    for(int i = 0; i < numlines; i++)
+        if(lines[i].frontsector && lines[i].backsector)
+            P_JoinRejectGroups(groups, lines[i].frontsector, lines[i].backsector);
+
+    // Also join the sectors of every seg in a subsector, in case the nodes
+    // don't agree with the lines about where one sector ends
+    for(int i = 0; i < numsubsectors; i++)
+    {
+        const sector_t* sector = subsectors[i].sector;
+        const seg_t* seg       = segs + subsectors[i].firstline;
+
+        if(!sector)
+            continue;
+
+        for(int j = 0; j < subsectors[i].numlines; j++, seg++)
+        {
+            if(seg->frontsector)
+                P_JoinRejectGroups(groups, sector, seg->frontsector);
+
+            if(seg->backsector)
+                P_JoinRejectGroups(groups, sector, seg->backsector);
+        }
+    }
+
+    for(int i = 0; i < numsectors; i++)
+        if((groups[i] = P_FindRejectGroup(groups, i)))
+            joined = false;
+
+    if(joined)
+    {
+        free(groups);
+        return;
+    }
+
+    newreject = Z_Calloc(1, required, PU_LEVEL, NULL);
+
+    for(int i = 0; i < numsectors; i++)
+    {
+        const size_t row = (size_t)i * numsectors;
+
+        for(int j = 0; j < numsectors; j++)
+            if(groups[i] != groups[j])
+                newreject[(row + j) >> 3] |= (1 << ((row + j) & 7));
+    }
+
+    free(groups);
+    W_ReleaseLumpNum(lump);
+    *matrix = newreject;
+}
+
 //
 // P_LoadReject - load the reject table
 //
@@ -2534,6 +2627,9 @@ static void P_LoadReject(int lumpnum)
 
     // e6y: check for overflow
     RejectOverrun(rejectlump, &rejectmatrix);
+
+    P_BuildReject(rejectlump, &rejectmatrix);
+    P_ClearSightCache();
 }
 
 //
@@ -2562,6 +2658,8 @@ static void P_GroupLines(void)
     int i;
     int total = numlines;
     line_t** linebuffer;
+    soundlink_t* linkbuffer;
+    int totallinks = 0;
 
     // figgi
     for(i = 0; i < numsubsectors; i++)
@@ -2617,6 +2715,34 @@ static void P_GroupLines(void)
             P_AddLineToSector(li, li->backsector);
     }
 
+    // Link each sector to its neighbors through two-sided lines, in the same
+    // order as its lines, so P_NoiseAlert doesn't need to look up sidedefs
+    for(i = 0, sector = sectors; i < numsectors; i++, sector++)
+        for(int j = 0; j < sector->linecount; j++)
+            if(sector->lines[j]->sidenum[1] != NO_INDEX)
+                totallinks++;
+
+    linkbuffer = Z_Malloc(MAX(1, totallinks) * sizeof(*linkbuffer), PU_LEVEL, NULL);
+
+    for(i = 0, sector = sectors; i < numsectors; i++, sector++)
+    {
+        sector->soundlinks     = linkbuffer;
+        sector->soundlinkcount = 0;
+
+        for(int j = 0; j < sector->linecount; j++)
+        {
+            line_t* line = sector->lines[j];
+
+            if(line->sidenum[1] != NO_INDEX)
+            {
+                linkbuffer->line   = line;
+                linkbuffer->sector = sides[line->sidenum[(sides[line->sidenum[0]].sector == sector)]].sector;
+                linkbuffer++;
+                sector->soundlinkcount++;
+            }
+        }
+    }
+
     for(i = 0, sector = sectors; i < numsectors; i++, sector++)
     {
         const fixed_t* bbox = (void*)sector->blockbox;
@@ -3163,6 +3289,7 @@ void P_SetupLevel(int ep, int map)
             free(nodes);
             free(subsectors);
         }
+        P_ClearBlockCells(true);
         free(blocklinks);
         free(blockmaplump);
         free(lines);
@@ -3241,7 +3368,10 @@ void P_SetupLevel(int ep, int map)
     if(!samelevel)
         P_LoadBlockMap(lumpnum + ML_BLOCKMAP);
     else
+    {
         memset(blocklinks, 0, (size_t)bmapwidth * bmapheight * sizeof(*blocklinks));
+        P_ClearBlockCells(false);
+    }
 
     if (!samelevel) // node format should have already been determined otherwise
     {
@@ -3317,8 +3447,9 @@ void P_SetupLevel(int ep, int map)
 
     P_MapEnd();
 
-    // preload graphics
+    // preload graphics and sounds
     R_PrecacheLevel();
+    S_PrecacheSounds();
 
     if(!musinfo.fromsavegame)
         S_Start();
@@ -56,6 +56,37 @@ typedef struct
 
 static los_t los; // cph - made static
 
+// Results of recent BSP traversals, keyed by looker and target. An entry is
+// only reused while both are where they were and no floor or ceiling has
+// moved since, so a hit gives the same answer the traversal would. Their
+// serial numbers are checked as well as their addresses, which are reused
+// once they're freed.
+#define SIGHTCACHESIZE  1024
+
+typedef struct
+{
+    const mobj_t*   t1;
+    const mobj_t*   t2;
+    unsigned int    serial1;
+    unsigned int    serial2;
+    fixed_t         x1, y1, z1, height1;
+    fixed_t         x2, y2, z2, height2;
+    unsigned int    epoch;
+    bool            result;
+} sightcache_t;
+
+static sightcache_t sightcache[SIGHTCACHESIZE];
+static unsigned int sightcacheepoch = 1;
+
+//
+// P_ClearSightCache
+// Called whenever sector heights change, invalidating every cached result.
+//
+void P_ClearSightCache(void)
+{
+    sightcacheepoch++;
+}
+
 //
 // P_DivlineSide
 // Returns side 0 (front), 1 (back), or 2 (on).
@@ -212,6 +243,7 @@ bool P_CheckSight(mobj_t* t1, mobj_t* t2)
     const sector_t* s1 = t1->subsector->sector;
     const sector_t* s2 = t2->subsector->sector;
     const int pnum     = s1->id * numsectors + s2->id;
+    sightcache_t* cache;
 
     // First check for trivial rejection.
     // Determine subsector entries in REJECT table.
@@ -237,6 +269,15 @@ bool P_CheckSight(mobj_t* t1, mobj_t* t2)
     if(t1->subsector == t2->subsector)
         return true;
 
+    cache = &sightcache[(((uintptr_t)t1 >> 6) * 31 + ((uintptr_t)t2 >> 6)) & (SIGHTCACHESIZE - 1)];
+
+    if(cache->epoch == sightcacheepoch && cache->t1 == t1 && cache->t2 == t2 &&
+    cache->serial1 == t1->serial && cache->serial2 == t2->serial &&
+    cache->x1 == t1->x && cache->y1 == t1->y && cache->z1 == t1->z &&
+    cache->height1 == t1->height && cache->x2 == t2->x && cache->y2 == t2->y &&
+    cache->z2 == t2->z && cache->height2 == t2->height)
+        return cache->result;
+
     // An unobstructed LOS is possible.
     // Now look from eyes of t1 to any part of t2.
     validcount++;
@@ -275,7 +316,21 @@ bool P_CheckSight(mobj_t* t1, mobj_t* t2)
     }
 
     // the head node is the last node output
-    return P_CrossBSPNode(numnodes - 1);
+    cache->t1      = t1;
+    cache->t2      = t2;
+    cache->serial1 = t1->serial;
+    cache->serial2 = t2->serial;
+    cache->x1      = t1->x;
+    cache->y1      = t1->y;
+    cache->z1      = t1->z;
+    cache->height1 = t1->height;
+    cache->x2      = t2->x;
+    cache->y2      = t2->y;
+    cache->z2      = t2->z;
+    cache->height2 = t2->height;
+    cache->epoch   = sightcacheepoch;
+
+    return (cache->result = P_CrossBSPNode(numnodes - 1));
 }
 
 //
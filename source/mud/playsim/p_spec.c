@@ -2808,7 +2808,7 @@ bool EV_DoDonut(const line_t* line)
             rtn = true;
 
             // Spawn rising slime
-            floor = Z_Calloc(1, sizeof(*floor), PU_LEVSPEC, NULL);
+            floor = Z_PoolCalloc(&floorpool);
 
             floor->thinker.function = &T_MoveFloor;
             P_AddThinker(&floor->thinker);
@@ -2823,7 +2823,7 @@ bool EV_DoDonut(const line_t* line)
             floor->stopsound = (s2->floorheight != floor->floordestheight);
 
             // Spawn lowering donut-hole
-            floor = Z_Calloc(1, sizeof(*floor), PU_LEVSPEC, NULL);
+            floor = Z_PoolCalloc(&floorpool);
 
             floor->thinker.function = &T_MoveFloor;
             P_AddThinker(&floor->thinker);
@@ -3252,9 +3252,13 @@ void T_Scroll(scroll_t* scroller)
         dy <<= 3;
 
         // [BH] scroll any blood splats as well
-        for(bloodsplat_t* splat = sec->splatlist; splat; splat = splat->next)
+        for(bloodsplat_t* splat = sec->splatlist, *next; splat; splat = next)
+        {
+            next = splat->next;
+
             if(sec != R_PointInSubsector((splat->x += dx), (splat->y += dy))->sector)
                 P_UnsetBloodSplatPosition(splat);
+        }
 
         break;
     }
@@ -35,6 +35,8 @@
 
 #pragma once
 
+#include "utils/z_zone.h"
+
 // jff 02/23/98 identify the special classes that can share sectors
 typedef enum
 {
@@ -194,6 +196,11 @@ void P_SpawnGlowingLight(sector_t* sector);
 
 void T_FireFlicker(fireflicker_t* flick);
 
+extern zpool_t fireflickerpool;
+extern zpool_t lightflashpool;
+extern zpool_t strobepool;
+extern zpool_t glowpool;
+
 //
 // P_SWITCH.C
 //
@@ -298,6 +305,8 @@ typedef struct platlist_s
     struct platlist_s** prev;
 } platlist_t;
 
+extern zpool_t platpool;
+
 #define PLATWAIT 3
 #define PLATSPEED FRACUNIT
 
@@ -367,6 +376,8 @@ typedef struct
 #define VDOORSPEED (2 * FRACUNIT)
 #define VDOORWAIT 150
 
+extern zpool_t doorpool;
+
 void EV_VerticalDoor(line_t* line, mobj_t* thing);
 
 bool EV_DoDoor(line_t* line, vldoor_e type, fixed_t speed);
@@ -438,6 +449,8 @@ typedef struct ceilinglist_s
 
 extern ceilinglist_t* activeceilings;
 
+extern zpool_t ceilingpool;
+
 bool EV_DoCeiling(const line_t* line, ceiling_e type);
 
 void T_CeilingStay(ceiling_t* ceiling);
@@ -543,6 +556,9 @@ typedef struct
 #define ELEVATORSPEED (4 * FRACUNIT)
 #define FLOORSPEED FRACUNIT
 
+extern zpool_t floorpool;
+extern zpool_t elevatorpool;
+
 typedef enum
 {
     ok,
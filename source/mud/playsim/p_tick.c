@@ -33,8 +33,10 @@
 ==============================================================================
 */
 
+#include "console/c_cmds.h"
 #include "console/c_console.h"
 #include "doom/doomstat.h"
+#include "game/g_demo.h"
 #include "system/i_config.h"
 #include "menu/m_menu.h"
 #include "playsim/p_local.h"
@@ -186,6 +188,45 @@ void P_SetTarget(mobj_t** mop, mobj_t* targ)
         targ->thinker.references++;
 }
 
+//
+// P_RunThinkers
+// Monsters that are asleep, as decided by P_MobjIsAsleep(), only have their
+// tics counted down by P_MobjSleep() instead of running their thinker when
+// dormancy is on.
+//
+static void P_RunThinkers(void)
+{
+    const sector_t* playersector = viewplayer->mo->subsector->sector;
+    const bool      sleep        = (dormancy && !vanilla);
+
+    dormancy_asleep = 0;
+    dormancy_awake  = 0;
+
+    for(currentthinker                                  = thinkers[th_all].next;
+    currentthinker != &thinkers[th_all]; currentthinker = currentthinker->next)
+    {
+        if(currentthinker->function == &P_MobjThinker)
+        {
+            mobj_t* mo = (mobj_t*)currentthinker;
+
+            if(sentient(mo))
+            {
+                if(sleep && P_MobjIsAsleep(mo, playersector))
+                {
+                    P_MobjSleep(mo);
+                    dormancy_asleep++;
+                    continue;
+                }
+
+                dormancy_awake++;
+            }
+        }
+
+        if(currentthinker->function)
+            currentthinker->function((mobj_t*)currentthinker);
+    }
+}
+
 //
 // P_Ticker
 //
@@ -196,10 +237,11 @@ void P_Ticker(void)
 
     P_PlayerThink();
 
-    if(consoleactive || helpscreen)
+    // The console and menu don't pause a demo, as they can't be played back
+    if((consoleactive || helpscreen) && !demorecording && !demoplayback)
         return;
 
-    if(menuactive && !freeze)
+    if(menuactive && !freeze && !demorecording && !demoplayback)
     {
         if(!(game.time & 2))
         {
@@ -225,10 +267,7 @@ void P_Ticker(void)
         return;
     }
 
-    for(currentthinker                                  = thinkers[th_all].next;
-    currentthinker != &thinkers[th_all]; currentthinker = currentthinker->next)
-        if(currentthinker->function)
-            currentthinker->function((mobj_t*)currentthinker);
+    P_RunThinkers();
 
     P_UpdateSpecials();
     T_MAPMusic();
@@ -36,19 +36,23 @@
 #include "doom/doomstat.h"
 #include "math/math_bbox.h"
 #include "system/i_config.h"
+#include "system/i_perfstats.h"
 #include "system/i_system.h"
+#include "system/i_timer.h"
 #include "render/r_plane.h"
 #include "mud_profiling.h"
 #include "render/r_segs.h"
 #include "render/r_things.h"
+#include "render/r_threads.h"
 
-seg_t* curline;
-line_t* linedef;
-sector_t* frontsector;
-sector_t* backsector;
+THREADLOCAL seg_t* curline;
+THREADLOCAL line_t* linedef;
+THREADLOCAL int lineflags;
+THREADLOCAL sector_t* frontsector;
+THREADLOCAL sector_t* backsector;
 
-drawseg_t* drawsegs;
-drawseg_t* ds_p;
+THREADLOCAL drawseg_t* drawsegs;
+THREADLOCAL drawseg_t* ds_p;
 
 //
 // R_ClearDrawSegs
@@ -61,14 +65,15 @@ void R_ClearDrawSegs(void)
 // CPhipps -
 // Instead of clipsegs, let's try using an array with one entry for each column,
 // indicating whether it's blocked by a solid wall yet or not.
-byte* solidcol;
+THREADLOCAL byte* solidcol;
+static THREADLOCAL int solidcolsize;
 
 // CPhipps -
 // R_ClipWallSegment
 //
 // Replaces the old R_Clip*WallSegment functions. It draws bits of walls in those
 // columns which aren't solid, and updates the solidcol[] array appropriately
-static void R_ClipWallSegment(int first, const int last, const bool solid)
+static void R_ClipWallSegment(rendercontext_t* rc, int first, const int last, const bool solid)
 {
     while(first < last)
         if(solidcol[first])
@@ -84,8 +89,12 @@ static void R_ClipWallSegment(int first, const int last, const bool solid)
         {
             const byte* p = memchr(solidcol + first, 1, (size_t)last - first);
             const int to  = (p ? (int)(p - solidcol) : last);
+            const uint64_t starttime = I_GetTimeNS();
 
-            R_StoreWallRange(first, to - 1);
+            R_StoreWallRange(rc, first, to - 1);
+
+            if(!r_strip)
+                I_AddPerfTime(PERF_WALLS, starttime);
 
             if(solid)
                 memset(solidcol + first, 1, (size_t)to - first);
@@ -97,15 +106,20 @@ static void R_ClipWallSegment(int first, const int last, const bool solid)
 //
 // R_ResizeClipSegs
 // Allocates or reallocates clip segment buffers for the current scale.
-// Called during init and by R_ResizeRenderState when buffer sizes need to increase.
+// Called during init and by R_ResizeRenderState when buffer sizes need to increase,
+// and by each render thread before it draws its strip.
 //
 // Buffer sizes:
 //   solidcol: r_alloc_max_width elements
 //
 void R_ResizeClipSegs(void)
 {
+    if(solidcol && solidcolsize == r_alloc_max_width)
+        return;
+
     if(solidcol) free(solidcol);
     solidcol = calloc(r_alloc_max_width, sizeof(*solidcol));
+    solidcolsize = r_alloc_max_width;
 
     // Verify allocation succeeded
     if(!solidcol)
@@ -114,6 +128,8 @@ void R_ResizeClipSegs(void)
 
 //
 // R_ClearClipSegs
+// Every render thread clips walls against the whole view, not just its strip,
+// so they are split into exactly the same ranges as by a single thread.
 //
 void R_ClearClipSegs(void)
 {
@@ -125,13 +141,12 @@ void R_ClearClipSegs(void)
 //
 // cph - converted to R_RecalcLineFlags. This recalculates all the flags for
 // a line, including closure and texture tiling.
-static void R_RecalcLineFlags(line_t* line)
+static int R_LineFlags(void)
 {
-    const bool twosided = (line->flags & ML_TWOSIDED);
+    const bool twosided = (curline->linedef->flags & ML_TWOSIDED);
+    int flags;
     int c;
 
-    line->r_validcount = game.time;
-
     if(!twosided || backsector->interpceilingheight <= frontsector->interpfloorheight ||
     backsector->interpfloorheight >= frontsector->interpceilingheight ||
     (backsector->interpceilingheight <= backsector->interpfloorheight &&
@@ -140,7 +155,7 @@ static void R_RecalcLineFlags(line_t* line)
     (backsector->interpfloorheight <= frontsector->interpfloorheight ||
     curline->sidedef->bottomtexture) &&
     (backsector->ceilingpic != skyflatnum || frontsector->ceilingpic != skyflatnum)))
-        line->r_flags = RF_CLOSED;
+        flags = RF_CLOSED;
     else if(backsector->interpceilingheight != frontsector->interpceilingheight ||
     backsector->interpfloorheight != frontsector->interpfloorheight ||
     curline->sidedef->midtexture || backsector->floorxoffset != frontsector->floorxoffset ||
@@ -155,42 +170,39 @@ static void R_RecalcLineFlags(line_t* line)
     backsector->colormap != frontsector->colormap ||
     backsector->floorrotation != frontsector->floorrotation ||
     backsector->ceilingrotation != frontsector->ceilingrotation)
-    {
-        line->r_flags = RF_NONE;
-        return;
-    }
+        return RF_NONE;
     else
-        line->r_flags = RF_IGNORE;
+        flags = RF_IGNORE;
 
     if(curline->sidedef->rowoffset)
-        return;
+        return flags;
 
     if(twosided)
     {
         // Does top texture need tiling?
         if((c = frontsector->interpceilingheight - backsector->interpceilingheight) > 0 &&
         textureheight[texturetranslation[curline->sidedef->toptexture]] > c)
-            line->r_flags |= RF_TOP_TILE;
+            flags |= RF_TOP_TILE;
 
         // Does bottom texture need tiling?
         if((c = frontsector->interpfloorheight - backsector->interpfloorheight) > 0 &&
         textureheight[texturetranslation[curline->sidedef->bottomtexture]] > c)
-            line->r_flags |= RF_BOT_TILE;
+            flags |= RF_BOT_TILE;
     }
     else
     {
         // Does middle texture need tiling?
         if((c = frontsector->interpceilingheight - frontsector->interpfloorheight) > 0 &&
         textureheight[texturetranslation[curline->sidedef->midtexture]] > c)
-            line->r_flags |= RF_MID_TILE;
+            flags |= RF_MID_TILE;
     }
+
+    return flags;
 }
 
 // [AM] Interpolate the passed sector.
 static void R_InterpolateSector(sector_t* sector)
 {
-    sector_t* heightsec = sector->heightsec;
-
     if(vid_capfps != TICRATE)
     {
         if(sector->floordata && sector->floorheight != sector->oldfloorheight &&
@@ -207,23 +219,6 @@ static void R_InterpolateSector(sector_t* sector)
         else
             sector->interpceilingheight = sector->ceilingheight;
 
-        if(heightsec)
-        {
-            if(heightsec->floordata && heightsec->floorheight != heightsec->oldfloorheight &&
-            heightsec->oldfloorgametime == game.time - 1)
-                heightsec->interpfloorheight = heightsec->oldfloorheight +
-                FixedMul(heightsec->floorheight - heightsec->oldfloorheight, fractionaltic);
-            else
-                heightsec->interpfloorheight = heightsec->floorheight;
-
-            if(heightsec->ceilingdata && heightsec->ceilingheight != heightsec->oldceilingheight &&
-            heightsec->oldceilinggametime == game.time - 1)
-                heightsec->interpceilingheight = heightsec->oldceilingheight +
-                FixedMul(heightsec->ceilingheight - heightsec->oldceilingheight, fractionaltic);
-            else
-                heightsec->interpceilingheight = heightsec->ceilingheight;
-        }
-
         if(sector->oldflooroffsetgametime == game.time - 1)
         {
             sector->floorxoffset = sector->oldfloorxoffset +
@@ -244,12 +239,6 @@ static void R_InterpolateSector(sector_t* sector)
     {
         sector->interpfloorheight   = sector->floorheight;
         sector->interpceilingheight = sector->ceilingheight;
-
-        if(heightsec)
-        {
-            heightsec->interpfloorheight   = heightsec->floorheight;
-            heightsec->interpceilingheight = heightsec->ceilingheight;
-        }
     }
 }
 
@@ -264,6 +253,20 @@ static void R_InterpolateTextureOffsets(side_t* side)
     }
 }
 
+//
+// R_InterpolateMap
+// Interpolates every sector and sidedef on the main thread before the view is
+// rendered, so the render threads only ever read them.
+//
+void R_InterpolateMap(void)
+{
+    for(int i = 0; i < numsectors; i++)
+        R_InterpolateSector(&sectors[i]);
+
+    for(int i = 0; i < numsides; i++)
+        R_InterpolateTextureOffsets(&sides[i]);
+}
+
 //
 // killough 03/07/98: Hack floor/ceiling heights for deep water etc.
 //
@@ -296,6 +299,7 @@ R_FakeFlat(sector_t* sec, sector_t* tempsec, int* floorlightlevel, int* ceilingl
 
         // Replace sector being drawn, with a copy to be hacked
         *tempsec = *sec;
+        tempsec->cachedheight = R_GetCachedHeight(sec);
 
         // Replace floor and ceiling height with other sector's heights.
         tempsec->interpfloorheight   = s->interpfloorheight;
@@ -380,7 +384,7 @@ R_FakeFlat(sector_t* sec, sector_t* tempsec, int* floorlightlevel, int* ceilingl
 // R_AddLine
 // Clips the given segment and adds any visible pieces to the line list.
 //
-static void R_AddLine(seg_t* line)
+static void R_AddLine(rendercontext_t* rc, seg_t* line)
 {
     TracyCZoneN(tracy_zone, "R_AddLine", 1);
     int x1;
@@ -450,31 +454,25 @@ static void R_AddLine(seg_t* line)
         return;
     }
 
-    R_InterpolateTextureOffsets(line->sidedef);
-
     // Single sided line?
     if((backsector = line->backsector))
     {
         sector_t tempsec; // killough 03/08/98: ceiling/water hack
 
-        // [AM] Interpolate sector movement before running clipping tests.
-        // Frontsector should already be interpolated.
-        R_InterpolateSector(backsector);
-
         // killough 03/08/98, 04/04/98: hack for invisible ceilings/deep water
         backsector = R_FakeFlat(backsector, &tempsec, NULL, NULL, true);
     }
 
-    if((linedef = curline->linedef)->r_validcount != game.time)
-        R_RecalcLineFlags(linedef);
+    linedef   = curline->linedef;
+    lineflags = R_LineFlags();
 
-    if(linedef->r_flags & RF_IGNORE)
+    if(lineflags & RF_IGNORE)
     {
         TracyCZoneEnd(tracy_zone)
         return;
     }
 
-    R_ClipWallSegment(x1, x2, (linedef->r_flags & RF_CLOSED));
+    R_ClipWallSegment(rc, x1, x2, (lineflags & RF_CLOSED));
     TracyCZoneEnd(tracy_zone)
 }
 
@@ -571,7 +569,7 @@ static bool R_CheckBBox(const fixed_t* bspcoord)
 // Add sprites of things in sector.
 // Draw one or more line segments.
 //
-static void R_Subsector(int num)
+static void R_Subsector(rendercontext_t* rc, int num)
 {
     TracyCZoneN(tracy_zone, "R_Subsector", 1);
     subsector_t* sub = subsectors + num;
@@ -585,9 +583,6 @@ static void R_Subsector(int num)
     int count   = sub->numlines;
     seg_t* line = segs + sub->firstline;
 
-    // [AM] Interpolate sector movement. Usually only needed when player is standing inside the sector.
-    R_InterpolateSector(sector);
-
     // killough 03/08/98, 04/04/98: Deep water/fake ceiling effect
     frontsector =
     R_FakeFlat(sector, &tempsec, &floorlightlevel, &ceilinglightlevel, false);
@@ -637,16 +632,15 @@ static void R_Subsector(int num)
     // Either you must pass the fake sector and handle validcount here, on the
     // real sector, or you must account for the lighting in some other way,
     // like passing it as an argument.
-    if(sector->validcount != validcount && !automapactive)
+    if(!R_SectorSpritesAdded(sector) && !automapactive)
     {
-        sector->validcount = validcount;
         R_AddSprites(sector,
         (sector->heightsec ? (ceilinglightlevel + floorlightlevel) / 2 : floorlightlevel));
         R_AddNearbySprites(sector);
     }
 
     while(count--)
-        R_AddLine(line++);
+        R_AddLine(rc, line++);
 
     TracyCZoneEnd(tracy_zone)
 }
@@ -658,7 +652,7 @@ static void R_Subsector(int num)
 //
 #define MAX_BSP_DEPTH 256
 
-void R_RenderBSPNode(int bspnum)
+void R_RenderBSPNode(rendercontext_t* rc, int bspnum)
 {
     TracyCZoneN(tracy_zone, "R_RenderBSPNode", 1);
     int bspstack[MAX_BSP_DEPTH]  = { 0 };
@@ -684,7 +678,7 @@ void R_RenderBSPNode(int bspnum)
             bspnum          = bsp->children[side];
         }
 
-        R_Subsector(bspnum == -1 ? 0 : (bspnum & ~NF_SUBSECTOR));
+        R_Subsector(rc, bspnum == -1 ? 0 : (bspnum & ~NF_SUBSECTOR));
 
         if(!sp)
         {
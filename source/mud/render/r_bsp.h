@@ -35,23 +35,36 @@
 
 #pragma once
 
-extern seg_t* curline;
-extern line_t* linedef;
-extern sector_t* frontsector;
-extern sector_t* backsector;
+// cph: what the renderer works out about each line it reaches
+enum
+{
+    RF_NONE     = 0,
+    RF_TOP_TILE = 1, // Upper texture needs tiling
+    RF_MID_TILE = 2, // Midtexture needs tiling
+    RF_BOT_TILE = 4, // Lower texture needs tiling
+    RF_IGNORE   = 8, // Renderer can skip this line
+    RF_CLOSED   = 16 // Line blocks view
+};
 
-extern drawseg_t* drawsegs;
+extern THREADLOCAL seg_t* curline;
+extern THREADLOCAL line_t* linedef;
+extern THREADLOCAL int lineflags;
+extern THREADLOCAL sector_t* frontsector;
+extern THREADLOCAL sector_t* backsector;
 
-extern byte* solidcol;
+extern THREADLOCAL drawseg_t* drawsegs;
 
-extern drawseg_t* ds_p;
+extern THREADLOCAL byte* solidcol;
+
+extern THREADLOCAL drawseg_t* ds_p;
 
 // BSP?
 void R_ResizeClipSegs(void);
 void R_ClearClipSegs(void);
 void R_ClearDrawSegs(void);
 
-void R_RenderBSPNode(int bspnum);
+void R_InterpolateMap(void);
+void R_RenderBSPNode(rendercontext_t* rc, int bspnum);
 
 // killough 04/13/98: fake floors/ceilings for deep water/fake ceilings:
 sector_t* R_FakeFlat(sector_t* sec,
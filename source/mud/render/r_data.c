@@ -42,6 +42,7 @@
 #include "system/i_config.h"
 #include "utils/m_misc.h"
 #include "playsim/p_local.h"
+#include "playsim/p_tick.h"
 #include "render/r_sky.h"
 #include "utils/sc_man.h"
 #include "wad/w_wad.h"
@@ -895,8 +896,7 @@ static void R_InitColormaps(void)
     else
         colormaps = I_Malloc(sizeof(*colormaps));
 
-    dc_colormap[1] = dc_nextcolormap[1] = colormaps[0] =
-    W_CacheLumpName("COLORMAP");
+    colormaps[0] = W_CacheLumpName("COLORMAP");
 
     if(numcolormaps == 1)
         C_Output(
@@ -1074,12 +1074,22 @@ int R_TextureNumForName(const char* name)
 // to avoid using alloca(), and to improve performance.
 void R_PrecacheLevel(void)
 {
-    bool* hitlist =
-    calloc(MAX(MAX(numsectors, numflats), MAX(numsides, numtextures)), sizeof(bool));
+    const int size =
+    MAX(MAX(MAX(numsectors, numflats), MAX(numsides, numtextures)), numspritelumps);
+    bool* hitlist = calloc(size, sizeof(bool));
+    int* ids;
+    int numids = 0;
+    int numtextureids;
 
     if(!hitlist)
         return;
 
+    if(!(ids = malloc((numtextures + numspritelumps) * sizeof(*ids))))
+    {
+        free(hitlist);
+        return;
+    }
+
     // Precache flats.
     for(int i = 0; i < numsectors; i++)
     {
@@ -1095,7 +1105,7 @@ void R_PrecacheLevel(void)
             W_CacheLumpNum(firstflat + i);
 
     // Precache textures.
-    memset(hitlist, false, sizeof(*hitlist));
+    memset(hitlist, false, size * sizeof(*hitlist));
 
     for(int i = 0; i < numsides; i++)
     {
@@ -1114,12 +1124,29 @@ void R_PrecacheLevel(void)
 
     for(int i = 0; i < numtextures; i++)
         if(hitlist[i])
-        {
-            texture_t* texture = textures[i];
+            ids[numids++] = i;
 
-            for(int j = 0; j < texture->patchcount; j++)
-                W_CacheLumpNum(texture->patches[j].patch);
-        }
+    numtextureids = numids;
+
+    // Precache every frame of the sprites of the things in the map.
+    memset(hitlist, false, size * sizeof(*hitlist));
+
+    for(thinker_t* th = thinkers[th_mobj].cnext; th != &thinkers[th_mobj]; th = th->cnext)
+    {
+        const spritedef_t* sprite = &sprites[((mobj_t*)th)->sprite];
+
+        for(int i = 0; i < sprite->numframes; i++)
+            for(int j = 0; j < 16; j++)
+                if(sprite->spriteframes[i].lump[j] >= 0)
+                    hitlist[sprite->spriteframes[i].lump[j]] = true;
+    }
+
+    for(int i = 0; i < numspritelumps; i++)
+        if(hitlist[i])
+            ids[numids++] = firstspritelump + i;
 
     free(hitlist);
+
+    // Build the composites of the textures and the sprites in the background.
+    R_PrefetchPatches(ids, numtextureids, numids);
 }
@@ -92,6 +92,16 @@ typedef enum
     SLUDGE
 } terraintype_t;
 
+//
+// A two-sided line leading out of a sector, and the sector on the other
+// side. Built by P_GroupLines for P_NoiseAlert.
+//
+typedef struct
+{
+    struct sector_s* sector;
+    struct line_s* line;
+} soundlink_t;
+
 //
 // The SECTORS record, at runtime.
 // Stores things/mobjs.
@@ -138,6 +148,9 @@ typedef struct sector_s
     int linecount;
     struct line_s** lines; // [linecount] size
 
+    int soundlinkcount;
+    soundlink_t* soundlinks; // [soundlinkcount] size
+
     int cachedheight;
 
     // [AM] Previous position of floor and ceiling before
@@ -315,18 +328,6 @@ typedef struct line_s
     int nexttag;
     int firsttag;
 
-    int r_validcount; // cph: if == game.time, r_flags already done
-
-    enum
-    {
-        RF_NONE     = 0, // cph:
-        RF_TOP_TILE = 1, // Upper texture needs tiling
-        RF_MID_TILE = 2, // Midtexture needs tiling
-        RF_BOT_TILE = 4, // Lower texture needs tiling
-        RF_IGNORE   = 8, // Renderer can skip this line
-        RF_CLOSED   = 16 // Line blocks view
-    } r_flags;
-
     // sound origin for switches/buttons
     degenmobj_t soundorg;
 } line_t;
@@ -1080,7 +1081,7 @@ typedef struct
 
     mobj_t* mobj;
 
-    void (*colfunc)(void);
+    void (*colfunc)(rendercontext_t* rc);
 
     // foot clipping
     fixed_t footclip;
@@ -1108,7 +1109,7 @@ typedef struct
     lighttable_t* nextcolormap;
     lighttable_t* sectorcolormap;
     int color;
-    void (*colfunc)(void);
+    void (*colfunc)(rendercontext_t* rc);
 } vissplat_t;
 
 //
@@ -1152,12 +1153,12 @@ typedef struct
 
 //
 // Now what is a visplane, anyway?
-// NOTE: top and bottom arrays are dynamically allocated based on max_width.
-// The pad fields provide sentinel values for [minx-1] and [maxx+1] access.
+// NOTE: top and bottom arrays are carved from blocks sized on max_width, with
+// room for sentinel values at [minx-1] and [maxx+1].
 //
 typedef struct visplane_s
 {
-    // Next visplane in hash chain -- killough
+    // Visplane this one was split from, with the same properties
     struct visplane_s* next;
 
     int picnum;
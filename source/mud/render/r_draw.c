@@ -38,6 +38,8 @@
 #include "system/i_system.h"
 #include "system/i_video.h"
 #include "render/v_draw.h"
+#include "render/r_simd.h"
+#include "render/r_threads.h"
 #include "render/v_video.h"
 
 #define NOFUZZ 251
@@ -56,37 +58,33 @@ int v_viewheight;
 int v_viewwindowx;
 int v_viewwindowy;
 
+int rowpitch;
+int columnpitch;
+
 int fuzzrange[3];
-int fuzz1pos;
-int fuzz2pos;
-int* fuzz1table;
-int* fuzz2table;
+
+// The main thread's fuzz tables are the ones V_DrawFuzzPatch() reads back while
+// paused. Every other render thread writes to its own, which nothing reads.
+THREADLOCAL int* fuzz1table;
+THREADLOCAL int* fuzz2table;
+static THREADLOCAL int fuzztablesize;
+
+// fuzzrange for the view, in rows of r_screens rather than v_screens
+static int viewfuzzrange[3];
+
+#define VIEWFUZZ1(a, b) viewfuzzrange[M_Fuzz1RandomInt(a, b) + 1]
+#define VIEWFUZZ2(a, b) viewfuzzrange[M_Fuzz2RandomInt(a, b) + 1]
 
 static byte** ylookup0;
 static byte** ylookup1;
+static int* columnofs;
+
+// When r_columnmajor is set, spans are drawn into a row of their own before
+// R_TransposeSpan copies them into the view
+static THREADLOCAL byte* spanrow;
+static THREADLOCAL int spanrowsize;
 
-lighttable_t* dc_colormap[2];
-lighttable_t* dc_nextcolormap[2];
-lighttable_t* dc_sectorcolormap;
-int dc_x;
-int dc_yl;
-int dc_yh;
-int dc_z;
-fixed_t dc_iscale;
-fixed_t dc_texturemid;
-fixed_t dc_texheight;
-fixed_t dc_texturefrac;
-byte dc_solidbloodcolor;
-byte* dc_bloodcolor;
-byte* dc_brightmap;
-int dc_floorclip;
-int dc_ceilingclip;
-int dc_numposts;
-byte dc_black;
-byte* dc_black33;
-byte* dc_black40;
-byte* dc_source;
-byte* dc_translation;
+#define SPANDEST(y, x) (r_columnmajor ? spanrow + (x) : ylookup0[y] + (x))
 
 #define DITHERSIZE 4
 
@@ -114,332 +112,416 @@ static const byte dithermatrix[DITHERSIZE][DITHERSIZE] = { { 0, 224, 48, 208 },
 //  be used. It has also been used with Wolfenstein 3D.
 //
 
-void R_DrawColumn(void)
+void R_DrawColumn(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
-        *dest = dc_sectorcolormap[colormap[dc_source[frac >> FRACBITS]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        *dest = sectorcolormap[colormap[source[frac >> FRACBITS]]];
+        dest += pitch;
+        frac += iscale;
     }
 
-    *dest = dc_sectorcolormap[colormap[dc_source[frac >> FRACBITS]]];
+    *dest = sectorcolormap[colormap[source[frac >> FRACBITS]]];
 }
 
-void R_DrawColumnWithBrightmap(void)
+void R_DrawColumnWithBrightmap(rendercontext_t* rc)
 {
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac = dc_texturefrac;
+    const byte* source                 = rc->dc_source;
+    const byte* brightmap              = rc->dc_brightmap;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_colormap[1] };
     byte dot;
 
     while(--count)
     {
-        dot   = dc_source[frac >> FRACBITS];
-        *dest = dc_sectorcolormap[dc_colormap[dc_brightmap[dot]][dot]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        dot   = source[frac >> FRACBITS];
+        *dest = sectorcolormap[colormap[brightmap[dot]][dot]];
+        dest += pitch;
+        frac += iscale;
     }
 
-    dot   = dc_source[frac >> FRACBITS];
-    *dest = dc_sectorcolormap[dc_colormap[dc_brightmap[dot]][dot]];
+    dot   = source[frac >> FRACBITS];
+    *dest = sectorcolormap[colormap[brightmap[dot]][dot]];
 }
 
-void R_DrawLowResDitheredColumn(void)
+void R_DrawLowResDitheredColumn(rendercontext_t* rc)
 {
-    int count                       = dc_yh - dc_yl + 1;
-    byte* dest                      = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                    = dc_texturefrac;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[colormap[ditherlow(dc_x, dc_yl++, dc_z)][dc_source[frac >> FRACBITS]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[colormap[ditherlow(x, yl++, z)][source[frac >> FRACBITS]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[colormap[ditherlow(dc_x, dc_yl, dc_z)][dc_source[frac >> FRACBITS]]];
+    sectorcolormap[colormap[ditherlow(x, yl, z)][source[frac >> FRACBITS]]];
 }
 
-void R_DrawDitheredColumn(void)
+void R_DrawDitheredColumn(rendercontext_t* rc)
 {
-    int count                       = dc_yh - dc_yl + 1;
-    byte* dest                      = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                    = dc_texturefrac;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[colormap[dither(dc_x, dc_yl++, dc_z)][dc_source[frac >> FRACBITS]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[colormap[dither(x, yl++, z)][source[frac >> FRACBITS]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[colormap[dither(dc_x, dc_yl, dc_z)][dc_source[frac >> FRACBITS]]];
-}
-
-void R_DrawLowResDitheredColumnWithBrightmap(void)
-{
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac = dc_texturefrac;
-    const lighttable_t* colormap[2][2] = { { dc_colormap[0], dc_nextcolormap[0] },
+    sectorcolormap[colormap[dither(x, yl, z)][source[frac >> FRACBITS]]];
+}
+
+void R_DrawLowResDitheredColumnWithBrightmap(rendercontext_t* rc)
+{
+    const byte* source                 = rc->dc_source;
+    const byte* brightmap              = rc->dc_brightmap;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2][2] = { { rc->dc_colormap[0], rc->dc_nextcolormap[0] },
         { fullcolormap, fullcolormap } };
     byte dot;
 
     while(--count)
     {
-        dot = dc_source[frac >> FRACBITS];
+        dot = source[frac >> FRACBITS];
         *dest =
-        dc_sectorcolormap[colormap[dc_brightmap[dot]][ditherlow(dc_x, dc_yl++, dc_z)][dot]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[colormap[brightmap[dot]][ditherlow(x, yl++, z)][dot]];
+        dest += pitch;
+        frac += iscale;
     }
 
-    dot = dc_source[frac >> FRACBITS];
+    dot = source[frac >> FRACBITS];
     *dest =
-    dc_sectorcolormap[colormap[dc_brightmap[dot]][ditherlow(dc_x, dc_yl++, dc_z)][dot]];
-}
-
-void R_DrawDitheredColumnWithBrightmap(void)
-{
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac = dc_texturefrac;
-    const lighttable_t* colormap[2][2] = { { dc_colormap[0], dc_nextcolormap[0] },
+    sectorcolormap[colormap[brightmap[dot]][ditherlow(x, yl++, z)][dot]];
+}
+
+void R_DrawDitheredColumnWithBrightmap(rendercontext_t* rc)
+{
+    const byte* source                 = rc->dc_source;
+    const byte* brightmap              = rc->dc_brightmap;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2][2] = { { rc->dc_colormap[0], rc->dc_nextcolormap[0] },
         { fullcolormap, fullcolormap } };
     byte dot;
 
     while(--count)
     {
-        dot = dc_source[frac >> FRACBITS];
+        dot = source[frac >> FRACBITS];
         *dest =
-        dc_sectorcolormap[colormap[dc_brightmap[dot]][dither(dc_x, dc_yl++, dc_z)][dot]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[colormap[brightmap[dot]][dither(x, yl++, z)][dot]];
+        dest += pitch;
+        frac += iscale;
     }
 
-    dot = dc_source[frac >> FRACBITS];
+    dot = source[frac >> FRACBITS];
     *dest =
-    dc_sectorcolormap[colormap[dc_brightmap[dot]][dither(dc_x, dc_yl++, dc_z)][dot]];
+    sectorcolormap[colormap[brightmap[dot]][dither(x, yl++, z)][dot]];
 }
 
-void R_DrawCorrectedColumn(void)
+void R_DrawCorrectedColumn(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
-        *dest = dc_sectorcolormap[colormap[nearestcolors[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        *dest = sectorcolormap[colormap[nearestcolors[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
-    *dest = dc_sectorcolormap[colormap[nearestcolors[dc_source[frac >> FRACBITS]]]];
+    *dest = sectorcolormap[colormap[nearestcolors[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawCorrectedLowResDitheredColumn(void)
+void R_DrawCorrectedLowResDitheredColumn(rendercontext_t* rc)
 {
-    int count                       = dc_yh - dc_yl + 1;
-    byte* dest                      = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                    = dc_texturefrac;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[colormap[ditherlow(dc_x, dc_yl++, dc_z)][nearestcolors[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[colormap[ditherlow(x, yl++, z)][nearestcolors[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[colormap[ditherlow(dc_x, dc_yl, dc_z)][nearestcolors[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[colormap[ditherlow(x, yl, z)][nearestcolors[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawCorrectedDitheredColumn(void)
+void R_DrawCorrectedDitheredColumn(rendercontext_t* rc)
 {
-    int count                       = dc_yh - dc_yl + 1;
-    byte* dest                      = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                    = dc_texturefrac;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[colormap[dither(dc_x, dc_yl++, dc_z)][nearestcolors[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[colormap[dither(x, yl++, z)][nearestcolors[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[colormap[dither(dc_x, dc_yl, dc_z)][nearestcolors[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[colormap[dither(x, yl, z)][nearestcolors[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawSolidColorColumn(void)
+void R_DrawSolidColorColumn(rendercontext_t* rc)
 {
-    int count        = dc_yh - dc_yl + 1;
-    byte* dest       = ylookup0[dc_yl] + dc_x;
-    const byte color = dc_sectorcolormap[dc_colormap[0][NOTEXTURECOLOR]];
+    const int pitch       = rowpitch;
+    int count             = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest            = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    const byte color      = rc->dc_sectorcolormap[rc->dc_colormap[0][NOTEXTURECOLOR]];
 
     while(--count)
     {
         *dest = color;
-        dest += render.screen_width;
+        dest += pitch;
     }
 
     *dest = color;
 }
 
-void R_DrawLowResDitheredSolidColorColumn(void)
+void R_DrawLowResDitheredSolidColorColumn(rendercontext_t* rc)
 {
-    int count                       = dc_yh - dc_yl + 1;
-    byte* dest                      = ylookup0[dc_yl] + dc_x;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
 
     while(--count)
     {
-        *dest = dc_sectorcolormap[colormap[ditherlow(dc_x, dc_yl++, dc_z)][NOTEXTURECOLOR]];
-        dest += render.screen_width;
+        *dest = sectorcolormap[colormap[ditherlow(x, yl++, z)][NOTEXTURECOLOR]];
+        dest += pitch;
     }
 
-    *dest = dc_sectorcolormap[colormap[ditherlow(dc_x, dc_yl, dc_z)][NOTEXTURECOLOR]];
+    *dest = sectorcolormap[colormap[ditherlow(x, yl, z)][NOTEXTURECOLOR]];
 }
 
-void R_DrawDitheredSolidColorColumn(void)
+void R_DrawDitheredSolidColorColumn(rendercontext_t* rc)
 {
-    int count                       = dc_yh - dc_yl + 1;
-    byte* dest                      = ylookup0[dc_yl] + dc_x;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
 
     while(--count)
     {
-        *dest = dc_sectorcolormap[colormap[dither(dc_x, dc_yl++, dc_z)][NOTEXTURECOLOR]];
-        dest += render.screen_width;
+        *dest = sectorcolormap[colormap[dither(x, yl++, z)][NOTEXTURECOLOR]];
+        dest += pitch;
     }
 
-    *dest = dc_sectorcolormap[colormap[dither(dc_x, dc_yl, dc_z)][NOTEXTURECOLOR]];
+    *dest = sectorcolormap[colormap[dither(x, yl, z)][NOTEXTURECOLOR]];
 }
 
-void R_DrawShadowColumn(void)
+void R_DrawShadowColumn(rendercontext_t* rc)
 {
-    int count  = dc_yh - dc_yl;
-    byte* dest = ylookup0[dc_yl] + dc_x;
+    const byte* black40   = rc->dc_black40;
+    const int pitch       = rowpitch;
+    int count             = rc->dc_yh - rc->dc_yl;
+    byte* dest            = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
 
     if(count)
     {
-        *dest = *(*dest + dc_black33);
-        dest += render.screen_width;
+        *dest = *(*dest + rc->dc_black33);
+        dest += pitch;
 
         while(--count)
         {
-            *dest = *(*dest + dc_black40);
-            dest += render.screen_width;
+            *dest = *(*dest + black40);
+            dest += pitch;
         }
 
-        *dest = *(*dest + (dc_yh == dc_floorclip ? dc_black40 : dc_black33));
+        *dest = *(*dest + (rc->dc_yh == rc->dc_floorclip ? black40 : rc->dc_black33));
     }
     else
-        *dest = *(*dest + dc_black33);
+        *dest = *(*dest + rc->dc_black33);
 }
 
-void R_DrawFuzzyShadowColumn(void)
+void R_DrawFuzzyShadowColumn(rendercontext_t* rc)
 {
+    const byte* black33   = rc->dc_black33;
+    const int pitch       = rowpitch;
     byte* dest;
     int count;
 
-    if(dc_x & 1)
+    if(rc->dc_x & 1)
         return;
 
-    dest = ylookup0[dc_yl] + dc_x;
+    dest = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
 
-    if((count = dc_yh - dc_yl))
+    if((count = rc->dc_yh - rc->dc_yl))
     {
-        *dest       = *(*dest + dc_black33);
-        *(dest + 1) = *(*(dest + 1) + dc_black33);
-        dest += render.screen_width;
+        *dest                 = *(*dest + black33);
+        *(dest + columnpitch) = *(*(dest + columnpitch) + black33);
+        dest += pitch;
 
         while(--count)
         {
-            *dest       = *(*dest + dc_black33);
-            *(dest + 1) = *(*(dest + 1) + dc_black33);
-            dest += render.screen_width;
+            *dest                 = *(*dest + black33);
+            *(dest + columnpitch) = *(*(dest + columnpitch) + black33);
+            dest += pitch;
         }
 
-        *dest       = *(*dest + dc_black33);
-        *(dest + 1) = *(*(dest + 1) + dc_black33);
+        *dest                 = *(*dest + black33);
+        *(dest + columnpitch) = *(*(dest + columnpitch) + black33);
     }
     else
     {
-        *dest       = *(*dest + dc_black33);
-        *(dest + 1) = *(*(dest + 1) + dc_black33);
+        *dest                 = *(*dest + black33);
+        *(dest + columnpitch) = *(*(dest + columnpitch) + black33);
     }
 }
 
-void R_DrawSolidShadowColumn(void)
+void R_DrawSolidShadowColumn(rendercontext_t* rc)
 {
-    int count  = dc_yh - dc_yl + 1;
-    byte* dest = ylookup0[dc_yl] + dc_x;
+    const byte black      = rc->dc_black;
+    const int pitch       = rowpitch;
+    int count             = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest            = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
 
     while(--count)
     {
-        *dest = dc_black;
-        dest += render.screen_width;
+        *dest = black;
+        dest += pitch;
     }
 
-    *dest = dc_black;
+    *dest = black;
 }
 
-void R_DrawBloodSplatColumn(void)
+void R_DrawBloodSplatColumn(rendercontext_t* rc)
 {
-    int count  = dc_yh - dc_yl + 1;
-    byte* dest = ylookup0[dc_yl] + dc_x;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const byte* bloodcolor             = rc->dc_bloodcolor;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
 
     while(--count)
     {
-        *dest = dc_sectorcolormap[*(*dest + dc_bloodcolor)];
-        dest += render.screen_width;
+        *dest = sectorcolormap[*(*dest + bloodcolor)];
+        dest += pitch;
     }
 
-    *dest = dc_sectorcolormap[*(*dest + dc_bloodcolor)];
+    *dest = sectorcolormap[*(*dest + bloodcolor)];
 }
 
-void R_DrawSolidBloodSplatColumn(void)
+void R_DrawSolidBloodSplatColumn(rendercontext_t* rc)
 {
-    int count  = dc_yh - dc_yl + 1;
-    byte* dest = ylookup0[dc_yl] + dc_x;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const byte solidbloodcolor         = rc->dc_solidbloodcolor;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
 
     while(--count)
     {
-        *dest = dc_sectorcolormap[dc_solidbloodcolor];
-        dest += render.screen_width;
+        *dest = sectorcolormap[solidbloodcolor];
+        dest += pitch;
     }
 
-    *dest = dc_sectorcolormap[dc_solidbloodcolor];
+    *dest = sectorcolormap[solidbloodcolor];
 }
 
-void R_DrawWallColumn(void)
+void R_DrawWallColumn(rendercontext_t* rc)
 {
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac = dc_texturemid + (dc_yl - r_centery) * dc_iscale;
-    const lighttable_t* colormap = dc_colormap[0];
-    fixed_t heightmask           = dc_texheight - 1;
+    const byte* source                 = rc->dc_source;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturemid + (rc->dc_yl - r_centery) * iscale;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
+    fixed_t heightmask                 = rc->dc_texheight - 1;
 
-    if(dc_texheight & heightmask)
+    if(rc->dc_texheight & heightmask)
     {
         heightmask = (heightmask + 1) << FRACBITS;
 
@@ -452,38 +534,44 @@ void R_DrawWallColumn(void)
 
         while(--count)
         {
-            *dest = dc_sectorcolormap[colormap[dc_source[frac >> FRACBITS]]];
-            dest += render.screen_width;
+            *dest = colormap[source[frac >> FRACBITS]];
+            dest += pitch;
 
-            if((frac += dc_iscale) >= heightmask)
+            if((frac += iscale) >= heightmask)
                 frac -= heightmask;
         }
 
-        *dest = dc_sectorcolormap[colormap[dc_source[frac >> FRACBITS]]];
+        *dest = colormap[source[frac >> FRACBITS]];
     }
     else
     {
         while(--count)
         {
             *dest =
-            dc_sectorcolormap[colormap[dc_source[(frac >> FRACBITS) & heightmask]]];
-            dest += render.screen_width;
-            frac += dc_iscale;
+            colormap[source[(frac >> FRACBITS) & heightmask]];
+            dest += pitch;
+            frac += iscale;
         }
 
-        *dest = dc_sectorcolormap[colormap[dc_source[(frac >> FRACBITS) & heightmask]]];
+        *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
     }
 }
 
-void R_DrawLowResDitheredWallColumn(void)
+void R_DrawLowResDitheredWallColumn(rendercontext_t* rc)
 {
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac = dc_texturemid + (dc_yl - r_centery) * dc_iscale;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
-    fixed_t heightmask              = dc_texheight - 1;
+    const byte* source                 = rc->dc_source;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturemid + (yl - r_centery) * iscale;
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
+    fixed_t heightmask                 = rc->dc_texheight - 1;
 
-    if(dc_texheight & heightmask)
+    if(rc->dc_texheight & heightmask)
     {
         heightmask = (heightmask + 1) << FRACBITS;
 
@@ -497,40 +585,46 @@ void R_DrawLowResDitheredWallColumn(void)
         while(--count)
         {
             *dest =
-            dc_sectorcolormap[colormap[ditherlow(dc_x, dc_yl++, dc_z)][dc_source[frac >> FRACBITS]]];
-            dest += render.screen_width;
+            colormap[ditherlow(x, yl++, z)][source[frac >> FRACBITS]];
+            dest += pitch;
 
-            if((frac += dc_iscale) >= heightmask)
+            if((frac += iscale) >= heightmask)
                 frac -= heightmask;
         }
 
         *dest =
-        dc_sectorcolormap[colormap[ditherlow(dc_x, dc_yl, dc_z)][dc_source[frac >> FRACBITS]]];
+        colormap[ditherlow(x, yl, z)][source[frac >> FRACBITS]];
     }
     else
     {
         while(--count)
         {
             *dest =
-            dc_sectorcolormap[colormap[ditherlow(dc_x, dc_yl++, dc_z)][dc_source[(frac >> FRACBITS) & heightmask]]];
-            dest += render.screen_width;
-            frac += dc_iscale;
+            colormap[ditherlow(x, yl++, z)][source[(frac >> FRACBITS) & heightmask]];
+            dest += pitch;
+            frac += iscale;
         }
 
         *dest =
-        dc_sectorcolormap[colormap[ditherlow(dc_x, dc_yl, dc_z)][dc_source[(frac >> FRACBITS) & heightmask]]];
+        colormap[ditherlow(x, yl, z)][source[(frac >> FRACBITS) & heightmask]];
     }
 }
 
-void R_DrawDitheredWallColumn(void)
+void R_DrawDitheredWallColumn(rendercontext_t* rc)
 {
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac = dc_texturemid + (dc_yl - r_centery) * dc_iscale;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
-    fixed_t heightmask              = dc_texheight - 1;
+    const byte* source                 = rc->dc_source;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturemid + (yl - r_centery) * iscale;
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
+    fixed_t heightmask                 = rc->dc_texheight - 1;
 
-    if(dc_texheight & heightmask)
+    if(rc->dc_texheight & heightmask)
     {
         heightmask = (heightmask + 1) << FRACBITS;
 
@@ -544,40 +638,45 @@ void R_DrawDitheredWallColumn(void)
         while(--count)
         {
             *dest =
-            dc_sectorcolormap[colormap[dither(dc_x, dc_yl++, dc_z)][dc_source[frac >> FRACBITS]]];
-            dest += render.screen_width;
+            colormap[dither(x, yl++, z)][source[frac >> FRACBITS]];
+            dest += pitch;
 
-            if((frac += dc_iscale) >= heightmask)
+            if((frac += iscale) >= heightmask)
                 frac -= heightmask;
         }
 
         *dest =
-        dc_sectorcolormap[colormap[dither(dc_x, dc_yl, dc_z)][dc_source[frac >> FRACBITS]]];
+        colormap[dither(x, yl, z)][source[frac >> FRACBITS]];
     }
     else
     {
         while(--count)
         {
             *dest =
-            dc_sectorcolormap[colormap[dither(dc_x, dc_yl++, dc_z)][dc_source[(frac >> FRACBITS) & heightmask]]];
-            dest += render.screen_width;
-            frac += dc_iscale;
+            colormap[dither(x, yl++, z)][source[(frac >> FRACBITS) & heightmask]];
+            dest += pitch;
+            frac += iscale;
         }
 
         *dest =
-        dc_sectorcolormap[colormap[dither(dc_x, dc_yl, dc_z)][dc_source[(frac >> FRACBITS) & heightmask]]];
+        colormap[dither(x, yl, z)][source[(frac >> FRACBITS) & heightmask]];
     }
 }
 
-void R_DrawWallColumnWithBrightmap(void)
+void R_DrawWallColumnWithBrightmap(rendercontext_t* rc)
 {
-    int count          = dc_yh - dc_yl + 1;
-    byte* dest         = ylookup0[dc_yl] + dc_x;
-    fixed_t frac       = dc_texturemid + (dc_yl - r_centery) * dc_iscale;
-    fixed_t heightmask = dc_texheight - 1;
+    const byte* source                 = rc->dc_source;
+    const byte* brightmap              = rc->dc_brightmap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturemid + (rc->dc_yl - r_centery) * iscale;
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_brightcolormap };
+    fixed_t heightmask                 = rc->dc_texheight - 1;
     byte dot;
 
-    if(dc_texheight & heightmask)
+    if(rc->dc_texheight & heightmask)
     {
         heightmask = (heightmask + 1) << FRACBITS;
 
@@ -590,43 +689,50 @@ void R_DrawWallColumnWithBrightmap(void)
 
         while(--count)
         {
-            dot   = dc_source[frac >> FRACBITS];
-            *dest = dc_sectorcolormap[dc_colormap[dc_brightmap[dot]][dot]];
-            dest += render.screen_width;
+            dot   = source[frac >> FRACBITS];
+            *dest = colormap[brightmap[dot]][dot];
+            dest += pitch;
 
-            if((frac += dc_iscale) >= heightmask)
+            if((frac += iscale) >= heightmask)
                 frac -= heightmask;
         }
 
-        dot   = dc_source[frac >> FRACBITS];
-        *dest = dc_sectorcolormap[dc_colormap[dc_brightmap[dot]][dot]];
+        dot   = source[frac >> FRACBITS];
+        *dest = colormap[brightmap[dot]][dot];
     }
     else
     {
         while(--count)
         {
-            dot   = dc_source[(frac >> FRACBITS) & heightmask];
-            *dest = dc_sectorcolormap[dc_colormap[dc_brightmap[dot]][dot]];
-            dest += render.screen_width;
-            frac += dc_iscale;
+            dot   = source[(frac >> FRACBITS) & heightmask];
+            *dest = colormap[brightmap[dot]][dot];
+            dest += pitch;
+            frac += iscale;
         }
 
-        dot   = dc_source[(frac >> FRACBITS) & heightmask];
-        *dest = dc_sectorcolormap[dc_colormap[dc_brightmap[dot]][dot]];
+        dot   = source[(frac >> FRACBITS) & heightmask];
+        *dest = colormap[brightmap[dot]][dot];
     }
 }
 
-void R_DrawLowResDitheredWallColumnWithBrightmap(void)
+void R_DrawLowResDitheredWallColumnWithBrightmap(rendercontext_t* rc)
 {
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac = dc_texturemid + (dc_yl - r_centery) * dc_iscale;
-    const lighttable_t* colormap[2][2] = { { dc_colormap[0], dc_nextcolormap[0] },
-        { fullcolormap, fullcolormap } };
-    fixed_t heightmask = dc_texheight - 1;
+    const byte* source                 = rc->dc_source;
+    const byte* brightmap              = rc->dc_brightmap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturemid + (yl - r_centery) * iscale;
+    const lighttable_t* colormap[2][2] = { { rc->dc_colormap[0], rc->dc_nextcolormap[0] },
+        { rc->dc_brightcolormap, rc->dc_brightcolormap } };
+    fixed_t heightmask = rc->dc_texheight - 1;
     byte dot;
 
-    if(dc_texheight & heightmask)
+    if(rc->dc_texheight & heightmask)
     {
         heightmask = (heightmask + 1) << FRACBITS;
 
@@ -639,47 +745,54 @@ void R_DrawLowResDitheredWallColumnWithBrightmap(void)
 
         while(--count)
         {
-            dot = dc_source[frac >> FRACBITS];
+            dot = source[frac >> FRACBITS];
             *dest =
-            dc_sectorcolormap[colormap[dc_brightmap[dot]][ditherlow(dc_x, dc_yl++, dc_z)][dot]];
-            dest += render.screen_width;
+            colormap[brightmap[dot]][ditherlow(x, yl++, z)][dot];
+            dest += pitch;
 
-            if((frac += dc_iscale) >= heightmask)
+            if((frac += iscale) >= heightmask)
                 frac -= heightmask;
         }
 
-        dot = dc_source[frac >> FRACBITS];
+        dot = source[frac >> FRACBITS];
         *dest =
-        dc_sectorcolormap[colormap[dc_brightmap[dot]][ditherlow(dc_x, dc_yl, dc_z)][dot]];
+        colormap[brightmap[dot]][ditherlow(x, yl, z)][dot];
     }
     else
     {
         while(--count)
         {
-            dot = dc_source[(frac >> FRACBITS) & heightmask];
+            dot = source[(frac >> FRACBITS) & heightmask];
             *dest =
-            dc_sectorcolormap[colormap[dc_brightmap[dot]][ditherlow(dc_x, dc_yl++, dc_z)][dot]];
-            dest += render.screen_width;
-            frac += dc_iscale;
+            colormap[brightmap[dot]][ditherlow(x, yl++, z)][dot];
+            dest += pitch;
+            frac += iscale;
         }
 
-        dot = dc_source[(frac >> FRACBITS) & heightmask];
+        dot = source[(frac >> FRACBITS) & heightmask];
         *dest =
-        dc_sectorcolormap[colormap[dc_brightmap[dot]][ditherlow(dc_x, dc_yl, dc_z)][dot]];
+        colormap[brightmap[dot]][ditherlow(x, yl, z)][dot];
     }
 }
 
-void R_DrawDitheredWallColumnWithBrightmap(void)
+void R_DrawDitheredWallColumnWithBrightmap(rendercontext_t* rc)
 {
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac = dc_texturemid + (dc_yl - r_centery) * dc_iscale;
-    const lighttable_t* colormap[2][2] = { { dc_colormap[0], dc_nextcolormap[0] },
-        { fullcolormap, fullcolormap } };
-    fixed_t heightmask = dc_texheight - 1;
+    const byte* source                 = rc->dc_source;
+    const byte* brightmap              = rc->dc_brightmap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturemid + (yl - r_centery) * iscale;
+    const lighttable_t* colormap[2][2] = { { rc->dc_colormap[0], rc->dc_nextcolormap[0] },
+        { rc->dc_brightcolormap, rc->dc_brightcolormap } };
+    fixed_t heightmask = rc->dc_texheight - 1;
     byte dot;
 
-    if(dc_texheight & heightmask)
+    if(rc->dc_texheight & heightmask)
     {
         heightmask = (heightmask + 1) << FRACBITS;
 
@@ -692,62 +805,68 @@ void R_DrawDitheredWallColumnWithBrightmap(void)
 
         while(--count)
         {
-            dot = dc_source[frac >> FRACBITS];
+            dot = source[frac >> FRACBITS];
             *dest =
-            dc_sectorcolormap[colormap[dc_brightmap[dot]][dither(dc_x, dc_yl++, dc_z)][dot]];
-            dest += render.screen_width;
+            colormap[brightmap[dot]][dither(x, yl++, z)][dot];
+            dest += pitch;
 
-            if((frac += dc_iscale) >= heightmask)
+            if((frac += iscale) >= heightmask)
                 frac -= heightmask;
         }
 
-        dot = dc_source[frac >> FRACBITS];
+        dot = source[frac >> FRACBITS];
         *dest =
-        dc_sectorcolormap[colormap[dc_brightmap[dot]][dither(dc_x, dc_yl, dc_z)][dot]];
+        colormap[brightmap[dot]][dither(x, yl, z)][dot];
     }
     else
     {
         while(--count)
         {
-            dot = dc_source[(frac >> FRACBITS) & heightmask];
+            dot = source[(frac >> FRACBITS) & heightmask];
             *dest =
-            dc_sectorcolormap[colormap[dc_brightmap[dot]][dither(dc_x, dc_yl++, dc_z)][dot]];
-            dest += render.screen_width;
-            frac += dc_iscale;
+            colormap[brightmap[dot]][dither(x, yl++, z)][dot];
+            dest += pitch;
+            frac += iscale;
         }
 
-        dot = dc_source[(frac >> FRACBITS) & heightmask];
+        dot = source[(frac >> FRACBITS) & heightmask];
         *dest =
-        dc_sectorcolormap[colormap[dc_brightmap[dot]][dither(dc_x, dc_yl, dc_z)][dot]];
+        colormap[brightmap[dot]][dither(x, yl, z)][dot];
     }
 }
 
-void R_DrawPlayerSpriteColumn(void)
+void R_DrawPlayerSpriteColumn(rendercontext_t* rc)
 {
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup1[dc_yl] + dc_x;
-    fixed_t frac = dc_texturefrac;
+    const byte* source    = rc->dc_source;
+    const fixed_t iscale  = rc->dc_iscale;
+    const int pitch       = rowpitch;
+    int count             = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest            = ylookup1[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac          = rc->dc_texturefrac;
 
     while(--count)
     {
-        *dest = dc_source[frac >> FRACBITS];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        *dest = source[frac >> FRACBITS];
+        dest += pitch;
+        frac += iscale;
     }
 
-    *dest = dc_source[frac >> FRACBITS];
+    *dest = source[frac >> FRACBITS];
 }
 
-void R_DrawSkyColumn(void)
+void R_DrawSkyColumn(rendercontext_t* rc)
 {
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac = dc_texturemid + (dc_yl - r_centery) * dc_iscale;
-    const lighttable_t* colormap = dc_colormap[0];
-    fixed_t heightmask           = dc_texheight - 1;
+    const byte* source                 = rc->dc_source;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturemid + (rc->dc_yl - r_centery) * iscale;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
+    fixed_t heightmask                 = rc->dc_texheight - 1;
     byte dot;
 
-    if(dc_texheight & heightmask)
+    if(rc->dc_texheight & heightmask)
     {
         heightmask = (heightmask + 1) << FRACBITS;
 
@@ -760,526 +879,671 @@ void R_DrawSkyColumn(void)
 
         while(--count)
         {
-            if((dot = dc_source[frac >> FRACBITS]))
-                *dest = dc_sectorcolormap[colormap[dot]];
+            if((dot = source[frac >> FRACBITS]))
+                *dest = colormap[dot];
 
-            dest += render.screen_width;
+            dest += pitch;
 
-            if((frac += dc_iscale) >= heightmask)
+            if((frac += iscale) >= heightmask)
                 frac -= heightmask;
         }
 
-        if((dot = dc_source[frac >> FRACBITS]))
-            *dest = dc_sectorcolormap[colormap[dot]];
+        if((dot = source[frac >> FRACBITS]))
+            *dest = colormap[dot];
     }
     else
     {
         while(--count)
         {
-            if((dot = dc_source[(frac >> FRACBITS) & heightmask]))
-                *dest = dc_sectorcolormap[colormap[dot]];
+            if((dot = source[(frac >> FRACBITS) & heightmask]))
+                *dest = colormap[dot];
 
-            dest += render.screen_width;
-            frac += dc_iscale;
+            dest += pitch;
+            frac += iscale;
         }
 
-        if((dot = dc_source[(frac >> FRACBITS) & heightmask]))
-            *dest = dc_sectorcolormap[colormap[dot]];
+        if((dot = source[(frac >> FRACBITS) & heightmask]))
+            *dest = colormap[dot];
     }
 }
 
-void R_DrawFlippedSkyColumn(void)
+void R_DrawFlippedSkyColumn(rendercontext_t* rc)
 {
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac = dc_texturemid + (dc_yl - r_centery) * dc_iscale;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturemid + (rc->dc_yl - r_centery) * iscale;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
     fixed_t i;
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[colormap[dc_source[(i = frac >> FRACBITS) < 128 ? i : 126 - (i & 127)]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        colormap[source[(i = frac >> FRACBITS) < 128 ? i : 126 - (i & 127)]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[colormap[dc_source[(i = frac >> FRACBITS) < 128 ? i : 126 - (i & 127)]]];
+    colormap[source[(i = frac >> FRACBITS) < 128 ? i : 126 - (i & 127)]];
 }
 
-void R_DrawTranslucentBloodColumn(void)
+void R_DrawTranslucentBloodColumn(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const byte* translation            = rc->dc_translation;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tinttab33[(*dest << 8) + colormap[dc_translation[dc_source[frac >> FRACBITS]]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tinttab33[(*dest << 8) + colormap[translation[source[frac >> FRACBITS]]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tinttab33[(*dest << 8) + colormap[dc_translation[dc_source[frac >> FRACBITS]]]]];
+    sectorcolormap[tinttab33[(*dest << 8) + colormap[translation[source[frac >> FRACBITS]]]]];
 }
 
-void R_DrawTranslucentColumn(void)
+void R_DrawTranslucentColumn(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tinttabadditive[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tinttabadditive[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tinttabadditive[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tinttabadditive[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawTranslucent50Column(void)
+void R_DrawTranslucent50Column(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tranmap[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tranmap[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tranmap[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tranmap[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawTranslucent50ColumnWithBrightmap(void)
+void R_DrawTranslucent50ColumnWithBrightmap(rendercontext_t* rc)
 {
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac = dc_texturefrac;
+    const byte* source                 = rc->dc_source;
+    const byte* brightmap              = rc->dc_brightmap;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_colormap[1] };
     byte dot;
 
     while(--count)
     {
-        dot = dc_source[frac >> FRACBITS];
+        dot = source[frac >> FRACBITS];
         *dest =
-        dc_sectorcolormap[tranmap[(*dest << 8) + dc_colormap[dc_brightmap[dot]][dot]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tranmap[(*dest << 8) + colormap[brightmap[dot]][dot]]];
+        dest += pitch;
+        frac += iscale;
     }
 
-    dot = dc_source[frac >> FRACBITS];
+    dot = source[frac >> FRACBITS];
     *dest =
-    dc_sectorcolormap[tranmap[(*dest << 8) + dc_colormap[dc_brightmap[dot]][dot]]];
-}
-
-void R_DrawDitheredTranslucent50ColumnWithBrightmap(void)
-{
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac = dc_texturefrac;
-    const lighttable_t* colormap[2][2] = { { dc_colormap[0], dc_nextcolormap[0] },
+    sectorcolormap[tranmap[(*dest << 8) + colormap[brightmap[dot]][dot]]];
+}
+
+void R_DrawDitheredTranslucent50ColumnWithBrightmap(rendercontext_t* rc)
+{
+    const byte* source                 = rc->dc_source;
+    const byte* brightmap              = rc->dc_brightmap;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2][2] = { { rc->dc_colormap[0], rc->dc_nextcolormap[0] },
         { fullcolormap, fullcolormap } };
     byte dot;
 
     while(--count)
     {
-        dot = dc_source[frac >> FRACBITS];
+        dot = source[frac >> FRACBITS];
         *dest =
-        dc_sectorcolormap[tranmap[(*dest << 8) + colormap[dc_brightmap[dot]][dither(dc_x, dc_yl++, dc_z)][dot]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tranmap[(*dest << 8) + colormap[brightmap[dot]][dither(x, yl++, z)][dot]]];
+        dest += pitch;
+        frac += iscale;
     }
 
-    dot = dc_source[frac >> FRACBITS];
+    dot = source[frac >> FRACBITS];
     *dest =
-    dc_sectorcolormap[tranmap[(*dest << 8) + colormap[dc_brightmap[dot]][dither(dc_x, dc_yl++, dc_z)][dot]]];
-}
-
-void R_DrawLowResDitheredTranslucent50ColumnWithBrightmap(void)
-{
-    int count    = dc_yh - dc_yl + 1;
-    byte* dest   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac = dc_texturefrac;
-    const lighttable_t* colormap[2][2] = { { dc_colormap[0], dc_nextcolormap[0] },
+    sectorcolormap[tranmap[(*dest << 8) + colormap[brightmap[dot]][dither(x, yl++, z)][dot]]];
+}
+
+void R_DrawLowResDitheredTranslucent50ColumnWithBrightmap(rendercontext_t* rc)
+{
+    const byte* source                 = rc->dc_source;
+    const byte* brightmap              = rc->dc_brightmap;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2][2] = { { rc->dc_colormap[0], rc->dc_nextcolormap[0] },
         { fullcolormap, fullcolormap } };
     byte dot;
 
     while(--count)
     {
-        dot = dc_source[frac >> FRACBITS];
+        dot = source[frac >> FRACBITS];
         *dest =
-        dc_sectorcolormap[tranmap[(*dest << 8) + colormap[dc_brightmap[dot]][ditherlow(dc_x, dc_yl++, dc_z)][dot]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tranmap[(*dest << 8) + colormap[brightmap[dot]][ditherlow(x, yl++, z)][dot]]];
+        dest += pitch;
+        frac += iscale;
     }
 
-    dot = dc_source[frac >> FRACBITS];
+    dot = source[frac >> FRACBITS];
     *dest =
-    dc_sectorcolormap[tranmap[(*dest << 8) + colormap[dc_brightmap[dot]][ditherlow(dc_x, dc_yl++, dc_z)][dot]]];
+    sectorcolormap[tranmap[(*dest << 8) + colormap[brightmap[dot]][ditherlow(x, yl++, z)][dot]]];
 }
 
-void R_DrawLowResDitheredTranslucent50Column(void)
+void R_DrawLowResDitheredTranslucent50Column(rendercontext_t* rc)
 {
-    int count                       = dc_yh - dc_yl + 1;
-    byte* dest                      = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                    = dc_texturefrac;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tranmap[(*dest << 8) + colormap[ditherlow(dc_x, dc_yl++, dc_z)][dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tranmap[(*dest << 8) + colormap[ditherlow(x, yl++, z)][source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tranmap[(*dest << 8) + colormap[ditherlow(dc_x, dc_yl, dc_z)][dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tranmap[(*dest << 8) + colormap[ditherlow(x, yl, z)][source[frac >> FRACBITS]]]];
 }
 
-void R_DrawDitheredTranslucent50Column(void)
+void R_DrawDitheredTranslucent50Column(rendercontext_t* rc)
 {
-    int count                       = dc_yh - dc_yl + 1;
-    byte* dest                      = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                    = dc_texturefrac;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tranmap[(*dest << 8) + colormap[dither(dc_x, dc_yl++, dc_z)][dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tranmap[(*dest << 8) + colormap[dither(x, yl++, z)][source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tranmap[(*dest << 8) + colormap[dither(dc_x, dc_yl, dc_z)][dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tranmap[(*dest << 8) + colormap[dither(x, yl, z)][source[frac >> FRACBITS]]]];
 }
 
-void R_DrawCorrectedTranslucent50Column(void)
+void R_DrawCorrectedTranslucent50Column(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tranmap[(*dest << 8) + colormap[nearestcolors[dc_source[frac >> FRACBITS]]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tranmap[(*dest << 8) + colormap[nearestcolors[source[frac >> FRACBITS]]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tranmap[(*dest << 8) + colormap[nearestcolors[dc_source[frac >> FRACBITS]]]]];
+    sectorcolormap[tranmap[(*dest << 8) + colormap[nearestcolors[source[frac >> FRACBITS]]]]];
 }
 
-void R_DrawTranslucent50SolidColorColumn(void)
+void R_DrawTranslucent50SolidColorColumn(rendercontext_t* rc)
 {
-    int count  = dc_yh - dc_yl + 1;
-    byte* dest = ylookup0[dc_yl] + dc_x;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
 
     while(--count)
     {
-        *dest = dc_sectorcolormap[tranmap[(*dest << 8) + NOTEXTURECOLOR]];
-        dest += render.screen_width;
+        *dest = sectorcolormap[tranmap[(*dest << 8) + NOTEXTURECOLOR]];
+        dest += pitch;
     }
 
-    *dest = dc_sectorcolormap[tranmap[(*dest << 8) + NOTEXTURECOLOR]];
+    *dest = sectorcolormap[tranmap[(*dest << 8) + NOTEXTURECOLOR]];
 }
 
-void R_DrawLowResDitheredTranslucent50SolidColorColumn(void)
+void R_DrawLowResDitheredTranslucent50SolidColorColumn(rendercontext_t* rc)
 {
-    int count                       = dc_yh - dc_yl + 1;
-    byte* dest                      = ylookup0[dc_yl] + dc_x;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tranmap[(*dest << 8) + colormap[ditherlow(dc_x, dc_yl++, dc_z)][NOTEXTURECOLOR]]];
-        dest += render.screen_width;
+        sectorcolormap[tranmap[(*dest << 8) + colormap[ditherlow(x, yl++, z)][NOTEXTURECOLOR]]];
+        dest += pitch;
     }
 
     *dest =
-    dc_sectorcolormap[tranmap[(*dest << 8) + colormap[ditherlow(dc_x, dc_yl, dc_z)][NOTEXTURECOLOR]]];
+    sectorcolormap[tranmap[(*dest << 8) + colormap[ditherlow(x, yl, z)][NOTEXTURECOLOR]]];
 }
 
-void R_DrawDitheredTranslucent50SolidColorColumn(void)
+void R_DrawDitheredTranslucent50SolidColorColumn(rendercontext_t* rc)
 {
-    int count                       = dc_yh - dc_yl + 1;
-    byte* dest                      = ylookup0[dc_yl] + dc_x;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tranmap[(*dest << 8) + colormap[dither(dc_x, dc_yl++, dc_z)][NOTEXTURECOLOR]]];
-        dest += render.screen_width;
+        sectorcolormap[tranmap[(*dest << 8) + colormap[dither(x, yl++, z)][NOTEXTURECOLOR]]];
+        dest += pitch;
     }
 
     *dest =
-    dc_sectorcolormap[tranmap[(*dest << 8) + colormap[dither(dc_x, dc_yl, dc_z)][NOTEXTURECOLOR]]];
+    sectorcolormap[tranmap[(*dest << 8) + colormap[dither(x, yl, z)][NOTEXTURECOLOR]]];
 }
 
-void R_DrawTranslucent33Column(void)
+void R_DrawTranslucent33Column(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tinttab33[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tinttab33[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tinttab33[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tinttab33[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawTranslucentRedColumn(void)
+void R_DrawTranslucentRedColumn(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tinttabred[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tinttabred[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tinttabred[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tinttabred[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawTranslucentRedWhiteColumn1(void)
+void R_DrawTranslucentRedWhiteColumn1(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tinttabredwhite1[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tinttabredwhite1[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tinttabredwhite1[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tinttabredwhite1[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawTranslucentRedWhiteColumn2(void)
+void R_DrawTranslucentRedWhiteColumn2(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tinttabredwhite2[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tinttabredwhite2[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tinttabredwhite2[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tinttabredwhite2[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawTranslucentRedWhite50Column(void)
+void R_DrawTranslucentRedWhite50Column(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tinttabredwhite50[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tinttabredwhite50[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tinttabredwhite50[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tinttabredwhite50[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawTranslucentGreenColumn(void)
+void R_DrawTranslucentGreenColumn(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tinttabgreen[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tinttabgreen[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tinttabgreen[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tinttabgreen[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawTranslucentBlueColumn(void)
+void R_DrawTranslucentBlueColumn(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tinttabblue[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tinttabblue[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tinttabblue[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tinttabblue[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawTranslucentRed33Column(void)
+void R_DrawTranslucentRed33Column(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tinttabred33[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tinttabred33[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tinttabred33[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tinttabred33[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawTranslucentGreen33Column(void)
+void R_DrawTranslucentGreen33Column(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tinttabgreen33[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tinttabgreen33[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tinttabgreen33[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tinttabgreen33[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawTranslucentBlue25Column(void)
+void R_DrawTranslucentBlue25Column(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[tinttabblue25[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[tinttabblue25[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[tinttabblue25[(*dest << 8) + colormap[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[tinttabblue25[(*dest << 8) + colormap[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawFuzzColumn(void)
+void R_DrawFuzzColumn(rendercontext_t* rc)
 {
     byte* dest;
     int count;
 
-    if(dc_x & 1)
+    if(rc->dc_x & 1)
         return;
 
-    if(!(count = (dc_yh - dc_yl) / 2))
+    if(!(count = (rc->dc_yh - rc->dc_yl) / 2))
         return;
 
-    dest = ylookup0[dc_yl] + dc_x;
+    dest = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
 
     // top
-    BIGFUZZYPIXEL(6, (fuzz1table[fuzz1pos++] = FUZZ1((dc_yl >= 2 ? -1 : 0), 1)));
+    BIGFUZZYPIXEL(6, (fuzz1table[rc->fuzz1pos++] = VIEWFUZZ1((rc->dc_yl >= 2 ? -1 : 0), 1)));
 
-    dest += render.screen_width * 2;
+    dest += rowpitch * 2;
 
     while(--count)
     {
         // middle
-        BIGFUZZYPIXEL(6, (fuzz1table[fuzz1pos++] = FUZZ1(-1, 1)));
-        dest += render.screen_width * 2;
+        BIGFUZZYPIXEL(6, (fuzz1table[rc->fuzz1pos++] = VIEWFUZZ1(-1, 1)));
+        dest += rowpitch * 2;
     }
 
     // bottom
-    if(dc_yl & 1)
-        HALFBIGFUZZYPIXEL(5, (fuzz1table[fuzz1pos++] = FUZZ1(-1, 0)));
+    if(rc->dc_yl & 1)
+        HALFBIGFUZZYPIXEL(5, (fuzz1table[rc->fuzz1pos++] = VIEWFUZZ1(-1, 0)));
     else
-        BIGFUZZYPIXEL(5, (fuzz1table[fuzz1pos++] = FUZZ1(-1, 0)));
+        BIGFUZZYPIXEL(5, (fuzz1table[rc->fuzz1pos++] = VIEWFUZZ1(-1, 0)));
 }
 
-void R_DrawFuzzColumns(void)
+//
+// R_SkipFuzzColumn
+// Takes the same fuzz as R_DrawFuzzColumn() would without drawing anything, for
+// the columns of a sprite outside the calling thread's strip, so every strip
+// carries on from where a single thread would have.
+//
+void R_SkipFuzzColumn(rendercontext_t* rc)
 {
+    int count;
+
+    if(rc->dc_x & 1)
+        return;
+
+    if(!(count = (rc->dc_yh - rc->dc_yl) / 2))
+        return;
+
+    fuzz1table[rc->fuzz1pos++] = VIEWFUZZ1((rc->dc_yl >= 2 ? -1 : 0), 1);
+
+    while(--count)
+        fuzz1table[rc->fuzz1pos++] = VIEWFUZZ1(-1, 1);
+
+    fuzz1table[rc->fuzz1pos++] = VIEWFUZZ1(-1, 0);
+}
+
+//
+// R_DrawFuzzColumns
+// Every strip scans the whole view so that it takes the same fuzz as a single
+// thread would, but only draws the pixels in its own strip.
+//
+void R_DrawFuzzColumns(rendercontext_t* rc)
+{
+    const int left   = render.view_window_x + r_stripleft;
+    const int right  = render.view_window_x + r_stripright + 1;
     const int width  = render.view_window_x + render.view_width;
-    const int height = (render.view_window_y + render.view_height) * render.screen_width;
+    const int bottom = render.view_window_y + render.view_height;
 
-    for(int y = render.view_window_y * render.screen_width; y < height; y += render.screen_width * 2)
-        for(int x = render.view_window_x + y; x < width + y; x += 2)
+    for(int y = render.view_window_y; y < bottom; y += 2)
+        for(int x = render.view_window_x; x < width; x += 2)
         {
-            const byte* source = r_screens[1] + x;
+            const int offset   = y * rowpitch + x * columnpitch;
+            const byte* source = r_screens[1] + offset;
 
             if(*source != NOFUZZ)
             {
-                byte* dest = r_screens[0] + x;
-
-                if(y == height - render.screen_width * 2)
-                    BIGFUZZYPIXEL(5, (fuzz2table[fuzz2pos++] = FUZZ2(-1, 0)));
-                else if(y >= render.screen_width * 2 && *(source - render.screen_width * 2) == NOFUZZ)
-                    BIGFUZZYPIXEL(8, (fuzz2table[fuzz2pos++] = FUZZ2(-1, 1)));
-                else
-                    BIGFUZZYPIXEL(6,
-                    (fuzz2table[fuzz2pos++] = FUZZ2((y >= render.screen_width * 2 ? -1 : 0), 1)));
+                const int fuzz = (fuzz2table[rc->fuzz2pos++] =
+                    (y == bottom - 2 ? VIEWFUZZ2(-1, 0) : VIEWFUZZ2((y >= 2 ? -1 : 0), 1)));
+
+                if(x >= left && x < right)
+                {
+                    byte* dest = r_screens[0] + offset;
+
+                    if(y == bottom - 2)
+                        BIGFUZZYPIXEL(5, fuzz);
+                    else if(y >= 2 && *(source - rowpitch * 2) == NOFUZZ)
+                        BIGFUZZYPIXEL(8, fuzz);
+                    else
+                        BIGFUZZYPIXEL(6, fuzz);
+                }
             }
         }
 }
@@ -1289,60 +1553,81 @@ void R_DrawFuzzColumns(void)
 //
 byte translationtables[256 * 3];
 
-void R_DrawTranslatedColumn(void)
+void R_DrawTranslatedColumn(rendercontext_t* rc)
 {
-    int count                    = dc_yh - dc_yl + 1;
-    byte* dest                   = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                 = dc_texturefrac;
-    const lighttable_t* colormap = dc_colormap[0];
+    const byte* source                 = rc->dc_source;
+    const byte* translation            = rc->dc_translation;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - rc->dc_yl + 1;
+    byte* dest                         = ylookup0[rc->dc_yl] + columnofs[rc->dc_x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap       = rc->dc_colormap[0];
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[colormap[dc_translation[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[colormap[translation[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
-    *dest = dc_sectorcolormap[colormap[dc_translation[dc_source[frac >> FRACBITS]]]];
+    *dest = sectorcolormap[colormap[translation[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawDitherLowTranslatedColumn(void)
+void R_DrawDitherLowTranslatedColumn(rendercontext_t* rc)
 {
-    int count                       = dc_yh - dc_yl + 1;
-    byte* dest                      = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                    = dc_texturefrac;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
+    const byte* source                 = rc->dc_source;
+    const byte* translation            = rc->dc_translation;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[colormap[ditherlow(dc_x, dc_yl++, dc_z)][dc_translation[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[colormap[ditherlow(x, yl++, z)][translation[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[colormap[ditherlow(dc_x, dc_yl, dc_z)][dc_translation[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[colormap[ditherlow(x, yl, z)][translation[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawDitherTranslatedColumn(void)
+void R_DrawDitherTranslatedColumn(rendercontext_t* rc)
 {
-    int count                       = dc_yh - dc_yl + 1;
-    byte* dest                      = ylookup0[dc_yl] + dc_x;
-    fixed_t frac                    = dc_texturefrac;
-    const lighttable_t* colormap[2] = { dc_colormap[0], dc_nextcolormap[0] };
+    const byte* source                 = rc->dc_source;
+    const byte* translation            = rc->dc_translation;
+    const lighttable_t* sectorcolormap = rc->dc_sectorcolormap;
+    const fixed_t iscale               = rc->dc_iscale;
+    const int x                        = rc->dc_x;
+    int yl                             = rc->dc_yl;
+    const int z                        = rc->dc_z;
+    const int pitch                    = rowpitch;
+    int count                          = rc->dc_yh - yl + 1;
+    byte* dest                         = ylookup0[yl] + columnofs[x];
+    fixed_t frac                       = rc->dc_texturefrac;
+    const lighttable_t* colormap[2]    = { rc->dc_colormap[0], rc->dc_nextcolormap[0] };
 
     while(--count)
     {
         *dest =
-        dc_sectorcolormap[colormap[dither(dc_x, dc_yl++, dc_z)][dc_translation[dc_source[frac >> FRACBITS]]]];
-        dest += render.screen_width;
-        frac += dc_iscale;
+        sectorcolormap[colormap[dither(x, yl++, z)][translation[source[frac >> FRACBITS]]]];
+        dest += pitch;
+        frac += iscale;
     }
 
     *dest =
-    dc_sectorcolormap[colormap[dither(dc_x, dc_yl, dc_z)][dc_translation[dc_source[frac >> FRACBITS]]]];
+    sectorcolormap[colormap[dither(x, yl, z)][translation[source[frac >> FRACBITS]]]];
 }
 
 //
@@ -1372,6 +1657,25 @@ void R_InitTranslationTables(void)
         }
 }
 
+//
+// R_DrawSpanBlocks
+// Hands the whole blocks of a span to the vectorized drawer, always leaving at
+// least one pixel for the caller's own loop to finish the span with.
+//
+static int R_DrawSpanBlocks(byte* dest, int count, const byte* source,
+    const lighttable_t* const* colormaps, bool dithered,
+    fixed_t* xfrac, fixed_t* yfrac, fixed_t xstep, fixed_t ystep)
+{
+    const int pixels = (count - 1) / SPANBLOCK * SPANBLOCK;
+
+    spanblocksfunc(dest, pixels / SPANBLOCK, source, colormaps, dithered,
+        *xfrac, *yfrac, xstep, ystep);
+    *xfrac = (fixed_t)((uint32_t)*xfrac + (uint32_t)pixels * (uint32_t)xstep);
+    *yfrac = (fixed_t)((uint32_t)*yfrac + (uint32_t)pixels * (uint32_t)ystep);
+
+    return pixels;
+}
+
 //
 // R_DrawSpan
 // With DOOM style restrictions on view orientation,
@@ -1384,82 +1688,123 @@ void R_InitTranslationTables(void)
 // In consequence, flats are not stored by column (like walls),
 //  and the inner loop has to step in texture space u and v.
 //
-int ds_x1;
-int ds_x2;
-int ds_y;
-int ds_z;
-
-lighttable_t* ds_colormap[2];
-lighttable_t* ds_sectorcolormap;
-
-fixed_t ds_xfrac;
-fixed_t ds_yfrac;
-fixed_t ds_xstep;
-fixed_t ds_ystep;
+void R_DrawSpan(rendercontext_t* rc)
+{
+    const byte* source                 = rc->ds_source;
+    fixed_t xfrac                      = rc->ds_xfrac;
+    fixed_t yfrac                      = rc->ds_yfrac;
+    const fixed_t xstep                = rc->ds_xstep;
+    const fixed_t ystep                = rc->ds_ystep;
+    int count                          = rc->ds_x2 - rc->ds_x1;
+    byte* dest                         = SPANDEST(rc->ds_y, rc->ds_x1);
+    const lighttable_t* colormap       = rc->ds_colormap[0];
 
-// start of a 64x64 tile image
-byte* ds_source;
+    if(spanblocksfunc && count > SPANBLOCK)
+    {
+        const int pixels =
+        R_DrawSpanBlocks(dest, count, source, &colormap, false, &xfrac, &yfrac, xstep, ystep);
 
-//
-// Draws the actual span.
-//
-void R_DrawSpan(void)
-{
-    int count                    = ds_x2 - ds_x1;
-    byte* dest                   = ylookup0[ds_y] + ds_x1;
-    const lighttable_t* colormap = ds_colormap[0];
+        dest += pixels;
+        count -= pixels;
+    }
 
     while(--count)
     {
         *dest++ =
-        ds_sectorcolormap[colormap[ds_source[((ds_xfrac >> 16) & 63) | ((ds_yfrac >> 10) & 4032)]]];
-        ds_xfrac += ds_xstep;
-        ds_yfrac += ds_ystep;
+        colormap[source[((xfrac >> 16) & 63) | ((yfrac >> 10) & 4032)]];
+        xfrac += xstep;
+        yfrac += ystep;
     }
 
     *dest =
-    ds_sectorcolormap[colormap[ds_source[((ds_xfrac >> 16) & 63) | ((ds_yfrac >> 10) & 4032)]]];
+    colormap[source[((xfrac >> 16) & 63) | ((yfrac >> 10) & 4032)]];
 }
 
-void R_DrawLowResDitheredSpan(void)
+void R_DrawLowResDitheredSpan(rendercontext_t* rc)
 {
-    int count  = ds_x2 - ds_x1;
-    byte* dest = ylookup0[ds_y] + ds_x1;
+    const byte* source                 = rc->ds_source;
+    fixed_t xfrac                      = rc->ds_xfrac;
+    fixed_t yfrac                      = rc->ds_yfrac;
+    const fixed_t xstep                = rc->ds_xstep;
+    const fixed_t ystep                = rc->ds_ystep;
+    int x1                             = rc->ds_x1;
+    const int y                        = rc->ds_y;
+    const int z                        = rc->ds_z;
+    int count                          = rc->ds_x2 - x1;
+    byte* dest                         = SPANDEST(y, x1);
+    const lighttable_t* colormap[2]    = { rc->ds_colormap[0], rc->ds_colormap[1] };
+
+    if(spanblocksfunc && count > SPANBLOCK)
+    {
+        const lighttable_t* colormaps[SPANBLOCK];
+        int                 pixels;
+
+        for(int i = 0; i < SPANBLOCK; i++)
+            colormaps[i] = colormap[ditherlow(x1 + i, y, z)];
+
+        pixels = R_DrawSpanBlocks(dest, count, source, colormaps, true, &xfrac, &yfrac, xstep, ystep);
+        dest += pixels;
+        x1 += pixels;
+        count -= pixels;
+    }
 
     while(--count)
     {
-        *dest++ = ds_sectorcolormap[ds_colormap[ditherlow(ds_x1++, ds_y,
-        ds_z)][ds_source[((ds_xfrac >> 16) & 63) | ((ds_yfrac >> 10) & 4032)]]];
-        ds_xfrac += ds_xstep;
-        ds_yfrac += ds_ystep;
+        *dest++ = colormap[ditherlow(x1++, y,
+        z)][source[((xfrac >> 16) & 63) | ((yfrac >> 10) & 4032)]];
+        xfrac += xstep;
+        yfrac += ystep;
     }
 
-    *dest = ds_sectorcolormap[ds_colormap[ditherlow(ds_x1, ds_y,
-    ds_z)][ds_source[((ds_xfrac >> 16) & 63) | ((ds_yfrac >> 10) & 4032)]]];
+    *dest = colormap[ditherlow(x1, y,
+    z)][source[((xfrac >> 16) & 63) | ((yfrac >> 10) & 4032)]];
 }
 
-void R_DrawDitheredSpan(void)
+void R_DrawDitheredSpan(rendercontext_t* rc)
 {
-    int count  = ds_x2 - ds_x1;
-    byte* dest = ylookup0[ds_y] + ds_x1;
+    const byte* source                 = rc->ds_source;
+    fixed_t xfrac                      = rc->ds_xfrac;
+    fixed_t yfrac                      = rc->ds_yfrac;
+    const fixed_t xstep                = rc->ds_xstep;
+    const fixed_t ystep                = rc->ds_ystep;
+    int x1                             = rc->ds_x1;
+    const int y                        = rc->ds_y;
+    const int z                        = rc->ds_z;
+    int count                          = rc->ds_x2 - x1;
+    byte* dest                         = SPANDEST(y, x1);
+    const lighttable_t* colormap[2]    = { rc->ds_colormap[0], rc->ds_colormap[1] };
+
+    if(spanblocksfunc && count > SPANBLOCK)
+    {
+        const lighttable_t* colormaps[SPANBLOCK];
+        int                 pixels;
+
+        for(int i = 0; i < SPANBLOCK; i++)
+            colormaps[i] = colormap[dither(x1 + i, y, z)];
+
+        pixels = R_DrawSpanBlocks(dest, count, source, colormaps, true, &xfrac, &yfrac, xstep, ystep);
+        dest += pixels;
+        x1 += pixels;
+        count -= pixels;
+    }
 
     while(--count)
     {
-        *dest++ = ds_sectorcolormap[ds_colormap[dither(ds_x1++, ds_y,
-        ds_z)][ds_source[((ds_xfrac >> 16) & 63) | ((ds_yfrac >> 10) & 4032)]]];
-        ds_xfrac += ds_xstep;
-        ds_yfrac += ds_ystep;
+        *dest++ = colormap[dither(x1++, y,
+        z)][source[((xfrac >> 16) & 63) | ((yfrac >> 10) & 4032)]];
+        xfrac += xstep;
+        yfrac += ystep;
     }
 
-    *dest = ds_sectorcolormap[ds_colormap[dither(ds_x1, ds_y,
-    ds_z)][ds_source[((ds_xfrac >> 16) & 63) | ((ds_yfrac >> 10) & 4032)]]];
+    *dest = colormap[dither(x1, y,
+    z)][source[((xfrac >> 16) & 63) | ((yfrac >> 10) & 4032)]];
 }
 
-void R_DrawSolidColorSpan(void)
+void R_DrawSolidColorSpan(rendercontext_t* rc)
 {
-    int count        = ds_x2 - ds_x1;
-    byte* dest       = ylookup0[ds_y] + ds_x1;
-    const byte color = ds_sectorcolormap[ds_colormap[0][NOTEXTURECOLOR]];
+    int count        = rc->ds_x2 - rc->ds_x1;
+    byte* dest       = SPANDEST(rc->ds_y, rc->ds_x1);
+    const byte color = rc->ds_colormap[0][NOTEXTURECOLOR];
 
     while(--count)
         *dest++ = color;
@@ -1467,51 +1812,124 @@ void R_DrawSolidColorSpan(void)
     *dest = color;
 }
 
-void R_DrawLowResDitheredSolidColorSpan(void)
+void R_DrawLowResDitheredSolidColorSpan(rendercontext_t* rc)
 {
-    int count  = ds_x2 - ds_x1;
-    byte* dest = ylookup0[ds_y] + ds_x1;
+    int x1                             = rc->ds_x1;
+    const int y                        = rc->ds_y;
+    const int z                        = rc->ds_z;
+    int count                          = rc->ds_x2 - x1;
+    byte* dest                         = SPANDEST(y, x1);
+    const lighttable_t* colormap[2]    = { rc->ds_colormap[0], rc->ds_colormap[1] };
 
     while(--count)
-        *dest++ =
-        ds_sectorcolormap[ds_colormap[ditherlow(ds_x1++, ds_y, ds_z)][NOTEXTURECOLOR]];
+        *dest++ = colormap[ditherlow(x1++, y, z)][NOTEXTURECOLOR];
 
-    *dest = ds_sectorcolormap[ds_colormap[ditherlow(ds_x1, ds_y, ds_z)][NOTEXTURECOLOR]];
+    *dest = colormap[ditherlow(x1, y, z)][NOTEXTURECOLOR];
 }
 
-void R_DrawDitheredSolidColorSpan(void)
+void R_DrawDitheredSolidColorSpan(rendercontext_t* rc)
 {
-    int count  = ds_x2 - ds_x1;
-    byte* dest = ylookup0[ds_y] + ds_x1;
+    int x1                             = rc->ds_x1;
+    const int y                        = rc->ds_y;
+    const int z                        = rc->ds_z;
+    int count                          = rc->ds_x2 - x1;
+    byte* dest                         = SPANDEST(y, x1);
+    const lighttable_t* colormap[2]    = { rc->ds_colormap[0], rc->ds_colormap[1] };
 
     while(--count)
-        *dest++ =
-        ds_sectorcolormap[ds_colormap[dither(ds_x1++, ds_y, ds_z)][NOTEXTURECOLOR]];
+        *dest++ = colormap[dither(x1++, y, z)][NOTEXTURECOLOR];
 
-    *dest = ds_sectorcolormap[ds_colormap[dither(ds_x1, ds_y, ds_z)][NOTEXTURECOLOR]];
+    *dest = colormap[dither(x1, y, z)][NOTEXTURECOLOR];
+}
+
+//
+// R_TransposeSpan
+// Copies a span drawn into spanrow into the view, when it's column-major.
+//
+void R_TransposeSpan(const rendercontext_t* rc)
+{
+    const byte* source = spanrow + rc->ds_x1;
+    byte* dest         = ylookup0[rc->ds_y] + columnofs[rc->ds_x1];
+    const int pitch    = columnpitch;
+    int count          = rc->ds_x2 - rc->ds_x1;
+
+    while(--count)
+    {
+        *dest = *source++;
+        dest += pitch;
+    }
+
+    *dest = *source;
 }
 
 //
 // R_InitBuffer
+// When r_columnmajor is set, r_screens is laid out a column at a time, so the
+// column drawers write to consecutive bytes. i_app.c then samples the level
+// texture transposed.
 //
 void R_InitBuffer(void)
 {
-    const int end = (render.view_window_y + render.view_height) * render.screen_width + render.view_window_x + render.view_width;
+    rowpitch    = (r_columnmajor ? 1 : render.screen_width);
+    columnpitch = (r_columnmajor ? render.screen_height : 1);
 
-    for(int i = 0, y = render.view_window_y * render.screen_width + render.view_window_x; y < end; i++, y += render.screen_width)
+    for(int i = 0; i < render.view_height; i++)
     {
+        const int y = (render.view_window_y + i) * rowpitch + render.view_window_x * columnpitch;
+
         ylookup0[i] = r_screens[0] + y;
         ylookup1[i] = r_screens[1] + y;
     }
 
+    // A player sprite may be drawn a column past the right of the view.
+    for(int i = 0; i <= render.view_width; i++)
+        columnofs[i] = i * columnpitch;
+
     fuzzrange[0] = -render.screen_width * 2;
     fuzzrange[1] = 0;
     fuzzrange[2] = render.screen_width * 2;
 
+    viewfuzzrange[0] = -rowpitch * 2;
+    viewfuzzrange[1] = 0;
+    viewfuzzrange[2] = rowpitch * 2;
+
     memset(fuzz1table, 0, render.max_screen_area);
     memset(fuzz2table, 0, render.max_screen_area);
 }
 
+//
+// R_ResizeDrawStripBuffers
+// Allocates or reallocates the span row each render thread keeps for itself,
+// and the fuzz tables of every render thread but the main one.
+// Called by each render thread before it draws its strip.
+//
+void R_ResizeDrawStripBuffers(void)
+{
+    if(r_strip && fuzztablesize != r_alloc_max_screen_area)
+    {
+        if(fuzz1table) free(fuzz1table);
+        if(fuzz2table) free(fuzz2table);
+
+        fuzz1table = calloc(r_alloc_max_screen_area, sizeof(int));
+        fuzz2table = calloc(r_alloc_max_screen_area, sizeof(int));
+
+        if(!fuzz1table || !fuzz2table)
+            I_Error("R_ResizeDrawStripBuffers: Failed to allocate fuzz tables");
+
+        fuzztablesize = r_alloc_max_screen_area;
+    }
+
+    if(spanrow && spanrowsize == r_alloc_max_width)
+        return;
+
+    if(spanrow) free(spanrow);
+
+    if(!(spanrow = calloc(r_alloc_max_width, 1)))
+        I_Error("R_ResizeDrawStripBuffers: Failed to allocate span row");
+
+    spanrowsize = r_alloc_max_width;
+}
+
 void R_FillBezel(void)
 {
     byte* dest = &v_screens[0][(video.screen_height - V_SBARHEIGHT) * video.screen_width];
@@ -1629,6 +2047,7 @@ void R_DrawViewBorder(void)
 // Buffer sizes:
 //   fuzz1table, fuzz2table: r_alloc_max_screen_area elements
 //   ylookup0, ylookup1: r_alloc_max_height elements
+//   columnofs: r_alloc_max_width + 1 elements
 //
 void R_ResizeDrawBuffers(void)
 {
@@ -1637,14 +2056,17 @@ void R_ResizeDrawBuffers(void)
     if(fuzz2table) free(fuzz2table);
     if(ylookup0) free(ylookup0);
     if(ylookup1) free(ylookup1);
+    if(columnofs) free(columnofs);
 
     // Allocate new buffers
     fuzz1table = calloc(r_alloc_max_screen_area, sizeof(int));
     fuzz2table = calloc(r_alloc_max_screen_area, sizeof(int));
+    fuzztablesize = r_alloc_max_screen_area;
     ylookup0 = calloc(r_alloc_max_height, sizeof(byte*));
     ylookup1 = calloc(r_alloc_max_height, sizeof(byte*));
+    columnofs = calloc(r_alloc_max_width + 1, sizeof(int));
 
     // Verify allocations succeeded
-    if(!fuzz1table || !fuzz2table || !ylookup0 || !ylookup1)
+    if(!fuzz1table || !fuzz2table || !ylookup0 || !ylookup1 || !columnofs)
         I_Error("R_ResizeDrawBuffers: Failed to allocate draw buffers");
 }
@@ -40,134 +40,158 @@
 #define FUZZ1(a, b) fuzzrange[M_Fuzz1RandomInt(a, b) + 1]
 #define FUZZ2(a, b) fuzzrange[M_Fuzz2RandomInt(a, b) + 1]
 #define BIGFUZZYPIXEL(a, b)                                                   \
-    *dest = *(dest + 1) = *(dest + render.screen_width) = *(dest + render.screen_width + 1) = \
+    *dest = *(dest + columnpitch) = *(dest + rowpitch) = *(dest + rowpitch + columnpitch) = \
     fullcolormap[(a) * 256 + dest[b]]
 #define HALFBIGFUZZYPIXEL(a, b) \
-    *dest = *(dest + 1) = fullcolormap[(a) * 256 + dest[b]]
+    *dest = *(dest + columnpitch) = fullcolormap[(a) * 256 + dest[b]]
 
 #define NOTEXTURECOLOR nearestcolors[LIGHTGRAY1]
 
-extern lighttable_t* dc_colormap[2];
-extern lighttable_t* dc_nextcolormap[2];
-extern lighttable_t* dc_sectorcolormap;
-extern int dc_x;
-extern int dc_yl;
-extern int dc_yh;
-extern int dc_z;
-extern fixed_t dc_iscale;
-extern fixed_t dc_texturemid;
-extern fixed_t dc_texheight;
-extern fixed_t dc_texturefrac;
-extern byte dc_solidbloodcolor;
-extern byte* dc_bloodcolor;
-extern byte* dc_brightmap;
-extern int dc_floorclip;
-extern int dc_ceilingclip;
-extern int dc_numposts;
-extern byte dc_black;
-extern byte* dc_black33;
-extern byte* dc_black40;
-
-// first pixel in a column
-extern byte* dc_source;
-
-extern int fuzz1pos;
-extern int fuzz2pos;
+//
+// The parameters of the column and span drawers. Each thread rendering part
+// of the view has its own context, which it passes to every drawer it calls.
+//
+typedef struct rendercontext_s
+{
+    // column drawers. The wall and sky drawers expect dc_colormap,
+    // dc_nextcolormap and dc_brightcolormap to already have the sector
+    // colormap applied, and ignore dc_sectorcolormap.
+    lighttable_t*   dc_colormap[2];
+    lighttable_t*   dc_nextcolormap[2];
+    lighttable_t*   dc_sectorcolormap;
+    lighttable_t*   dc_brightcolormap;
+    int             dc_x;
+    int             dc_yl;
+    int             dc_yh;
+    int             dc_z;
+    fixed_t         dc_iscale;
+    fixed_t         dc_texturemid;
+    fixed_t         dc_texheight;
+    fixed_t         dc_texturefrac;
+    byte            dc_solidbloodcolor;
+    byte*           dc_bloodcolor;
+    byte*           dc_brightmap;
+    int             dc_floorclip;
+    int             dc_ceilingclip;
+    int             dc_numposts;
+    byte            dc_black;
+    byte*           dc_black33;
+    byte*           dc_black40;
+    byte*           dc_translation;
+
+    // first pixel in a column
+    byte*           dc_source;
+
+    // span drawers. ds_colormap has the sector colormap applied, taken from
+    // the fused light tables in ds_fusedcolormap.
+    int             ds_x1;
+    int             ds_x2;
+    int             ds_y;
+    int             ds_z;
+    lighttable_t*   ds_colormap[2];
+    lighttable_t*   ds_fusedcolormap;
+    fixed_t         ds_xfrac;
+    fixed_t         ds_yfrac;
+    fixed_t         ds_xstep;
+    fixed_t         ds_ystep;
+
+    // start of a 64x64 tile image
+    byte*           ds_source;
+
+    // positions in the fuzz tables
+    int             fuzz1pos;
+    int             fuzz2pos;
+
+    // drawer of the current masked seg or sprite
+    void            (*colfunc)(struct rendercontext_s* rc);
+} rendercontext_t;
+
+// Distances between vertically and horizontally adjacent pixels in
+// r_screens, which are swapped when r_columnmajor is set
+extern int rowpitch;
+extern int columnpitch;
+
 extern int fuzzrange[3];
-extern int* fuzz1table;
-extern int* fuzz2table;
+extern THREADLOCAL int* fuzz1table;
+extern THREADLOCAL int* fuzz2table;
 
 // The span blitting interface.
 // Hook in assembler or system specific BLT here.
-void R_DrawColumn(void);
-void R_DrawColumnWithBrightmap(void);
-void R_DrawLowResDitheredColumn(void);
-void R_DrawDitheredColumn(void);
-void R_DrawCorrectedColumn(void);
-void R_DrawCorrectedLowResDitheredColumn(void);
-void R_DrawCorrectedDitheredColumn(void);
-void R_DrawSolidColorColumn(void);
-void R_DrawWallColumn(void);
-void R_DrawLowResDitheredWallColumn(void);
-void R_DrawDitheredWallColumn(void);
-void R_DrawWallColumnWithBrightmap(void);
-void R_DrawLowResDitheredColumnWithBrightmap(void);
-void R_DrawDitheredColumnWithBrightmap(void);
-void R_DrawLowResDitheredWallColumnWithBrightmap(void);
-void R_DrawDitheredWallColumnWithBrightmap(void);
-void R_DrawLowResDitheredSolidColorColumn(void);
-void R_DrawDitheredSolidColorColumn(void);
-void R_DrawSkyColumn(void);
-void R_DrawFlippedSkyColumn(void);
-void R_DrawTranslucentColumn(void);
-void R_DrawTranslucent50Column(void);
-void R_DrawLowResDitheredTranslucent50Column(void);
-void R_DrawDitheredTranslucent50Column(void);
-void R_DrawTranslucent50ColumnWithBrightmap(void);
-void R_DrawDitheredTranslucent50ColumnWithBrightmap(void);
-void R_DrawLowResDitheredTranslucent50ColumnWithBrightmap(void);
-void R_DrawCorrectedTranslucent50Column(void);
-void R_DrawTranslucent50SolidColorColumn(void);
-void R_DrawLowResDitheredTranslucent50SolidColorColumn(void);
-void R_DrawDitheredTranslucent50SolidColorColumn(void);
-void R_DrawTranslucent33Column(void);
-void R_DrawTranslucentGreenColumn(void);
-void R_DrawTranslucentRedColumn(void);
-void R_DrawTranslucentRedWhiteColumn1(void);
-void R_DrawTranslucentRedWhiteColumn2(void);
-void R_DrawTranslucentRedWhite50Column(void);
-void R_DrawTranslucentBlueColumn(void);
-void R_DrawTranslucentGreen33Column(void);
-void R_DrawTranslucentRed33Column(void);
-void R_DrawTranslucentBlue25Column(void);
-void R_DrawPlayerSpriteColumn(void);
-void R_DrawShadowColumn(void);
-void R_DrawSolidShadowColumn(void);
-void R_DrawTranslucentBloodColumn(void);
-void R_DrawBloodSplatColumn(void);
-void R_DrawSolidBloodSplatColumn(void);
+void R_DrawColumn(rendercontext_t* rc);
+void R_DrawColumnWithBrightmap(rendercontext_t* rc);
+void R_DrawLowResDitheredColumn(rendercontext_t* rc);
+void R_DrawDitheredColumn(rendercontext_t* rc);
+void R_DrawCorrectedColumn(rendercontext_t* rc);
+void R_DrawCorrectedLowResDitheredColumn(rendercontext_t* rc);
+void R_DrawCorrectedDitheredColumn(rendercontext_t* rc);
+void R_DrawSolidColorColumn(rendercontext_t* rc);
+void R_DrawWallColumn(rendercontext_t* rc);
+void R_DrawLowResDitheredWallColumn(rendercontext_t* rc);
+void R_DrawDitheredWallColumn(rendercontext_t* rc);
+void R_DrawWallColumnWithBrightmap(rendercontext_t* rc);
+void R_DrawLowResDitheredColumnWithBrightmap(rendercontext_t* rc);
+void R_DrawDitheredColumnWithBrightmap(rendercontext_t* rc);
+void R_DrawLowResDitheredWallColumnWithBrightmap(rendercontext_t* rc);
+void R_DrawDitheredWallColumnWithBrightmap(rendercontext_t* rc);
+void R_DrawLowResDitheredSolidColorColumn(rendercontext_t* rc);
+void R_DrawDitheredSolidColorColumn(rendercontext_t* rc);
+void R_DrawSkyColumn(rendercontext_t* rc);
+void R_DrawFlippedSkyColumn(rendercontext_t* rc);
+void R_DrawTranslucentColumn(rendercontext_t* rc);
+void R_DrawTranslucent50Column(rendercontext_t* rc);
+void R_DrawLowResDitheredTranslucent50Column(rendercontext_t* rc);
+void R_DrawDitheredTranslucent50Column(rendercontext_t* rc);
+void R_DrawTranslucent50ColumnWithBrightmap(rendercontext_t* rc);
+void R_DrawDitheredTranslucent50ColumnWithBrightmap(rendercontext_t* rc);
+void R_DrawLowResDitheredTranslucent50ColumnWithBrightmap(rendercontext_t* rc);
+void R_DrawCorrectedTranslucent50Column(rendercontext_t* rc);
+void R_DrawTranslucent50SolidColorColumn(rendercontext_t* rc);
+void R_DrawLowResDitheredTranslucent50SolidColorColumn(rendercontext_t* rc);
+void R_DrawDitheredTranslucent50SolidColorColumn(rendercontext_t* rc);
+void R_DrawTranslucent33Column(rendercontext_t* rc);
+void R_DrawTranslucentGreenColumn(rendercontext_t* rc);
+void R_DrawTranslucentRedColumn(rendercontext_t* rc);
+void R_DrawTranslucentRedWhiteColumn1(rendercontext_t* rc);
+void R_DrawTranslucentRedWhiteColumn2(rendercontext_t* rc);
+void R_DrawTranslucentRedWhite50Column(rendercontext_t* rc);
+void R_DrawTranslucentBlueColumn(rendercontext_t* rc);
+void R_DrawTranslucentGreen33Column(rendercontext_t* rc);
+void R_DrawTranslucentRed33Column(rendercontext_t* rc);
+void R_DrawTranslucentBlue25Column(rendercontext_t* rc);
+void R_DrawPlayerSpriteColumn(rendercontext_t* rc);
+void R_DrawShadowColumn(rendercontext_t* rc);
+void R_DrawSolidShadowColumn(rendercontext_t* rc);
+void R_DrawTranslucentBloodColumn(rendercontext_t* rc);
+void R_DrawBloodSplatColumn(rendercontext_t* rc);
+void R_DrawSolidBloodSplatColumn(rendercontext_t* rc);
 
 // The spectre/invisibility effect.
-void R_DrawFuzzColumn(void);
-void R_DrawFuzzColumns(void);
-void R_DrawFuzzyShadowColumn(void);
+void R_DrawFuzzColumn(rendercontext_t* rc);
+void R_DrawFuzzColumns(rendercontext_t* rc);
+void R_SkipFuzzColumn(rendercontext_t* rc);
+void R_DrawFuzzyShadowColumn(rendercontext_t* rc);
 
 // Draw with color translation tables,
 //  for player sprite rendering,
 //  green/red/blue/indigo shirts.
-void R_DrawTranslatedColumn(void);
-void R_DrawDitherLowTranslatedColumn(void);
-void R_DrawDitherTranslatedColumn(void);
+void R_DrawTranslatedColumn(rendercontext_t* rc);
+void R_DrawDitherLowTranslatedColumn(rendercontext_t* rc);
+void R_DrawDitherTranslatedColumn(rendercontext_t* rc);
 
 void R_VideoErase(unsigned int offset, int count);
 
-extern int ds_x1;
-extern int ds_x2;
-extern int ds_y;
-extern int ds_z;
-
-extern lighttable_t* ds_colormap[2];
-extern lighttable_t* ds_sectorcolormap;
-
-extern fixed_t ds_xfrac;
-extern fixed_t ds_yfrac;
-extern fixed_t ds_xstep;
-extern fixed_t ds_ystep;
-
-// start of a 64x64 tile image
-extern byte* ds_source;
-
 extern byte translationtables[256 * 3];
-extern byte* dc_translation;
 
 // Span blitting for rows, floor/ceiling.
 // No Spectre effect needed.
-void R_DrawSpan(void);
-void R_DrawLowResDitheredSpan(void);
-void R_DrawDitheredSpan(void);
-void R_DrawSolidColorSpan(void);
-void R_DrawLowResDitheredSolidColorSpan(void);
-void R_DrawDitheredSolidColorSpan(void);
+void R_DrawSpan(rendercontext_t* rc);
+void R_DrawLowResDitheredSpan(rendercontext_t* rc);
+void R_DrawDitheredSpan(rendercontext_t* rc);
+void R_DrawSolidColorSpan(rendercontext_t* rc);
+void R_DrawLowResDitheredSolidColorSpan(rendercontext_t* rc);
+void R_DrawDitheredSolidColorSpan(rendercontext_t* rc);
+
+void R_TransposeSpan(const rendercontext_t* rc);
 
 void R_InitBuffer(void);
 
@@ -184,3 +208,4 @@ void R_FillBackScreen(void);
 void R_DrawViewBorder(void);
 
 void R_ResizeDrawBuffers(void);
+void R_ResizeDrawStripBuffers(void);
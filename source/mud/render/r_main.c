@@ -40,6 +40,7 @@
 #include "doom/d_deh.h"
 #include "doom/doomstat.h"
 #include "math/math_colors.h"
+#include "system/i_perfstats.h"
 #include "system/i_system.h"
 #include "system/i_timer.h"
 #include "system/i_config.h"
@@ -49,7 +50,9 @@
 #include "playsim/p_local.h"
 #include "playsim/p_setup.h"
 #include "playsim/p_tick.h"
+#include "render/r_simd.h"
 #include "render/r_sky.h"
+#include "render/r_threads.h"
 #include "render/v_draw.h"
 #include "render/v_video.h"
 
@@ -113,6 +116,21 @@ lighttable_t* (*psprscalelight)[OLDMAXLIGHTSCALE];
 lighttable_t* (*zlight)[MAXLIGHTZ];
 lighttable_t* fullcolormap;
 lighttable_t** colormaps;
+lighttable_t** fusedcolormaps;
+lighttable_t nosectorcolormap[256];
+
+typedef struct
+{
+    int             colormap;
+    int             sectorcolormap;
+    int             lastused;
+    lighttable_t*   table;
+} fusedcolormap_t;
+
+static fusedcolormap_t* fusedcache;
+static int              numfusedcache;
+static bool*            identitycolormaps;
+static int              fusedframe;
 
 // bumped light from gun blasts
 int extralight;
@@ -370,6 +388,94 @@ static void R_InitLightTables(void)
     }
 }
 
+//
+// R_InitFusedColormaps
+// Finds the colormaps whose fullbright row leaves every color as it is, since
+// using them as a sector colormap has no effect.
+//
+static void R_InitFusedColormaps(void)
+{
+    for(int i = 0; i < 256; i++)
+        nosectorcolormap[i] = i;
+
+    identitycolormaps = I_Malloc(numcolormaps * sizeof(*identitycolormaps));
+    fusedcolormaps    = I_Malloc(numcolormaps * sizeof(*fusedcolormaps));
+
+    for(int i = 0; i < numcolormaps; i++)
+        identitycolormaps[i] = !memcmp(colormaps[i], nosectorcolormap, 256);
+
+    // room for every sector colormap under two different view colormaps
+    numfusedcache = numcolormaps * 2;
+    fusedcache    = I_Malloc(numfusedcache * sizeof(*fusedcache));
+
+    for(int i = 0; i < numfusedcache; i++)
+    {
+        fusedcache[i].colormap = -1;
+        fusedcache[i].lastused = 0;
+        fusedcache[i].table    = NULL;
+    }
+}
+
+//
+// R_GetFusedColormap
+// Returns the light tables of colormaps[colormap] with the fullbright row of
+// colormaps[sectorcolormap] applied on top, building them into the least
+// recently used slot of the cache if they aren't there already.
+//
+static lighttable_t* R_GetFusedColormap(const int colormap, const int sectorcolormap)
+{
+    fusedcolormap_t*    entry = &fusedcache[0];
+    const lighttable_t* source;
+    const lighttable_t* sector;
+
+    if(identitycolormaps[sectorcolormap])
+        return colormaps[colormap];
+
+    for(int i = 0; i < numfusedcache; i++)
+    {
+        fusedcolormap_t* cached = &fusedcache[i];
+
+        if(cached->colormap == colormap && cached->sectorcolormap == sectorcolormap)
+        {
+            cached->lastused = fusedframe;
+            return cached->table;
+        }
+
+        if(cached->lastused < entry->lastused)
+            entry = cached;
+    }
+
+    if(!entry->table)
+        entry->table = I_Malloc(FUSEDCOLORMAPSIZE);
+
+    entry->colormap       = colormap;
+    entry->sectorcolormap = sectorcolormap;
+    entry->lastused       = fusedframe;
+
+    source = colormaps[colormap];
+    sector = colormaps[sectorcolormap];
+
+    for(int i = 0; i < FUSEDCOLORMAPSIZE; i++)
+        entry->table[i] = sector[source[i]];
+
+    return entry->table;
+}
+
+//
+// R_UpdateFusedColormaps
+// Called once a frame, before any strip is drawn, so that every fused light
+// table a wall or plane could need is ready. fusedcolormaps[0] is for sectors
+// that have no colormap of their own, and so use the view's.
+//
+static void R_UpdateFusedColormaps(const int colormap)
+{
+    fusedframe++;
+    fusedcolormaps[0] = R_GetFusedColormap(colormap, colormap);
+
+    for(int i = 1; i < numcolormaps; i++)
+        fusedcolormaps[i] = R_GetFusedColormap(colormap, i);
+}
+
 //
 // R_SetViewSize
 // Do not really change anything here, because it might be in the middle of a
@@ -491,36 +597,35 @@ void R_ExecuteSetViewSize(void)
     AM_SetAutomapSize(r_screensize);
 }
 
-void (*colfunc)(void);
-void (*wallcolfunc)(void);
-void (*altwallcolfunc)(void);
-void (*missingcolfunc)(void);
-void (*bmapwallcolfunc)(void);
-void (*altbmapwallcolfunc)(void);
-void (*segcolfunc)(void);
-void (*bmapsegcolfunc)(void);
-void (*translatedcolfunc)(void);
-void (*basecolfunc)(void);
-void (*tlcolfunc)(void);
-void (*tl50colfunc)(void);
-void (*tl50segcolfunc)(void);
-void (*tl50bmapsegcolfunc)(void);
-void (*tl33colfunc)(void);
-void (*tlgreencolfunc)(void);
-void (*tlredcolfunc)(void);
-void (*tlredwhitecolfunc1)(void);
-void (*tlredwhitecolfunc2)(void);
-void (*tlredwhite50colfunc)(void);
-void (*tlbluecolfunc)(void);
-void (*tlgreen33colfunc)(void);
-void (*tlred33colfunc)(void);
-void (*tlblue25colfunc)(void);
-void (*skycolfunc)(void);
-void (*psprcolfunc)(void);
-void (*spanfunc)(void);
-void (*altspanfunc)(void);
-void (*bloodcolfunc)(void);
-void (*bloodsplatcolfunc)(void);
+void (*wallcolfunc)(rendercontext_t* rc);
+void (*altwallcolfunc)(rendercontext_t* rc);
+void (*missingcolfunc)(rendercontext_t* rc);
+void (*bmapwallcolfunc)(rendercontext_t* rc);
+void (*altbmapwallcolfunc)(rendercontext_t* rc);
+void (*segcolfunc)(rendercontext_t* rc);
+void (*bmapsegcolfunc)(rendercontext_t* rc);
+void (*translatedcolfunc)(rendercontext_t* rc);
+void (*basecolfunc)(rendercontext_t* rc);
+void (*tlcolfunc)(rendercontext_t* rc);
+void (*tl50colfunc)(rendercontext_t* rc);
+void (*tl50segcolfunc)(rendercontext_t* rc);
+void (*tl50bmapsegcolfunc)(rendercontext_t* rc);
+void (*tl33colfunc)(rendercontext_t* rc);
+void (*tlgreencolfunc)(rendercontext_t* rc);
+void (*tlredcolfunc)(rendercontext_t* rc);
+void (*tlredwhitecolfunc1)(rendercontext_t* rc);
+void (*tlredwhitecolfunc2)(rendercontext_t* rc);
+void (*tlredwhite50colfunc)(rendercontext_t* rc);
+void (*tlbluecolfunc)(rendercontext_t* rc);
+void (*tlgreen33colfunc)(rendercontext_t* rc);
+void (*tlred33colfunc)(rendercontext_t* rc);
+void (*tlblue25colfunc)(rendercontext_t* rc);
+void (*skycolfunc)(rendercontext_t* rc);
+void (*psprcolfunc)(rendercontext_t* rc);
+void (*spanfunc)(rendercontext_t* rc);
+void (*altspanfunc)(rendercontext_t* rc);
+void (*bloodcolfunc)(rendercontext_t* rc);
+void (*bloodsplatcolfunc)(rendercontext_t* rc);
 
 void R_UpdateMobjColfunc(mobj_t* mobj)
 {
@@ -614,6 +719,8 @@ void R_UpdateMobjColfunc(mobj_t* mobj)
 
 void R_InitColumnFunctions(void)
 {
+    R_InitSIMD();
+
     if(r_textures)
     {
         skycolfunc = (canmodify && !transferredsky &&
@@ -1092,10 +1199,12 @@ void R_Init(void)
     c_psprscalelight = malloc(numcolormaps * sizeof(*c_psprscalelight));
 
     R_InitLightTables();
+    R_InitFusedColormaps();
     R_InitTranslationTables();
     R_InitPatches();
     R_InitDistortedFlats();
     R_InitColumnFunctions();
+    R_InitRenderThreads();
 }
 
 //
@@ -1179,9 +1288,9 @@ static void R_SetupFrame(void)
         {
             const fixed_t amount = FRACUNIT * (fixed_t)(shake - time) / shakeduration;
 
-            viewx += M_RandomInt(-3, 3) * amount;
-            viewy += M_RandomInt(-3, 3) * amount;
-            viewz += M_RandomInt(-2, 2) * amount;
+            viewx += M_Fuzz1RandomInt(-3, 3) * amount;
+            viewy += M_Fuzz1RandomInt(-3, 3) * amount;
+            viewz += M_Fuzz1RandomInt(-2, 2) * amount;
         }
     }
 
@@ -1221,6 +1330,7 @@ static void R_SetupFrame(void)
     zlight          = c_zlight[colormap];
     scalelight      = c_scalelight[colormap];
     psprscalelight  = c_psprscalelight[colormap];
+    R_UpdateFusedColormaps(colormap);
     drawbloodsplats = (r_blood != r_blood_none && r_bloodsplats_max);
 
     if(viewplayer->fixedcolormap && r_textures)
@@ -1250,13 +1360,42 @@ static void R_SetupFrame(void)
 }
 
 //
-// R_RenderPlayerView
+// R_InitRenderContext
 //
-void R_RenderPlayerView(void)
+static void R_InitRenderContext(rendercontext_t* rc)
 {
-    TracyCZoneN(tracy_zone, "R_RenderPlayerView", 1);
+    memset(rc, 0, sizeof(*rc));
 
-    R_SetupFrame();
+    // brightmapped pixels are drawn unlit
+    rc->dc_colormap[1] = rc->dc_nextcolormap[1] = colormaps[0];
+}
+
+// The fuzz seeds every strip starts from
+static unsigned int framefuzz1seed;
+static unsigned int framefuzz2seed;
+
+//
+// R_RenderStrip
+// Renders the calling thread's strip of the view. Each strip walks and clips
+// the whole view exactly as a single thread would, so it finds the same walls,
+// planes and sprites, but only draws the columns in its strip.
+//
+static void R_RenderStrip(void)
+{
+    TracyCZoneN(zone_strip, "R_RenderStrip", 1);
+    rendercontext_t context;
+    rendercontext_t* rc = &context;
+    uint64_t starttime;
+
+    R_InitRenderContext(rc);
+    R_ResizeDrawStripBuffers();
+    R_ResizeClipSegs();
+    R_ResizePlaneStripBuffers();
+    R_ResizeThingsStripBuffers();
+
+    M_Fuzz1Seed(framefuzz1seed);
+    M_Fuzz2Seed(framefuzz2seed);
+    R_LoadWiggleCache();
 
     // Clear buffers.
     R_ClearClipSegs();
@@ -1264,9 +1403,53 @@ void R_RenderPlayerView(void)
     R_ClearPlanes();
     R_ClearSprites();
 
+    starttime = I_GetTimeNS();
+    R_RenderBSPNode(rc, numnodes - 1); // head node is the last node output
+
+    R_DrawNearbySprites();
+
+    if(!r_strip)
+        I_AddPerfTime(PERF_BSP, starttime);
+
+    starttime = I_GetTimeNS();
+    R_DrawPlanes(rc);
+
+    if(!r_strip)
+        I_AddPerfTime(PERF_PLANES, starttime);
+
+    starttime = I_GetTimeNS();
+    R_DrawMasked(rc);
+
+    if(!r_strip)
+        I_AddPerfTime(PERF_MASKED, starttime);
+
+    TracyCZoneEnd(zone_strip)
+}
+
+//
+// R_RenderPlayerView
+//
+void R_RenderPlayerView(void)
+{
+    TracyCZoneN(tracy_zone, "R_RenderPlayerView", 1);
+    uint64_t starttime;
+
+    R_InterpolateMap();
+    R_SetupFrame();
+
     if(automapactive)
     {
-        R_RenderBSPNode(numnodes - 1);
+        rendercontext_t context;
+
+        R_InitRenderContext(&context);
+
+        // Clear buffers.
+        R_ClearClipSegs();
+        R_ClearDrawSegs();
+        R_ClearPlanes();
+        R_ClearSprites();
+
+        R_RenderBSPNode(&context, numnodes - 1);
         TracyCZoneEnd(tracy_zone)
         return;
     }
@@ -1280,13 +1463,18 @@ void R_RenderPlayerView(void)
         V_FillRect(0, v_viewwindowx, v_viewwindowy, v_viewwidth, v_viewheight,
         nearestblack, 0, false, false, NULL, NULL);
 #endif
-    R_RenderBSPNode(numnodes - 1); // head node is the last node output
+    R_SetupPlanes();
+    R_SetupSprites();
 
-    R_DrawNearbySprites();
+    framefuzz1seed = fuzz1seed;
+    framefuzz2seed = fuzz2seed;
 
-    R_DrawPlanes();
+    starttime = I_GetTimeNS();
+    R_RenderStrips(&R_RenderStrip);
+    I_AddPerfTime(PERF_VIEW, starttime);
 
-    R_DrawMasked();
+    R_SaveWiggleCache();
+    r_screensupdated = true;
 
     if(!r_textures && viewplayer->fixedcolormap == INVERSECOLORMAP)
         V_InvertScreen();
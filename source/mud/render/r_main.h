@@ -82,6 +82,13 @@ extern fixed_t fovtx;
 // There a 0-31, i.e. 32 LUT in the COLORMAP lump.
 #define NUMCOLORMAPS 32
 
+// The light tables of a colormap, and the inverse row used by the invulnerability
+// powerup, with a sector colormap already applied to them.
+#define FUSEDCOLORMAPSIZE ((NUMCOLORMAPS + 1) * 256)
+
+// Moves a light table of the view's colormap onto a set of fused light tables.
+#define FUSEDLIGHT(fused, light) ((fused) + ((light) - fullcolormap))
+
 // killough 03/20/98: Allow colormaps to be dynamic (e.g. underwater)
 extern lighttable_t* (*scalelight)[MAXLIGHTSCALE];
 extern lighttable_t* (*zlight)[MAXLIGHTZ];
@@ -89,6 +96,8 @@ extern lighttable_t* (*psprscalelight)[OLDMAXLIGHTSCALE];
 extern lighttable_t* fullcolormap;
 extern int numcolormaps; // killough 04/04/98: dynamic number of maps
 extern lighttable_t** colormaps;
+extern lighttable_t** fusedcolormaps;
+extern lighttable_t nosectorcolormap[256];
 extern int extralight;
 extern lighttable_t* fixedcolormap;
 extern bool setsizeneeded;
@@ -98,36 +107,35 @@ extern bool drawbloodsplats;
 // Function pointers to switch refresh/drawing functions.
 // Used to select shadow mode etc.
 //
-extern void (*colfunc)(void);
-extern void (*wallcolfunc)(void);
-extern void (*altwallcolfunc)(void);
-extern void (*bmapsegcolfunc)(void);
-extern void (*bmapwallcolfunc)(void);
-extern void (*missingcolfunc)(void);
-extern void (*altbmapwallcolfunc)(void);
-extern void (*segcolfunc)(void);
-extern void (*translatedcolfunc)(void);
-extern void (*basecolfunc)(void);
-extern void (*tlcolfunc)(void);
-extern void (*tl50colfunc)(void);
-extern void (*tl50segcolfunc)(void);
-extern void (*tl50bmapsegcolfunc)(void);
-extern void (*tl33colfunc)(void);
-extern void (*tlgreencolfunc)(void);
-extern void (*tlredcolfunc)(void);
-extern void (*tlredwhitecolfunc1)(void);
-extern void (*tlredwhitecolfunc2)(void);
-extern void (*tlredwhite50colfunc)(void);
-extern void (*tlbluecolfunc)(void);
-extern void (*tlgreen33colfunc)(void);
-extern void (*tlred33colfunc)(void);
-extern void (*tlblue25colfunc)(void);
-extern void (*skycolfunc)(void);
-extern void (*psprcolfunc)(void);
-extern void (*spanfunc)(void);
-extern void (*altspanfunc)(void);
-extern void (*bloodcolfunc)(void);
-extern void (*bloodsplatcolfunc)(void);
+extern void (*wallcolfunc)(rendercontext_t* rc);
+extern void (*altwallcolfunc)(rendercontext_t* rc);
+extern void (*bmapsegcolfunc)(rendercontext_t* rc);
+extern void (*bmapwallcolfunc)(rendercontext_t* rc);
+extern void (*missingcolfunc)(rendercontext_t* rc);
+extern void (*altbmapwallcolfunc)(rendercontext_t* rc);
+extern void (*segcolfunc)(rendercontext_t* rc);
+extern void (*translatedcolfunc)(rendercontext_t* rc);
+extern void (*basecolfunc)(rendercontext_t* rc);
+extern void (*tlcolfunc)(rendercontext_t* rc);
+extern void (*tl50colfunc)(rendercontext_t* rc);
+extern void (*tl50segcolfunc)(rendercontext_t* rc);
+extern void (*tl50bmapsegcolfunc)(rendercontext_t* rc);
+extern void (*tl33colfunc)(rendercontext_t* rc);
+extern void (*tlgreencolfunc)(rendercontext_t* rc);
+extern void (*tlredcolfunc)(rendercontext_t* rc);
+extern void (*tlredwhitecolfunc1)(rendercontext_t* rc);
+extern void (*tlredwhitecolfunc2)(rendercontext_t* rc);
+extern void (*tlredwhite50colfunc)(rendercontext_t* rc);
+extern void (*tlbluecolfunc)(rendercontext_t* rc);
+extern void (*tlgreen33colfunc)(rendercontext_t* rc);
+extern void (*tlred33colfunc)(rendercontext_t* rc);
+extern void (*tlblue25colfunc)(rendercontext_t* rc);
+extern void (*skycolfunc)(rendercontext_t* rc);
+extern void (*psprcolfunc)(rendercontext_t* rc);
+extern void (*spanfunc)(rendercontext_t* rc);
+extern void (*altspanfunc)(rendercontext_t* rc);
+extern void (*bloodcolfunc)(rendercontext_t* rc);
+extern void (*bloodsplatcolfunc)(rendercontext_t* rc);
 
 //
 // Utility functions.
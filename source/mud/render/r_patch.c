@@ -37,8 +37,11 @@
 #include "doom/doomstat.h"
 #include "math/math_swap.h"
 #include "render/r_main.h"
+#include "system/i_config.h"
 #include "wad/w_wad.h"
-#include "utils/z_zone.h"
+#include "thread.h"
+
+#include "mud_profiling.h"
 
 //
 // Patches.
@@ -51,6 +54,25 @@
 static rpatch_t* patches;
 static rpatch_t* texturecomposites;
 
+// Patches and texture composites are only built the first time they're used
+enum
+{
+    NOTBUILT,
+    BUILDING,
+    BUILT
+};
+
+static thread_atomic_int_t* patchstates;
+static thread_atomic_int_t* texturecompositestates;
+
+// The current map's textures and sprites, being built in the background
+static thread_ptr_t         prefetchthreads[r_threads_max];
+static int                  numprefetchthreads;
+static int*                 prefetchids;
+static int                  numprefetchtextures;
+static int                  numprefetchids;
+static thread_atomic_int_t  nextprefetch;
+
 static short BIGDOOR7;
 static short FIREBLU1;
 static short SKY1;
@@ -98,9 +120,10 @@ bool R_CheckIfPatch(const int lump)
     return result;
 }
 
-static void CreatePatch(int patchnum)
+static void CreatePatch(const int id)
 {
-    rpatch_t* patch;
+    rpatch_t* patch = &patches[id];
+    int patchnum    = id;
     const patch_t* oldpatch;
     const column_t* oldcolumn = NULL;
     int pixeldatasize;
@@ -115,7 +138,6 @@ static void CreatePatch(int patchnum)
         patchnum = W_GetNumForName("TNT1A0");
 
     oldpatch          = W_CacheLumpNum(patchnum);
-    patch             = &patches[patchnum];
     patch->width      = SHORT(oldpatch->width);
     patch->widthmask  = 0;
     patch->height     = SHORT(oldpatch->height);
@@ -152,7 +174,7 @@ static void CreatePatch(int patchnum)
 
     // allocate our data chunk
     datasize    = pixeldatasize + columnsdatasize + postsdatasize;
-    patch->data = Z_Calloc(1, datasize, PU_CACHE, (void**)&patch->data);
+    patch->data = calloc(1, datasize);
 
     // set out pixel, column, and post pointers into our data array
     patch->pixels = patch->data;
@@ -312,8 +334,7 @@ static void CreateTextureCompositePatch(const int id)
 
     // allocate our data chunk
     datasize = pixeldatasize + columnsdatasize + postsdatasize;
-    compositepatch->data =
-    Z_Calloc(1, datasize, PU_STATIC, (void**)&compositepatch->data);
+    compositepatch->data = calloc(1, datasize);
 
     // set out pixel, column, and post pointers into our data array
     compositepatch->pixels = compositepatch->data;
@@ -489,32 +510,116 @@ static void CreateTextureCompositePatch(const int id)
 void R_InitPatches(void)
 {
     patches = calloc(numlumps, sizeof(rpatch_t));
+    patchstates = calloc(numlumps, sizeof(thread_atomic_int_t));
 
     texturecomposites = calloc(numtextures, sizeof(rpatch_t));
+    texturecompositestates = calloc(numtextures, sizeof(thread_atomic_int_t));
 
     BIGDOOR7 = R_CheckTextureNumForName("BIGDOOR7");
     FIREBLU1 = R_CheckTextureNumForName("FIREBLU1");
     SKY1     = R_CheckTextureNumForName("SKY1");
     STEP2    = R_CheckTextureNumForName("STEP2");
     TEKWALL1 = R_CheckTextureNumForName("TEKWALL1");
+}
 
-    for(int i = 0; i < numspritelumps; i++)
-        CreatePatch(firstspritelump + i);
-
-    for(int i = 0; i < numtextures; i++)
-        CreateTextureCompositePatch(i);
+//
+// R_BuildPatch
+// Builds a patch or texture composite, unless another thread already has, in
+// which case it waits for that thread to finish.
+//
+static void R_BuildPatch(thread_atomic_int_t* state, void (*create)(const int), const int id)
+{
+    if(thread_atomic_int_compare_and_swap(state, NOTBUILT, BUILDING) == NOTBUILT)
+    {
+        create(id);
+        thread_atomic_int_store(state, BUILT);
+    }
+    else
+        while(thread_atomic_int_load(state) != BUILT)
+            thread_yield();
 }
 
 const rpatch_t* R_CachePatchNum(const int id)
 {
+    if(thread_atomic_int_load(&patchstates[id]) != BUILT)
+        R_BuildPatch(&patchstates[id], &CreatePatch, id);
+
     return &patches[id];
 }
 
 const rpatch_t* R_CacheTextureCompositePatchNum(const int id)
 {
+    if(thread_atomic_int_load(&texturecompositestates[id]) != BUILT)
+        R_BuildPatch(&texturecompositestates[id], &CreateTextureCompositePatch, id);
+
     return &texturecomposites[id];
 }
 
+static int R_PrefetchThreadProc(void* data)
+{
+    int i;
+
+    TracyCSetThreadName("Prefetch Thread");
+
+    while((i = thread_atomic_int_inc(&nextprefetch)) < numprefetchids)
+    {
+        if(i < numprefetchtextures)
+            R_CacheTextureCompositePatchNum(prefetchids[i]);
+        else
+            R_CachePatchNum(prefetchids[i]);
+    }
+
+    return 0;
+}
+
+//
+// R_StopPrefetchingPatches
+//
+static void R_StopPrefetchingPatches(void)
+{
+    thread_atomic_int_store(&nextprefetch, numprefetchids);
+
+    for(int i = 0; i < numprefetchthreads; i++)
+    {
+        thread_join(prefetchthreads[i]);
+        thread_destroy(prefetchthreads[i]);
+    }
+
+    free(prefetchids);
+    prefetchids         = NULL;
+    numprefetchthreads  = 0;
+    numprefetchtextures = 0;
+    numprefetchids      = 0;
+}
+
+//
+// R_PrefetchPatches
+// Builds the texture composites and patches in ids, the first numtextures of
+// which are textures, on up to r_threads threads in the background. Those
+// needed before then are built when they're first used, as they would be
+// anyway. ids is freed once they're all built, or another map is loaded.
+//
+void R_PrefetchPatches(int* ids, const int numtextures, const int numids)
+{
+    R_StopPrefetchingPatches();
+
+    prefetchids         = ids;
+    numprefetchtextures = numtextures;
+    numprefetchids      = numids;
+    thread_atomic_int_store(&nextprefetch, 0);
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    while(numprefetchthreads < MIN(r_threads, numids))
+    {
+        if(!(prefetchthreads[numprefetchthreads] = thread_create(&R_PrefetchThreadProc, NULL,
+            THREAD_STACK_SIZE_DEFAULT)))
+            break;
+
+        numprefetchthreads++;
+    }
+#endif
+}
+
 const rcolumn_t* R_GetPatchColumnWrapped(const rpatch_t* patch, int columnindex)
 {
     while(columnindex < 0)
@@ -75,4 +75,5 @@ const rcolumn_t* R_GetPatchColumnWrapped(const rpatch_t* patch, int columnindex)
 const rcolumn_t* R_GetPatchColumnClamped(const rpatch_t* patch, int columnindex);
 
 void R_InitPatches(void);
+void R_PrefetchPatches(int* ids, const int numtextures, const int numids);
 bool R_CheckIfPatch(const int lump);
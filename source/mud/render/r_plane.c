@@ -41,60 +41,89 @@
 #include "system/i_video.h"
 #include "menu/m_menu.h"
 #include "render/r_sky.h"
+#include "render/r_threads.h"
 #include "wad/w_wad.h"
 #include "mud_profiling.h"
 
-#define MAXVISPLANES 1024 // must be a power of 2
+#define MINVISPLANES      1024 // must be a power of 2
+#define VISPLANEBLOCKSIZE 128
 
-// killough -- hash function for visplanes
-// Empirically verified to be fairly uniform:
-#define visplane_hash(picnum, lightlevel, height, colormap)                         \
-    ((unsigned int)((picnum) * 3 + (lightlevel) + (height) * 7 + (colormap) * 11) & \
-    (MAXVISPLANES - 1))
-
-static visplane_t* visplanes[MAXVISPLANES]; // killough
-static visplane_t* freetail;                // killough
-static visplane_t** freehead = &freetail;   // killough
-visplane_t* floorplane;
-visplane_t* ceilingplane;
-
-int* openings;
-int* lastopening; // dropoff overflow
+// A block of visplanes, followed by the top and bottom arrays of each of them
+typedef struct visplaneblock_s
+{
+    struct visplaneblock_s* next;
+    visplane_t planes[VISPLANEBLOCKSIZE];
+    unsigned short columns[];
+} visplaneblock_t;
+
+// Each render thread finds, clips and draws its own visplanes. They're looked
+// up in an open addressing table that holds the newest visplane with each set
+// of properties, with any it was split from by R_DupPlane chained behind it.
+static THREADLOCAL visplane_t** visplanes;
+static THREADLOCAL unsigned int visplanesmask;
+static THREADLOCAL int numvisplanekinds;
+
+// Visplanes are carved from blocks that are kept from frame to frame, and
+// handed out again from the first block by R_ClearPlanes
+static THREADLOCAL visplaneblock_t* visplaneblocks;
+static THREADLOCAL visplaneblock_t* currentvisplaneblock;
+static THREADLOCAL int numblockvisplanes;
+static THREADLOCAL int visplanestride;
+
+THREADLOCAL visplane_t* floorplane;
+THREADLOCAL visplane_t* ceilingplane;
+
+THREADLOCAL int* openings;
+THREADLOCAL int* lastopening; // dropoff overflow
 
 // Clip values are the solid pixel bounding the range.
 //  floorclip starts out render.screen_height
 //  ceilingclip starts out -1
-int* floorclip;   // dropoff overflow
-int* ceilingclip; // dropoff overflow
+THREADLOCAL int* floorclip;   // dropoff overflow
+THREADLOCAL int* ceilingclip; // dropoff overflow
 
 // texture mapping
-static lighttable_t** planezlight;
-static fixed_t planeheight;
+static THREADLOCAL lighttable_t** planezlight;
+static THREADLOCAL fixed_t planeheight;
 
-static fixed_t xoffset, yoffset; // killough 02/28/98: flat offsets
+static THREADLOCAL fixed_t xoffset, yoffset; // killough 02/28/98: flat offsets
 
-static angle_t rotation;
+static THREADLOCAL angle_t rotation;
 
-static fixed_t angle_sin;
-static fixed_t angle_cos;
-static fixed_t viewx_trans;
-static fixed_t viewy_trans;
+static THREADLOCAL fixed_t angle_sin;
+static THREADLOCAL fixed_t angle_cos;
+static THREADLOCAL fixed_t viewx_trans;
+static THREADLOCAL fixed_t viewy_trans;
 
 fixed_t* yslope;
 fixed_t** yslopes;
 
-static fixed_t* cachedheight;
+static THREADLOCAL fixed_t* cachedheight;
 
 // Static arrays used inside R_MapPlane - allocated dynamically
-static fixed_t* cacheddistance;
-static fixed_t* cachedanglecosdistance;
-static fixed_t* cachedanglesindistance;
-static fixed_t* cachedxstep;
-static fixed_t* cachedystep;
-static fixed_t* cachedangle;
+static THREADLOCAL fixed_t* cacheddistance;
+static THREADLOCAL fixed_t* cachedanglecosdistance;
+static THREADLOCAL fixed_t* cachedanglesindistance;
+static THREADLOCAL fixed_t* cachedxstep;
+static THREADLOCAL fixed_t* cachedystep;
+static THREADLOCAL fixed_t* cachedangle;
 
 // Static array used inside R_MakeSpans
-static int* spanstart;
+static THREADLOCAL int* spanstart;
+
+// Sizes the buffers above were allocated for
+static THREADLOCAL int planebufferwidth;
+static THREADLOCAL int planebufferheight;
+static THREADLOCAL int planebufferarea;
+
+// The visplanes left to draw once R_MergePlanes is done, sorted by flat
+static THREADLOCAL visplane_t** drawnplanes;
+static THREADLOCAL int numdrawnplanes;
+static THREADLOCAL int maxdrawnplanes;
+
+// The visplanes in the last frame, before and after merging
+static int visplanesfound;
+static int visplanesdrawn;
 
 static bool updateswirl;
 
@@ -103,7 +132,7 @@ static angle_t* xtoskyangle;
 //
 // R_MapPlane
 //
-static void R_MapPlane(const int y, const int x1)
+static void R_MapPlane(rendercontext_t* rc, const int y, const int x1)
 {
     TracyCZoneN(tracy_zone, "R_MapPlane", 1);
     fixed_t anglecosdistance;
@@ -118,54 +147,59 @@ static void R_MapPlane(const int y, const int x1)
         const fixed_t dy =
         (ABS(r_centery - y) << FRACBITS) + (y < r_centery ? -FRACUNIT : FRACUNIT) / 2;
 
-        cachedheight[y] = planeheight;
-        cachedangle[y]  = rotation;
-        ds_z = cacheddistance[y] = FixedMul(planeheight, yslope[y]);
-        anglecosdistance = cachedanglecosdistance[y] = FixedMul(angle_cos, ds_z);
-        anglesindistance = cachedanglesindistance[y] = FixedMul(angle_sin, ds_z);
-        ds_xstep = cachedxstep[y] = (fixed_t)((int64_t)angle_sin * planeheight / dy);
-        ds_ystep = cachedystep[y] = (fixed_t)((int64_t)angle_cos * planeheight / dy);
+        cachedheight[y]  = planeheight;
+        cachedangle[y]   = rotation;
+        rc->ds_z         = cacheddistance[y] = FixedMul(planeheight, yslope[y]);
+        anglecosdistance = cachedanglecosdistance[y] = FixedMul(angle_cos, rc->ds_z);
+        anglesindistance = cachedanglesindistance[y] = FixedMul(angle_sin, rc->ds_z);
+        rc->ds_xstep     = cachedxstep[y] = (fixed_t)((int64_t)angle_sin * planeheight / dy);
+        rc->ds_ystep     = cachedystep[y] = (fixed_t)((int64_t)angle_cos * planeheight / dy);
     }
     else
     {
-        ds_z             = cacheddistance[y];
+        rc->ds_z         = cacheddistance[y];
         anglecosdistance = cachedanglecosdistance[y];
         anglesindistance = cachedanglesindistance[y];
-        ds_xstep         = cachedxstep[y];
-        ds_ystep         = cachedystep[y];
+        rc->ds_xstep     = cachedxstep[y];
+        rc->ds_ystep     = cachedystep[y];
     }
 
-    dx       = x1 - r_centerx;
-    ds_xfrac = viewx_trans + anglecosdistance + dx * ds_xstep;
-    ds_yfrac = viewy_trans - anglesindistance + dx * ds_ystep;
-    ds_y     = y;
-    ds_x1    = x1;
+    dx           = x1 - r_centerx;
+    rc->ds_xfrac = viewx_trans + anglecosdistance + dx * rc->ds_xstep;
+    rc->ds_yfrac = viewy_trans - anglesindistance + dx * rc->ds_ystep;
+    rc->ds_y     = y;
+    rc->ds_x1    = x1;
 
     if(fixedcolormap)
     {
-        ds_colormap[0] = ds_colormap[1] = fixedcolormap;
-        altspanfunc();
+        rc->ds_colormap[0] = rc->ds_colormap[1] = FUSEDLIGHT(rc->ds_fusedcolormap, fixedcolormap);
+        altspanfunc(rc);
     }
     else
     {
-        ds_colormap[0] = planezlight[BETWEEN(0, ds_z >> LIGHTZSHIFT, MAXLIGHTZ - 1)];
+        rc->ds_colormap[0] = FUSEDLIGHT(rc->ds_fusedcolormap,
+            planezlight[BETWEEN(0, rc->ds_z >> LIGHTZSHIFT, MAXLIGHTZ - 1)]);
 
         if(r_ditheredlighting)
         {
-            ds_colormap[1] =
-            planezlight[BETWEEN(0, (ds_z >> LIGHTZSHIFT) + 1, MAXLIGHTZ - 1)];
+            rc->ds_colormap[1] = FUSEDLIGHT(rc->ds_fusedcolormap,
+                planezlight[BETWEEN(0, (rc->ds_z >> LIGHTZSHIFT) + 1, MAXLIGHTZ - 1)]);
 
-            if(ds_colormap[0] == ds_colormap[1])
-                altspanfunc();
+            if(rc->ds_colormap[0] == rc->ds_colormap[1])
+                altspanfunc(rc);
             else
             {
-                ds_z = ((ds_z >> 12) & 255);
-                spanfunc();
+                rc->ds_z = ((rc->ds_z >> 12) & 255);
+                spanfunc(rc);
             }
         }
         else
-            spanfunc();
+            spanfunc(rc);
     }
+
+    if(r_columnmajor)
+        R_TransposeSpan(rc);
+
     TracyCZoneEnd(tracy_zone)
 }
 
@@ -182,17 +216,16 @@ void R_ClearPlanes(void)
         ceilingclip[i] = -1;
     }
 
-    // [PN] Optimize loop by avoiding unnecessary assignments and checks.
-    // Only process non-null visplanes and simplify inner loop performance.
-    for(int i = 0; i < MAXVISPLANES; i++)
-        if(visplanes[i])
-        {
-            *freehead    = visplanes[i];
-            visplanes[i] = NULL;
+    if(!visplanes)
+    {
+        visplanesmask = MINVISPLANES - 1;
+        visplanes     = I_Malloc(MINVISPLANES * sizeof(*visplanes));
+    }
 
-            while(*freehead)
-                freehead = &(*freehead)->next;
-        }
+    memset(visplanes, 0, (visplanesmask + 1) * sizeof(*visplanes));
+    numvisplanekinds     = 0;
+    currentvisplaneblock = NULL;
+    numblockvisplanes    = 0;
 
     lastopening = openings;
 
@@ -200,36 +233,137 @@ void R_ClearPlanes(void)
     memset(cachedheight, 0, render.view_height * sizeof(*cachedheight));
 }
 
-// New function, by Lee Killough
-static visplane_t* new_visplane(const unsigned int hash)
+//
+// R_HashPlane
+// killough -- hash function for visplanes, scrambled so that every bit of
+// the table's index depends on each property
+//
+static unsigned int R_HashPlane(const fixed_t height, const int picnum,
+const int lightlevel, const int colormap)
 {
-    visplane_t* check = freetail;
+    const unsigned int hash = ((unsigned int)picnum * 3 + (unsigned int)lightlevel
+    + (unsigned int)height * 7 + (unsigned int)colormap * 11) * 2654435761u;
 
-    if(!check)
+    return (hash ^ (hash >> 16));
+}
+
+//
+// R_FindPlaneSlot
+// Returns the slot in the table that either holds the newest visplane with
+// these properties, or is empty and is where it should go.
+//
+static visplane_t** R_FindPlaneSlot(const fixed_t height, const int picnum,
+const int lightlevel, const fixed_t x, const fixed_t y, const int colormap,
+const angle_t angle)
+{
+    unsigned int i = R_HashPlane(height, picnum, lightlevel, colormap) & visplanesmask;
+    visplane_t* check;
+
+    while((check = visplanes[i]))
     {
-        check = calloc(1, sizeof(*check));
-        if(check)
-        {
-            // Allocate top and bottom arrays for this visplane
-            // Add +1 and offset pointer by 1 to allow sentinel access at index -1
-            // (R_MakeSpans accesses pl->top[pl->left - 1] which can be -1 when left is 0)
-            check->top = calloc(r_alloc_max_width + 1, sizeof(unsigned short));
-            check->bottom = calloc(r_alloc_max_width + 1, sizeof(unsigned short));
-            if(check->top)
-                check->top++;
-            if(check->bottom)
-                check->bottom++;
-        }
+        if(height == check->height && picnum == check->picnum &&
+        lightlevel == check->lightlevel && x == check->xoffset &&
+        y == check->yoffset && colormap == check->colormap && angle == check->angle)
+            break;
+
+        i = (i + 1) & visplanesmask;
     }
-    else if(!(freetail = freetail->next))
-        freehead = &freetail;
 
-    if(check)
+    return &visplanes[i];
+}
+
+//
+// R_GrowPlaneTable
+// Doubles the size of the table once it's half full, so probes stay short.
+//
+static void R_GrowPlaneTable(void)
+{
+    visplane_t** oldvisplanes = visplanes;
+    const unsigned int oldsize = visplanesmask + 1;
+
+    visplanesmask = oldsize * 2 - 1;
+    visplanes     = I_Malloc(oldsize * 2 * sizeof(*visplanes));
+    memset(visplanes, 0, oldsize * 2 * sizeof(*visplanes));
+
+    for(unsigned int i = 0; i < oldsize; i++)
+    {
+        visplane_t* pl = oldvisplanes[i];
+
+        if(pl)
+            *R_FindPlaneSlot(pl->height, pl->picnum, pl->lightlevel, pl->xoffset,
+            pl->yoffset, pl->colormap, pl->angle) = pl;
+    }
+
+    free(oldvisplanes);
+}
+
+//
+// R_FreePlaneBlocks
+// Frees every block of visplanes, once the width they were carved for changes.
+//
+static void R_FreePlaneBlocks(void)
+{
+    while(visplaneblocks)
     {
-        check->next     = visplanes[hash];
-        visplanes[hash] = check;
+        visplaneblock_t* next = visplaneblocks->next;
+
+        free(visplaneblocks);
+        visplaneblocks = next;
     }
 
+    currentvisplaneblock = NULL;
+    numblockvisplanes    = 0;
+
+    if(visplanes)
+    {
+        memset(visplanes, 0, (visplanesmask + 1) * sizeof(*visplanes));
+        numvisplanekinds = 0;
+    }
+}
+
+//
+// R_NewPlane
+// Takes the next visplane from the current block, and its top and bottom
+// arrays with it. A new block is only allocated once every block allocated in
+// earlier frames is in use.
+//
+static visplane_t* R_NewPlane(void)
+{
+    visplane_t* check;
+    unsigned short* columns;
+
+    if(!currentvisplaneblock || numblockvisplanes == VISPLANEBLOCKSIZE)
+    {
+        visplaneblock_t* block =
+        (currentvisplaneblock ? currentvisplaneblock->next : visplaneblocks);
+
+        if(!block)
+        {
+            // Leave a sentinel before and after each array, as R_MakeSpans
+            // accesses pl->top[pl->left - 1] and pl->top[pl->right + 1]
+            visplanestride = planebufferwidth + 2;
+
+            if(!(block = calloc(1, sizeof(*block)
+                + VISPLANEBLOCKSIZE * 2 * visplanestride * sizeof(*block->columns))))
+                I_Error("R_NewPlane: Failed to allocate visplanes");
+
+            if(currentvisplaneblock)
+                currentvisplaneblock->next = block;
+            else
+                visplaneblocks = block;
+        }
+
+        currentvisplaneblock = block;
+        numblockvisplanes    = 0;
+    }
+
+    check   = &currentvisplaneblock->planes[numblockvisplanes];
+    columns = &currentvisplaneblock->columns[numblockvisplanes * 2 * visplanestride];
+    numblockvisplanes++;
+
+    check->top    = columns + 1;
+    check->bottom = columns + visplanestride + 1;
+
     return check;
 }
 
@@ -246,8 +380,8 @@ const angle_t angle)
 {
     TracyCZoneN(tracy_zone, "R_FindPlane", 1);
 
+    visplane_t** slot;
     visplane_t* check;
-    unsigned int hash;
 
     if(picnum == skyflatnum || (picnum & PL_SKYFLAT))
     {
@@ -260,20 +394,17 @@ const angle_t angle)
         height = (height > viewz);
     }
 
-    // New visplane algorithm uses hash table -- killough
-    hash = visplane_hash(picnum, lightlevel, height, colormap);
+    slot = R_FindPlaneSlot(height, picnum, lightlevel, x, y, colormap, angle);
 
-    for(check = visplanes[hash]; check; check = check->next)
-        if(height == check->height && picnum == check->picnum &&
-        lightlevel == check->lightlevel && x == check->xoffset &&
-        y == check->yoffset && colormap == check->colormap && angle == check->angle)
-        {
-            TracyCZoneEnd(tracy_zone)
-            return check;
-        }
+    if((check = *slot))
+    {
+        TracyCZoneEnd(tracy_zone)
+        return check;
+    }
 
-    check = new_visplane(hash);
+    *slot = check = R_NewPlane();
 
+    check->next       = NULL;
     check->height     = height;
     check->picnum     = picnum;
     check->lightlevel = lightlevel;
@@ -287,6 +418,9 @@ const angle_t angle)
 
     memset(check->top, USHRT_MAX, render.view_width * sizeof(*check->top));
 
+    if(++numvisplanekinds * 2 > (int)visplanesmask)
+        R_GrowPlaneTable();
+
     TracyCZoneEnd(tracy_zone)
     return check;
 }
@@ -296,9 +430,11 @@ const angle_t angle)
 //
 visplane_t* R_DupPlane(const visplane_t* pl, const int start, const int stop)
 {
-    visplane_t* new_pl =
-    new_visplane(visplane_hash(pl->picnum, pl->lightlevel, pl->height, pl->colormap));
+    visplane_t** slot = R_FindPlaneSlot(pl->height, pl->picnum, pl->lightlevel,
+        pl->xoffset, pl->yoffset, pl->colormap, pl->angle);
+    visplane_t* new_pl = R_NewPlane();
 
+    new_pl->next       = *slot;
     new_pl->height     = pl->height;
     new_pl->picnum     = pl->picnum;
     new_pl->lightlevel = pl->lightlevel;
@@ -312,6 +448,8 @@ visplane_t* R_DupPlane(const visplane_t* pl, const int start, const int stop)
 
     memset(new_pl->top, USHRT_MAX, render.view_width * sizeof(*new_pl->top));
 
+    *slot = new_pl;
+
     return new_pl;
 }
 
@@ -365,7 +503,7 @@ visplane_t* R_CheckPlane(visplane_t* pl, const int start, const int stop)
 //
 // R_MakeSpans
 //
-static void R_MakeSpans(visplane_t* pl)
+static void R_MakeSpans(rendercontext_t* rc, visplane_t* pl)
 {
     TracyCZoneN(tracy_zone, "R_MakeSpans", 1);
     const int stop = pl->right + 1;
@@ -406,24 +544,24 @@ static void R_MakeSpans(visplane_t* pl)
     pl->top[pl->left - 1] = USHRT_MAX;
     pl->top[stop]         = USHRT_MAX;
 
-    for(ds_x2 = pl->left; ds_x2 <= stop; ds_x2++)
+    for(rc->ds_x2 = pl->left; rc->ds_x2 <= stop; rc->ds_x2++)
     {
-        unsigned int t1 = pl->top[ds_x2 - 1];
-        unsigned int b1 = pl->bottom[ds_x2 - 1];
-        unsigned int t2 = pl->top[ds_x2];
-        unsigned int b2 = pl->bottom[ds_x2];
+        unsigned int t1 = pl->top[rc->ds_x2 - 1];
+        unsigned int b1 = pl->bottom[rc->ds_x2 - 1];
+        unsigned int t2 = pl->top[rc->ds_x2];
+        unsigned int b2 = pl->bottom[rc->ds_x2];
 
         for(; t1 < t2 && t1 <= b1; t1++)
-            R_MapPlane(t1, spanstart[t1]);
+            R_MapPlane(rc, t1, spanstart[t1]);
 
         for(; b1 > b2 && b1 >= t1; b1--)
-            R_MapPlane(b1, spanstart[b1]);
+            R_MapPlane(rc, b1, spanstart[b1]);
 
         while(t2 < t1 && t2 <= b2)
-            spanstart[t2++] = ds_x2;
+            spanstart[t2++] = rc->ds_x2;
 
         while(b2 > b1 && b2 >= t2)
-            spanstart[b2--] = ds_x2;
+            spanstart[b2--] = rc->ds_x2;
     }
     TracyCZoneEnd(tracy_zone)
 }
@@ -440,6 +578,9 @@ static void R_MakeSpans(visplane_t* pl)
 
 static int offsets[1024 * 4096];
 
+// Offsets for the current frame, shared by every render thread
+static int* swirloffset = offsets;
+
 //
 // R_InitDistortedFlats
 // [BH] Moved to separate function and called at startup
@@ -471,235 +612,337 @@ void R_InitDistortedFlats(void)
 //
 static byte* R_DistortedFlat(const int flatnum)
 {
-    static byte distortedflat[64 * 64];
-    static int prevflatnum = -1;
-    static int prevtic     = -1;
-    static byte* normalflat;
-    static int* offset = offsets;
+    static THREADLOCAL byte distortedflat[64 * 64];
+    static THREADLOCAL int prevflatnum = -1;
+    static THREADLOCAL int* prevoffset;
 
-    if(prevtic != animatedtic && updateswirl)
+    if(prevflatnum != flatnum || prevoffset != swirloffset)
     {
-        offset  = &offsets[(animatedtic & 1023) << 12];
-        prevtic = animatedtic;
-
-        if(prevflatnum != flatnum)
-        {
-            normalflat  = lumpinfo[firstflat + flatnum]->cache;
-            prevflatnum = flatnum;
-        }
+        const byte* normalflat = lumpinfo[firstflat + flatnum]->cache;
 
-        for(int i = 0; i < 64 * 64; i++)
-            distortedflat[i] = normalflat[offset[i]];
-    }
-    else if(prevflatnum != flatnum)
-    {
-        normalflat  = lumpinfo[firstflat + flatnum]->cache;
         prevflatnum = flatnum;
+        prevoffset  = swirloffset;
 
         for(int i = 0; i < 64 * 64; i++)
-            distortedflat[i] = normalflat[offset[i]];
+            distortedflat[i] = normalflat[swirloffset[i]];
     }
 
     return distortedflat;
 }
 
-static void DrawSkyTex(visplane_t* pl, skytex_t* skytex, void func(void))
+static void DrawSkyTex(rendercontext_t* rc, visplane_t* pl, skytex_t* skytex, void func(rendercontext_t* rc))
 {
     const int texture = R_TextureNumForName(skytex->name);
     const angle_t angle = viewangle + (skytex->currx << (ANGLETOSKYSHIFT - FRACBITS));
 
-    dc_texturemid = (fixed_t)(skytex->mid * FRACUNIT) + skytex->curry;
-    dc_texheight  = textureheight[texture] >> FRACBITS;
-    dc_iscale     = FixedMul(skyiscale, skytex->scaley);
+    rc->dc_texturemid = (fixed_t)(skytex->mid * FRACUNIT) + skytex->curry;
+    rc->dc_texheight  = textureheight[texture] >> FRACBITS;
+    rc->dc_iscale     = FixedMul(skyiscale, skytex->scaley);
 
-    for(dc_x = pl->left; dc_x <= pl->right; dc_x++)
-        if((dc_yl = pl->top[dc_x]) != USHRT_MAX && dc_yl <= (dc_yh = pl->bottom[dc_x]))
+    for(rc->dc_x = pl->left; rc->dc_x <= pl->right; rc->dc_x++)
+        if((rc->dc_yl = pl->top[rc->dc_x]) != USHRT_MAX && rc->dc_yl <= (rc->dc_yh = pl->bottom[rc->dc_x]))
         {
-            dc_source = R_GetTextureColumn(R_CacheTextureCompositePatchNum(texture),
-            FixedMul((angle + xtoskyangle[dc_x]) >> ANGLETOSKYSHIFT, skytex->scalex));
+            rc->dc_source = R_GetTextureColumn(R_CacheTextureCompositePatchNum(texture),
+            FixedMul((angle + xtoskyangle[rc->dc_x]) >> ANGLETOSKYSHIFT, skytex->scalex));
 
-            func();
+            func(rc);
         }
 }
 
 //
-// R_DrawPlanes
-// At the end of each frame.
+// R_SetupPlanes
+// Once a frame, before any render thread draws its planes.
 //
-void R_DrawPlanes(void)
+void R_SetupPlanes(void)
 {
-    TracyCZoneN(tracy_zone, "R_DrawPlanes", 1);
     xtoskyangle = (r_linearskies ? linearskyangle : xtoviewangle);
 
     if(r_liquid_swirl)
+    {
         updateswirl = !(consoleactive || helpscreen || paused || freeze);
 
-    dc_colormap[0] = (fixedcolormap && r_textures ? fixedcolormap : fullcolormap);
+        if(updateswirl)
+            swirloffset = &offsets[(animatedtic & 1023) << 12];
+    }
+}
+
+//
+// R_MergePlane
+// Moves the columns of src into dest, as long as none of them are already
+// taken. Both planes must have the same flat, height, light and offsets, so
+// the spans come out exactly as if they'd been drawn apart.
+//
+static bool R_MergePlane(visplane_t* dest, visplane_t* src)
+{
+    const int left  = MAX(dest->left, src->left);
+    const int right = MIN(dest->right, src->right);
+
+    for(int x = left; x <= right; x++)
+        if(dest->top[x] != USHRT_MAX && src->top[x] != USHRT_MAX)
+            return false;
+
+    for(int x = src->left; x <= src->right; x++)
+        if(src->top[x] != USHRT_MAX)
+        {
+            dest->top[x]    = src->top[x];
+            dest->bottom[x] = src->bottom[x];
+        }
+
+    dest->left    = MIN(dest->left, src->left);
+    dest->right   = MAX(dest->right, src->right);
+    src->modified = false;
+
+    return true;
+}
+
+static int R_ComparePlanes(const void* a, const void* b)
+{
+    const visplane_t* pl1 = *(const visplane_t**)a;
+    const visplane_t* pl2 = *(const visplane_t**)b;
+
+    if(pl1->picnum != pl2->picnum)
+        return (pl1->picnum < pl2->picnum ? -1 : 1);
+
+    if(pl1->height != pl2->height)
+        return (pl1->height < pl2->height ? -1 : 1);
+
+    return (pl1->angle < pl2->angle ? -1 : (pl1->angle > pl2->angle));
+}
 
-    for(int i = 0; i < MAXVISPLANES; i++)
+//
+// R_MergePlanes
+// R_CheckPlane splits a visplane whenever a seg covers columns it already has,
+// which leaves maps with lots of small sectors with many fragments of the same
+// plane. Put them back together where they don't overlap, then sort what's
+// left by flat, so each flat stays in the cache while all of its spans are
+// drawn, and by height, so R_MapPlane can reuse more of its cached rows.
+//
+static void R_MergePlanes(void)
+{
+    int merged = 0;
+
+    numdrawnplanes = 0;
+
+    // Every visplane chained in the same slot has the same properties
+    for(unsigned int i = 0; i <= visplanesmask; i++)
         for(visplane_t* pl = visplanes[i]; pl; pl = pl->next)
-            if(pl->modified && pl->left <= pl->right)
+        {
+            if(!pl->modified || pl->left > pl->right)
+                continue;
+
+            for(visplane_t* check = pl->next; check; check = check->next)
+                if(check->modified && check->left <= check->right)
+                    merged += R_MergePlane(pl, check);
+
+            if(numdrawnplanes == maxdrawnplanes)
             {
-                const int picnum = pl->picnum;
+                maxdrawnplanes = (maxdrawnplanes ? maxdrawnplanes * 2 : 256);
+                drawnplanes    = I_Realloc(drawnplanes, maxdrawnplanes * sizeof(*drawnplanes));
+            }
 
-                ds_sectorcolormap = fullcolormap;
+            drawnplanes[numdrawnplanes++] = pl;
+        }
 
-                if(picnum == skyflatnum)
-                {
-                    dc_iscale = skyiscale;
+    qsort(drawnplanes, numdrawnplanes, sizeof(*drawnplanes), &R_ComparePlanes);
 
-                    if(sky && (!vanilla || sky->type != SkyType_Fire))
-                    {
-                        id24compatible = true;
+    // every strip finds the same visplanes
+    if(!r_strip)
+    {
+        visplanesfound = numdrawnplanes + merged;
+        visplanesdrawn = numdrawnplanes;
+    }
+}
 
-                        if(sky->type == SkyType_Fire)
-                        {
-                            dc_texheight  = FIREHEIGHT;
-                            dc_texturemid = -28 * FRACUNIT;
-
-                            for(dc_x = pl->left; dc_x <= pl->right; dc_x++)
-                                if((dc_yl = pl->top[dc_x]) != USHRT_MAX &&
-                                dc_yl <= (dc_yh = pl->bottom[dc_x]))
-                                {
-                                    dc_source = R_GetFireColumn(
-                                    (viewangle + xtoskyangle[dc_x]) >> ANGLETOSKYSHIFT);
-
-                                    skycolfunc();
-                                }
-                        }
-                        else
-                        {
-                            DrawSkyTex(pl, &sky->skytex, skycolfunc);
+//
+// R_GetVisplaneCounts
+//
+void R_GetVisplaneCounts(int* found, int* drawn)
+{
+    *found = visplanesfound;
+    *drawn = visplanesdrawn;
+}
 
-                            if(sky->type == SkyType_WithForeground)
-                                DrawSkyTex(pl, &sky->foreground, &R_DrawSkyColumn);
-                        }
-                    }
-                    else
-                    {
-                        // Normal DOOM sky, only one allowed per level
-                        const int texture = texturetranslation[skytexture];
-                        const rpatch_t* patch = R_CacheTextureCompositePatchNum(texture);
-
-                        dc_texheight  = textureheight[texture] >> FRACBITS;
-                        dc_texturemid = skytexturemid;
-
-                        for(dc_x = pl->left; dc_x <= pl->right; dc_x++)
-                            if((dc_yl = pl->top[dc_x]) != USHRT_MAX &&
-                            dc_yl <= (dc_yh = pl->bottom[dc_x]))
-                            {
-                                dc_source = R_GetTextureColumn(patch,
-                                (((viewangle + xtoskyangle[dc_x]) /
-                                 (1 << (ANGLETOSKYSHIFT - FRACBITS))) +
-                                skycolumnoffset) /
-                                FRACUNIT);
-
-                                skycolfunc();
-                            }
-                    }
-                }
-                else if((picnum & PL_FLATMAPPING) == PL_FLATMAPPING)
-                {
-                    const int texture = (picnum & ~PL_FLATMAPPING);
-                    const rpatch_t* patch = R_CacheTextureCompositePatchNum(texture);
+//
+// R_DrawPlanes
+// At the end of each frame.
+//
+void R_DrawPlanes(rendercontext_t* rc)
+{
+    TracyCZoneN(tracy_zone, "R_DrawPlanes", 1);
+
+    // skies have no sector colormap, but still get the view's
+    rc->dc_colormap[0] =
+    FUSEDLIGHT(fusedcolormaps[0], (fixedcolormap && r_textures ? fixedcolormap : fullcolormap));
+    rc->dc_sectorcolormap = nosectorcolormap;
 
-                    dc_iscale     = skyiscale;
-                    dc_texheight  = textureheight[texture] >> FRACBITS;
-                    dc_texturemid = skytexturemid;
+    R_MergePlanes();
 
-                    for(dc_x = pl->left; dc_x <= pl->right; dc_x++)
-                        if((dc_yl = pl->top[dc_x]) != USHRT_MAX &&
-                        dc_yl <= (dc_yh = pl->bottom[dc_x]))
+    for(int i = 0; i < numdrawnplanes; i++)
+    {
+        visplane_t* pl   = drawnplanes[i];
+        const int picnum = pl->picnum;
+
+        // only draw the columns in this thread's strip
+        pl->left  = MAX(pl->left, r_stripleft);
+        pl->right = MIN(pl->right, r_stripright);
+
+        if(pl->left > pl->right)
+            continue;
+
+        if(picnum == skyflatnum)
+        {
+            rc->dc_iscale = skyiscale;
+
+            if(sky && (!vanilla || sky->type != SkyType_Fire))
+            {
+                id24compatible = true;
+
+                if(sky->type == SkyType_Fire)
+                {
+                    rc->dc_texheight  = FIREHEIGHT;
+                    rc->dc_texturemid = -28 * FRACUNIT;
+
+                    for(rc->dc_x = pl->left; rc->dc_x <= pl->right; rc->dc_x++)
+                        if((rc->dc_yl = pl->top[rc->dc_x]) != USHRT_MAX &&
+                        rc->dc_yl <= (rc->dc_yh = pl->bottom[rc->dc_x]))
                         {
-                            dc_source = R_GetTextureColumn(patch,
-                            (((viewangle + xtoskyangle[dc_x]) /
-                             (1 << (ANGLETOSKYSHIFT - FRACBITS))) +
-                            skycolumnoffset) /
-                            FRACUNIT);
+                            rc->dc_source = R_GetFireColumn(
+                            (viewangle + xtoskyangle[rc->dc_x]) >> ANGLETOSKYSHIFT);
 
-                            R_DrawWallColumn();
+                            skycolfunc(rc);
                         }
                 }
-                else if(picnum & PL_SKYFLAT)
+                else
                 {
-                    // killough 10/98: allow skies to come from sidedefs.
-                    // Allows scrolling and/or animated skies, as well as
-                    // arbitrary multiple skies per level without having
-                    // to use info lumps.
+                    DrawSkyTex(rc, pl, &sky->skytex, skycolfunc);
 
-                    // Sky linedef
-                    const line_t* line = lines + (picnum & ~PL_SKYFLAT);
+                    if(sky->type == SkyType_WithForeground)
+                        DrawSkyTex(rc, pl, &sky->foreground, &R_DrawSkyColumn);
+                }
+            }
+            else
+            {
+                // Normal DOOM sky, only one allowed per level
+                const int texture = texturetranslation[skytexture];
+                const rpatch_t* patch = R_CacheTextureCompositePatchNum(texture);
 
-                    // Sky transferred from first sidedef
-                    const side_t* side = sides + *line->sidenum;
+                rc->dc_texheight  = textureheight[texture] >> FRACBITS;
+                rc->dc_texturemid = skytexturemid;
 
-                    if(side->missingtoptexture)
+                for(rc->dc_x = pl->left; rc->dc_x <= pl->right; rc->dc_x++)
+                    if((rc->dc_yl = pl->top[rc->dc_x]) != USHRT_MAX &&
+                    rc->dc_yl <= (rc->dc_yh = pl->bottom[rc->dc_x]))
                     {
-                        for(dc_x = pl->left; dc_x <= pl->right; dc_x++)
-                            if((dc_yl = pl->top[dc_x]) != USHRT_MAX &&
-                            dc_yl <= (dc_yh = pl->bottom[dc_x]))
-                                R_DrawSolidColorColumn();
+                        rc->dc_source = R_GetTextureColumn(patch,
+                        (((viewangle + xtoskyangle[rc->dc_x]) /
+                         (1 << (ANGLETOSKYSHIFT - FRACBITS))) +
+                        skycolumnoffset) /
+                        FRACUNIT);
+
+                        skycolfunc(rc);
                     }
-                    else
-                    {
-                        // Texture comes from upper texture of reference sidedef
-                        const int texture = texturetranslation[side->toptexture];
+            }
+        }
+        else if((picnum & PL_FLATMAPPING) == PL_FLATMAPPING)
+        {
+            const int texture = (picnum & ~PL_FLATMAPPING);
+            const rpatch_t* patch = R_CacheTextureCompositePatchNum(texture);
+
+            rc->dc_iscale     = skyiscale;
+            rc->dc_texheight  = textureheight[texture] >> FRACBITS;
+            rc->dc_texturemid = skytexturemid;
+
+            for(rc->dc_x = pl->left; rc->dc_x <= pl->right; rc->dc_x++)
+                if((rc->dc_yl = pl->top[rc->dc_x]) != USHRT_MAX &&
+                rc->dc_yl <= (rc->dc_yh = pl->bottom[rc->dc_x]))
+                {
+                    rc->dc_source = R_GetTextureColumn(patch,
+                    (((viewangle + xtoskyangle[rc->dc_x]) /
+                     (1 << (ANGLETOSKYSHIFT - FRACBITS))) +
+                    skycolumnoffset) /
+                    FRACUNIT);
+
+                    R_DrawWallColumn(rc);
+                }
+        }
+        else if(picnum & PL_SKYFLAT)
+        {
+            // killough 10/98: allow skies to come from sidedefs.
+            // Allows scrolling and/or animated skies, as well as
+            // arbitrary multiple skies per level without having
+            // to use info lumps.
+
+            // Sky linedef
+            const line_t* line = lines + (picnum & ~PL_SKYFLAT);
 
-                        // Horizontal offset is turned into an angle offset,
-                        // to allow sky rotation as well as careful positioning.
-                        // However, the offset is scaled very small, so that it
-                        // allows a long-period of sky rotation.
-                        const angle_t angle = viewangle + side->textureoffset;
+            // Sky transferred from first sidedef
+            const side_t* side = sides + *line->sidenum;
 
-                        angle_t flip = 0U;
-                        const rpatch_t* patch = R_CacheTextureCompositePatchNum(texture);
+            if(side->missingtoptexture)
+            {
+                for(rc->dc_x = pl->left; rc->dc_x <= pl->right; rc->dc_x++)
+                    if((rc->dc_yl = pl->top[rc->dc_x]) != USHRT_MAX &&
+                    rc->dc_yl <= (rc->dc_yh = pl->bottom[rc->dc_x]))
+                        R_DrawSolidColorColumn(rc);
+            }
+            else
+            {
+                // Texture comes from upper texture of reference sidedef
+                const int texture = texturetranslation[side->toptexture];
 
-                        dc_iscale = skyiscale;
+                // Horizontal offset is turned into an angle offset,
+                // to allow sky rotation as well as careful positioning.
+                // However, the offset is scaled very small, so that it
+                // allows a long-period of sky rotation.
+                const angle_t angle = viewangle + side->textureoffset;
 
-                        // Vertical offset allows careful sky positioning.
-                        dc_texturemid = side->rowoffset - 28 * FRACUNIT;
+                angle_t flip = 0U;
+                const rpatch_t* patch = R_CacheTextureCompositePatchNum(texture);
 
-                        dc_texheight = textureheight[texture] >> FRACBITS;
+                rc->dc_iscale = skyiscale;
 
-                        if(canfreelook)
-                            dc_texturemid = dc_texturemid * dc_texheight / SKYSTRETCH_HEIGHT;
+                // Vertical offset allows careful sky positioning.
+                rc->dc_texturemid = side->rowoffset - 28 * FRACUNIT;
 
-                        // We sometimes flip the picture horizontally.
+                rc->dc_texheight = textureheight[texture] >> FRACBITS;
 
-                        // DOOM always flipped the picture, so we make it
-                        // optional, to make it easier to use the new feature,
-                        // while to still allow old sky textures to be used.
-                        if(line->special != TransferSkyTextureToTaggedSectors_Flipped)
-                            flip = ~0U;
+                if(canfreelook)
+                    rc->dc_texturemid = rc->dc_texturemid * rc->dc_texheight / SKYSTRETCH_HEIGHT;
 
-                        for(dc_x = pl->left; dc_x <= pl->right; dc_x++)
-                            if((dc_yl = pl->top[dc_x]) != USHRT_MAX &&
-                            dc_yl <= (dc_yh = pl->bottom[dc_x]))
-                            {
-                                dc_source = R_GetTextureColumn(patch,
-                                ((((angle + xtoskyangle[dc_x]) ^ flip) /
-                                 (1 << (ANGLETOSKYSHIFT - FRACBITS))) +
-                                skycolumnoffset) /
-                                FRACUNIT);
+                // We sometimes flip the picture horizontally.
+
+                // DOOM always flipped the picture, so we make it
+                // optional, to make it easier to use the new feature,
+                // while to still allow old sky textures to be used.
+                if(line->special != TransferSkyTextureToTaggedSectors_Flipped)
+                    flip = ~0U;
+
+                for(rc->dc_x = pl->left; rc->dc_x <= pl->right; rc->dc_x++)
+                    if((rc->dc_yl = pl->top[rc->dc_x]) != USHRT_MAX &&
+                    rc->dc_yl <= (rc->dc_yh = pl->bottom[rc->dc_x]))
+                    {
+                        rc->dc_source = R_GetTextureColumn(patch,
+                        ((((angle + xtoskyangle[rc->dc_x]) ^ flip) /
+                         (1 << (ANGLETOSKYSHIFT - FRACBITS))) +
+                        skycolumnoffset) /
+                        FRACUNIT);
 
-                                skycolfunc();
-                            }
+                        skycolfunc(rc);
                     }
-                }
-                else
-                {
-                    // regular flat
-                    ds_source = (terraintypes[picnum] >= LIQUID && r_liquid_swirl ?
-                    R_DistortedFlat(picnum) :
-                    lumpinfo[flattranslation[picnum]]->cache);
-                    ds_sectorcolormap =
-                    (pl->colormap && viewplayer->fixedcolormap != INVERSECOLORMAP ?
-                    colormaps[pl->colormap] :
-                    fullcolormap);
-
-                    R_MakeSpans(pl);
-                }
             }
+        }
+        else
+        {
+            // regular flat
+            rc->ds_source = (terraintypes[picnum] >= LIQUID && r_liquid_swirl ?
+            R_DistortedFlat(picnum) :
+            lumpinfo[flattranslation[picnum]]->cache);
+            rc->ds_fusedcolormap =
+            fusedcolormaps[viewplayer->fixedcolormap != INVERSECOLORMAP ? pl->colormap : 0];
+
+            R_MakeSpans(rc, pl);
+        }
+    }
     TracyCZoneEnd(tracy_zone)
 }
 
@@ -707,18 +950,25 @@ void R_DrawPlanes(void)
 static int yslopes_alloc_count = 0;
 
 //
-// R_ResizePlaneBuffers
-// Allocates or reallocates plane rendering buffers for the current scale.
-// Called by R_ResizeRenderState when buffer sizes need to increase.
+// R_ResizePlaneStripBuffers
+// Allocates or reallocates the plane buffers each render thread keeps for itself.
+// Called by R_ResizePlaneBuffers, and by each render thread before it draws its strip.
 //
 // Buffer sizes:
 //   openings: r_alloc_max_screen_area elements
 //   floorclip, ceilingclip: r_alloc_max_width elements
 //   cachedheight, cacheddistance, cached*: r_alloc_max_height elements
-//   yslopes: r_alloc_lookdirs x r_alloc_max_height 2D array
 //
-void R_ResizePlaneBuffers(void)
+void R_ResizePlaneStripBuffers(void)
 {
+    if(openings && planebufferwidth == r_alloc_max_width &&
+       planebufferheight == r_alloc_max_height && planebufferarea == r_alloc_max_screen_area)
+        return;
+
+    // Visplanes carved for another width are no use
+    if(planebufferwidth != r_alloc_max_width)
+        R_FreePlaneBlocks();
+
     // Free existing buffers
     if(openings) free(openings);
     if(floorclip) free(floorclip);
@@ -732,16 +982,6 @@ void R_ResizePlaneBuffers(void)
     if(cachedangle) free(cachedangle);
     if(spanstart) free(spanstart);
 
-    // Free yslopes 2D array using the tracked allocation count
-    if(yslopes)
-    {
-        for(int i = 0; i < yslopes_alloc_count; i++)
-            if(yslopes[i]) free(yslopes[i]);
-        free(yslopes);
-        yslopes = NULL;
-        yslopes_alloc_count = 0;
-    }
-
     // Allocate new buffers based on current allocation sizes
     openings = calloc(r_alloc_max_screen_area, sizeof(int));
     floorclip = calloc(r_alloc_max_width, sizeof(int));
@@ -762,6 +1002,33 @@ void R_ResizePlaneBuffers(void)
        !cachedangle || !spanstart)
         I_Error("R_ResizePlaneBuffers: Failed to allocate plane buffers");
 
+    planebufferwidth = r_alloc_max_width;
+    planebufferheight = r_alloc_max_height;
+    planebufferarea = r_alloc_max_screen_area;
+}
+
+//
+// R_ResizePlaneBuffers
+// Allocates or reallocates plane rendering buffers for the current scale.
+// Called by R_ResizeRenderState when buffer sizes need to increase.
+//
+// Buffer sizes:
+//   yslopes: r_alloc_lookdirs x r_alloc_max_height 2D array
+//
+void R_ResizePlaneBuffers(void)
+{
+    R_ResizePlaneStripBuffers();
+
+    // Free yslopes 2D array using the tracked allocation count
+    if(yslopes)
+    {
+        for(int i = 0; i < yslopes_alloc_count; i++)
+            if(yslopes[i]) free(yslopes[i]);
+        free(yslopes);
+        yslopes = NULL;
+        yslopes_alloc_count = 0;
+    }
+
     // Allocate yslopes 2D array and track the count
     yslopes = calloc(r_alloc_lookdirs, sizeof(fixed_t*));
     if(!yslopes)
@@ -40,15 +40,17 @@
 #define PL_FLATMAPPING 0xC0000000
 
 // Visplane related.
-extern int* lastopening;
-extern int* floorclip;
-extern int* ceilingclip;
+extern THREADLOCAL int* lastopening;
+extern THREADLOCAL int* floorclip;
+extern THREADLOCAL int* ceilingclip;
 extern fixed_t* yslope;
 extern fixed_t** yslopes;
-extern int* openings;
+extern THREADLOCAL int* openings;
 
 void R_ClearPlanes(void);
-void R_DrawPlanes(void);
+void R_SetupPlanes(void);
+void R_DrawPlanes(rendercontext_t* rc);
+void R_GetVisplaneCounts(int* found, int* drawn);
 visplane_t* R_FindPlane(fixed_t height,
 const int picnum,
 int lightlevel,
@@ -60,3 +62,4 @@ visplane_t* R_CheckPlane(visplane_t* pl, const int start, const int stop);
 visplane_t* R_DupPlane(const visplane_t* pl, const int start, const int stop);
 void R_InitDistortedFlats(void);
 void R_ResizePlaneBuffers(void);
+void R_ResizePlaneStripBuffers(void);
@@ -38,63 +38,64 @@
 #include "system/i_system.h"
 #include "system/i_config.h"
 #include "system/i_video.h"
+#include "render/r_threads.h"
 #include "mud_profiling.h"
 
-static bool segtextured; // True if any of the segs textures might be visible.
+static THREADLOCAL bool segtextured; // True if any of the segs textures might be visible.
 
-static bool markfloor; // False if the back side is the same plane.
-static bool markceiling;
+static THREADLOCAL bool markfloor; // False if the back side is the same plane.
+static THREADLOCAL bool markceiling;
 
-static bool maskedtexture;
-static int toptexture;
-static int midtexture;
-static int bottomtexture;
+static THREADLOCAL bool maskedtexture;
+static THREADLOCAL int toptexture;
+static THREADLOCAL int midtexture;
+static THREADLOCAL int bottomtexture;
 
-static bool missingtoptexture;
-static bool missingmidtexture;
-static bool missingbottomtexture;
+static THREADLOCAL bool missingtoptexture;
+static THREADLOCAL bool missingmidtexture;
+static THREADLOCAL bool missingbottomtexture;
 
-static fixed_t toptexheight;
-static fixed_t midtexheight;
-static fixed_t bottomtexheight;
+static THREADLOCAL fixed_t toptexheight;
+static THREADLOCAL fixed_t midtexheight;
+static THREADLOCAL fixed_t bottomtexheight;
 
-static byte* topbrightmap;
-static byte* midbrightmap;
-static byte* bottombrightmap;
+static THREADLOCAL byte* topbrightmap;
+static THREADLOCAL byte* midbrightmap;
+static THREADLOCAL byte* bottombrightmap;
 
-static angle_t rw_normalangle;
-static fixed_t rw_distance;
+static THREADLOCAL angle_t rw_normalangle;
+static THREADLOCAL fixed_t rw_distance;
 
 //
 // regular wall
 //
-static int rw_x;
-static int rw_stopx;
-static angle_t rw_centerangle;
-static fixed_t rw_offset;
-static fixed_t rw_scale;
-static fixed_t rw_scalestep;
-static fixed_t rw_midtexturemid;
-static fixed_t rw_toptexturemid;
-static fixed_t rw_bottomtexturemid;
+static THREADLOCAL int rw_x;
+static THREADLOCAL int rw_stopx;
+static THREADLOCAL angle_t rw_centerangle;
+static THREADLOCAL fixed_t rw_offset;
+static THREADLOCAL fixed_t rw_scale;
+static THREADLOCAL fixed_t rw_scalestep;
+static THREADLOCAL fixed_t rw_midtexturemid;
+static THREADLOCAL fixed_t rw_toptexturemid;
+static THREADLOCAL fixed_t rw_bottomtexturemid;
 
-static int64_t pixhigh;
-static int64_t pixlow;
-static fixed_t pixhighstep;
-static fixed_t pixlowstep;
+static THREADLOCAL int64_t pixhigh;
+static THREADLOCAL int64_t pixlow;
+static THREADLOCAL fixed_t pixhighstep;
+static THREADLOCAL fixed_t pixlowstep;
 
-static int64_t topfrac;
-static fixed_t topstep;
+static THREADLOCAL int64_t topfrac;
+static THREADLOCAL fixed_t topstep;
 
-static int64_t bottomfrac;
-static fixed_t bottomstep;
+static THREADLOCAL int64_t bottomfrac;
+static THREADLOCAL fixed_t bottomstep;
 
-static lighttable_t** walllights;
-static lighttable_t** walllightsnext;
+static THREADLOCAL lighttable_t** walllights;
+static THREADLOCAL lighttable_t** walllightsnext;
 
-static int* maskedtexturecol; // dropoff overflow
+static THREADLOCAL int* maskedtexturecol; // dropoff overflow
 
-unsigned int maxdrawsegs;
+THREADLOCAL unsigned int maxdrawsegs;
 
 //
 // R_FixWiggle()
@@ -135,19 +136,32 @@ unsigned int maxdrawsegs;
 //   increasing the precision of various renderer variables, and,
 //   possibly, creating a noticeable performance penalty.
 //
-static int max_rwscale = 64 * FRACUNIT;
-static int heightbits  = 12;
-static int heightunit  = 1 << 12;
-static int invhgtbits  = FRACBITS - 12;
+//  Every render thread works from its own copy of the cache, taken from the
+//   sectors by R_LoadWiggleCache() at the start of its strip, so it adjusts
+//   each wall just as a single thread would.
+//
+static THREADLOCAL int* cachedheights;
+static THREADLOCAL int cachedheightssize;
+static THREADLOCAL int max_rwscale = 64 * FRACUNIT;
+static THREADLOCAL int heightbits  = 12;
+static THREADLOCAL int heightunit  = 1 << 12;
+static THREADLOCAL int invhgtbits  = FRACBITS - 12;
+
+static int frame_max_rwscale = 64 * FRACUNIT;
+static int frame_heightbits  = 12;
 
 static void R_FixWiggle(sector_t* sector)
 {
+    // a copy made by R_FakeFlat() caches its own height
+    int* cachedheight =
+    (sector == &sectors[sector->id] ? &cachedheights[sector->id] : &sector->cachedheight);
+
     // disallow negative heights, force cache initialization
     int height =
     MAX(1, (sector->interpceilingheight - sector->interpfloorheight) >> FRACBITS);
 
     // initialize, or handle moving sector
-    if(height != sector->cachedheight)
+    if(height != *cachedheight)
     {
         typedef struct
         {
@@ -163,7 +177,7 @@ static void R_FixWiggle(sector_t* sector)
         int scaleindex = 0;
         const scalevalues_t* scalevalue;
 
-        sector->cachedheight = height;
+        *cachedheight = height;
         height >>= 7;
 
         // calculate adjustment
@@ -179,37 +193,81 @@ static void R_FixWiggle(sector_t* sector)
     }
 }
 
+//
+// R_LoadWiggleCache
+// Called by each render thread before it renders its strip.
+//
+void R_LoadWiggleCache(void)
+{
+    if(cachedheightssize < numsectors)
+    {
+        cachedheightssize = numsectors;
+        cachedheights     = I_Realloc(cachedheights, cachedheightssize * sizeof(*cachedheights));
+    }
+
+    for(int i = 0; i < numsectors; i++)
+        cachedheights[i] = sectors[i].cachedheight;
+
+    max_rwscale = frame_max_rwscale;
+    heightbits  = frame_heightbits;
+    heightunit  = 1 << heightbits;
+    invhgtbits  = FRACBITS - heightbits;
+}
+
+//
+// R_GetCachedHeight
+// For R_FakeFlat() to start its copy of a sector from this thread's cache.
+//
+int R_GetCachedHeight(const sector_t* sec)
+{
+    return (sec->id < cachedheightssize ? cachedheights[sec->id] : sec->cachedheight);
+}
+
+//
+// R_SaveWiggleCache
+// Called on the main thread once every strip is done, to keep what its strip
+// left in the cache for the next frame.
+//
+void R_SaveWiggleCache(void)
+{
+    for(int i = 0; i < numsectors; i++)
+        sectors[i].cachedheight = cachedheights[i];
+
+    frame_max_rwscale = max_rwscale;
+    frame_heightbits  = heightbits;
+}
+
 static lighttable_t** GetLightTable(const int lightlevel)
 {
     return scalelight[BETWEEN(0,
     (lightlevel >> LIGHTSEGSHIFT) + extralight + curline->fakecontrast, LIGHTLEVELS - 1)];
 }
 
-static void R_BlastMaskedSegColumn(const rcolumn_t* column)
+static void R_BlastMaskedSegColumn(rendercontext_t* rc, const rcolumn_t* column)
 {
     TracyCZoneN(tracy_zone, "R_BlastMaskedSegColumn", 1);
 
     unsigned char* pixels = column->pixels;
 
-    dc_ceilingclip = mceilingclip[dc_x] + 1;
-    dc_floorclip   = mfloorclip[dc_x] - 1;
+    rc->dc_ceilingclip = mceilingclip[rc->dc_x] + 1;
+    rc->dc_floorclip   = mfloorclip[rc->dc_x] - 1;
 
-    while(dc_numposts--)
+    while(rc->dc_numposts--)
     {
-        const rpost_t* post = &column->posts[dc_numposts];
+        const rpost_t* post = &column->posts[rc->dc_numposts];
         const int topdelta  = post->topdelta;
 
         // calculate unclipped screen coordinates for post
         const int64_t topscreen = sprtopscreen + (int64_t)spryscale * topdelta + 1;
 
-        if((dc_yh = MIN((int)((topscreen + (int64_t)spryscale * post->length) >> FRACBITS),
-            dc_floorclip)) >= 0)
-            if((dc_yl = MAX(dc_ceilingclip, (int)((topscreen + FRACUNIT - 1) >> FRACBITS))) <= dc_yh)
+        if((rc->dc_yh = MIN((int)((topscreen + (int64_t)spryscale * post->length) >> FRACBITS),
+            rc->dc_floorclip)) >= 0)
+            if((rc->dc_yl = MAX(rc->dc_ceilingclip, (int)((topscreen + FRACUNIT - 1) >> FRACBITS))) <= rc->dc_yh)
             {
-                dc_texturefrac = dc_texturemid - (topdelta << FRACBITS) +
-                FixedMul((dc_yl - r_centery) << FRACBITS, dc_iscale);
-                dc_source = pixels + topdelta;
-                colfunc();
+                rc->dc_texturefrac = rc->dc_texturemid - (topdelta << FRACBITS) +
+                FixedMul((rc->dc_yl - r_centery) << FRACBITS, rc->dc_iscale);
+                rc->dc_source = pixels + topdelta;
+                rc->colfunc(rc);
             }
     }
 
@@ -219,13 +277,21 @@ static void R_BlastMaskedSegColumn(const rcolumn_t* column)
 //
 // R_RenderMaskedSegRange
 //
-void R_RenderMaskedSegRange(const drawseg_t* ds, const int x1, const int x2)
+void R_RenderMaskedSegRange(rendercontext_t* rc, const drawseg_t* ds, int x1, int x2)
 {
-    TracyCZoneN(tracy_zone, "R_RenderMaskedSegRange", 1);
     int texnum;
     fixed_t texheight;
     const rpatch_t* patch;
 
+    // only draw the columns in this thread's strip
+    x1 = MAX(x1, r_stripleft);
+    x2 = MIN(x2, r_stripright);
+
+    if(x1 > x2)
+        return;
+
+    TracyCZoneN(tracy_zone, "R_RenderMaskedSegRange", 1);
+
     curline     = ds->curline;
     frontsector = curline->frontsector;
     backsector  = curline->backsector;
@@ -237,13 +303,13 @@ void R_RenderMaskedSegRange(const drawseg_t* ds, const int x1, const int x2)
     // killough 04/13/98: get correct lightlevel for 2s normal textures
     if(fixedcolormap)
     {
-        dc_colormap[0]     = fixedcolormap;
-        dc_nextcolormap[0] = fixedcolormap;
-        dc_sectorcolormap =
+        rc->dc_colormap[0]     = fixedcolormap;
+        rc->dc_nextcolormap[0] = fixedcolormap;
+        rc->dc_sectorcolormap =
         (frontsector->colormap && viewplayer->fixedcolormap != INVERSECOLORMAP ?
         colormaps[frontsector->colormap] :
         fullcolormap);
-        colfunc = (curline->linedef->tranlump >= 0 ? tl50segcolfunc : segcolfunc);
+        rc->colfunc = (curline->linedef->tranlump >= 0 ? tl50segcolfunc : segcolfunc);
     }
     else
     {
@@ -256,13 +322,13 @@ void R_RenderMaskedSegRange(const drawseg_t* ds, const int x1, const int x2)
 
         if(usebrightmaps && !nobrightmap[texnum] && brightmap[texnum])
         {
-            dc_brightmap = brightmap[texnum];
-            colfunc = (curline->linedef->tranlump >= 0 ? tl50bmapsegcolfunc : bmapsegcolfunc);
+            rc->dc_brightmap = brightmap[texnum];
+            rc->colfunc = (curline->linedef->tranlump >= 0 ? tl50bmapsegcolfunc : bmapsegcolfunc);
         }
         else
-            colfunc = (curline->linedef->tranlump >= 0 ? tl50segcolfunc : segcolfunc);
+            rc->colfunc = (curline->linedef->tranlump >= 0 ? tl50segcolfunc : segcolfunc);
 
-        dc_sectorcolormap =
+        rc->dc_sectorcolormap =
         (frontsector->colormap ? colormaps[frontsector->colormap] : fullcolormap);
     }
 
@@ -274,23 +340,23 @@ void R_RenderMaskedSegRange(const drawseg_t* ds, const int x1, const int x2)
 
     // find positioning
     if(curline->linedef->flags & ML_DONTPEGBOTTOM)
-        dc_texturemid = MAX(frontsector->interpfloorheight, backsector->interpfloorheight) +
+        rc->dc_texturemid = MAX(frontsector->interpfloorheight, backsector->interpfloorheight) +
         texheight - viewz + curline->sidedef->rowoffset;
     else
-        dc_texturemid =
+        rc->dc_texturemid =
         MIN(frontsector->interpceilingheight, backsector->interpceilingheight) -
         viewz + curline->sidedef->rowoffset;
 
     patch = R_CacheTextureCompositePatchNum(texnum);
 
     // draw the columns
-    for(dc_x = x1; dc_x <= x2; dc_x++, spryscale += rw_scalestep)
-        if(maskedtexturecol[dc_x] != INT_MAX)
+    for(rc->dc_x = x1; rc->dc_x <= x2; rc->dc_x++, spryscale += rw_scalestep)
+        if(maskedtexturecol[rc->dc_x] != INT_MAX)
         {
             const rcolumn_t* column =
-            R_GetPatchColumnWrapped(patch, maskedtexturecol[dc_x]);
+            R_GetPatchColumnWrapped(patch, maskedtexturecol[rc->dc_x]);
 
-            if((dc_numposts = column->numposts))
+            if((rc->dc_numposts = column->numposts))
             {
                 // killough 03/02/98:
                 //
@@ -302,7 +368,7 @@ void R_RenderMaskedSegRange(const drawseg_t* ds, const int x1, const int x2)
                 // arithmetic and by skipping the drawing of 2s normals whose
                 // mapping to screen coordinates is totally out of range:
                 const int64_t t = ((int64_t)r_centeryfrac << FRACBITS) -
-                (int64_t)dc_texturemid * spryscale;
+                (int64_t)rc->dc_texturemid * spryscale;
 
                 // skip if the texture is out of screen's range
                 if(t + (int64_t)texheight * spryscale < 0 ||
@@ -317,16 +383,16 @@ void R_RenderMaskedSegRange(const drawseg_t* ds, const int x1, const int x2)
                     const int index =
                     MIN(spryscale >> LIGHTSCALESHIFT, MAXLIGHTSCALE - 1);
 
-                    dc_colormap[0]     = walllights[index];
-                    dc_nextcolormap[0] = walllightsnext[index];
-                    dc_z               = ((spryscale >> 5) & 255);
+                    rc->dc_colormap[0]     = walllights[index];
+                    rc->dc_nextcolormap[0] = walllightsnext[index];
+                    rc->dc_z               = ((spryscale >> 5) & 255);
                 }
 
-                dc_iscale = UINT_MAX / (unsigned int)spryscale;
+                rc->dc_iscale = UINT_MAX / (unsigned int)spryscale;
 
                 // draw the texture
-                R_BlastMaskedSegColumn(column);
-                maskedtexturecol[dc_x] = INT_MAX; // dropoff overflow
+                R_BlastMaskedSegColumn(rc, column);
+                maskedtexturecol[rc->dc_x] = INT_MAX; // dropoff overflow
             }
         }
     TracyCZoneEnd(tracy_zone)
@@ -338,18 +404,28 @@ void R_RenderMaskedSegRange(const drawseg_t* ds, const int x1, const int x2)
 // Can draw or mark the starting pixel of floor and ceiling textures.
 // CALLED: CORE LOOPING ROUTINE.
 //
-static bool didsolidcol;
+static THREADLOCAL bool didsolidcol;
 
-static void R_RenderSegLoop(void)
+static void R_RenderSegLoop(rendercontext_t* rc)
 {
+    lighttable_t* fused =
+    fusedcolormaps[fixedcolormap && viewplayer->fixedcolormap == INVERSECOLORMAP ? 0 : frontsector->colormap];
+
+    // the sector's colormap is already part of the light tables
+    rc->dc_sectorcolormap = nosectorcolormap;
+    rc->dc_brightcolormap = fused;
+
     if(fixedcolormap)
     {
-        dc_colormap[0]     = fixedcolormap;
-        dc_nextcolormap[0] = fixedcolormap;
+        rc->dc_colormap[0]     = FUSEDLIGHT(fused, fixedcolormap);
+        rc->dc_nextcolormap[0] = rc->dc_colormap[0];
     }
 
+    // Every column is clipped, so planes and sprites are clipped just as they
+    // are by a single thread, but only those in the strip are drawn.
     for(; rw_x < rw_stopx; rw_x++)
     {
+        const bool instrip    = (rw_x >= r_stripleft && rw_x <= r_stripright);
         fixed_t texturecolumn = 0;
 
         // no space above wall?
@@ -388,7 +464,7 @@ static void R_RenderSegLoop(void)
         }
 
         // texturecolumn and lighting are independent of wall tiers
-        if(segtextured)
+        if(segtextured && instrip)
         {
             // calculate texture offset and lighting
             const angle_t angle = MIN((rw_centerangle + xtoviewangle[rw_x]) >> ANGLETOFINESHIFT,
@@ -397,65 +473,61 @@ static void R_RenderSegLoop(void)
             texturecolumn =
             (rw_offset - FixedMul(finetangent[angle], rw_distance)) >> FRACBITS;
 
-            if(fixedcolormap)
-                dc_sectorcolormap =
-                (frontsector->colormap && viewplayer->fixedcolormap != INVERSECOLORMAP ?
-                colormaps[frontsector->colormap] :
-                fullcolormap);
-            else
+            if(!fixedcolormap)
             {
                 const int index = MIN(rw_scale >> LIGHTSCALESHIFT, MAXLIGHTSCALE - 1);
 
-                dc_colormap[0]     = walllights[index];
-                dc_nextcolormap[0] = walllightsnext[index];
-                dc_z               = ((rw_scale >> 5) & 255);
-                dc_sectorcolormap =
-                (frontsector->colormap ? colormaps[frontsector->colormap] : fullcolormap);
+                rc->dc_colormap[0]     = FUSEDLIGHT(fused, walllights[index]);
+                rc->dc_nextcolormap[0] = FUSEDLIGHT(fused, walllightsnext[index]);
+                rc->dc_z               = ((rw_scale >> 5) & 255);
             }
 
-            dc_x      = rw_x;
-            dc_iscale = UINT_MAX / rw_scale;
+            rc->dc_x      = rw_x;
+            rc->dc_iscale = UINT_MAX / rw_scale;
         }
 
         // draw the wall tiers
         if(midtexture && yh >= yl)
         {
             // single sided line
-            dc_yl = yl;
-            dc_yh = yh;
-
-            if(missingmidtexture)
-                missingcolfunc();
-            else
+            if(instrip)
             {
-                dc_source = R_GetTextureColumn(
-                R_CacheTextureCompositePatchNum(midtexture), texturecolumn);
-                dc_texturemid = rw_midtexturemid;
-                dc_texheight  = midtexheight;
+                rc->dc_yl = yl;
+                rc->dc_yh = yh;
 
-                if(midbrightmap)
+                if(missingmidtexture)
+                    missingcolfunc(rc);
+                else
                 {
-                    dc_brightmap = midbrightmap;
+                    rc->dc_source = R_GetTextureColumn(
+                    R_CacheTextureCompositePatchNum(midtexture), texturecolumn);
+                    rc->dc_texturemid = rw_midtexturemid;
+                    rc->dc_texheight  = midtexheight;
 
-                    if(r_ditheredlighting)
+                    if(midbrightmap)
                     {
-                        if(!memcmp(dc_colormap, dc_nextcolormap, sizeof(dc_colormap)))
-                            altbmapwallcolfunc();
+                        rc->dc_brightmap = midbrightmap;
+
+                        if(r_ditheredlighting)
+                        {
+                            if(!memcmp(rc->dc_colormap, rc->dc_nextcolormap, sizeof(rc->dc_colormap)))
+                                altbmapwallcolfunc(rc);
+                            else
+                                bmapwallcolfunc(rc);
+                        }
                         else
-                            bmapwallcolfunc();
+                            bmapwallcolfunc(rc);
+                    }
+                    else if(r_ditheredlighting)
+                    {
+                        if(!memcmp(rc->dc_colormap, rc->dc_nextcolormap, sizeof(rc->dc_colormap)))
+                            altwallcolfunc(rc);
+                        else
+                            wallcolfunc(rc);
                     }
                     else
-                        bmapwallcolfunc();
-                }
-                else if(r_ditheredlighting)
-                {
-                    if(!memcmp(dc_colormap, dc_nextcolormap, sizeof(dc_colormap)))
-                        altwallcolfunc();
-                    else
-                        wallcolfunc();
+                        wallcolfunc(rc);
                 }
-                else
-                    wallcolfunc();
             }
 
             ceilingclip[rw_x] = render.view_height;
@@ -473,42 +545,45 @@ static void R_RenderSegLoop(void)
 
                 if(mid >= yl)
                 {
-                    dc_yl = yl;
-                    dc_yh = mid;
-
-                    if(missingtoptexture)
-                        missingcolfunc();
-                    else
+                    if(instrip)
                     {
-                        dc_source = R_GetTextureColumn(
-                        R_CacheTextureCompositePatchNum(toptexture), texturecolumn);
-                        dc_texturemid = rw_toptexturemid + (dc_yl - r_centery + 1) * SPARKLEFIX;
-                        dc_iscale -= SPARKLEFIX;
-                        dc_texheight = toptexheight;
+                        rc->dc_yl = yl;
+                        rc->dc_yh = mid;
 
-                        if(topbrightmap)
+                        if(missingtoptexture)
+                            missingcolfunc(rc);
+                        else
                         {
-                            dc_brightmap = topbrightmap;
+                            rc->dc_source = R_GetTextureColumn(
+                            R_CacheTextureCompositePatchNum(toptexture), texturecolumn);
+                            rc->dc_texturemid = rw_toptexturemid + (rc->dc_yl - r_centery + 1) * SPARKLEFIX;
+                            rc->dc_iscale -= SPARKLEFIX;
+                            rc->dc_texheight = toptexheight;
 
-                            if(r_ditheredlighting)
+                            if(topbrightmap)
                             {
-                                if(!memcmp(dc_colormap, dc_nextcolormap, sizeof(dc_colormap)))
-                                    altbmapwallcolfunc();
+                                rc->dc_brightmap = topbrightmap;
+
+                                if(r_ditheredlighting)
+                                {
+                                    if(!memcmp(rc->dc_colormap, rc->dc_nextcolormap, sizeof(rc->dc_colormap)))
+                                        altbmapwallcolfunc(rc);
+                                    else
+                                        bmapwallcolfunc(rc);
+                                }
                                 else
-                                    bmapwallcolfunc();
+                                    bmapwallcolfunc(rc);
+                            }
+                            else if(r_ditheredlighting)
+                            {
+                                if(!memcmp(rc->dc_colormap, rc->dc_nextcolormap, sizeof(rc->dc_colormap)))
+                                    altwallcolfunc(rc);
+                                else
+                                    wallcolfunc(rc);
                             }
                             else
-                                bmapwallcolfunc();
-                        }
-                        else if(r_ditheredlighting)
-                        {
-                            if(!memcmp(dc_colormap, dc_nextcolormap, sizeof(dc_colormap)))
-                                altwallcolfunc();
-                            else
-                                wallcolfunc();
+                                wallcolfunc(rc);
                         }
-                        else
-                            wallcolfunc();
                     }
 
                     ceilingclip[rw_x] = mid;
@@ -531,41 +606,44 @@ static void R_RenderSegLoop(void)
 
                 if(mid <= yh)
                 {
-                    dc_yl = mid;
-                    dc_yh = yh;
-
-                    if(missingbottomtexture)
-                        missingcolfunc();
-                    else
+                    if(instrip)
                     {
-                        dc_source = R_GetTextureColumn(
-                        R_CacheTextureCompositePatchNum(bottomtexture), texturecolumn);
-                        dc_texturemid = rw_bottomtexturemid;
-                        dc_texheight  = bottomtexheight;
+                        rc->dc_yl = mid;
+                        rc->dc_yh = yh;
 
-                        if(bottombrightmap)
+                        if(missingbottomtexture)
+                            missingcolfunc(rc);
+                        else
                         {
-                            dc_brightmap = bottombrightmap;
+                            rc->dc_source = R_GetTextureColumn(
+                            R_CacheTextureCompositePatchNum(bottomtexture), texturecolumn);
+                            rc->dc_texturemid = rw_bottomtexturemid;
+                            rc->dc_texheight  = bottomtexheight;
 
-                            if(r_ditheredlighting)
+                            if(bottombrightmap)
                             {
-                                if(!memcmp(dc_colormap, dc_nextcolormap, sizeof(dc_colormap)))
-                                    altbmapwallcolfunc();
+                                rc->dc_brightmap = bottombrightmap;
+
+                                if(r_ditheredlighting)
+                                {
+                                    if(!memcmp(rc->dc_colormap, rc->dc_nextcolormap, sizeof(rc->dc_colormap)))
+                                        altbmapwallcolfunc(rc);
+                                    else
+                                        bmapwallcolfunc(rc);
+                                }
                                 else
-                                    bmapwallcolfunc();
+                                    bmapwallcolfunc(rc);
+                            }
+                            else if(r_ditheredlighting)
+                            {
+                                if(!memcmp(rc->dc_colormap, rc->dc_nextcolormap, sizeof(rc->dc_colormap)))
+                                    altwallcolfunc(rc);
+                                else
+                                    wallcolfunc(rc);
                             }
                             else
-                                bmapwallcolfunc();
-                        }
-                        else if(r_ditheredlighting)
-                        {
-                            if(!memcmp(dc_colormap, dc_nextcolormap, sizeof(dc_colormap)))
-                                altwallcolfunc();
-                            else
-                                wallcolfunc();
+                                wallcolfunc(rc);
                         }
-                        else
-                            wallcolfunc();
                     }
 
                     floorclip[rw_x] = mid;
@@ -616,7 +694,7 @@ static fixed_t R_ScaleFromGlobalAngle(angle_t visangle)
 // R_StoreWallRange
 // A wall segment will be drawn between start and stop pixels (inclusive).
 //
-void R_StoreWallRange(const int start, const int stop)
+void R_StoreWallRange(rendercontext_t* rc, const int start, const int stop)
 {
     TracyCZoneN(tracy_zone, "R_StoreWallRange", 1);
     int64_t dx, dy;
@@ -632,8 +710,9 @@ void R_StoreWallRange(const int start, const int stop)
     linedef = curline->linedef;
     flags   = linedef->flags;
 
-    // mark the segment as visible for automap
-    if(!menuactive && !(flags & ML_MAPPED) && !(flags & ML_DONTDRAW) &&
+    // mark the segment as visible for automap. Every strip sees the same
+    // segs, so the leftmost one marks them for all of them.
+    if(!r_strip && !menuactive && !(flags & ML_MAPPED) && !(flags & ML_DONTDRAW) &&
     (am_dynamic || !automapactive))
     {
         nummappedlines++;
@@ -741,7 +820,7 @@ void R_StoreWallRange(const int start, const int stop)
 
             midtexture = texturetranslation[sidedef->midtexture];
             height     = textureheight[midtexture];
-            midtexheight = ((linedef->r_flags & RF_MID_TILE) ? 0 : (height >> FRACBITS));
+            midtexheight = ((lineflags & RF_MID_TILE) ? 0 : (height >> FRACBITS));
             midbrightmap =
             (usebrightmaps && !nobrightmap[midtexture] ? brightmap[midtexture] : NULL);
             rw_midtexturemid = ((linedef->flags & ML_DONTPEGBOTTOM) ?
@@ -763,7 +842,7 @@ void R_StoreWallRange(const int start, const int stop)
         int liquidoffset = 0;
 
         // two sided line
-        if(linedef->r_flags & RF_CLOSED)
+        if(lineflags & RF_CLOSED)
         {
             ds_p->sprtopclip    = viewheightarray;
             ds_p->sprbottomclip = negonearray;
@@ -856,7 +935,7 @@ void R_StoreWallRange(const int start, const int stop)
                 toptexture = texturetranslation[sidedef->toptexture];
                 height     = textureheight[toptexture];
                 toptexheight =
-                ((linedef->r_flags & RF_TOP_TILE) ? 0 : (height >> FRACBITS));
+                ((lineflags & RF_TOP_TILE) ? 0 : (height >> FRACBITS));
                 topbrightmap =
                 (usebrightmaps && !nobrightmap[toptexture] ? brightmap[toptexture] : NULL);
                 rw_toptexturemid = ((linedef->flags & ML_DONTPEGTOP) ?
@@ -879,7 +958,7 @@ void R_StoreWallRange(const int start, const int stop)
                 bottomtexture = texturetranslation[sidedef->bottomtexture];
                 height        = textureheight[bottomtexture];
                 bottomtexheight =
-                ((linedef->r_flags & RF_BOT_TILE) ? 0 : (height >> FRACBITS));
+                ((lineflags & RF_BOT_TILE) ? 0 : (height >> FRACBITS));
                 bottombrightmap = (usebrightmaps && !nobrightmap[bottomtexture] ?
                 brightmap[bottomtexture] :
                 NULL);
@@ -990,7 +1069,7 @@ void R_StoreWallRange(const int start, const int stop)
     }
 
     didsolidcol = false;
-    R_RenderSegLoop();
+    R_RenderSegLoop(rc);
 
     if((backsector && didsolidcol) || maskedtexture)
         ds_p->silhouette = SIL_BOTH;
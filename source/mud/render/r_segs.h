@@ -37,7 +37,10 @@
 
 #define SPARKLEFIX 64
 
-extern unsigned int maxdrawsegs;
+extern THREADLOCAL unsigned int maxdrawsegs;
 
-void R_RenderMaskedSegRange(const drawseg_t* ds, const int x1, const int x2);
-void R_StoreWallRange(const int start, const int stop);
+void R_RenderMaskedSegRange(rendercontext_t* rc, const drawseg_t* ds, int x1, int x2);
+void R_StoreWallRange(rendercontext_t* rc, const int start, const int stop);
+void R_LoadWiggleCache(void);
+void R_SaveWiggleCache(void);
+int R_GetCachedHeight(const sector_t* sec);
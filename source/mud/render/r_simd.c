@@ -0,0 +1,284 @@
+/*
+==============================================================================
+
+                                 DOOM Retro
+           The classic, refined DOOM source port. For Windows PC.
+
+==============================================================================
+
+    Copyright © 1993-2025 by id Software LLC, a ZeniMax Media company.
+    Copyright © 2013-2025 by Brad Harding <mailto:brad@doomretro.com>.
+
+    This file is a part of DOOM Retro.
+
+    DOOM Retro is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation, either version 3 of the license, or (at your
+    option) any later version.
+
+    DOOM Retro is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DOOM Retro. If not, see <https://www.gnu.org/licenses/>.
+
+    DOOM is a registered trademark of id Software LLC, a ZeniMax Media
+    company, in the US and/or other countries, and is used without
+    permission. All other trademarks are the property of their respective
+    holders. DOOM Retro is in no way affiliated with nor endorsed by
+    id Software.
+
+==============================================================================
+*/
+
+#include <string.h>
+
+#include "console/c_console.h"
+#include "render/r_simd.h"
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define SIMD_WASM
+#elif defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#define SIMD_X86
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SIMD_NEON
+#endif
+
+#if defined(_MSC_VER)
+#define ALIGN16 __declspec(align(16))
+#define ALIGN32 __declspec(align(32))
+#else
+#define ALIGN16 __attribute__((aligned(16)))
+#define ALIGN32 __attribute__((aligned(32)))
+#endif
+
+spanblocksfunc_t    spanblocksfunc;
+const char*         spanblocksisa = "scalar";
+
+//
+// R_SpanBlockLookup
+// There is no byte gather on any of the targets, so once the texel offsets of
+// a block have been worked out, the texel and light table lookups are done
+// one pixel at a time into a local block that is then stored in one go.
+//
+static inline void R_SpanBlockLookup(byte* dest, const uint32_t* offsets, const byte* source,
+    const lighttable_t* const* colormaps, bool dithered)
+{
+    byte    block[SPANBLOCK];
+
+    if(dithered)
+        for(int i = 0; i < SPANBLOCK; i++)
+            block[i] = colormaps[i][source[offsets[i]]];
+    else
+    {
+        const lighttable_t* colormap = colormaps[0];
+
+        for(int i = 0; i < SPANBLOCK; i++)
+            block[i] = colormap[source[offsets[i]]];
+    }
+
+    memcpy(dest, block, SPANBLOCK);
+}
+
+//
+// The offset of a texel in a 64x64 flat is ((xfrac >> 16) & 63) | ((yfrac >> 10) & 4032),
+// which gives the same result whether the shifts are arithmetic or logical, so
+// every path below steps xfrac and yfrac as wrapping unsigned lanes.
+//
+#if defined(SIMD_X86)
+
+static void R_DrawSpanBlocksSSE2(byte* dest, int blocks, const byte* source,
+    const lighttable_t* const* colormaps, bool dithered,
+    uint32_t xfrac, uint32_t yfrac, uint32_t xstep, uint32_t ystep)
+{
+    ALIGN16 uint32_t    offsets[SPANBLOCK];
+    const __m128i       xmask = _mm_set1_epi32(63);
+    const __m128i       ymask = _mm_set1_epi32(4032);
+    const __m128i       xstep4 = _mm_set1_epi32(xstep * 4);
+    const __m128i       ystep4 = _mm_set1_epi32(ystep * 4);
+    __m128i             x = _mm_setr_epi32(xfrac, xfrac + xstep, xfrac + xstep * 2, xfrac + xstep * 3);
+    __m128i             y = _mm_setr_epi32(yfrac, yfrac + ystep, yfrac + ystep * 2, yfrac + ystep * 3);
+
+    while(blocks--)
+    {
+        for(int i = 0; i < SPANBLOCK; i += 4)
+        {
+            _mm_store_si128((__m128i*)&offsets[i],
+                _mm_or_si128(_mm_and_si128(_mm_srli_epi32(x, 16), xmask),
+                    _mm_and_si128(_mm_srli_epi32(y, 10), ymask)));
+            x = _mm_add_epi32(x, xstep4);
+            y = _mm_add_epi32(y, ystep4);
+        }
+
+        R_SpanBlockLookup(dest, offsets, source, colormaps, dithered);
+        dest += SPANBLOCK;
+    }
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2")))
+#endif
+static void R_DrawSpanBlocksAVX2(byte* dest, int blocks, const byte* source,
+    const lighttable_t* const* colormaps, bool dithered,
+    uint32_t xfrac, uint32_t yfrac, uint32_t xstep, uint32_t ystep)
+{
+    ALIGN32 uint32_t    offsets[SPANBLOCK];
+    const __m256i       lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i       xmask = _mm256_set1_epi32(63);
+    const __m256i       ymask = _mm256_set1_epi32(4032);
+    const __m256i       xstep8 = _mm256_set1_epi32(xstep * 8);
+    const __m256i       ystep8 = _mm256_set1_epi32(ystep * 8);
+    __m256i             x = _mm256_add_epi32(_mm256_set1_epi32(xfrac), _mm256_mullo_epi32(lanes, _mm256_set1_epi32(xstep)));
+    __m256i             y = _mm256_add_epi32(_mm256_set1_epi32(yfrac), _mm256_mullo_epi32(lanes, _mm256_set1_epi32(ystep)));
+
+    while(blocks--)
+    {
+        for(int i = 0; i < SPANBLOCK; i += 8)
+        {
+            _mm256_store_si256((__m256i*)&offsets[i],
+                _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(x, 16), xmask),
+                    _mm256_and_si256(_mm256_srli_epi32(y, 10), ymask)));
+            x = _mm256_add_epi32(x, xstep8);
+            y = _mm256_add_epi32(y, ystep8);
+        }
+
+        R_SpanBlockLookup(dest, offsets, source, colormaps, dithered);
+        dest += SPANBLOCK;
+    }
+}
+
+static bool R_CPUHasAVX2(void)
+{
+#if defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 0);
+
+    if(info[0] < 7)
+        return false;
+
+    // AVX2 also needs the OS to save the YMM registers
+    __cpuid(info, 1);
+
+    if(!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+
+    return !!(info[1] & (1 << 5));
+#else
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#elif defined(SIMD_NEON)
+
+static void R_DrawSpanBlocksNEON(byte* dest, int blocks, const byte* source,
+    const lighttable_t* const* colormaps, bool dithered,
+    uint32_t xfrac, uint32_t yfrac, uint32_t xstep, uint32_t ystep)
+{
+    uint32_t            offsets[SPANBLOCK];
+    const uint32_t      xinit[4] = { xfrac, xfrac + xstep, xfrac + xstep * 2, xfrac + xstep * 3 };
+    const uint32_t      yinit[4] = { yfrac, yfrac + ystep, yfrac + ystep * 2, yfrac + ystep * 3 };
+    const uint32x4_t    xmask = vdupq_n_u32(63);
+    const uint32x4_t    ymask = vdupq_n_u32(4032);
+    const uint32x4_t    xstep4 = vdupq_n_u32(xstep * 4);
+    const uint32x4_t    ystep4 = vdupq_n_u32(ystep * 4);
+    uint32x4_t          x = vld1q_u32(xinit);
+    uint32x4_t          y = vld1q_u32(yinit);
+
+    while(blocks--)
+    {
+        for(int i = 0; i < SPANBLOCK; i += 4)
+        {
+            vst1q_u32(&offsets[i], vorrq_u32(vandq_u32(vshrq_n_u32(x, 16), xmask),
+                vandq_u32(vshrq_n_u32(y, 10), ymask)));
+            x = vaddq_u32(x, xstep4);
+            y = vaddq_u32(y, ystep4);
+        }
+
+        R_SpanBlockLookup(dest, offsets, source, colormaps, dithered);
+        dest += SPANBLOCK;
+    }
+}
+
+#elif defined(SIMD_WASM)
+
+static void R_DrawSpanBlocksSIMD128(byte* dest, int blocks, const byte* source,
+    const lighttable_t* const* colormaps, bool dithered,
+    uint32_t xfrac, uint32_t yfrac, uint32_t xstep, uint32_t ystep)
+{
+    uint32_t        offsets[SPANBLOCK];
+    const v128_t    xmask = wasm_i32x4_splat(63);
+    const v128_t    ymask = wasm_i32x4_splat(4032);
+    const v128_t    xstep4 = wasm_i32x4_splat(xstep * 4);
+    const v128_t    ystep4 = wasm_i32x4_splat(ystep * 4);
+    v128_t          x = wasm_i32x4_make(xfrac, xfrac + xstep, xfrac + xstep * 2, xfrac + xstep * 3);
+    v128_t          y = wasm_i32x4_make(yfrac, yfrac + ystep, yfrac + ystep * 2, yfrac + ystep * 3);
+
+    while(blocks--)
+    {
+        for(int i = 0; i < SPANBLOCK; i += 4)
+        {
+            wasm_v128_store(&offsets[i], wasm_v128_or(wasm_v128_and(wasm_u32x4_shr(x, 16), xmask),
+                wasm_v128_and(wasm_u32x4_shr(y, 10), ymask)));
+            x = wasm_i32x4_add(x, xstep4);
+            y = wasm_i32x4_add(y, ystep4);
+        }
+
+        R_SpanBlockLookup(dest, offsets, source, colormaps, dithered);
+        dest += SPANBLOCK;
+    }
+}
+
+#endif
+
+//
+// R_InitSIMD
+// Picks the widest span path the CPU supports. It is only done once, since
+// the answer can't change while the game is running.
+//
+void R_InitSIMD(void)
+{
+    static bool initialized;
+
+    if(initialized)
+        return;
+
+    initialized = true;
+
+#if defined(SIMD_X86)
+    if(R_CPUHasAVX2())
+    {
+        spanblocksfunc = &R_DrawSpanBlocksAVX2;
+        spanblocksisa  = "AVX2";
+    }
+    else
+    {
+        // SSE2 is always there on x86-64, and 32-bit builds only get here
+        // when built with it
+        spanblocksfunc = &R_DrawSpanBlocksSSE2;
+        spanblocksisa  = "SSE2";
+    }
+#elif defined(SIMD_NEON)
+    spanblocksfunc = &R_DrawSpanBlocksNEON;
+    spanblocksisa  = "NEON";
+#elif defined(SIMD_WASM)
+    spanblocksfunc = &R_DrawSpanBlocksSIMD128;
+    spanblocksisa  = "SIMD128";
+#endif
+
+    if(spanblocksfunc)
+        C_Output("Floors and ceilings are drawn %i pixels at a time using " BOLD("%s") ".",
+            SPANBLOCK, spanblocksisa);
+}
@@ -0,0 +1,57 @@
+/*
+==============================================================================
+
+                                 DOOM Retro
+           The classic, refined DOOM source port. For Windows PC.
+
+==============================================================================
+
+    Copyright © 1993-2025 by id Software LLC, a ZeniMax Media company.
+    Copyright © 2013-2025 by Brad Harding <mailto:brad@doomretro.com>.
+
+    This file is a part of DOOM Retro.
+
+    DOOM Retro is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation, either version 3 of the license, or (at your
+    option) any later version.
+
+    DOOM Retro is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DOOM Retro. If not, see <https://www.gnu.org/licenses/>.
+
+    DOOM is a registered trademark of id Software LLC, a ZeniMax Media
+    company, in the US and/or other countries, and is used without
+    permission. All other trademarks are the property of their respective
+    holders. DOOM Retro is in no way affiliated with nor endorsed by
+    id Software.
+
+==============================================================================
+*/
+
+#pragma once
+
+#include "render/r_defs.h"
+
+// The number of pixels of a span the vectorized drawers handle at once. The
+// dither matrices repeat every 4 or 8 pixels, so every block starts with the
+// same dither pattern.
+#define SPANBLOCK   16
+
+// Draws blocks * SPANBLOCK pixels of a span. If dithered, colormaps holds the
+// colormap of each pixel of a block, otherwise only colormaps[0] is used. The
+// fractions are passed unsigned so that stepping them wraps like the scalar
+// drawers do.
+typedef void (*spanblocksfunc_t)(byte* dest, int blocks, const byte* source,
+    const lighttable_t* const* colormaps, bool dithered,
+    uint32_t xfrac, uint32_t yfrac, uint32_t xstep, uint32_t ystep);
+
+// NULL if there is no vectorized path for this CPU
+extern spanblocksfunc_t spanblocksfunc;
+extern const char*      spanblocksisa;
+
+void R_InitSIMD(void);
@@ -144,7 +144,7 @@ extern int viewangletox[FINEANGLES / 2];
 extern angle_t* xtoviewangle;
 extern angle_t* linearskyangle;
 
-extern visplane_t* floorplane;
-extern visplane_t* ceilingplane;
+extern THREADLOCAL visplane_t* floorplane;
+extern THREADLOCAL visplane_t* ceilingplane;
 
 void R_ResizeMainBuffers(void);
@@ -42,6 +42,7 @@
 #include "system/i_video.h"
 #include "utils/m_array.h"
 #include "system/i_config.h"
+#include "render/r_threads.h"
 #include "render/v_draw.h"
 #include "render/v_video.h"
 #include "wad/w_wad.h"
@@ -54,6 +55,7 @@
 #define BASEYCENTER ((render.vanilla_height / 2) / render.scale)
 
 #define MAXVISSPRITES 256
+#define MAXVISSPLATS 256
 #define DS_RANGES_COUNT 3
 
 //
@@ -64,8 +66,8 @@
 fixed_t pspritescale;
 fixed_t pspriteiscale;
 
-static lighttable_t** spritelights; // killough 01/25/98 made static
-static lighttable_t** nextspritelights;
+static THREADLOCAL lighttable_t** spritelights; // killough 01/25/98 made static
+static THREADLOCAL lighttable_t** nextspritelights;
 
 typedef struct
 {
@@ -79,20 +81,26 @@ typedef struct
     int count;
 } drawsegs_xrange_t;
 
-static drawsegs_xrange_t drawsegs_xranges[DS_RANGES_COUNT];
+static THREADLOCAL drawsegs_xrange_t drawsegs_xranges[DS_RANGES_COUNT];
 
-static drawseg_xrange_item_t* drawsegs_xrange;
-static unsigned int drawsegs_xrange_size;
-static int drawsegs_xrange_count;
+static THREADLOCAL drawseg_xrange_item_t* drawsegs_xrange;
+static THREADLOCAL unsigned int drawsegs_xrange_size;
+static THREADLOCAL int drawsegs_xrange_count;
 
-static mobj_t** nearby_sprites;
+static THREADLOCAL mobj_t** nearby_sprites;
+
+// Per sector, the validcount of the last frame its sprites were added by this
+// render thread
+static THREADLOCAL int* sectoradded;
+static THREADLOCAL int sectoraddedsize;
 
 // constant arrays used for psprite clipping and initializing clipping
 int* negonearray;
 int* viewheightarray;
 
-static int* cliptop;
-static int* clipbot;
+static THREADLOCAL int* cliptop;
+static THREADLOCAL int* clipbot;
+static THREADLOCAL int clipsize;
 
 //
 // INITIALIZATION FUNCTIONS
@@ -109,10 +117,15 @@ bool allowwolfensteinss = true;
 static spriteframe_t sprtemp[MAXSPRITEFRAMES];
 static int maxframe;
 
-static bool drawshadows;
+static THREADLOCAL bool drawshadows;
 static bool interpolatesprites;
 static bool invulnerable;
 
+// Player sprites, projected once a frame and drawn by every render thread
+static vissprite_t psprvissprites[NUMPSPRITES];
+static int numpsprvissprites;
+static bool psprinvisibility;
+
 static const fixed_t floatbobdiffs[64] = { 205560, 205560, 203576, 199640,
     193776, 186048, 176528, 165304, 152496, 138216, 122600, 105808, 87992,
     69336, 50008, 30200, 10096, -10096, -30200, -50008, -69336, -87992, -105808,
@@ -367,13 +380,14 @@ static void R_InitSpriteDefs(void)
 // GAME FUNCTIONS
 //
 
-static vissprite_t* vissprites;
-static vissprite_t** vissprite_ptrs;
-static unsigned int num_vissprite;
-static unsigned int num_vissplat;
-static unsigned int num_vissprite_alloc = MAXVISSPRITES;
+static THREADLOCAL vissprite_t* vissprites;
+static THREADLOCAL vissprite_t** vissprite_ptrs;
+static THREADLOCAL unsigned int num_vissprite;
+static THREADLOCAL unsigned int num_vissplat;
+static THREADLOCAL unsigned int num_vissprite_alloc;
 
-static vissplat_t vissplats[r_bloodsplats_max_max];
+static THREADLOCAL vissplat_t* vissplats;
+static THREADLOCAL unsigned int num_vissplat_alloc;
 
 //
 // R_InitSprites
@@ -385,8 +399,6 @@ void R_InitSprites(void)
         negonearray[i] = -1;
 
     R_InitSpriteDefs();
-
-    vissprites = malloc(num_vissprite_alloc * sizeof(*vissprites));
 }
 
 //
@@ -397,6 +409,13 @@ void R_ClearSprites(void)
 {
     num_vissprite = 0;
     num_vissplat  = 0;
+
+    if(sectoraddedsize < numsectors)
+    {
+        sectoraddedsize = numsectors;
+        sectoradded     = I_Realloc(sectoradded, sectoraddedsize * sizeof(*sectoradded));
+        memset(sectoradded, 0, sectoraddedsize * sizeof(*sectoradded));
+    }
 }
 
 //
@@ -414,39 +433,53 @@ static vissprite_t* R_NewVisSprite(void)
     return (vissprites + num_vissprite++);
 }
 
-int* mfloorclip;
-int* mceilingclip;
+//
+// R_NewVisSplat
+//
+static vissplat_t* R_NewVisSplat(void)
+{
+    if(num_vissplat >= num_vissplat_alloc)
+    {
+        num_vissplat_alloc = (num_vissplat_alloc ? num_vissplat_alloc * 2 : MAXVISSPLATS);
+        vissplats = I_Realloc(vissplats, num_vissplat_alloc * sizeof(*vissplats));
+    }
 
-fixed_t spryscale;
-int64_t sprtopscreen;
-static int64_t shadowtopscreen;
-static int shadowshift;
-static int splattopscreen;
+    return (vissplats + num_vissplat++);
+}
 
-static void (*shadowcolfunc)(void);
+THREADLOCAL int* mfloorclip;
+THREADLOCAL int* mceilingclip;
+
+THREADLOCAL fixed_t spryscale;
+THREADLOCAL int64_t sprtopscreen;
+static THREADLOCAL int64_t shadowtopscreen;
+static THREADLOCAL int shadowshift;
+static THREADLOCAL int splattopscreen;
+
+static THREADLOCAL void (*shadowcolfunc)(rendercontext_t* rc);
 
 //
 // R_BlastSpriteColumn
 //
-static void inline R_BlastSpriteColumn(const rcolumn_t* column)
+static void inline R_BlastSpriteColumn(rendercontext_t* rc, const rcolumn_t* column)
 {
     unsigned char* pixels = column->pixels;
 
-    while(dc_numposts--)
+    while(rc->dc_numposts--)
     {
-        const rpost_t* post     = &column->posts[dc_numposts];
+        const rpost_t* post     = &column->posts[rc->dc_numposts];
         const int topdelta      = post->topdelta;
         const int64_t topscreen = sprtopscreen + (int64_t)spryscale * topdelta;
 
-        if((dc_yh = MIN((int)((topscreen + (int64_t)spryscale * post->length - 256) >> FRACBITS),
-            dc_floorclip)) >= 0)
-            if((dc_yl = MAX(dc_ceilingclip,
-                (int)((topscreen + FRACUNIT + 512) >> FRACBITS))) <= dc_yh)
+        if((rc->dc_yh = MIN((int)((topscreen + (int64_t)spryscale * post->length - 256) >> FRACBITS),
+            rc->dc_floorclip)) >= 0)
+            if((rc->dc_yl = MAX(rc->dc_ceilingclip,
+                (int)((topscreen + FRACUNIT + 512) >> FRACBITS))) <= rc->dc_yh)
             {
-                dc_texturefrac = dc_texturemid - (topdelta << FRACBITS) +
-                FixedMul((dc_yl - r_centery) << FRACBITS, dc_iscale);
-                dc_source = pixels + topdelta;
-                colfunc();
+                rc->dc_texturefrac = rc->dc_texturemid - (topdelta << FRACBITS) +
+                FixedMul((rc->dc_yl - r_centery) << FRACBITS, rc->dc_iscale);
+                rc->dc_source = pixels + topdelta;
+                rc->colfunc(rc);
             }
     }
 }
@@ -454,24 +487,24 @@ static void inline R_BlastSpriteColumn(const rcolumn_t* column)
 //
 // R_BlastPlayerSpriteColumn
 //
-static void inline R_BlastPlayerSpriteColumn(const rcolumn_t* column)
+static void inline R_BlastPlayerSpriteColumn(rendercontext_t* rc, const rcolumn_t* column)
 {
     unsigned char* pixels = column->pixels;
 
-    while(dc_numposts--)
+    while(rc->dc_numposts--)
     {
-        const rpost_t* post = &column->posts[dc_numposts];
-        const int topdelta  = post->topdelta;
+        const rpost_t* post     = &column->posts[rc->dc_numposts];
+        const int topdelta      = post->topdelta;
         const int64_t topscreen = sprtopscreen + (int64_t)pspritescale * topdelta + 1;
 
-        if((dc_yh = MIN((int)((topscreen + (int64_t)pspritescale * post->length) >> FRACBITS),
+        if((rc->dc_yh = MIN((int)((topscreen + (int64_t)pspritescale * post->length) >> FRACBITS),
             render.view_height - 1)) >= 0)
-            if((dc_yl = MAX(0, (int)((topscreen + FRACUNIT) >> FRACBITS))) <= dc_yh)
+            if((rc->dc_yl = MAX(0, (int)((topscreen + FRACUNIT) >> FRACBITS))) <= rc->dc_yh)
             {
-                dc_texturefrac = dc_texturemid - (topdelta << FRACBITS) +
-                FixedMul((dc_yl - r_centery) << FRACBITS, dc_iscale);
-                dc_source = pixels + topdelta;
-                colfunc();
+                rc->dc_texturefrac = rc->dc_texturemid - (topdelta << FRACBITS) +
+                FixedMul((rc->dc_yl - r_centery) << FRACBITS, rc->dc_iscale);
+                rc->dc_source = pixels + topdelta;
+                rc->colfunc(rc);
             }
     }
 }
@@ -479,16 +512,18 @@ static void inline R_BlastPlayerSpriteColumn(const rcolumn_t* column)
 //
 // R_DrawVisSprite
 //
-static void R_DrawVisSprite(const vissprite_t* vis)
+static void R_DrawVisSprite(rendercontext_t* rc, const vissprite_t* vis)
 {
-    fixed_t frac          = vis->startfrac;
     const fixed_t xiscale = vis->xiscale;
-    const fixed_t x2      = vis->x2;
+    int x1                = MAX(vis->x1, r_stripleft);
+    int x2                = MIN(vis->x2, r_stripright);
     const rpatch_t* patch = R_CachePatchNum(vis->patch + firstspritelump);
     const mobj_t* mobj    = vis->mobj;
     const int flags       = mobj->flags;
     const int translation = (flags & MF_TRANSLATION);
     int baseclip;
+    fixed_t frac;
+    bool fuzz;
     bool percolumnlighting;
     fixed_t pcl_patchoffset = 0;
     fixed_t pcl_cosine      = 0;
@@ -497,30 +532,42 @@ static void R_DrawVisSprite(const vissprite_t* vis)
 
     spryscale = vis->scale;
 
-    dc_colormap[0]     = vis->colormap;
-    dc_nextcolormap[0] = vis->nextcolormap;
-    dc_sectorcolormap  = vis->sectorcolormap;
-    dc_z               = ((spryscale >> 5) & 255);
-    dc_iscale          = FixedDiv(FRACUNIT, spryscale);
-    dc_texturemid      = vis->texturemid;
+    rc->dc_colormap[0]     = vis->colormap;
+    rc->dc_nextcolormap[0] = vis->nextcolormap;
+    rc->dc_sectorcolormap  = vis->sectorcolormap;
+    rc->dc_z               = ((spryscale >> 5) & 255);
+    rc->dc_iscale          = FixedDiv(FRACUNIT, spryscale);
+    rc->dc_texturemid      = vis->texturemid;
 
     if(translation && (r_corpses_color || !(flags & MF_CORPSE)))
     {
-        colfunc = translatedcolfunc;
-        dc_translation =
+        rc->colfunc = translatedcolfunc;
+        rc->dc_translation =
         &translationtables[(translation >> (MF_TRANSLATIONSHIFT - 8)) - 256];
     }
     else
     {
-        colfunc = vis->colfunc;
+        rc->colfunc = vis->colfunc;
 
-        if(colfunc == bloodcolfunc || colfunc == translatedcolfunc)
-            dc_translation = colortranslation[mobj->bloodcolor - 1];
+        if(rc->colfunc == bloodcolfunc || rc->colfunc == translatedcolfunc)
+            rc->dc_translation = colortranslation[mobj->bloodcolor - 1];
     }
 
-    sprtopscreen = (int64_t)r_centeryfrac - FixedMul(dc_texturemid, spryscale);
+    sprtopscreen = (int64_t)r_centeryfrac - FixedMul(rc->dc_texturemid, spryscale);
     baseclip = (vis->footclip ? (int)(sprtopscreen + vis->footclip) >> FRACBITS : render.view_height);
-    fuzz1pos = 0;
+    rc->fuzz1pos = 0;
+
+    // A fuzzy sprite is walked across its whole width, skipping the fuzz of the
+    // columns outside the strip, so it takes the same fuzz in every strip.
+    if((fuzz = (rc->colfunc == &R_DrawFuzzColumn)))
+    {
+        x1 = vis->x1;
+        x2 = vis->x2;
+    }
+    else if(x1 > x2)
+        return;
+
+    frac = vis->startfrac + xiscale * (x1 - vis->x1);
 
     if((percolumnlighting = (r_percolumnlighting && !vis->fullbright &&
         !fixedcolormap && (flags & (MF_SHOOTABLE | MF_CORPSE)))))
@@ -533,16 +580,21 @@ static void R_DrawVisSprite(const vissprite_t* vis)
         pcl_lightindex  = MIN(spryscale >> LIGHTSCALESHIFT, MAXLIGHTSCALE - 1);
     }
 
-    for(dc_x = vis->x1; dc_x <= x2; dc_x++, frac += xiscale)
+    for(rc->dc_x = x1; rc->dc_x <= x2; rc->dc_x++, frac += xiscale)
     {
         const rcolumn_t* column = R_GetPatchColumnClamped(patch, frac >> FRACBITS);
 
-        if((dc_numposts = column->numposts))
+        if((rc->dc_numposts = column->numposts))
         {
-            dc_ceilingclip = mceilingclip[dc_x] + 1;
-            dc_floorclip   = MIN(baseclip, mfloorclip[dc_x]) - 1;
+            const bool instrip = (rc->dc_x >= r_stripleft && rc->dc_x <= r_stripright);
 
-            if(percolumnlighting)
+            rc->dc_ceilingclip = mceilingclip[rc->dc_x] + 1;
+            rc->dc_floorclip   = MIN(baseclip, mfloorclip[rc->dc_x]) - 1;
+
+            if(fuzz)
+                rc->colfunc = (instrip ? &R_DrawFuzzColumn : &R_SkipFuzzColumn);
+
+            if(percolumnlighting && instrip)
             {
                 const fixed_t offset =
                 (vis->flipped ? pcl_patchoffset - frac : frac - pcl_patchoffset);
@@ -559,14 +611,14 @@ static void R_DrawVisSprite(const vissprite_t* vis)
                 lightnum =
                 ((floorlightlevel + ceilinglightlevel) >> (LIGHTSEGSHIFT + 1)) + extralight;
 
-                dc_colormap[0] =
+                rc->dc_colormap[0] =
                 scalelight[BETWEEN(0, lightnum - 2, LIGHTLEVELS - 1)][pcl_lightindex];
-                dc_nextcolormap[0] =
+                rc->dc_nextcolormap[0] =
                 scalelight[BETWEEN(0, lightnum + 2, LIGHTLEVELS - 1)][pcl_lightindex];
-                dc_sectorcolormap = R_GetSectorColormap(sector);
+                rc->dc_sectorcolormap = R_GetSectorColormap(sector);
             }
 
-            R_BlastSpriteColumn(column);
+            R_BlastSpriteColumn(rc, column);
         }
     }
 }
@@ -574,16 +626,18 @@ static void R_DrawVisSprite(const vissprite_t* vis)
 //
 // R_DrawVisSpriteWithShadow
 //
-static void R_DrawVisSpriteWithShadow(const vissprite_t* vis)
+static void R_DrawVisSpriteWithShadow(rendercontext_t* rc, const vissprite_t* vis)
 {
-    fixed_t frac          = vis->startfrac;
     const fixed_t xiscale = vis->xiscale;
-    const fixed_t x2      = vis->x2;
+    int x1                = MAX(vis->x1, r_stripleft);
+    int x2                = MIN(vis->x2, r_stripright);
     const rpatch_t* patch = R_CachePatchNum(vis->patch + firstspritelump);
     const mobj_t* mobj    = vis->mobj;
     const int flags       = mobj->flags;
     const int translation = (flags & MF_TRANSLATION);
     int black;
+    fixed_t frac;
+    bool fuzz;
     bool percolumnlighting;
     fixed_t pcl_patchoffset = 0;
     fixed_t pcl_cosine      = 0;
@@ -592,53 +646,64 @@ static void R_DrawVisSpriteWithShadow(const vissprite_t* vis)
 
     spryscale = vis->scale;
 
-    dc_colormap[0]     = vis->colormap;
-    dc_nextcolormap[0] = vis->nextcolormap;
-    dc_sectorcolormap  = vis->sectorcolormap;
-    dc_z               = ((spryscale >> 5) & 255);
-    dc_black           = dc_colormap[0][nearestblack];
-    black              = dc_black << 8;
+    rc->dc_colormap[0]     = vis->colormap;
+    rc->dc_nextcolormap[0] = vis->nextcolormap;
+    rc->dc_sectorcolormap  = vis->sectorcolormap;
+    rc->dc_z               = ((spryscale >> 5) & 255);
+    rc->dc_black           = rc->dc_colormap[0][nearestblack];
+    black                  = rc->dc_black << 8;
 
     if(flags & MF_FUZZ)
-        dc_black33 = &tinttab15[black];
+        rc->dc_black33 = &tinttab15[black];
     else if(vis->fullbright)
     {
-        dc_black33 = &tinttab20[black];
-        dc_black40 = &tinttab25[black];
+        rc->dc_black33 = &tinttab20[black];
+        rc->dc_black40 = &tinttab25[black];
     }
     else if((mobj->flags2 & (MF2_TRANSLUCENT_33 | MF2_EXPLODING)) && r_sprites_translucency)
     {
-        dc_black33 = &tinttab10[black];
-        dc_black40 = &tinttab25[black];
+        rc->dc_black33 = &tinttab10[black];
+        rc->dc_black40 = &tinttab25[black];
     }
     else
     {
-        dc_black33 = &tinttab33[black];
-        dc_black40 = &tinttab40[black];
+        rc->dc_black33 = &tinttab33[black];
+        rc->dc_black40 = &tinttab40[black];
     }
 
-    dc_iscale     = FixedDiv(FRACUNIT, spryscale);
-    dc_texturemid = vis->texturemid;
+    rc->dc_iscale     = FixedDiv(FRACUNIT, spryscale);
+    rc->dc_texturemid = vis->texturemid;
 
     if(translation && (r_corpses_color || !(flags & MF_CORPSE)))
     {
-        colfunc = translatedcolfunc;
-        dc_translation =
+        rc->colfunc = translatedcolfunc;
+        rc->dc_translation =
         &translationtables[(translation >> (MF_TRANSLATIONSHIFT - 8)) - 256];
     }
     else
     {
-        colfunc = vis->colfunc;
+        rc->colfunc = vis->colfunc;
 
-        if(colfunc == translatedcolfunc)
-            dc_translation = colortranslation[mobj->bloodcolor - 1];
+        if(rc->colfunc == translatedcolfunc)
+            rc->dc_translation = colortranslation[mobj->bloodcolor - 1];
     }
 
-    sprtopscreen    = (int64_t)r_centeryfrac - FixedMul(dc_texturemid, spryscale);
+    sprtopscreen    = (int64_t)r_centeryfrac - FixedMul(rc->dc_texturemid, spryscale);
     shadowcolfunc   = mobj->shadowcolfunc;
     shadowtopscreen = (int64_t)r_centeryfrac - FixedMul(vis->shadowpos, spryscale);
     shadowshift     = (shadowtopscreen * 9 / 10) >> FRACBITS;
-    fuzz1pos        = 0;
+    rc->fuzz1pos    = 0;
+
+    // As in R_DrawVisSprite()
+    if((fuzz = (rc->colfunc == &R_DrawFuzzColumn)))
+    {
+        x1 = vis->x1;
+        x2 = vis->x2;
+    }
+    else if(x1 > x2)
+        return;
+
+    frac = vis->startfrac + xiscale * (x1 - vis->x1);
 
     if((percolumnlighting = (r_percolumnlighting && !vis->fullbright &&
         !fixedcolormap && (flags & (MF_SHOOTABLE | MF_CORPSE)))))
@@ -651,16 +716,28 @@ static void R_DrawVisSpriteWithShadow(const vissprite_t* vis)
         pcl_lightindex  = MIN(spryscale >> LIGHTSCALESHIFT, MAXLIGHTSCALE - 1);
     }
 
-    for(dc_x = vis->x1; dc_x <= x2; dc_x++, frac += xiscale)
+    for(rc->dc_x = x1; rc->dc_x <= x2; rc->dc_x++, frac += xiscale)
     {
         const rcolumn_t* column = R_GetPatchColumnClamped(patch, frac >> FRACBITS);
 
-        if((dc_numposts = column->numposts))
+        if((rc->dc_numposts = column->numposts))
         {
             const rpost_t* posts = column->posts;
+            const bool instrip   = (rc->dc_x >= r_stripleft && rc->dc_x <= r_stripright);
+
+            rc->dc_ceilingclip = mceilingclip[rc->dc_x] + 1;
+            rc->dc_floorclip   = mfloorclip[rc->dc_x] - 1;
 
-            dc_ceilingclip = mceilingclip[dc_x] + 1;
-            dc_floorclip   = mfloorclip[dc_x] - 1;
+            if(fuzz)
+            {
+                rc->colfunc = (instrip ? &R_DrawFuzzColumn : &R_SkipFuzzColumn);
+
+                if(!instrip)
+                {
+                    R_BlastSpriteColumn(rc, column);
+                    continue;
+                }
+            }
 
             if(percolumnlighting)
             {
@@ -679,27 +756,27 @@ static void R_DrawVisSpriteWithShadow(const vissprite_t* vis)
                 lightnum =
                 ((floorlightlevel + ceilinglightlevel) >> (LIGHTSEGSHIFT + 1)) + extralight;
 
-                dc_colormap[0] =
+                rc->dc_colormap[0] =
                 scalelight[BETWEEN(0, lightnum - 2, LIGHTLEVELS - 1)][pcl_lightindex];
-                dc_nextcolormap[0] =
+                rc->dc_nextcolormap[0] =
                 scalelight[BETWEEN(0, lightnum + 2, LIGHTLEVELS - 1)][pcl_lightindex];
-                dc_sectorcolormap = R_GetSectorColormap(sector);
+                rc->dc_sectorcolormap = R_GetSectorColormap(sector);
             }
 
-            while(dc_numposts--)
+            while(rc->dc_numposts--)
             {
-                const rpost_t* post = &posts[dc_numposts];
+                const rpost_t* post = &posts[rc->dc_numposts];
                 const int64_t topscreen = shadowtopscreen + spryscale * post->topdelta;
 
-                if((dc_yh = MIN((((topscreen + spryscale * post->length) >> FRACBITS) / 10 + shadowshift),
-                    dc_floorclip)) >= 0)
-                    if((dc_yl = MAX(dc_ceilingclip,
-                        ((topscreen + FRACUNIT) >> FRACBITS) / 10 + shadowshift)) <= dc_yh)
-                        shadowcolfunc();
+                if((rc->dc_yh = MIN((((topscreen + spryscale * post->length) >> FRACBITS) / 10 + shadowshift),
+                    rc->dc_floorclip)) >= 0)
+                    if((rc->dc_yl = MAX(rc->dc_ceilingclip,
+                        ((topscreen + FRACUNIT) >> FRACBITS) / 10 + shadowshift)) <= rc->dc_yh)
+                        shadowcolfunc(rc);
             }
 
-            dc_numposts = column->numposts;
-            R_BlastSpriteColumn(column);
+            rc->dc_numposts = column->numposts;
+            R_BlastSpriteColumn(rc, column);
         }
     }
 }
@@ -707,46 +784,64 @@ static void R_DrawVisSpriteWithShadow(const vissprite_t* vis)
 //
 // R_DrawPlayerVisSprite
 //
-static void R_DrawPlayerVisSprite(const vissprite_t* vis)
+static void R_DrawPlayerVisSprite(rendercontext_t* rc, const vissprite_t* vis)
 {
-    fixed_t frac          = vis->startfrac;
-    const fixed_t x2      = vis->x2;
+    const int x1          = MAX(vis->x1, r_stripleft);
+    const int x2          = MIN(vis->x2, r_stripright);
+    fixed_t frac          = vis->startfrac + pspriteiscale * (x1 - vis->x1);
     const rpatch_t* patch = R_CachePatchNum(vis->patch + firstspritelump);
 
-    colfunc            = vis->colfunc;
-    dc_colormap[0]     = vis->colormap;
-    dc_nextcolormap[0] = vis->colormap;
-    dc_sectorcolormap  = vis->sectorcolormap;
-    dc_iscale          = pspriteiscale;
-    dc_texturemid      = vis->texturemid;
-    sprtopscreen = (int64_t)r_centeryfrac - FixedMul(dc_texturemid, pspritescale);
+    rc->colfunc            = vis->colfunc;
+    rc->dc_colormap[0]     = vis->colormap;
+    rc->dc_nextcolormap[0] = vis->colormap;
+    rc->dc_sectorcolormap  = vis->sectorcolormap;
+    rc->dc_iscale          = pspriteiscale;
+    rc->dc_texturemid      = vis->texturemid;
+    sprtopscreen           = (int64_t)r_centeryfrac - FixedMul(rc->dc_texturemid, pspritescale);
 
-    for(dc_x = vis->x1; dc_x <= x2; dc_x++, frac += pspriteiscale)
+    for(rc->dc_x = x1; rc->dc_x <= x2; rc->dc_x++, frac += pspriteiscale)
     {
         const rcolumn_t* column = R_GetPatchColumnClamped(patch, frac >> FRACBITS);
 
-        if((dc_numposts = column->numposts))
-            R_BlastPlayerSpriteColumn(column);
+        if((rc->dc_numposts = column->numposts))
+            R_BlastPlayerSpriteColumn(rc, column);
+    }
+
+    // An interpolated player sprite may end a column past the right of the
+    // view, in the border or, if there isn't one, the leftmost column of the
+    // next row. That's the leftmost strip's to draw.
+    if(vis->x2 == render.view_width && !r_strip && !r_columnmajor)
+    {
+        const rcolumn_t* column = R_GetPatchColumnClamped(patch,
+            (vis->startfrac + pspriteiscale * (vis->x2 - vis->x1)) >> FRACBITS);
+
+        rc->dc_x = vis->x2;
+
+        if((rc->dc_numposts = column->numposts))
+            R_BlastPlayerSpriteColumn(rc, column);
     }
 }
 
 //
 // R_DrawVisSplat
 //
-static void R_DrawVisSplat(const vissplat_t* vis)
+static void R_DrawVisSplat(rendercontext_t* rc, const vissplat_t* vis)
 {
-    fixed_t frac             = vis->startfrac;
     const fixed_t xiscale    = vis->xiscale;
-    const fixed_t x2         = vis->x2;
     const rcolumn_t* columns = R_CachePatchNum(vis->patch)->columns;
+    const bool fuzz          = (vis->colfunc == &R_DrawFuzzColumn);
+    const int x1             = (fuzz ? vis->x1 : MAX(vis->x1, r_stripleft));
+    const int x2             = (fuzz ? vis->x2 : MIN(vis->x2, r_stripright));
+    fixed_t frac             = vis->startfrac + xiscale * (x1 - vis->x1);
 
-    spryscale = vis->scale;
-    colfunc   = vis->colfunc;
-    dc_bloodcolor = &tinttab50[(dc_solidbloodcolor = vis->colormap[vis->color]) << 8];
-    dc_sectorcolormap = vis->sectorcolormap;
-    splattopscreen    = r_centeryfrac - FixedMul(vis->texturemid, spryscale);
+    spryscale             = vis->scale;
+    rc->colfunc           = vis->colfunc;
+    rc->dc_bloodcolor     = &tinttab50[(rc->dc_solidbloodcolor = vis->colormap[vis->color]) << 8];
+    rc->dc_sectorcolormap = vis->sectorcolormap;
+    splattopscreen        = r_centeryfrac - FixedMul(vis->texturemid, spryscale);
 
-    for(dc_x = vis->x1; dc_x <= x2; dc_x++, frac += xiscale)
+    // As in R_DrawVisSprite()
+    for(rc->dc_x = x1; rc->dc_x <= x2; rc->dc_x++, frac += xiscale)
     {
         const rcolumn_t* column = &columns[frac >> FRACBITS];
 
@@ -755,10 +850,14 @@ static void R_DrawVisSplat(const vissplat_t* vis)
             const rpost_t* post = column->posts;
             const int topscreen = splattopscreen + spryscale * post->topdelta;
 
-            if((dc_yh = MIN((topscreen + spryscale * post->length) >> FRACBITS,
-                clipbot[dc_x] - 1)) >= 0)
-                if((dc_yl = MAX(cliptop[dc_x], topscreen >> FRACBITS)) <= dc_yh)
-                    colfunc();
+            if(fuzz)
+                rc->colfunc = (rc->dc_x >= r_stripleft && rc->dc_x <= r_stripright ?
+                    &R_DrawFuzzColumn : &R_SkipFuzzColumn);
+
+            if((rc->dc_yh = MIN((topscreen + spryscale * post->length) >> FRACBITS,
+                clipbot[rc->dc_x] - 1)) >= 0)
+                if((rc->dc_yl = MAX(cliptop[rc->dc_x], topscreen >> FRACBITS)) <= rc->dc_yh)
+                    rc->colfunc(rc);
         }
     }
 }
@@ -1086,7 +1185,7 @@ static void R_ProjectBloodSplat(const bloodsplat_t* splat)
         return;
 
     // store information in a vissprite
-    vis = &vissplats[num_vissplat++];
+    vis = R_NewVisSplat();
 
     vis->scale      = xscale;
     vis->gx         = fx;
@@ -1133,6 +1232,8 @@ static void R_ProjectBloodSplat(const bloodsplat_t* splat)
 void R_AddSprites(sector_t* sec, int lightlevel)
 {
     TracyCZoneN(zone_addsprites, "R_AddSprites", 1);
+    sectoradded[sec - sectors] = validcount;
+
     mobj_t* thing = sec->thinglist;
     bloodsplat_t* splat = (menuactive || !drawbloodsplats ? NULL : sec->splatlist);
 
@@ -1184,6 +1285,11 @@ void R_AddSprites(sector_t* sec, int lightlevel)
     TracyCZoneEnd(zone_addsprites)
 }
 
+bool R_SectorSpritesAdded(const sector_t* sec)
+{
+    return (sectoradded[sec - sectors] == validcount);
+}
+
 void R_AddNearbySprites(sector_t* sec)
 {
     TracyCZoneN(tracy_zone, "R_AddNearbySprites", 1);
@@ -1192,7 +1298,7 @@ void R_AddNearbySprites(sector_t* sec)
     {
         mobj_t* thing = n->m_thing;
 
-        if(thing->subsector->sector->validcount != validcount)
+        if(!R_SectorSpritesAdded(thing->subsector->sector))
             array_push(nearby_sprites, thing);
     }
 
@@ -1211,7 +1317,7 @@ void R_DrawNearbySprites(void)
         sector_t* sec = thing->subsector->sector;
 
         // [FG] sprites in sector have already been projected
-        if(sec->validcount != validcount)
+        if(!R_SectorSpritesAdded(sec))
         {
             const short lightlevel = sec->lightlevel;
 
@@ -1230,21 +1336,20 @@ void R_DrawNearbySprites(void)
 }
 
 //
-// R_DrawPlayerSprite
+// R_ProjectPlayerSprite
 //
 static bool muzzleflash;
 
-static void R_DrawPlayerSprite(const pspdef_t* psp, bool invisibility, bool altered)
+static void R_ProjectPlayerSprite(const pspdef_t* psp, bool invisibility, bool altered)
 {
     fixed_t tx;
     int x1, x2;
-    vissprite_t tempvis   = { 0 };
-    vissprite_t* vis      = &tempvis;
-    const state_t* state  = psp->state;
-    const spritenum_t spr = state->sprite;
-    const int frame       = state->frame;
+    vissprite_t* vis              = &psprvissprites[numpsprvissprites++];
+    const state_t* state          = psp->state;
+    const spritenum_t spr         = state->sprite;
+    const int frame               = state->frame;
     const spriteframe_t* sprframe = &sprites[spr].spriteframes[frame & FF_FRAMEMASK];
-    const int lump = sprframe->lump[0];
+    const int lump                = sprframe->lump[0];
 
     // calculate edges of the shape
     tx = psp->sx - render.vanilla_width / render.scale / 2 * FRACUNIT -
@@ -1291,7 +1396,7 @@ static void R_DrawPlayerSprite(const pspdef_t* psp, bool invisibility, bool alte
             const int deltax = x2 - vis->x1;
 
             vis->x1 = psp_inter.x1 + FixedMul(vis->x1 - psp_inter.x1, fractionaltic);
-            vis->x2         = MIN(vis->x1 + deltax, render.view_width);
+            vis->x2 = MIN(vis->x1 + deltax, render.view_width);
             vis->texturemid = psp_inter.texturemid +
             FixedMul(vis->texturemid - psp_inter.texturemid, fractionaltic);
         }
@@ -1312,7 +1417,7 @@ static void R_DrawPlayerSprite(const pspdef_t* psp, bool invisibility, bool alte
 
     if(invisibility)
     {
-        vis->colfunc = (r_textures ? psprcolfunc : &R_DrawTranslucent50SolidColorColumn);
+        vis->colfunc        = (r_textures ? psprcolfunc : &R_DrawTranslucent50SolidColorColumn);
         vis->colormap       = NULL;
         vis->sectorcolormap = fullcolormap;
     }
@@ -1337,7 +1442,7 @@ static void R_DrawPlayerSprite(const pspdef_t* psp, bool invisibility, bool alte
             else if(muzzleflash && spr >= SPR_SHTG && spr <= SPR_BFGF &&
             (!altered || state->translucent))
             {
-                void (*colfuncs[])(void) = { NULL, NULL,
+                void (*colfuncs[])(rendercontext_t* rc) = { NULL, NULL,
                     /* SPR_SHTG */ basecolfunc, basecolfunc,
                     /* SPR_PUNG */ basecolfunc, basecolfunc,
                     /* SPR_PISG */ basecolfunc, basecolfunc,
@@ -1394,8 +1499,6 @@ static void R_DrawPlayerSprite(const pspdef_t* psp, bool invisibility, bool alte
             vis->sectorcolormap = R_GetSectorColormap(sec);
         }
     }
-
-    R_DrawPlayerVisSprite(vis);
 }
 
 //
@@ -1413,21 +1516,27 @@ bool right,
 const byte* tinttab1,
 const byte* tinttab2)
 {
-    byte* dest = &r_screens[screen][y * render.screen_width + x];
+    byte* dest = &r_screens[screen][y * rowpitch + x * columnpitch];
 
-    while(height--)
-    {
-        memset(dest, color1, width);
-        dest += render.screen_width;
-    }
+    if(r_columnmajor)
+        while(width--)
+        {
+            memset(dest, color1, height);
+            dest += columnpitch;
+        }
+    else
+        while(height--)
+        {
+            memset(dest, color1, width);
+            dest += rowpitch;
+        }
 }
 
 //
-// R_DrawPlayerSprites
+// R_ProjectPlayerSprites
 //
-static void R_DrawPlayerSprites(void)
+static void R_ProjectPlayerSprites(void)
 {
-    TracyCZoneN(zone_psprites, "R_DrawPlayerSprites", 1);
     const int invisibility     = viewplayer->powers[pw_invisibility];
     const pspdef_t* weapon     = viewplayer->psprites;
     const pspdef_t* flash      = weapon + 1;
@@ -1435,34 +1544,26 @@ static void R_DrawPlayerSprites(void)
     const state_t* flashstate  = flash->state;
     bool altered;
 
+    numpsprvissprites = 0;
+
     if(!weaponstate)
-    {
-        TracyCZoneEnd(zone_psprites)
         return;
-    }
 
     altered = (weaponinfo[viewplayer->readyweapon].altered ||
     weaponstate->dehacked || !r_fixspriteoffsets);
 
     // add all active psprites
-    if(invisibility && (invisibility > STARTFLASHING || (invisibility & FLASHONTIC)))
+    if((psprinvisibility = (invisibility && (invisibility > STARTFLASHING || (invisibility & FLASHONTIC)))))
     {
-        fuzz2pos = 0;
-
-        R_FillRect(1, render.view_window_x, render.view_window_y, render.view_width, render.view_height, PINK, 0,
-        false, false, NULL, NULL);
-
         if(flashstate)
         {
             altered |= flashstate->dehacked;
 
-            R_DrawPlayerSprite(weapon, true, altered);
-            R_DrawPlayerSprite(flash, true, altered);
+            R_ProjectPlayerSprite(weapon, true, altered);
+            R_ProjectPlayerSprite(flash, true, altered);
         }
         else
-            R_DrawPlayerSprite(weapon, true, altered);
-
-        R_DrawFuzzColumns();
+            R_ProjectPlayerSprite(weapon, true, altered);
     }
     else
     {
@@ -1473,19 +1574,62 @@ static void R_DrawPlayerSprites(void)
             altered |= flashstate->dehacked;
             muzzleflash |= (flashstate->frame & FF_FULLBRIGHT);
 
-            R_DrawPlayerSprite(weapon, false, altered);
-            R_DrawPlayerSprite(flash, false, altered);
+            R_ProjectPlayerSprite(weapon, false, altered);
+            R_ProjectPlayerSprite(flash, false, altered);
         }
         else
-            R_DrawPlayerSprite(weapon, false, altered);
+            R_ProjectPlayerSprite(weapon, false, altered);
     }
+}
+
+//
+// R_DrawPlayerSprites
+//
+static void R_DrawPlayerSprites(rendercontext_t* rc)
+{
+    TracyCZoneN(zone_psprites, "R_DrawPlayerSprites", 1);
+
+    if(psprinvisibility)
+    {
+        rc->fuzz2pos = 0;
+
+        R_FillRect(1, render.view_window_x + r_stripleft, render.view_window_y,
+        r_stripright - r_stripleft + 1, render.view_height, PINK, 0, false, false, NULL, NULL);
+
+        for(int i = 0; i < numpsprvissprites; i++)
+            R_DrawPlayerVisSprite(rc, &psprvissprites[i]);
+
+        // R_DrawFuzzColumns() reads the player sprites across the whole view.
+        R_RenderStripBarrier();
+        R_DrawFuzzColumns(rc);
+    }
+    else
+        for(int i = 0; i < numpsprvissprites; i++)
+            R_DrawPlayerVisSprite(rc, &psprvissprites[i]);
+
     TracyCZoneEnd(zone_psprites)
 }
 
+//
+// R_SetupSprites
+// Once a frame, before any render thread adds its sprites.
+//
+void R_SetupSprites(void)
+{
+    interpolatesprites = (vid_capfps != TICRATE && !consoleactive && !freeze);
+    invulnerable = (viewplayer->fixedcolormap == INVERSECOLORMAP && r_sprites_translucency);
+
+    // the psprites are drawn on top of everything
+    if(r_playersprites && !menuactive)
+        R_ProjectPlayerSprites();
+    else
+        numpsprvissprites = 0;
+}
+
 //
 // R_DrawBloodSplatSprite
 //
-static void R_DrawBloodSplatSprite(const vissplat_t* splat)
+static void R_DrawBloodSplatSprite(rendercontext_t* rc, const vissplat_t* splat)
 {
     const int x1        = splat->x1;
     const int x2        = splat->x2;
@@ -1493,6 +1637,10 @@ static void R_DrawBloodSplatSprite(const vissplat_t* splat)
     const fixed_t gx    = splat->gx;
     const fixed_t gy    = splat->gy;
 
+    // nothing to draw in this thread's strip, nor any fuzz to take
+    if((x1 > r_stripright || x2 < r_stripleft) && splat->colfunc != &R_DrawFuzzColumn)
+        return;
+
     // initialize the clipping arrays
     for(int i = x1; i <= x2; i++)
     {
@@ -1532,7 +1680,7 @@ static void R_DrawBloodSplatSprite(const vissplat_t* splat)
     }
 
     // all clipping has been performed, so draw the blood splat
-    R_DrawVisSplat(splat);
+    R_DrawVisSplat(rc, splat);
 }
 
 static void msort(vissprite_t** s, vissprite_t** t, unsigned int n)
@@ -1582,7 +1730,7 @@ static void msort(vissprite_t** s, vissprite_t** t, unsigned int n)
 static void R_SortVisSprites(void)
 {
     TracyCZoneN(zone_sort, "R_SortVisSprites", 1);
-    static unsigned int num_vissprite_ptrs;
+    static THREADLOCAL unsigned int num_vissprite_ptrs;
 
     if(num_vissprite_ptrs < num_vissprite * 2)
         vissprite_ptrs = I_Realloc(vissprite_ptrs,
@@ -1595,7 +1743,7 @@ static void R_SortVisSprites(void)
     TracyCZoneEnd(zone_sort)
 }
 
-static void R_DrawSprite(const vissprite_t* spr)
+static void R_DrawSprite(rendercontext_t* rc, const vissprite_t* spr)
 {
     TracyCZoneN(tracy_zone, "R_DrawSprite", 1);
     const int x1        = spr->x1;
@@ -1604,6 +1752,13 @@ static void R_DrawSprite(const vissprite_t* spr)
     const fixed_t gx    = spr->gx;
     const fixed_t gy    = spr->gy;
 
+    // nothing to draw in this thread's strip, nor any fuzz to take
+    if((x1 > r_stripright || x2 < r_stripleft) && spr->colfunc != &R_DrawFuzzColumn)
+    {
+        TracyCZoneEnd(tracy_zone)
+        return;
+    }
+
     // initialize the clipping arrays
     for(int i = x1; i <= x2; i++)
     {
@@ -1639,7 +1794,7 @@ static void R_DrawSprite(const vissprite_t* spr)
             {
                 // masked midtexture?
                 if(ds->maskedtexturecol)
-                    R_RenderMaskedSegRange(ds, MAX(x1, ds->x1), MIN(ds->x2, x2));
+                    R_RenderMaskedSegRange(rc, ds, MAX(x1, ds->x1), MIN(ds->x2, x2));
 
                 // seg is behind sprite
                 continue;
@@ -1715,16 +1870,16 @@ static void R_DrawSprite(const vissprite_t* spr)
     mfloorclip   = clipbot;
 
     if(spr->shadowpos <= 0)
-        R_DrawVisSpriteWithShadow(spr);
+        R_DrawVisSpriteWithShadow(rc, spr);
     else
-        R_DrawVisSprite(spr);
+        R_DrawVisSprite(rc, spr);
     TracyCZoneEnd(tracy_zone)
 }
 
 //
 // R_DrawMasked
 //
-void R_DrawMasked(void)
+void R_DrawMasked(rendercontext_t* rc)
 {
     TracyCZoneN(tracy_zone, "R_DrawMasked", 1);
     if(consoleactive || paused || freeze)
@@ -1733,12 +1888,9 @@ void R_DrawMasked(void)
         M_Fuzz2Seed(game.stats.maptime);
     }
 
-    interpolatesprites = (vid_capfps != TICRATE && !consoleactive && !freeze);
-    invulnerable = (viewplayer->fixedcolormap == INVERSECOLORMAP && r_sprites_translucency);
-
     // draw all blood splats
     for(int i = num_vissplat - 1; i >= 0; i--)
-        R_DrawBloodSplatSprite(&vissplats[i]);
+        R_DrawBloodSplatSprite(rc, &vissplats[i]);
 
     for(int i = 0; i < DS_RANGES_COUNT; i++)
         drawsegs_xranges[i].count = 0;
@@ -1802,18 +1954,18 @@ void R_DrawMasked(void)
                 drawsegs_xrange_count = drawsegs_xranges[0].count;
             }
 
-            R_DrawSprite(spr);
+            R_DrawSprite(rc, spr);
         }
     }
 
     // render any remaining masked midtextures
     for(drawseg_t* ds = ds_p; ds-- > drawsegs;)
         if(ds->maskedtexturecol)
-            R_RenderMaskedSegRange(ds, ds->x1, ds->x2);
+            R_RenderMaskedSegRange(rc, ds, ds->x1, ds->x2);
 
     // draw the psprites on top of everything
-    if(r_playersprites && !menuactive)
-        R_DrawPlayerSprites();
+    if(numpsprvissprites)
+        R_DrawPlayerSprites(rc);
     TracyCZoneEnd(tracy_zone)
 }
 
@@ -1830,16 +1982,38 @@ void R_ResizeThingsBuffers(void)
     // Free existing buffers
     if(negonearray) free(negonearray);
     if(viewheightarray) free(viewheightarray);
-    if(cliptop) free(cliptop);
-    if(clipbot) free(clipbot);
 
     // Allocate new buffers based on current allocation sizes
     negonearray = calloc(r_alloc_max_width, sizeof(int));
     viewheightarray = calloc(r_alloc_max_width, sizeof(int));
+
+    // Verify allocations succeeded
+    if(!negonearray || !viewheightarray)
+        I_Error("R_ResizeThingsBuffers: Failed to allocate sprite buffers");
+
+    R_ResizeThingsStripBuffers();
+}
+
+//
+// R_ResizeThingsStripBuffers
+// Allocates or reallocates the sprite clipping buffers each render thread keeps for itself.
+// Called by R_ResizeThingsBuffers, and by each render thread before it draws its strip.
+//
+// Buffer sizes:
+//   cliptop, clipbot: r_alloc_max_width elements
+//
+void R_ResizeThingsStripBuffers(void)
+{
+    if(cliptop && clipsize == r_alloc_max_width)
+        return;
+
+    if(cliptop) free(cliptop);
+    if(clipbot) free(clipbot);
+
     cliptop = calloc(r_alloc_max_width, sizeof(int));
     clipbot = calloc(r_alloc_max_width, sizeof(int));
+    clipsize = r_alloc_max_width;
 
-    // Verify allocations succeeded
-    if(!negonearray || !viewheightarray || !cliptop || !clipbot)
+    if(!cliptop || !clipbot)
         I_Error("R_ResizeThingsBuffers: Failed to allocate sprite buffers");
 }
@@ -41,10 +41,10 @@ extern int* negonearray;
 extern int* viewheightarray;
 
 // vars for R_DrawMaskedColumn
-extern int* mfloorclip;
-extern int* mceilingclip;
-extern fixed_t spryscale;
-extern int64_t sprtopscreen;
+extern THREADLOCAL int* mfloorclip;
+extern THREADLOCAL int* mceilingclip;
+extern THREADLOCAL fixed_t spryscale;
+extern THREADLOCAL int64_t sprtopscreen;
 
 extern fixed_t pspritescale;
 extern fixed_t pspriteiscale;
@@ -56,8 +56,11 @@ extern bool allowwolfensteinss;
 
 void R_AddSprites(sector_t* sec, int lightlevel);
 void R_AddNearbySprites(sector_t* sec);
+void R_DrawNearbySprites(void);
+bool R_SectorSpritesAdded(const sector_t* sec);
 void R_InitSprites(void);
 void R_ClearSprites(void);
-void R_DrawMasked(void);
-void R_DrawNearbySprites(void);
+void R_SetupSprites(void);
+void R_DrawMasked(rendercontext_t* rc);
 void R_ResizeThingsBuffers(void);
+void R_ResizeThingsStripBuffers(void);
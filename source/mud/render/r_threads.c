@@ -0,0 +1,219 @@
+/*
+==============================================================================
+
+                                 DOOM Retro
+           The classic, refined DOOM source port. For Windows PC.
+
+==============================================================================
+
+    Copyright © 1993-2025 by id Software LLC, a ZeniMax Media company.
+    Copyright © 2013-2025 by Brad Harding <mailto:brad@doomretro.com>.
+
+    This file is a part of DOOM Retro.
+
+    DOOM Retro is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation, either version 3 of the license, or (at your
+    option) any later version.
+
+    DOOM Retro is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DOOM Retro. If not, see <https://www.gnu.org/licenses/>.
+
+    DOOM is a registered trademark of id Software LLC, a ZeniMax Media
+    company, in the US and/or other countries, and is used without
+    permission. All other trademarks are the property of their respective
+    holders. DOOM Retro is in no way affiliated with nor endorsed by
+    id Software.
+
+==============================================================================
+*/
+
+#include <stdio.h>
+
+#include "doom/doomstat.h"
+#include "render/r_threads.h"
+#include "system/i_config.h"
+#include "system/i_video.h"
+#include "thread.h"
+
+#include "mud_profiling.h"
+
+// Strips are kept a multiple of this many columns wide so that the low detail
+// and fuzz drawers, which touch column pairs, never cross into a neighbour.
+#define STRIPALIGN  64
+
+typedef struct
+{
+    thread_ptr_t    thread;
+    thread_signal_t start;
+    thread_signal_t done;
+    int             strip;
+    int             left;
+    int             right;
+    char            name[32];
+} renderthread_t;
+
+THREADLOCAL int r_strip;
+THREADLOCAL int r_stripleft;
+THREADLOCAL int r_stripright;
+
+int r_numstrips = 1;
+
+static renderthread_t       renderthreads[r_threads_max];
+static int                  numrenderthreads = 1;
+static void                 (*stripfunc)(void);
+
+static thread_signal_t      resume[r_threads_max];
+static thread_atomic_int_t  arrived;
+static thread_mutex_t       renderlock;
+
+static int R_RenderThreadProc(void* data)
+{
+    renderthread_t* renderthread = data;
+
+    TracyCSetThreadName(renderthread->name);
+
+    while(true)
+    {
+        thread_signal_wait(&renderthread->start, THREAD_SIGNAL_WAIT_INFINITE);
+
+        r_strip      = renderthread->strip;
+        r_stripleft  = renderthread->left;
+        r_stripright = renderthread->right;
+
+        stripfunc();
+
+        thread_signal_raise(&renderthread->done);
+    }
+
+    return 0;
+}
+
+//
+// R_InitRenderThreads
+//
+void R_InitRenderThreads(void)
+{
+    thread_mutex_init(&renderlock);
+    thread_atomic_int_store(&arrived, 0);
+
+    for(int i = 0; i < r_threads_max; i++)
+        thread_signal_init(&resume[i]);
+
+    r_strip      = 0;
+    r_stripleft  = 0;
+    r_stripright = render.view_width - 1;
+}
+
+//
+// R_StartRenderThreads
+// Workers are created the first time they are needed and then kept for the
+// rest of the session, idling on their start signal between frames.
+//
+static void R_StartRenderThreads(int count)
+{
+    while(numrenderthreads < count)
+    {
+        renderthread_t* renderthread = &renderthreads[numrenderthreads];
+
+        renderthread->strip = numrenderthreads;
+        snprintf(renderthread->name, sizeof(renderthread->name), "Render Thread %i", numrenderthreads);
+        thread_signal_init(&renderthread->start);
+        thread_signal_init(&renderthread->done);
+
+        if(!(renderthread->thread = thread_create(&R_RenderThreadProc, renderthread, THREAD_STACK_SIZE_DEFAULT)))
+            break;
+
+        numrenderthreads++;
+    }
+}
+
+//
+// R_RenderStrips
+// Calls func once per vertical strip of the view, on the main thread for the
+// leftmost strip and on a worker for each of the others, and returns once
+// every strip is done.
+//
+void R_RenderStrips(void (*func)(void))
+{
+    TracyCZoneN(zone_strips, "R_RenderStrips", 1);
+    const int   width = render.view_width;
+    int         count = BETWEEN(1, MIN(r_threads, width / STRIPALIGN), r_threads_max);
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    count = 1;
+#endif
+
+    R_StartRenderThreads(count);
+    r_numstrips = count = MIN(count, numrenderthreads);
+    stripfunc = func;
+
+    for(int i = 1; i < count; i++)
+    {
+        renderthread_t* renderthread = &renderthreads[i];
+
+        renderthread->left  = (width * i / count) & ~(STRIPALIGN - 1);
+        renderthread->right = (i == count - 1 ? width : (width * (i + 1) / count) & ~(STRIPALIGN - 1)) - 1;
+        thread_signal_raise(&renderthread->start);
+    }
+
+    r_strip      = 0;
+    r_stripleft  = 0;
+    r_stripright = (count == 1 ? width : (width / count) & ~(STRIPALIGN - 1)) - 1;
+
+    func();
+
+    for(int i = 1; i < count; i++)
+        thread_signal_wait(&renderthreads[i].done, THREAD_SIGNAL_WAIT_INFINITE);
+
+    // Leave the main thread covering the whole view for anything drawn
+    // outside of the strips, such as the automap's BSP walk.
+    r_numstrips  = 1;
+    r_stripright = width - 1;
+
+    TracyCZoneEnd(zone_strips)
+}
+
+//
+// R_RenderStripBarrier
+// Blocks until every strip of the current frame has reached this point.
+//
+void R_RenderStripBarrier(void)
+{
+    if(r_numstrips == 1)
+        return;
+
+    if(thread_atomic_int_inc(&arrived) == r_numstrips - 1)
+    {
+        thread_atomic_int_store(&arrived, 0);
+
+        for(int i = 0; i < r_numstrips; i++)
+            if(i != r_strip)
+                thread_signal_raise(&resume[i]);
+    }
+    else
+        thread_signal_wait(&resume[r_strip], THREAD_SIGNAL_WAIT_INFINITE);
+}
+
+//
+// R_LockRenderThreads
+//
+void R_LockRenderThreads(void)
+{
+    if(r_numstrips > 1)
+        thread_mutex_lock(&renderlock);
+}
+
+//
+// R_UnlockRenderThreads
+//
+void R_UnlockRenderThreads(void)
+{
+    if(r_numstrips > 1)
+        thread_mutex_unlock(&renderlock);
+}
@@ -59,10 +59,10 @@ static void Wipe_InitMelt(void)
     Wipe_ShittyColMajorXform((short*)v_screens[3]);
 
     // setup initial column positions (y < 0 => not ready to scroll yet)
-    y[0] = y[1] = -(M_BigRandom() & 15);
+    y[0] = y[1] = -M_Fuzz1RandomInt(0, 15);
 
     for(int i = 2; i < video.screen_width - 1; i += 2)
-        y[i] = y[i + 1] = BETWEEN(-15, y[i - 1] + M_BigRandom() % 3 - 1, 0);
+        y[i] = y[i + 1] = BETWEEN(-15, y[i - 1] + M_Fuzz1RandomInt(-1, 1), 0);
 }
 
 static void Wipe_Melt(const int i, const int dy)
@@ -1515,13 +1515,12 @@ void V_DrawFuzzPatch(int x, int y, patch_t* patch)
 {
     byte* desttop;
     const int width = SHORT(patch->width) << FRACBITS;
+    int fuzzpos     = 0;
 
     y -= SHORT(patch->topoffset);
     x -= SHORT(patch->leftoffset);
     x += video.widescreen_delta;
 
-    fuzz1pos = 0;
-
     desttop = &v_screens[0][((y * DY) >> FRACBITS) * video.screen_width + ((x * DX) >> FRACBITS)];
 
     for(int col = 0; col < width; col += DXI, desttop++)
@@ -1539,13 +1538,13 @@ void V_DrawFuzzPatch(int x, int y, patch_t* patch)
             {
                 if(count & 1)
                 {
-                    fuzz1pos++;
+                    fuzzpos++;
 
                     if(!menuactive && !consoleactive && !paused)
-                        fuzz1table[fuzz1pos] = FUZZ1(-1, 1);
+                        fuzz1table[fuzzpos] = FUZZ1(-1, 1);
                 }
 
-                *dest = fullcolormap[6 * 256 + dest[fuzz1table[fuzz1pos]]];
+                *dest = fullcolormap[6 * 256 + dest[fuzz1table[fuzzpos]]];
                 dest += video.screen_width;
             }
 
@@ -1558,13 +1557,12 @@ void V_DrawFlippedFuzzPatch(int x, int y, patch_t* patch)
 {
     byte* desttop;
     const int width = SHORT(patch->width) << FRACBITS;
+    int fuzzpos     = 0;
 
     y -= SHORT(patch->topoffset);
     x -= SHORT(patch->leftoffset);
     x += video.widescreen_delta;
 
-    fuzz1pos = 0;
-
     desttop = &v_screens[0][((y * DY) >> FRACBITS) * video.screen_width + ((x * DX) >> FRACBITS)];
 
     for(int col = 0; col < width; col += DXI, desttop++)
@@ -1582,13 +1580,13 @@ void V_DrawFlippedFuzzPatch(int x, int y, patch_t* patch)
             {
                 if(count & 1)
                 {
-                    fuzz1pos++;
+                    fuzzpos++;
 
                     if(!menuactive && !consoleactive && !paused)
-                        fuzz1table[fuzz1pos] = FUZZ1(-1, 1);
+                        fuzz1table[fuzzpos] = FUZZ1(-1, 1);
                 }
 
-                *dest = fullcolormap[6 * 256 + dest[fuzz1table[fuzz1pos]]];
+                *dest = fullcolormap[6 * 256 + dest[fuzz1table[fuzzpos]]];
                 dest += video.screen_width;
             }
 
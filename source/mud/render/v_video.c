@@ -54,6 +54,7 @@
 
 byte* v_screens[V_NUMSCREENS];
 byte* r_screens[R_NUMSCREENS];
+bool r_screensupdated;
 
 int lowpixelwidth;
 int lowpixelheight;
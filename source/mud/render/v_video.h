@@ -55,6 +55,10 @@ extern byte* v_screens[V_NUMSCREENS];
 #define R_NUMSCREENS 4
 extern byte* r_screens[R_NUMSCREENS];
 
+// Set once the view has been drawn into r_screens[0], and cleared once it's
+// been uploaded
+extern bool r_screensupdated;
+
 extern int lowpixelwidth;
 extern int lowpixelheight;
 
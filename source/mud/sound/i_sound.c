@@ -39,8 +39,10 @@
 #include "system/i_system.h"
 #include "system/i_config.h"
 #include "sound/s_sound.h"
+#if !defined(MUD_HEADLESS)
 #include "sokol_audio.h"
 #include "sokol_log.h"
+#endif
 // clang-format off
 #define STB_VORBIS_HEADER_ONLY
 #include "stb_vorbis.h"
@@ -49,12 +51,20 @@
 #include "system/i_version.h"
 #include "wad/w_wad.h"
 
+#include "mud_profiling.h"
+
 #define DMXPADSIZE 16
 
+// How much decoded PCM may be kept before the sound effects played the
+// longest ago are dropped, to be decoded again when they're next played
+#define SFXCACHESIZE (32 * 1024 * 1024)
+
 typedef struct allocated_sound_s
 {
     sfxinfo_t* sfxinfo;
     struct atomix_sound *chunk;
+    size_t size;
+    thread_atomic_int_t state;
     struct allocated_sound_s* prev;
     struct allocated_sound_s* next;
 } allocated_sound_t;
@@ -66,10 +76,21 @@ static allocated_sound_t* channels_playing[s_channels_max];
 thread_atomic_ptr_t mixer;
 int mixer_freq = 0;
 
-// Doubly-linked list of allocated sounds.
+// One for each sound effect, indexed the same as s_sfx.
+static allocated_sound_t* allocated_sounds;
+
+// Doubly-linked list of decoded sounds.
 // When a sound is played, it is moved to the head, so that the oldest sounds not used recently are at the tail.
 static allocated_sound_t* allocated_sounds_head;
 static allocated_sound_t* allocated_sounds_tail;
+static size_t allocated_sounds_size;
+
+// Sounds are decoded on their own thread, in the order they're queued.
+// Decoding them and changing the list above are done under sound_lock.
+static thread_ptr_t decode_thread;
+static thread_queue_t decode_queue;
+static void** decode_queue_values;
+static thread_mutex_t sound_lock;
 
 // Used for decoding and expansion of sound effects prior to being sent to atomix.
 // Both expansion_buffer_size and the new_size parameter are in bytes.
@@ -128,6 +149,7 @@ static void AllocatedSoundUnlink(allocated_sound_t* snd)
         snd->next->prev = snd->prev;
 }
 
+#if !defined(MUD_HEADLESS)
 static void AudioStreamCallback(float *buffer, int num_frames, int num_channels) 
 {
     if (thread_atomic_int_load(&sound_initialized))
@@ -141,47 +163,44 @@ static void AudioStreamCallback(float *buffer, int num_frames, int num_channels)
     else
         memset(buffer, 0, num_frames * num_channels * sizeof(float));
 }
+#endif
 
 static inline float ConvertDoomPanning(const int sep)
 {
     return (float)(sep - 127) / 127;
 }
 
+// Free a decoded sound that's no longer being played, so it's decoded again the next time it's needed.
 static void FreeAllocatedSound(allocated_sound_t* snd)
 {
     // Unlink from linked list.
     AllocatedSoundUnlink(snd);
+    allocated_sounds_size -= snd->size;
     atomixSoundFree(snd->chunk);
-    free(snd);
+    snd->chunk = NULL;
+    snd->size  = 0;
+    thread_atomic_int_store(&snd->state, sound_uncached);
 }
 
-// Allocate a block for a new sound effect.
-static allocated_sound_t* AllocateSound(sfxinfo_t* sfxinfo)
+// Free the sounds played the longest ago, that aren't being played now, until the cache is small enough.
+static void TrimAllocatedSounds(void)
 {
-    allocated_sound_t* snd = calloc(1, sizeof(allocated_sound_t));
-    if (!snd)
-    {
-        I_Error("AllocateSound: Memory allocation failed!");
-    }
-    snd->sfxinfo   = sfxinfo;
-    AllocatedSoundLink(snd);
-    return snd;
-}
+    allocated_sound_t* snd = allocated_sounds_tail;
 
-static allocated_sound_t*
-GetAllocatedSoundBySfxInfo(const sfxinfo_t* sfxinfo)
-{
-    allocated_sound_t* p = allocated_sounds_head;
-
-    while(p)
+    while(snd && allocated_sounds_size > SFXCACHESIZE)
     {
-        if(p->sfxinfo == sfxinfo)
-            return p;
+        allocated_sound_t* prev = snd->prev;
+
+        if(!atomixSoundRefCount(snd->chunk))
+            FreeAllocatedSound(snd);
 
-        p = p->next;
+        snd = prev;
     }
+}
 
-    return NULL;
+static allocated_sound_t* GetAllocatedSoundBySfxInfo(const sfxinfo_t* sfxinfo)
+{
+    return &allocated_sounds[sfxinfo - s_sfx];
 }
 
 // When a sound stops, check if it is still playing. If it is not, we can mark
@@ -197,14 +216,11 @@ static void ReleaseSoundOnChannel(const int channel, const int handle)
     channels_playing[channel] = NULL;
 }
 
-// Load and convert a sound effect
+// Convert a sound effect from its lump
 // Returns true if successful
-bool CacheSFX(sfxinfo_t* sfxinfo)
+static bool DecodeSound(allocated_sound_t* snd, byte* data, const int lumplen)
 {
-    // Need to load the sound
-    const int lumpnum = sfxinfo->lumpnum;
-    byte* data        = W_CacheLumpNum(lumpnum);
-    const int lumplen = W_LumpLength(lumpnum);
+    int channels = 1;
 
     // Check the header, and ensure this is a valid sound
     if(lumplen > 4 && (!memcmp(data, "RIFF", 4) || !memcmp(data, "RIFX", 4) || !memcmp(data, "riff", 4) || !memcmp(data, "RF64", 4) || !memcmp(data, "FORM", 4)))
@@ -217,12 +233,11 @@ bool CacheSFX(sfxinfo_t* sfxinfo)
             drwav_uninit(&wav);
             return false;
         }
-        allocated_sound_t* snd = AllocateSound(sfxinfo);
+        channels = wav.channels;
         ResizeExpansionBuffer(wav.totalPCMFrameCount * wav.channels * sizeof(float));
         size_t frames_read = drwav_read_pcm_frames_f32(&wav, wav.totalPCMFrameCount, expansion_buffer);
         if (frames_read == 0)
         {
-            FreeAllocatedSound(snd);
             drwav_uninit(&wav);
             return false;
         }
@@ -231,7 +246,6 @@ bool CacheSFX(sfxinfo_t* sfxinfo)
         else
             snd->chunk = atomixSoundNewResampled(thread_atomic_ptr_load(&mixer), wav.channels, expansion_buffer, frames_read, wav.sampleRate, ATOMIX_F32);
         drwav_uninit(&wav);
-        return true;
     }
     else if(lumplen > 4 && !memcmp(data, "OggS", 4))
     {
@@ -249,8 +263,7 @@ bool CacheSFX(sfxinfo_t* sfxinfo)
             stb_vorbis_close(ogg);
             return false;
         }
-        allocated_sound_t* snd = AllocateSound(sfxinfo);
-        int channels = info.channels;
+        channels = info.channels;
         // stb_vorbis 'coerces' the true number of channels present in an Ogg file to fulfill
         // the requested channel count, so it is safe to assign a channel count of 2 to an
         // Ogg sound that actually has more than 2 channels
@@ -266,7 +279,6 @@ bool CacheSFX(sfxinfo_t* sfxinfo)
         else
             snd->chunk = atomixSoundNewResampled(thread_atomic_ptr_load(&mixer), channels, expansion_buffer, frames_read, info.sample_rate, ATOMIX_F32);
         stb_vorbis_close(ogg);
-        return true;
     }
     else if(lumplen >= 8 && data[0] == 0x03 && data[1] == 0x00)
     {
@@ -280,13 +292,74 @@ bool CacheSFX(sfxinfo_t* sfxinfo)
         // although the actual cut-off length seems to vary slightly depending on the sample rate. This
         // needs further investigation to better understand the correct behavior.
         if(length > 48 && length <= lumplen - 8)
-        {
-            allocated_sound_t* snd = AllocateSound(sfxinfo);
             snd->chunk = atomixSoundNewResampled(thread_atomic_ptr_load(&mixer), 1, data+DMXPADSIZE, length - DMXPADSIZE, (data[2] | (data[3] << 8)), ATOMIX_U8);
-            return true;
-        }
     }
-    return false;
+
+    if(!snd->chunk)
+        return false;
+
+    snd->size = (size_t)atomixSoundLength(snd->chunk) * channels * sizeof(float);
+    return true;
+}
+
+// Load and decode a sound, and add it to the head of the linked list.
+// Sounds are only ever decoded one at a time, as they share expansion_buffer and the mixer's resampler.
+static void DecodeAllocatedSound(allocated_sound_t* snd)
+{
+    const int lumpnum = snd->sfxinfo->lumpnum;
+    const bool valid  = DecodeSound(snd, W_CacheLumpNum(lumpnum), W_LumpLength(lumpnum));
+
+    W_ReleaseLumpNum(lumpnum);
+
+    if(!valid)
+    {
+        thread_atomic_int_store(&snd->state, sound_invalid);
+        return;
+    }
+
+    thread_mutex_lock(&sound_lock);
+    AllocatedSoundLink(snd);
+    allocated_sounds_size += snd->size;
+    TrimAllocatedSounds();
+    thread_atomic_int_store(&snd->state, sound_decoded);
+    thread_mutex_unlock(&sound_lock);
+}
+
+#if !defined(MUD_HEADLESS) && (!defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__))
+static int DecodeThreadProc(void* data)
+{
+    allocated_sound_t* snd;
+
+    TracyCSetThreadName("Sound Decode Thread");
+
+    // A NULL is queued when the sound is shut down
+    while((snd = thread_queue_consume(&decode_queue, THREAD_QUEUE_WAIT_INFINITE)))
+        DecodeAllocatedSound(snd);
+
+    return 0;
+}
+#endif
+
+//
+// I_CacheSound
+// Queues a sound effect to be decoded, if it isn't already, and returns
+// whether it has been yet.
+//
+soundstate_t I_CacheSound(const sfxinfo_t* sfxinfo)
+{
+    allocated_sound_t* snd = GetAllocatedSoundBySfxInfo(sfxinfo);
+
+    if(thread_atomic_int_compare_and_swap(&snd->state, sound_uncached, sound_decoding) == sound_uncached)
+    {
+        snd->sfxinfo = (sfxinfo_t*)sfxinfo;
+
+        if(decode_thread)
+            thread_queue_produce(&decode_queue, snd, THREAD_QUEUE_WAIT_INFINITE);
+        else
+            DecodeAllocatedSound(snd);
+    }
+
+    return thread_atomic_int_load(&snd->state);
 }
 
 void I_UpdateSoundParms(const int handle, const int vol, const int sep)
@@ -303,21 +376,26 @@ void I_UpdateSoundParms(const int handle, const int vol, const int sep)
 //
 int I_StartSound(const sfxinfo_t* sfxinfo, const int channel, const int handle, const int vol, const int sep)
 {
-    allocated_sound_t* snd;
+    allocated_sound_t* snd = GetAllocatedSoundBySfxInfo(sfxinfo);
+    uint32_t new_handle = 0;
 
     // Release a sound effect if there is already one playing on this channel.
     ReleaseSoundOnChannel(channel, handle);
 
-    if(!(snd = GetAllocatedSoundBySfxInfo(sfxinfo)))
-        return -1;
-
     struct atomix_mixer *mix = thread_atomic_ptr_load(&mixer);
     if (!mix)
         return -1;
 
-    // Play sound
-    uint32_t new_handle = atomixMixerPlaySound(mix, snd->chunk, ATOMIX_PLAY,
+    // Play sound, if it's still decoded, and move it to the head of the linked list
+    thread_mutex_lock(&sound_lock);
+    if (thread_atomic_int_load(&snd->state) == sound_decoded)
+    {
+        new_handle = atomixMixerPlaySound(mix, snd->chunk, ATOMIX_PLAY,
                                   ConvertDoomVolume(vol), ConvertDoomPanning(sep));
+        AllocatedSoundUnlink(snd);
+        AllocatedSoundLink(snd);
+    }
+    thread_mutex_unlock(&sound_lock);
     if (new_handle == 0)
         return -1;
 
@@ -355,10 +433,28 @@ void I_ShutdownSound(void)
         return;
 
     thread_atomic_int_store(&sound_initialized, 0);
+
+    if(decode_thread)
+    {
+        thread_queue_produce(&decode_queue, NULL, THREAD_QUEUE_WAIT_INFINITE);
+        thread_join(decode_thread);
+        thread_destroy(decode_thread);
+        thread_queue_term(&decode_queue);
+        free(decode_queue_values);
+        decode_thread = NULL;
+    }
+
     struct atomix_mixer *mix = thread_atomic_ptr_load(&mixer);
     thread_atomic_ptr_store(&mixer, NULL);
     atomixMixerFree(mix);
+#if !defined(MUD_HEADLESS)
     saudio_shutdown();
+#endif
+    while(allocated_sounds_head)
+        FreeAllocatedSound(allocated_sounds_head);
+    free(allocated_sounds);
+    allocated_sounds = NULL;
+    thread_mutex_term(&sound_lock);
     free(expansion_buffer);
     expansion_buffer = NULL;
 }
@@ -373,6 +469,10 @@ bool I_InitSound(void)
 
     thread_atomic_ptr_store(&mixer, NULL);
 
+#if defined(MUD_HEADLESS)
+    // There's no audio device to mix for
+    return false;
+#else
     saudio_setup(&(saudio_desc){
         .sample_rate   = SAMPLERATE,
         .stream_cb = AudioStreamCallback,
@@ -398,7 +498,27 @@ bool I_InitSound(void)
     else
         thread_atomic_ptr_store(&mixer, mix);
 
+    // Sound effects are decoded as they're first played, or precached
+    if(!(allocated_sounds = calloc(numsfx, sizeof(allocated_sound_t))))
+        I_Error("I_InitSound: Memory allocation failed!");
+
+    thread_mutex_init(&sound_lock);
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    // Each sound is only ever queued once until it's decoded, so with room for the NULL
+    // queued at shutdown, there's always room for it
+    decode_queue_values = malloc((numsfx + 1) * sizeof(*decode_queue_values));
+    thread_queue_init(&decode_queue, numsfx + 1, decode_queue_values, 0);
+
+    if(!(decode_thread = thread_create(&DecodeThreadProc, NULL, THREAD_STACK_SIZE_DEFAULT)))
+    {
+        thread_queue_term(&decode_queue);
+        free(decode_queue_values);
+    }
+#endif
+
     thread_atomic_int_store(&sound_initialized, 1);
 
     return true;
+#endif
 }
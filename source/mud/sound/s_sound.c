@@ -42,7 +42,9 @@
 #include "utils/m_misc.h"
 #include "math/math_random.h"
 #include "playsim/p_setup.h"
+#include "playsim/p_tick.h"
 #include "sound/s_sound.h"
+#include "system/i_timer.h"
 #include "utils/sc_man.h"
 #include "wad/w_wad.h"
 #include "utils/z_zone.h"
@@ -66,6 +68,10 @@
 
 #define NORM_SEP 127
 
+// How long a sound effect may wait to be decoded before it's dropped
+// rather than started late, in ms
+#define S_MAX_START_DELAY 100
+
 #define TIDNUM(x) (int)(x->musicid & 0xFFFF) // thing identifier
 
 typedef struct
@@ -78,6 +84,10 @@ typedef struct
 
     // handle of the sound being played
     int handle;
+
+    // sound is waiting to be decoded before it starts, since starttime
+    bool pending;
+    uint64_t starttime;
 } channel_t;
 
 // [crispy] "sound objects" hold the coordinates of removed map objects
@@ -146,6 +156,33 @@ static void InitMusicModule(void)
     }
 }
 
+//
+// S_CacheSound
+// Queues a sound effect to be decoded, if it isn't already. If its lump
+// can't be decoded, it won't be tried again.
+//
+static soundstate_t S_CacheSound(sfxinfo_t* sfx)
+{
+    soundstate_t state;
+
+    if(sfx->lumpnum == -1)
+        return sound_invalid;
+
+    if((state = I_CacheSound(sfx)) == sound_invalid)
+    {
+        char namebuf[9];
+        char* temp;
+
+        M_snprintf(namebuf, sizeof(namebuf), "ds%s", sfx->name1);
+        temp = uppercase(namebuf);
+        sfx->lumpnum = -1;
+        C_Warning(1, "The " BOLD("%s") " sound effect lump won't be played.", temp);
+        free(temp);
+    }
+
+    return state;
+}
+
 //
 // Initializes sound stuff, including volume
 // Sets channels, SFX and music volume, allocates channel buffer, sets s_sfx lookup.
@@ -173,6 +210,12 @@ void S_Init(void)
         }
     }
 
+#if defined(MUD_HEADLESS)
+    // There's no audio device to play anything on
+    nomusic = true;
+    nosfx   = true;
+#endif
+
     if(!nosfx)
     {
         InitSfxModule();
@@ -181,7 +224,7 @@ void S_Init(void)
         channels = Z_Calloc(s_channels_max, sizeof(channel_t), PU_STATIC, NULL);
         sobjs    = Z_Calloc(s_channels_max, sizeof(sobj_t), PU_STATIC, NULL);
 
-        // [BH] precache all SFX
+        // Find all SFX. They're only decoded once they're first played, or precached.
         for(int i = 1; i < numsfx; i++)
         {
             sfxinfo_t* sfx = &s_sfx[i];
@@ -191,17 +234,19 @@ void S_Init(void)
                 char namebuf[9];
 
                 M_snprintf(namebuf, sizeof(namebuf), "ds%s", sfx->name1);
-
-                if((sfx->lumpnum = W_CheckNumForName(namebuf)) >= 0 && !CacheSFX(sfx))
-                {
-                    char* temp = uppercase(namebuf);
-
-                    sfx->lumpnum = -1;
-                    C_Warning(1, "The " BOLD("%s") " sound effect lump won't be played.", temp);
-                    free(temp);
-                }
+                sfx->lumpnum = W_CheckNumForName(namebuf);
             }
         }
+
+        // Decode the menu's SFX now, as it's the first thing to be heard
+        if(!nosfx)
+        {
+            S_CacheSound(&s_sfx[sfx_swtchn]);
+            S_CacheSound(&s_sfx[sfx_swtchx]);
+            S_CacheSound(&s_sfx[sfx_pstop]);
+            S_CacheSound(&s_sfx[sfx_stnmov]);
+            S_CacheSound(&s_sfx[sfx_pistol]);
+        }
     }
 
     if(!nomusic)
@@ -231,6 +276,84 @@ void S_Init(void)
     }
 }
 
+static void S_PrecacheSound(const int sfxnum)
+{
+    if(sfxnum > sfx_none && sfxnum < numsfx)
+        S_CacheSound(&s_sfx[sfxnum]);
+}
+
+static void S_PrecacheMobjSounds(const mobjtype_t type)
+{
+    const mobjinfo_t* info;
+
+    if(type == MT_NULL)
+        return;
+
+    info = &mobjinfo[type];
+    S_PrecacheSound(info->seesound);
+    S_PrecacheSound(info->attacksound);
+    S_PrecacheSound(info->painsound);
+    S_PrecacheSound(info->deathsound);
+    S_PrecacheSound(info->activesound);
+}
+
+// The weapons' pickups and projectiles, and the sounds played by their codepointers
+static const struct
+{
+    mobjtype_t  pickup;
+    mobjtype_t  projectile;
+    sfxnum_t    sounds[4];
+} weaponsounds[NUMWEAPONS] = {
+    [wp_fist]         = { MT_NULL,         MT_NULL,   { sfx_punch } },
+    [wp_pistol]       = { MT_NULL,         MT_NULL,   { sfx_pistol } },
+    [wp_shotgun]      = { MT_SHOTGUN,      MT_NULL,   { sfx_shotgn } },
+    [wp_chaingun]     = { MT_CHAINGUN,     MT_NULL,   { sfx_pistol } },
+    [wp_missile]      = { MT_MISC27,       MT_ROCKET, { sfx_none } },
+    [wp_plasma]       = { MT_MISC28,       MT_PLASMA, { sfx_none } },
+    [wp_bfg]          = { MT_MISC25,       MT_BFG,    { sfx_bfg } },
+    [wp_chainsaw]     = { MT_MISC26,       MT_NULL,   { sfx_sawup, sfx_sawidl, sfx_sawful, sfx_sawhit } },
+    [wp_supershotgun] = { MT_SUPERSHOTGUN, MT_NULL,   { sfx_dshtgn, sfx_dbopn, sfx_dbload, sfx_dbcls } }
+};
+
+static void S_PrecacheWeaponSounds(const weapontype_t weapon)
+{
+    S_PrecacheMobjSounds(weaponsounds[weapon].projectile);
+
+    for(int i = 0; i < arrlen(weaponsounds[weapon].sounds); i++)
+        S_PrecacheSound(weaponsounds[weapon].sounds[i]);
+}
+
+//
+// S_PrecacheSounds
+// Queues the SFX of the things in the map, and of the weapons the player
+// has or can pick up, to be decoded before they're first played.
+//
+void S_PrecacheSounds(void)
+{
+    bool weapons[NUMWEAPONS] = { false };
+
+    if(nosfx)
+        return;
+
+    for(int i = 0; i < NUMWEAPONS; i++)
+        weapons[i] = viewplayer->weaponowned[i];
+
+    for(thinker_t* th = thinkers[th_mobj].cnext; th != &thinkers[th_mobj]; th = th->cnext)
+    {
+        const mobjtype_t type = ((mobj_t*)th)->type;
+
+        S_PrecacheMobjSounds(type);
+
+        for(int i = 0; i < NUMWEAPONS; i++)
+            if(weaponsounds[i].pickup == type)
+                weapons[i] = true;
+    }
+
+    for(int i = 0; i < NUMWEAPONS; i++)
+        if(weapons[i])
+            S_PrecacheWeaponSounds(i);
+}
+
 void S_Shutdown(void)
 {
     I_ShutdownSound();
@@ -254,6 +377,7 @@ static void S_StopChannel(int cnum)
 
         c->sfxinfo = NULL;
         c->origin  = NULL;
+        c->pending = false;
     }
 }
 
@@ -459,8 +583,9 @@ static void S_StartSoundAtVolume(mobj_t* origin, sfxnum_t sfxnum)
     int cnum;
     int handle;
     int volume = s_sfxvolume;
+    soundstate_t state;
 
-    if(sfx->lumpnum == -1 || nosfx)
+    if(sfx->lumpnum == -1 || nosfx || (state = S_CacheSound(sfx)) == sound_invalid)
         return;
 
     // Check to see if it is audible, and if not, modify the parms
@@ -471,6 +596,14 @@ static void S_StartSoundAtVolume(mobj_t* origin, sfxnum_t sfxnum)
     if((cnum = S_GetChannel(origin, sfx)) < 0)
         return;
 
+    // If it's still being decoded, hold onto the channel until it has been
+    if(state != sound_decoded)
+    {
+        channels[cnum].pending   = true;
+        channels[cnum].starttime = I_GetTimeMS();
+        return;
+    }
+
     // Assigns the handle to one of the channels in the mix/output buffer.
     // e6y: [Fix] Crash with zero-length sounds.
     if((handle = I_StartSound(sfx, cnum, channels[cnum].handle, volume, sep)) != -1)
@@ -514,6 +647,32 @@ void S_ResumeMusic(void)
     }
 }
 
+// Start a sound effect that's been waiting to be decoded, or give up on it if
+// it's taking too long, rather than play it out of sync.
+static void S_StartPendingSound(const int cnum)
+{
+    channel_t* c               = &channels[cnum];
+    const mobj_t* origin       = c->origin;
+    const soundstate_t state   = S_CacheSound(c->sfxinfo);
+    int sep                    = NORM_SEP;
+    int volume                 = s_sfxvolume;
+    int handle;
+
+    if(state == sound_decoding && I_GetTimeMS() - c->starttime < S_MAX_START_DELAY)
+        return;
+
+    if(state != sound_decoded || (origin && origin != viewplayer->mo && !S_AdjustSoundParms(origin, &volume, &sep)))
+    {
+        S_StopChannel(cnum);
+        return;
+    }
+
+    c->pending = false;
+
+    if((handle = I_StartSound(c->sfxinfo, cnum, c->handle, volume, sep)) != -1)
+        c->handle = handle;
+}
+
 //
 // Updates sounds
 //
@@ -529,7 +688,9 @@ void S_UpdateSounds(void)
 
         if(sfx)
         {
-            if(I_SoundIsPlaying(c->handle))
+            if(c->pending)
+                S_StartPendingSound(cnum);
+            else if(I_SoundIsPlaying(c->handle))
             {
                 // initialize parameters
                 const mobj_t* origin = c->origin;
@@ -48,9 +48,17 @@ static inline float ConvertDoomVolume(const int vol)
     return (float)vol / 31;
 }
 
+typedef enum
+{
+    sound_uncached,
+    sound_decoding,
+    sound_decoded,
+    sound_invalid
+} soundstate_t;
+
 bool I_InitSound(void);
 void I_ShutdownSound(void);
-bool CacheSFX(sfxinfo_t* sfxinfo);
+soundstate_t I_CacheSound(const sfxinfo_t* sfxinfo);
 void I_UpdateSoundParms(const int handle, const int vol, const int sep);
 int I_StartSound(const sfxinfo_t* sfxinfo, const int channel, const int handle, const int vol, const int sep);
 void I_StopSound(const int channel, const int handle);
@@ -77,6 +85,9 @@ void S_Init(void);
 // Shut down sound
 void S_Shutdown(void);
 
+// Decode the sound effects the things and weapons in the map may play
+void S_PrecacheSounds(void);
+
 void S_StopSoundEffect(const sfxnum_t sfxnum);
 void S_StopSound(const mobj_t* origin);
 void S_StopSounds(void);
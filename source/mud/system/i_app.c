@@ -8,6 +8,9 @@
 #include "script/script_main.h"
 #include "system/i_config.h"
 #include "system/i_input.h"
+#include "system/i_perfstats.h"
+#include "system/i_system.h"
+#include "system/i_timer.h"
 
 #include "sokol_app.h"
 #include "sokol_args.h"
@@ -37,6 +40,7 @@ typedef struct
 
         int gfx_rscreenwidth;
         int gfx_rscreenheight;
+        bool gfx_columnmajor;
 
         struct
         {
@@ -66,6 +70,7 @@ typedef struct
         sg_sampler smp_palettize;  // Sampler for the palettization pass
         sg_sampler smp_upscale;    // Sampler for the upscale pass
         sg_pipeline offscreen_pip; // Offscreen pipeline
+        sg_pipeline transposed_pip; // Offscreen pipeline for a column-major level
         sg_pipeline display_pip;   // Display pipeline
     } gfx;
 
@@ -78,6 +83,14 @@ typedef struct
 } app_state_t;
 
 static app_state_t state;
+
+// What was last uploaded to the hud and palette textures, so that unchanged
+// frames aren't uploaded again
+static byte* uploadedhud;
+static bool uploadedhudvalid;
+static uint32_t uploadedpalette[256];
+static bool uploadedpalettevalid;
+
 static TracyCZoneCtx tracy_zone = {0};
 
 extern int r_upscaledwidth;
@@ -156,6 +169,20 @@ static void init(void)
         .colors[0].pixel_format = SG_PIXELFORMAT_RGBA8,
     });
 
+    // Create pipeline for the same pass, sampling the level texture transposed
+    // when r_columnmajor is set
+    state.gfx.transposed_pip = sg_make_pipeline(&(sg_pipeline_desc){
+        .shader    = sg_make_shader(transposed_shader_desc(sg_query_backend())),
+        .layout    = { .attrs[0].format = SG_VERTEXFORMAT_FLOAT2 },
+        .cull_mode = SG_CULLMODE_NONE,
+        .depth = {
+            .write_enabled = false,
+            .compare       = SG_COMPAREFUNC_ALWAYS,
+            .pixel_format  = SG_PIXELFORMAT_NONE,
+        },
+        .colors[0].pixel_format = SG_PIXELFORMAT_RGBA8,
+    });
+
     // Create pipeline to upscale offscreen framebuffer to display
     state.gfx.display_pip = sg_make_pipeline(&(sg_pipeline_desc){
         .shader    = sg_make_shader(display_shader_desc(sg_query_backend())),
@@ -174,6 +201,17 @@ static void init(void)
     
 }
 
+static void update_hud_texture(void)
+{
+    sg_update_image(state.gfx.hud.img,
+    &(sg_image_data){ .mip_levels[0] = {
+                      .ptr  = v_screens[0],
+                      .size = video.screen_width * video.screen_height,
+                      } });
+
+    vid_uploadedbytes += video.screen_width * video.screen_height;
+}
+
 static void update_render_textures()
 {
     if(state.gfx.gfx_vscreenwidth != video.screen_width || state.gfx.gfx_vscreenheight != video.screen_height)
@@ -206,9 +244,13 @@ static void update_render_textures()
 
         state.gfx.gfx_vscreenwidth  = video.screen_width;
         state.gfx.gfx_vscreenheight = video.screen_height;
+
+        uploadedhud      = I_Realloc(uploadedhud, video.screen_area);
+        uploadedhudvalid = false;
     }
 
-    if(state.gfx.gfx_rscreenwidth != render.screen_width || state.gfx.gfx_rscreenheight != render.screen_height)
+    if(state.gfx.gfx_rscreenwidth != render.screen_width || state.gfx.gfx_rscreenheight != render.screen_height
+       || state.gfx.gfx_columnmajor != r_columnmajor)
     {
         // Validate dimensions before creating textures
         if(render.screen_width <= 0 || render.screen_height <= 0 ||
@@ -237,10 +279,11 @@ static void update_render_textures()
             state.gfx.level.tex_view.id = 0;
         }
 
-        // Create dynamic image and texture view for level
+        // Create dynamic image and texture view for level, with its rows
+        // holding the columns of the view if it's column-major
         state.gfx.level.img = sg_make_image(&(sg_image_desc){
-        .width               = render.screen_width,
-        .height              = render.screen_height,
+        .width               = (r_columnmajor ? render.screen_height : render.screen_width),
+        .height              = (r_columnmajor ? render.screen_width : render.screen_height),
         .pixel_format        = SG_PIXELFORMAT_R8,
         .usage.stream_update = true,
         });
@@ -267,21 +310,51 @@ static void update_render_textures()
 
         state.gfx.gfx_rscreenwidth  = render.screen_width;
         state.gfx.gfx_rscreenheight = render.screen_height;
+        state.gfx.gfx_columnmajor   = r_columnmajor;
+
+        r_screensupdated = true;
     }
 
-    // Update hud texture
-    sg_update_image(state.gfx.hud.img,
-    &(sg_image_data){ .mip_levels[0] = {
-                      .ptr  = v_screens[0],
-                      .size = video.screen_width * video.screen_height,
-                      } });
+    // Update hud texture, but only if a row of it has changed. Sokol can only
+    // replace a texture as a whole, so the changed rows are just what needs
+    // copying to compare against next frame.
+    if(!uploadedhudvalid)
+    {
+        memcpy(uploadedhud, v_screens[0], video.screen_area);
+        uploadedhudvalid = true;
+        update_hud_texture();
+    }
+    else
+    {
+        const int width = video.screen_width;
+        int top         = 0;
+        int bottom      = video.screen_height - 1;
 
-    // Update level texture
-    sg_update_image(state.gfx.level.img,
-    &(sg_image_data){ .mip_levels[0] = {
-                      .ptr  = r_screens[0],
-                      .size = render.screen_width * render.screen_height,
-                      } });
+        while(top <= bottom && !memcmp(&v_screens[0][top * width], &uploadedhud[top * width], width))
+            top++;
+
+        if(top <= bottom)
+        {
+            while(!memcmp(&v_screens[0][bottom * width], &uploadedhud[bottom * width], width))
+                bottom--;
+
+            memcpy(&uploadedhud[top * width], &v_screens[0][top * width], (bottom - top + 1) * width);
+            update_hud_texture();
+        }
+    }
+
+    // Update level texture, if the view has been drawn since it last was
+    if(r_screensupdated)
+    {
+        sg_update_image(state.gfx.level.img,
+        &(sg_image_data){ .mip_levels[0] = {
+                          .ptr  = r_screens[0],
+                          .size = render.screen_width * render.screen_height,
+                          } });
+
+        vid_uploadedbytes += render.screen_width * render.screen_height;
+        r_screensupdated = false;
+    }
 }
 
 extern SDL_Rect src_rect;
@@ -295,6 +368,7 @@ extern SDL_Rect dest_rect;
 static void frame(void)
 {
     TracyCZoneN(tracy_zone, "sokol frame", 1);
+    uint64_t starttime;
 
     void I_ReadController(void);
     I_ReadController();
@@ -303,21 +377,35 @@ static void frame(void)
     void D_DoomTick(void);
     D_DoomTick();
 
+    starttime         = I_GetTimeNS();
+    vid_uploadedbytes = 0;
     update_render_textures();
 
     // Skip rendering if GPU resources aren't valid
     if(!state.gfx.rgba.img.id || !state.gfx.level.img.id || !state.gfx.hud.img.id)
     {
         sg_commit();
+        I_AddPerfTime(PERF_UPLOAD, starttime);
+        I_EndPerfFrame();
         TracyCZoneEnd(tracy_zone);
         TracyCFrameMark
         return;
     }
 
     // update palette
-    sg_update_image(state.gfx.pal.img,
-    &(sg_image_data){
-    .mip_levels[0] = { .ptr = screencolors, .size = 256 * sizeof(uint32_t) } });
+    if(!uploadedpalettevalid || memcmp(uploadedpalette, screencolors, sizeof(uploadedpalette)))
+    {
+        sg_update_image(state.gfx.pal.img,
+        &(sg_image_data){
+        .mip_levels[0] = { .ptr = screencolors, .size = 256 * sizeof(uint32_t) } });
+
+        memcpy(uploadedpalette, screencolors, sizeof(uploadedpalette));
+        uploadedpalettevalid = true;
+        vid_uploadedbytes += sizeof(uploadedpalette);
+    }
+
+    I_AddPerfTime(PERF_UPLOAD, starttime);
+    starttime = I_GetTimeNS();
 
     // Offscreen render pass to perform color palette lookup
     sg_begin_pass(&(sg_pass){
@@ -325,7 +413,7 @@ static void frame(void)
     .attachments = { .colors[0] = state.gfx.rgba.att_view },
     });
 
-    sg_apply_pipeline(state.gfx.offscreen_pip);
+    sg_apply_pipeline(state.gfx.gfx_columnmajor ? state.gfx.transposed_pip : state.gfx.offscreen_pip);
 
     sg_apply_bindings(&(sg_bindings){
         .vertex_buffers[0] = state.gfx.vbuf,
@@ -338,7 +426,8 @@ static void frame(void)
 
     sg_draw(0, 3, 1);
 
-    // sg_apply_pipeline(state.gfx.offscreen_pip);
+    if(state.gfx.gfx_columnmajor)
+        sg_apply_pipeline(state.gfx.offscreen_pip);
 
     sg_apply_bindings(&(sg_bindings){
         .vertex_buffers[0] = state.gfx.vbuf,
@@ -394,6 +483,9 @@ static void frame(void)
 
     sg_commit();
 
+    I_AddPerfTime(PERF_PRESENT, starttime);
+    I_EndPerfFrame();
+
     TracyCZoneEnd(tracy_zone);
 
     TracyCFrameMark
@@ -420,6 +512,7 @@ static void cleanup(void)
     // Destroy pipelines
     sg_destroy_pipeline(state.gfx.display_pip);
     sg_destroy_pipeline(state.gfx.offscreen_pip);
+    sg_destroy_pipeline(state.gfx.transposed_pip);
 
     // Destroy samplers
     sg_destroy_sampler(state.gfx.smp_upscale);
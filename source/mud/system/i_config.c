@@ -99,6 +99,9 @@ bool con_timestamps              = con_timestamps_default;
 int con_warninglevel             = con_warninglevel_default;
 int crosshair                    = crosshair_default;
 int crosshaircolor               = crosshaircolor_default;
+bool dormancy                    = dormancy_default;
+int dormancy_asleep;
+int dormancy_awake;
 int english                      = english_default;
 int episode                      = episode_default;
 int expansion                    = expansion_default;
@@ -150,6 +153,7 @@ int r_bloodsplats_total;
 bool r_bloodsplats_translucency  = r_bloodsplats_translucency_default;
 bool r_brightmaps                = r_brightmaps_default;
 bool r_buildnodes                = r_buildnodes_default;
+bool r_columnmajor               = r_columnmajor_default;
 bool r_corpses_color             = r_corpses_color_default;
 bool r_corpses_gib               = r_corpses_gib_default;
 bool r_corpses_mirrored          = r_corpses_mirrored_default;
@@ -197,6 +201,8 @@ bool r_shake_damage              = r_shake_damage_default;
 bool r_sprites_translucency      = r_sprites_translucency_default;
 bool r_textures                  = r_textures_default;
 bool r_textures_translucency     = r_textures_translucency_default;
+int r_threads                    = r_threads_default;
+int rewindinterval               = rewindinterval_default;
 int s_channels                   = s_channels_default;
 bool s_fullsfx                   = s_fullsfx_default;
 bool s_lowermenumusic            = s_lowermenumusic_default;
@@ -234,6 +240,7 @@ char* vid_scaleapi         = vid_scaleapi_default;
 char* vid_scalefilter      = vid_scalefilter_default;
 char* vid_screenresolution = vid_screenresolution_default;
 bool vid_showfps           = vid_showfps_default;
+int vid_uploadedbytes;
 int vid_vsync              = vid_vsync_default;
 bool vid_widescreen        = vid_widescreen_default;
 char* vid_windowpos        = vid_windowpos_default;
@@ -357,6 +364,7 @@ static default_t cvars[] = { COMMENT("; CVARs"),
     CVAR_INT(con_warninglevel, con_warninglevel, con_warninglevel, NOVALUEALIAS),
     CVAR_INT(crosshair, crosshair, crosshair, CROSSHAIRVALUEALIAS),
     CVAR_INT(crosshaircolor, crosshaircolour, crosshaircolor, NOVALUEALIAS),
+    CVAR_BOOL(dormancy, dormancy, dormancy, BOOLVALUEALIAS),
     CVAR_BOOL(english, english, english, ENGLISHVALUEALIAS),
     CVAR_INT(episode, episode, episode, NOVALUEALIAS),
     CVAR_INT(expansion, expansion, expansion, NOVALUEALIAS),
@@ -406,6 +414,7 @@ static default_t cvars[] = { COMMENT("; CVARs"),
     CVAR_BOOL(r_bloodsplats_translucency, r_bloodsplats_translucency, r_bloodsplats_translucency, BOOLVALUEALIAS),
     CVAR_BOOL(r_brightmaps, r_brightmaps, r_brightmaps, BOOLVALUEALIAS),
     CVAR_BOOL(r_buildnodes, r_buildnodes, r_buildnodes, BOOLVALUEALIAS),
+    CVAR_BOOL(r_columnmajor, r_columnmajor, r_columnmajor, BOOLVALUEALIAS),
     CVAR_BOOL(r_corpses_color, r_corpses_colour, r_corpses_color, BOOLVALUEALIAS),
     CVAR_BOOL(r_corpses_gib, r_corpses_gib, r_corpses_gib, BOOLVALUEALIAS),
     CVAR_BOOL(r_corpses_mirrored, r_corpses_mirrored, r_corpses_mirrored, BOOLVALUEALIAS),
@@ -453,6 +462,8 @@ static default_t cvars[] = { COMMENT("; CVARs"),
     CVAR_BOOL(r_sprites_translucency, r_translucency, r_sprites_translucency, BOOLVALUEALIAS),
     CVAR_BOOL(r_textures, r_textures, r_textures, BOOLVALUEALIAS),
     CVAR_BOOL(r_textures_translucency, r_textures_translucency, r_textures_translucency, BOOLVALUEALIAS),
+    CVAR_INT(r_threads, r_threads, r_threads, NOVALUEALIAS),
+    CVAR_INT(rewindinterval, rewindinterval, rewindinterval, NOVALUEALIAS),
     CVAR_INT(s_channels, s_channels, s_channels, NOVALUEALIAS),
     CVAR_BOOL(s_fullsfx, s_fullsfx, s_fullsfx, BOOLVALUEALIAS),
     CVAR_BOOL(s_lowermenumusic, s_lowermenumusic, s_lowermenumusic, BOOLVALUEALIAS),
@@ -118,6 +118,9 @@ extern bool con_timestamps;
 extern int con_warninglevel;
 extern int crosshair;
 extern int crosshaircolor;
+extern bool dormancy;
+extern int dormancy_asleep;
+extern int dormancy_awake;
 extern int english;
 extern int episode;
 extern int expansion;
@@ -183,6 +186,7 @@ extern int r_bloodsplats_total;
 extern bool r_bloodsplats_translucency;
 extern bool r_brightmaps;
 extern bool r_buildnodes;
+extern bool r_columnmajor;
 extern bool r_corpses_color;
 extern bool r_corpses_gib;
 extern bool r_corpses_mirrored;
@@ -230,6 +234,8 @@ extern bool r_shake_damage;
 extern bool r_sprites_translucency;
 extern bool r_textures;
 extern bool r_textures_translucency;
+extern int r_threads;
+extern int rewindinterval;
 
 // =============================================================================
 // SOUND/MUSIC SETTINGS (s_*)
@@ -277,6 +283,7 @@ extern char* vid_scaleapi;
 extern char* vid_scalefilter;
 extern char* vid_screenresolution;
 extern bool vid_showfps;
+extern int vid_uploadedbytes;
 extern int vid_vsync;
 extern bool vid_widescreen;
 extern char* vid_windowpos;
@@ -600,6 +607,16 @@ enum
 #define crosshaircolor_default 4
 #define crosshaircolor_max 255
 
+#define dormancy_default false
+
+#define dormancy_asleep_min 0
+#define dormancy_asleep_default 0
+#define dormancy_asleep_max 0
+
+#define dormancy_awake_min 0
+#define dormancy_awake_default 0
+#define dormancy_awake_max 0
+
 #define english_default english_american
 
 #define episode_min 1
@@ -740,6 +757,8 @@ enum
 
 #define r_buildnodes_default true
 
+#define r_columnmajor_default false
+
 #define r_corpses_color_default true
 
 #define r_corpses_gib_default true
@@ -844,6 +863,14 @@ enum
 
 #define r_textures_translucency_default true
 
+#define r_threads_min 1
+#define r_threads_default 1
+#define r_threads_max 16
+
+#define rewindinterval_min 0
+#define rewindinterval_default 35
+#define rewindinterval_max 350
+
 #define s_channels_min 8
 #define s_channels_default 32
 #define s_channels_max 64
@@ -969,6 +996,10 @@ enum
 
 #define vid_showfps_default false
 
+#define vid_uploadedbytes_min 0
+#define vid_uploadedbytes_default 0
+#define vid_uploadedbytes_max 0
+
 #if defined(__APPLE__)
 #define vid_vsync_min vid_vsync_off
 #else
@@ -11,12 +11,23 @@
 #include <emscripten/emscripten.h>
 #endif
 
+// WADs opened from the real filesystem are memory-mapped where possible, so
+// their lumps are only paged in when used, and are shared between processes
+#if (defined(__APPLE__) || defined(__linux__)) && !defined(__EMSCRIPTEN__)
+#define MUD_MMAP_WADS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <string.h>
 
 #include "console/c_console.h"
 // clang-format off
 #include "system/i_filesystem.h"
 #include "backends/wad/fs_wad.h"
+#include "backends/zip/fs_zip.h"
 // clang-format on
 #include "system/i_system.h"
 #include "doom/doomtype.h"
@@ -26,6 +37,16 @@
 static fs* file_system = NULL;
 static char executable_folder[MUD_MAX_PATH] = { 0 };
 
+// The stream a WAD is read through. The memory stream must come first, as the
+// rest of the filesystem layer only sees that.
+typedef struct
+{
+    fs_memory_stream strm;
+    void *data;
+    size_t size;
+    fs_bool32 mapped;
+} fs_wad_stream;
+
 static void GetExecutableFolder(void)
 {
 #if defined(_WIN32)
@@ -165,15 +186,45 @@ fs_memory_stream *FS_OpenMem(const void *data, size_t length)
     return strm;
 }
 
-fs *FS_OpenWAD(const char *path, fs_bool32 external)
+static void *MapWAD(const char *path, size_t size)
 {
-    if (!path) return NULL;
-    
-    fs_file_info info;
-    if (fs_info(external ? NULL : file_system, path, FS_READ, &info) != FS_SUCCESS)
+#if defined(MUD_MMAP_WADS)
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size != size)
+    {
+        close(fd);
         return NULL;
-    if (!info.size) return NULL;
-    
+    }
+
+    // Mapped copy-on-write, as some lumps are changed in place once cached.
+    // The mapping stays valid once the file is closed.
+    void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    return (data == MAP_FAILED ? NULL : data);
+#else
+    (void)path;
+    (void)size;
+    return NULL;
+#endif
+}
+
+static void FreeWAD(fs_wad_stream *wad_stream)
+{
+    if (!wad_stream->data) return;
+#if defined(MUD_MMAP_WADS)
+    if (wad_stream->mapped)
+        munmap(wad_stream->data, wad_stream->size);
+    else
+#endif
+        free(wad_stream->data);
+    wad_stream->data = NULL;
+}
+
+static void *ReadWAD(const char *path, size_t size, fs_bool32 external)
+{
     fs_file *handle = NULL;
     fs_result res = fs_file_open(external ? NULL : file_system, path, FS_READ, &handle);
     if (!handle || res != FS_SUCCESS)
@@ -181,42 +232,60 @@ fs *FS_OpenWAD(const char *path, fs_bool32 external)
         if (handle) fs_file_close(handle);
         return NULL;
     }
-    
-    // Load entire WAD into memory for fast random access to lumps.
-    // Ownership of raw_wad transfers to the memory stream; it will be freed in FS_CloseWAD.
-    uint8_t *raw_wad = malloc(info.size);
-    if (!raw_wad)
+
+    uint8_t *raw_wad = malloc(size);
+    if (raw_wad && FS_Read(raw_wad, size, 1, handle) != 1)
     {
-        fs_file_close(handle);
-        return NULL;
+        free(raw_wad);
+        raw_wad = NULL;
     }
+
+    fs_file_close(handle);
+    return raw_wad;
+}
+
+fs *FS_OpenWAD(const char *path, fs_bool32 external)
+{
+    if (!path) return NULL;
+    
+    fs_file_info info;
+    if (fs_info(external ? NULL : file_system, path, FS_READ, &info) != FS_SUCCESS)
+        return NULL;
+    if (!info.size) return NULL;
     
-    if (FS_Read(raw_wad, info.size, 1, handle) != 1)
+    fs_wad_stream *wad_mem_stream = calloc(1, sizeof(fs_wad_stream));
+    if (!wad_mem_stream) return NULL;
+    wad_mem_stream->size = info.size;
+
+    // Map the WAD if it's on the real filesystem, or else load all of it into
+    // memory. Either way, lumps are then read straight out of it, and it's
+    // owned by the stream until FS_CloseWAD.
+    if (external && (wad_mem_stream->data = MapWAD(path, info.size)))
+        wad_mem_stream->mapped = FS_TRUE;
+    else if (!(wad_mem_stream->data = ReadWAD(path, info.size, external)))
     {
-        fs_file_close(handle);
-        free(raw_wad);
+        free(wad_mem_stream);
         return NULL;
     }
     
-    fs_memory_stream *wad_mem_stream = FS_OpenMem(raw_wad, info.size);
-    if (!wad_mem_stream)
+    if (fs_memory_stream_init_readonly(wad_mem_stream->data, info.size, &wad_mem_stream->strm) != FS_SUCCESS)
     {
-        fs_file_close(handle);
-        free(raw_wad);
+        FreeWAD(wad_mem_stream);
+        free(wad_mem_stream);
         return NULL;
     }
     
-    // File handle no longer needed; data is in memory
-    fs_file_close(handle);
-    
+    // PK3s are zip archives, which are read through the zip backend instead
+    const fs_backend *backend = (info.size >= 4 && !memcmp(wad_mem_stream->data, "PK\3\4", 4) ? FS_ZIP : FS_WAD);
+
     fs *wad_stream = NULL;
-    fs_config wad_config = fs_config_init(FS_WAD, NULL, (fs_stream *)wad_mem_stream);
+    fs_config wad_config = fs_config_init(backend, NULL, (fs_stream *)wad_mem_stream);
     if (fs_init(&wad_config, &wad_stream) != FS_SUCCESS)
     {
         if (wad_stream) fs_uninit(wad_stream);
-        fs_memory_stream_uninit(wad_mem_stream);
+        fs_memory_stream_uninit(&wad_mem_stream->strm);
+        FreeWAD(wad_mem_stream);
         free(wad_mem_stream);
-        free(raw_wad);
         return NULL;
     }
     
@@ -237,6 +306,28 @@ void *FS_GetRawLump(lumpinfo_t *info)
     return (uint8_t *)*strm->ppData + info->position;
 }
 
+size_t FS_ReadArchiveFile(fs *archive, const char *path, void *dest, size_t size)
+{
+    if (!archive || !path || !dest || !size) return 0;
+
+    fs_file *handle = NULL;
+    if (fs_file_open(archive, path, FS_READ, &handle) != FS_SUCCESS || !handle)
+        return 0;
+
+    // Entries are inflated as they're read, so keep reading until all of it is
+    size_t total = 0;
+    while (total < size)
+    {
+        size_t read = 0;
+        if (fs_file_read(handle, (uint8_t *)dest + total, size - total, &read) != FS_SUCCESS || !read)
+            break;
+        total += read;
+    }
+
+    fs_file_close(handle);
+    return total;
+}
+
 void FS_OpenURI(const char *url, const char *description)
 {
 #if defined(_WIN32)
@@ -280,21 +371,18 @@ int FS_CloseWAD(fs *wad)
 {
     if (!wad) return EOF;
     
-    fs_memory_stream *strm = (fs_memory_stream *)fs_get_stream(wad);
+    fs_wad_stream *strm = (fs_wad_stream *)fs_get_stream(wad);
     if (!strm)
     {
         fs_uninit(wad);
         return EOF;
     }
     
-    // The memory stream holds a pointer to the raw WAD data we allocated in FS_OpenWAD.
-    // We need to free it before uninitializing the stream.
-    if (strm->ppData && *strm->ppData)
-    {
-        free((void *)*strm->ppData);
-    }
+    // The stream owns the raw WAD data that was mapped or allocated in
+    // FS_OpenWAD. We need to release it before uninitializing the stream.
+    FreeWAD(strm);
     
-    fs_memory_stream_uninit(strm);
+    fs_memory_stream_uninit(&strm->strm);
     free(strm);
     fs_uninit(wad);
     return 0;
@@ -44,7 +44,7 @@ fs_int64 FS_MemTell(fs_memory_stream *strm);
 size_t FS_MemRead(void *dest, size_t size, size_t count, fs_memory_stream *strm);
 int FS_MemSeek(fs_memory_stream *strm, fs_int64 offset, fs_seek_origin seekpoint);
 
-/* WAD file operations (loads entire WAD into memory for fast lump access) */
+/* WAD and PK3 file operations (maps or loads the entire file into memory for fast lump access) */
 fs *FS_OpenWAD(const char *path, fs_bool32 external);
 int FS_CloseWAD(fs *wad);
 size_t FS_WADRead(void *dest, size_t size, size_t count, fs *wad);
@@ -53,6 +53,9 @@ int FS_WADSeek(fs *wad, fs_int64 offset, fs_seek_origin seekpoint);
 /* Returns a direct pointer to lump data within a loaded WAD (no copy) */
 void *FS_GetRawLump(lumpinfo_t *info);
 
+/* Reads (and inflates) up to size bytes of a file within a PK3 opened by FS_OpenWAD */
+size_t FS_ReadArchiveFile(fs *archive, const char *path, void *dest, size_t size);
+
 /* Utility functions */
 void FS_OpenURI(const char *url, const char *description);
 int FS_MakeDir(const char *path, fs_bool32 external);
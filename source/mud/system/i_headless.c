@@ -0,0 +1,80 @@
+/*
+==============================================================================
+
+                                 DOOM Retro
+           The classic, refined DOOM source port. For Windows PC.
+
+==============================================================================
+
+    Copyright © 1993-2025 by id Software LLC, a ZeniMax Media company.
+    Copyright © 2013-2025 by Brad Harding <mailto:brad@doomretro.com>.
+
+    This file is a part of DOOM Retro.
+
+    DOOM Retro is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation, either version 3 of the license, or (at your
+    option) any later version.
+
+    DOOM Retro is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DOOM Retro. If not, see <https://www.gnu.org/licenses/>.
+
+    DOOM is a registered trademark of id Software LLC, a ZeniMax Media
+    company, in the US and/or other countries, and is used without
+    permission. All other trademarks are the property of their respective
+    holders. DOOM Retro is in no way affiliated with nor endorsed by
+    id Software.
+
+==============================================================================
+*/
+
+//
+// i_headless.c - Entry point for the headless build, without a window, GPU
+// or audio device
+//
+
+#include "doom/d_main.h"
+#include "game/g_demo.h"
+#include "script/script_main.h"
+#include "system/i_perfstats.h"
+#include "system/i_timer.h"
+
+#include "sokol_args.h"
+
+#include "mud_profiling.h"
+
+//
+// main
+//
+// Runs D_DoomTick until the game quits. Nothing is drawn, sound effects and
+// music are off, and there's no input other than what a demo plays back.
+// Tics run as they fall due, or back to back during a timedemo.
+//
+int main(int argc, char* argv[])
+{
+    sargs_setup(&(sargs_desc){ .argc = argc, .argv = argv });
+
+    TracyCSetThreadName("Main Thread");
+
+    Script_Init();
+
+    int doomretro_main(void);
+    doomretro_main();
+
+    while(true)
+    {
+        D_DoomTick();
+
+        I_EndPerfFrame();
+
+        if(!timingdemo)
+            I_Sleep(1);
+    }
+
+    return 0;
+}
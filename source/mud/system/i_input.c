@@ -473,7 +473,9 @@ bool MouseShouldBeGrabbed(void)
 //
 void SetShowCursor(bool show)
 {
+#if !defined(MUD_HEADLESS)
     sapp_lock_mouse(!show);
+#endif
 }
 
 //
@@ -1039,7 +1041,9 @@ void I_InitInput(void)
 {
     I_ClearKeyState();
     I_InitEventQueue();
+#if !defined(MUD_HEADLESS)
     I_InitController();
+#endif
 }
 
 //
@@ -1051,5 +1055,7 @@ void I_ShutdownInput(void)
 {
     I_ShutdownEventQueue();
     I_ShutdownKeyboard();
+#if !defined(MUD_HEADLESS)
     I_ShutdownController();
+#endif
 }
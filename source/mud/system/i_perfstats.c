@@ -0,0 +1,146 @@
+//
+// i_perfstats.c - Per-frame timings of each part of the frame
+//
+// Each part of the frame adds the time it takes to the current frame's
+// timings, which I_EndPerfFrame then moves into a ring buffer of the last
+// PERFSTATFRAMES frames, in microseconds, and optionally writes to a CSV
+// file. Only the main thread's strip of the view is timed.
+//
+
+#include <stdlib.h>
+
+#include "math/math_fixed.h"
+#include "system/i_filesystem.h"
+#include "system/i_perfstats.h"
+#include "system/i_timer.h"
+
+const char* perfstatnames[NUMPERFSTATS] = {
+    "input", "tics", "rewind", "view", "bsp", "walls", "planes", "masked", "hud",
+    "upload", "present", "frame"
+};
+
+static uint64_t perftimes[NUMPERFSTATS];
+static int      perfhistory[PERFSTATFRAMES][NUMPERFSTATS];
+static int      perfframes;
+static uint64_t perfframestart;
+static fs_file* perflog;
+
+//
+// I_AddPerfTime
+//
+void I_AddPerfTime(const perfstat_t stat, const uint64_t starttime)
+{
+    perftimes[stat] += I_GetTimeNS() - starttime;
+}
+
+//
+// I_EndPerfFrame
+//
+void I_EndPerfFrame(void)
+{
+    const uint64_t  now     = I_GetTimeNS();
+    int*            history = perfhistory[perfframes % PERFSTATFRAMES];
+
+    if(perfframestart)
+        perftimes[PERF_FRAME] = now - perfframestart;
+
+    perfframestart = now;
+
+    // Walls are drawn as the BSP tree is walked, the HUD is timed as the whole
+    // of D_Display and rewind snapshots are taken during tics, so take out
+    // what's already counted elsewhere
+    perftimes[PERF_TICS] -= (perftimes[PERF_REWIND] < perftimes[PERF_TICS] ? perftimes[PERF_REWIND] : perftimes[PERF_TICS]);
+    perftimes[PERF_BSP] -= (perftimes[PERF_WALLS] < perftimes[PERF_BSP] ? perftimes[PERF_WALLS] : perftimes[PERF_BSP]);
+    perftimes[PERF_HUD] -= (perftimes[PERF_VIEW] < perftimes[PERF_HUD] ? perftimes[PERF_VIEW] : perftimes[PERF_HUD]);
+
+    for(int i = 0; i < NUMPERFSTATS; i++)
+    {
+        history[i]   = (int)(perftimes[i] / 1000);
+        perftimes[i] = 0;
+    }
+
+    if(perflog)
+    {
+        FS_Print(perflog, "%i", perfframes);
+
+        for(int i = 0; i < NUMPERFSTATS; i++)
+            FS_Print(perflog, ",%i", history[i]);
+
+        FS_PutChar('\n', perflog);
+    }
+
+    perfframes++;
+}
+
+//
+// I_GetPerfFrames
+//
+int I_GetPerfFrames(void)
+{
+    return MIN(perfframes, PERFSTATFRAMES);
+}
+
+static int I_CompareTimes(const void* a, const void* b)
+{
+    return (*(const int*)a - *(const int*)b);
+}
+
+//
+// I_GetPerfPercentile
+// Returns the time in microseconds that stat took in the given percentile of
+// the frames kept
+//
+int I_GetPerfPercentile(const perfstat_t stat, const int percentile)
+{
+    const int   count = I_GetPerfFrames();
+    static int  times[PERFSTATFRAMES];
+
+    if(!count)
+        return 0;
+
+    for(int i = 0; i < count; i++)
+        times[i] = perfhistory[i][stat];
+
+    qsort(times, count, sizeof(int), &I_CompareTimes);
+
+    return times[MIN(count * percentile / 100, count - 1)];
+}
+
+//
+// I_StartPerfLog
+//
+bool I_StartPerfLog(const char* filename)
+{
+    I_StopPerfLog();
+
+    if(!(perflog = FS_OpenFile(filename, FS_WRITE | FS_TRUNCATE, FS_TRUE)))
+        return false;
+
+    FS_PutString("frame", perflog);
+
+    for(int i = 0; i < NUMPERFSTATS; i++)
+        FS_Print(perflog, ",%s", perfstatnames[i]);
+
+    FS_PutChar('\n', perflog);
+    return true;
+}
+
+//
+// I_StopPerfLog
+//
+void I_StopPerfLog(void)
+{
+    if(perflog)
+    {
+        FS_CloseFile(perflog);
+        perflog = NULL;
+    }
+}
+
+//
+// I_PerfLogging
+//
+bool I_PerfLogging(void)
+{
+    return (perflog != NULL);
+}
@@ -0,0 +1,42 @@
+//
+// i_perfstats.h - Per-frame timings of each part of the frame
+//
+
+#pragma once
+
+#include "doom/doomtype.h"
+
+// How many frames of timings are kept for perfstats
+#define PERFSTATFRAMES  1024
+
+typedef enum
+{
+    PERF_INPUT,
+    PERF_TICS,
+    PERF_REWIND,
+    PERF_VIEW,
+    PERF_BSP,
+    PERF_WALLS,
+    PERF_PLANES,
+    PERF_MASKED,
+    PERF_HUD,
+    PERF_UPLOAD,
+    PERF_PRESENT,
+    PERF_FRAME,
+    NUMPERFSTATS
+} perfstat_t;
+
+extern const char* perfstatnames[NUMPERFSTATS];
+
+// Adds the time since starttime, as returned by I_GetTimeNS, to the current
+// frame's timing of stat
+void I_AddPerfTime(const perfstat_t stat, const uint64_t starttime);
+
+void I_EndPerfFrame(void);
+
+int I_GetPerfFrames(void);
+int I_GetPerfPercentile(const perfstat_t stat, const int percentile);
+
+bool I_StartPerfLog(const char* filename);
+void I_StopPerfLog(void);
+bool I_PerfLogging(void);
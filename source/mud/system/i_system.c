@@ -42,12 +42,14 @@
 #include "console/c_console.h"
 #include "doom/d_main.h"
 #include "doom/doomstat.h"
+#include "game/g_demo.h"
 #include "system/i_controller.h"
 #include "system/i_filesystem.h"
 #include "system/i_input.h"
 #include "system/i_system.h"
 #include "system/i_config.h"
 #include "utils/m_misc.h"
+#include "playsim/p_saveg.h"
 #include "sound/s_sound.h"
 #include "system/i_version.h"
 #include "wad/w_wad.h"
@@ -57,6 +59,8 @@
 //
 NORETURN void I_Quit(bool shutdown)
 {
+    G_StopDemo();
+
     if(shutdown)
     {
         D_FadeScreenToBlack();
@@ -69,6 +73,9 @@ NORETURN void I_Quit(bool shutdown)
         I_ShutdownGraphics();
     }
 
+    // Don't lose a savegame that's still being written
+    P_FinishSaveGame();
+
     W_CloseFiles();
 
     FS_Shutdown();
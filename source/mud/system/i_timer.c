@@ -71,6 +71,11 @@ uint64_t I_GetTimeUS(void)
     return stm_since(time_start) / 1000;
 }
 
+uint64_t I_GetTimeNS(void)
+{
+    return stm_since(time_start);
+}
+
 //
 // Sleep for a specified number of milliseconds
 //
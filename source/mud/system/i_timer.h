@@ -44,6 +44,8 @@ uint64_t I_GetTimeMS(void);
 
 uint64_t I_GetTimeUS(void);
 
+uint64_t I_GetTimeNS(void);
+
 // Pause for a specified number of ms
 void I_Sleep(int ms);
 
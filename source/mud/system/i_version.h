@@ -46,6 +46,7 @@
 #define DOOMRETRO_SAVEGAMEVERSION_5_7_1 "DOOM Retro v5.7.1"
 #define DOOMRETRO_SAVEGAMEVERSION_5_7_2 "DOOM Retro v5.7.2"
 #define DOOMRETRO_SAVEGAMEVERSIONSTRING DOOMRETRO_SAVEGAMEVERSION_5_7_2
+#define DOOMRETRO_SAVEGAMEVERSION_LZ DOOMRETRO_SAVEGAMEVERSIONSTRING " LZ"
 
 #define DOOMRETRO "doomretro"
 #define DOOMRETRO_AUTOLOADFOLDER "autoload"
@@ -73,6 +74,7 @@
 #define DOOMRETRO_SAVEGAME "doomretro%i.save"
 #define DOOMRETRO_SAVEGAMESFOLDER "savegames"
 #define DOOMRETRO_SCREENSHOTSFOLDER "screenshots"
+#define DOOMRETRO_TINTTABLESFILE "doomretro.tint"
 #define DOOMRETRO_TRADEMARKS                                        \
     "DOOM is a registered trademark of id Software LLC, a ZeniMax " \
     "Media company, in the US and/or other countries, and is used " \
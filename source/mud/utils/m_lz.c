@@ -0,0 +1,205 @@
+/*
+==============================================================================
+
+                                 DOOM Retro
+           The classic, refined DOOM source port. For Windows PC.
+
+==============================================================================
+
+    Copyright © 1993-2025 by id Software LLC, a ZeniMax Media company.
+    Copyright © 2013-2025 by Brad Harding <mailto:brad@doomretro.com>.
+
+    This file is a part of DOOM Retro.
+
+    DOOM Retro is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation, either version 3 of the license, or (at your
+    option) any later version.
+
+    DOOM Retro is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DOOM Retro. If not, see <https://www.gnu.org/licenses/>.
+
+    DOOM is a registered trademark of id Software LLC, a ZeniMax Media
+    company, in the US and/or other countries, and is used without
+    permission. All other trademarks are the property of their respective
+    holders. DOOM Retro is in no way affiliated with nor endorsed by
+    id Software.
+
+==============================================================================
+*/
+
+#include <string.h>
+
+#include "utils/m_lz.h"
+
+// A block is a token byte, holding the number of literals in its high
+// nibble and the match length less LZMINMATCH in its low nibble, then any
+// extra literal length bytes, the literals, a 16-bit little-endian offset
+// back to the match, and any extra match length bytes. A nibble of 15 is
+// followed by bytes that are added to it until one is less than 255. The
+// last block has literals only.
+#define LZMINMATCH  4
+#define LZMAXOFFSET 65535
+
+static unsigned int M_LZHash(const byte* p)
+{
+    const unsigned int value = (p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24));
+
+    return ((value * 2654435761U) >> (32 - LZHASHBITS));
+}
+
+static byte* M_LZWriteLength(byte* dest, size_t length)
+{
+    while(length >= 255)
+    {
+        *dest++ = 255;
+        length -= 255;
+    }
+
+    *dest++ = (byte)length;
+    return dest;
+}
+
+static byte* M_LZWriteBlock(byte* dest, const byte* literals, const size_t numliterals,
+    const size_t offset, const size_t matchlength)
+{
+    byte* token = dest++;
+
+    *token = (byte)((numliterals < 15 ? numliterals : 15) << 4);
+
+    if(numliterals >= 15)
+        dest = M_LZWriteLength(dest, numliterals - 15);
+
+    memcpy(dest, literals, numliterals);
+    dest += numliterals;
+
+    if(matchlength)
+    {
+        const size_t length = matchlength - LZMINMATCH;
+
+        *dest++ = (byte)(offset & 0xFF);
+        *dest++ = (byte)(offset >> 8);
+        *token |= (byte)(length < 15 ? length : 15);
+
+        if(length >= 15)
+            dest = M_LZWriteLength(dest, length - 15);
+    }
+
+    return dest;
+}
+
+//
+// M_LZCompress
+// Compresses length bytes of src into dest, which must have room for
+// M_LZBound(length) bytes, and returns the compressed length. table must
+// have room for LZHASHTABLESIZE entries.
+//
+size_t M_LZCompress(const byte* src, size_t length, byte* dest, unsigned int* table)
+{
+    const byte* end     = src + length;
+    const byte* literal = src;
+    const byte* p       = src;
+    byte* out           = dest;
+
+    memset(table, 0, LZHASHTABLESIZE * sizeof(*table));
+
+    // Leave the last few bytes as literals so a match never reads past end
+    if(length > LZMINMATCH + 8)
+        while(p < end - LZMINMATCH - 8)
+        {
+            const unsigned int hash = M_LZHash(p);
+            const byte* match       = src + table[hash];
+
+            table[hash] = (unsigned int)(p - src);
+
+            if(match < p && p - match <= LZMAXOFFSET && !memcmp(match, p, LZMINMATCH))
+            {
+                size_t matchlength = LZMINMATCH;
+
+                while(p + matchlength < end && match[matchlength] == p[matchlength])
+                    matchlength++;
+
+                out = M_LZWriteBlock(out, literal, p - literal, p - match, matchlength);
+                p += matchlength;
+                literal = p;
+            }
+            else
+                p++;
+        }
+
+    return (M_LZWriteBlock(out, literal, end - literal, 0, 0) - dest);
+}
+
+static bool M_LZReadLength(const byte** src, const byte* end, size_t* length)
+{
+    byte value;
+
+    do
+    {
+        if(*src >= end)
+            return false;
+
+        value = *(*src)++;
+        *length += value;
+    } while(value == 255);
+
+    return true;
+}
+
+//
+// M_LZDecompress
+// Decompresses length bytes of src, written by M_LZCompress(), into dest.
+// Returns false unless that gives exactly destlength bytes.
+//
+bool M_LZDecompress(const byte* src, size_t length, byte* dest, size_t destlength)
+{
+    const byte* end     = src + length;
+    byte* out           = dest;
+    const byte* destend = dest + destlength;
+
+    while(src < end)
+    {
+        const byte token   = *src++;
+        size_t numliterals = (token >> 4);
+        size_t matchlength = (token & 15);
+        size_t offset;
+
+        if(numliterals == 15 && !M_LZReadLength(&src, end, &numliterals))
+            return false;
+
+        if(numliterals > (size_t)(end - src) || numliterals > (size_t)(destend - out))
+            return false;
+
+        memcpy(out, src, numliterals);
+        out += numliterals;
+        src += numliterals;
+
+        if(src == end)
+            break;
+
+        if(end - src < 2)
+            return false;
+
+        offset = (src[0] | (src[1] << 8));
+        src += 2;
+
+        if(matchlength == 15 && !M_LZReadLength(&src, end, &matchlength))
+            return false;
+
+        matchlength += LZMINMATCH;
+
+        if(!offset || offset > (size_t)(out - dest) || matchlength > (size_t)(destend - out))
+            return false;
+
+        // Matches can overlap what they're writing, so copy a byte at a time
+        for(const byte* match = out - offset; matchlength--; )
+            *out++ = *match++;
+    }
+
+    return (out == destend);
+}
@@ -0,0 +1,49 @@
+/*
+==============================================================================
+
+                                 DOOM Retro
+           The classic, refined DOOM source port. For Windows PC.
+
+==============================================================================
+
+    Copyright © 1993-2025 by id Software LLC, a ZeniMax Media company.
+    Copyright © 2013-2025 by Brad Harding <mailto:brad@doomretro.com>.
+
+    This file is a part of DOOM Retro.
+
+    DOOM Retro is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation, either version 3 of the license, or (at your
+    option) any later version.
+
+    DOOM Retro is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DOOM Retro. If not, see <https://www.gnu.org/licenses/>.
+
+    DOOM is a registered trademark of id Software LLC, a ZeniMax Media
+    company, in the US and/or other countries, and is used without
+    permission. All other trademarks are the property of their respective
+    holders. DOOM Retro is in no way affiliated with nor endorsed by
+    id Software.
+
+==============================================================================
+*/
+
+#pragma once
+
+#include "doom/doomtype.h"
+
+// The most M_LZCompress() can write for length bytes of input
+#define M_LZBound(length)   ((length) + (length) / 255 + 16)
+
+// The hash table M_LZCompress() finds matches with, which each thread that
+// compresses needs its own of
+#define LZHASHBITS          14
+#define LZHASHTABLESIZE     (1 << LZHASHBITS)
+
+size_t M_LZCompress(const byte* src, size_t length, byte* dest, unsigned int* table);
+bool M_LZDecompress(const byte* src, size_t length, byte* dest, size_t destlength);
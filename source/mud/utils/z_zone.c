@@ -45,6 +45,7 @@ typedef struct memblock_s
     struct memblock_s* prev;
     size_t size;
     void** user;
+    zpool_t* pool;
     unsigned char tag;
 } memblock_t;
 
@@ -55,6 +56,134 @@ static const size_t headersize =
 
 static memblock_t* blockbytag[PU_MAX];
 
+//
+// ARENAS
+// Blocks with a tag that is only ever freed all at once, when a level ends,
+// are bumped out of large chunks rather than each being malloc'd and linked
+// into a tag list. Z_Free puts a block on a free list for blocks of its size,
+// to be handed out again by Z_Malloc, and Z_FreeTags just frees the chunks.
+//
+#define ARENACHUNKSIZE  (1024 * 1024)
+#define ARENAFREELISTS  32 // blocks of up to 32 * CHUNKSIZE bytes are reused
+
+#define ISARENATAG(tag) ((tag) == PU_LEVEL || (tag) == PU_LEVSPEC || (tag) == PU_NANOBSP)
+
+typedef struct arenachunk_s
+{
+    struct arenachunk_s* next;
+    size_t size;
+    size_t used;
+} arenachunk_t;
+
+typedef struct
+{
+    arenachunk_t* chunks;
+    memblock_t* freelists[ARENAFREELISTS + 1];
+    int users;
+} arena_t;
+
+static const size_t chunkheadersize =
+((sizeof(arenachunk_t) + CHUNKSIZE - 1) & ~(CHUNKSIZE - 1));
+
+static arena_t arenas[PU_MAX];
+
+// Every pool that has had a block allocated from it
+static zpool_t* pools;
+
+//
+// Z_ArenaMalloc
+// Returns a block from the arena's free list for blocks of that size, or
+// bumps one out of its current chunk, allocating a new chunk if it's full.
+//
+static memblock_t* Z_ArenaMalloc(arena_t* arena, size_t size)
+{
+    const size_t blocksize = size + headersize;
+    const size_t list      = size / CHUNKSIZE;
+    arenachunk_t* chunk    = arena->chunks;
+    memblock_t* block;
+
+    if(list <= ARENAFREELISTS && (block = arena->freelists[list]))
+    {
+        arena->freelists[list] = block->next;
+        return block;
+    }
+
+    if(!chunk || chunk->size - chunk->used < blocksize)
+    {
+        const size_t chunksize = (blocksize > ARENACHUNKSIZE ? blocksize : ARENACHUNKSIZE);
+
+        while(!(chunk = malloc(chunkheadersize + chunksize)))
+        {
+            if(!blockbytag[PU_CACHE])
+                I_Error("Z_Malloc: Failure trying to allocate %lu bytes", (unsigned long)size);
+
+            Z_FreeTags(PU_CACHE, PU_CACHE);
+        }
+
+        chunk->size = chunksize;
+        chunk->used = 0;
+
+        // A block too big for a chunk of its own is given one, leaving the
+        // current chunk to carry on with
+        if(chunksize > ARENACHUNKSIZE && arena->chunks)
+        {
+            chunk->next         = arena->chunks->next;
+            arena->chunks->next = chunk;
+        }
+        else
+        {
+            chunk->next   = arena->chunks;
+            arena->chunks = chunk;
+        }
+    }
+
+    block        = (memblock_t*)((char*)chunk + chunkheadersize + chunk->used);
+    chunk->used += blocksize;
+
+    return block;
+}
+
+//
+// Z_FreeArena
+// Frees every chunk in the arena apart from one, which is kept for the next
+// level. Users of blocks are only looked for if any were given.
+//
+static void Z_FreeArena(arena_t* arena)
+{
+    arenachunk_t* chunk = arena->chunks;
+    arenachunk_t* kept  = NULL;
+
+    while(chunk)
+    {
+        arenachunk_t* next = chunk->next;
+
+        if(arena->users)
+            for(size_t offset = 0; offset < chunk->used;)
+            {
+                memblock_t* block = (memblock_t*)((char*)chunk + chunkheadersize + offset);
+
+                if(block->user)
+                    *block->user = NULL;
+
+                offset += block->size + headersize;
+            }
+
+        if(!kept && chunk->size == ARENACHUNKSIZE)
+        {
+            kept       = chunk;
+            kept->next = NULL;
+            kept->used = 0;
+        }
+        else
+            free(chunk);
+
+        chunk = next;
+    }
+
+    memset(arena, 0, sizeof(*arena));
+    arena->chunks = kept;
+}
+
 //
 // Z_Malloc
 // You can pass a NULL user if the tag is < PU_PURGELEVEL.
@@ -76,28 +205,39 @@ void* Z_Malloc(size_t size, unsigned char tag, void** user)
 
     size = ((size + CHUNKSIZE - 1) & ~(CHUNKSIZE - 1)); // round to chunk size
 
-    while(!(block = malloc(size + headersize)))
+    if(ISARENATAG(tag))
     {
-        if(!blockbytag[PU_CACHE])
-            I_Error("Z_Malloc: Failure trying to allocate %lu bytes", (unsigned long)size);
-
-        Z_FreeTags(PU_CACHE, PU_CACHE);
-    }
+        block = Z_ArenaMalloc(&arenas[tag], size);
 
-    if(!blockbytag[tag])
-    {
-        blockbytag[tag] = block;
-        block->next = block->prev = block;
+        if(user)
+            arenas[tag].users++;
     }
     else
     {
-        blockbytag[tag]->prev->next = block;
-        block->prev                 = blockbytag[tag]->prev;
-        block->next                 = blockbytag[tag];
-        blockbytag[tag]->prev       = block;
+        while(!(block = malloc(size + headersize)))
+        {
+            if(!blockbytag[PU_CACHE])
+                I_Error("Z_Malloc: Failure trying to allocate %lu bytes", (unsigned long)size);
+
+            Z_FreeTags(PU_CACHE, PU_CACHE);
+        }
+
+        if(!blockbytag[tag])
+        {
+            blockbytag[tag] = block;
+            block->next = block->prev = block;
+        }
+        else
+        {
+            blockbytag[tag]->prev->next = block;
+            block->prev                 = blockbytag[tag]->prev;
+            block->next                 = blockbytag[tag];
+            blockbytag[tag]->prev       = block;
+        }
     }
 
     block->size = size;
+    block->pool = NULL;
 
     block->tag  = tag;
     block->user = user;
@@ -137,6 +277,37 @@ void Z_Free(void* ptr)
     if(block->user)
         *block->user = NULL;
 
+    // Pooled blocks go back on their pool's free list
+    if(block->pool)
+    {
+        block->next           = block->pool->freelist;
+        block->pool->freelist = block;
+        block->pool->used--;
+        return;
+    }
+
+    // Arena blocks go back on their arena's free list for blocks of their
+    // size, or are left until the arena is freed if there isn't one
+    if(ISARENATAG(block->tag))
+    {
+        arena_t* arena    = &arenas[block->tag];
+        const size_t list = block->size / CHUNKSIZE;
+
+        if(block->user)
+        {
+            block->user = NULL;
+            arena->users--;
+        }
+
+        if(list <= ARENAFREELISTS)
+        {
+            block->next            = arena->freelists[list];
+            arena->freelists[list] = block;
+        }
+
+        return;
+    }
+
     if(block == block->next)
         blockbytag[block->tag] = NULL;
     else if(blockbytag[block->tag] == block)
@@ -150,11 +321,26 @@ void Z_Free(void* ptr)
 
 void Z_FreeTags(unsigned char lowtag, unsigned char hightag)
 {
+    for(zpool_t* pool = pools; pool; pool = pool->nextpool)
+        if(pool->tag >= lowtag && pool->tag <= hightag)
+        {
+            pool->freelist = NULL;
+            pool->slab     = 0;
+            pool->carved   = 0;
+            pool->used     = 0;
+        }
+
     for(; lowtag <= hightag; lowtag++)
     {
         memblock_t* block = blockbytag[lowtag];
         memblock_t* endblock;
 
+        if(ISARENATAG(lowtag))
+        {
+            Z_FreeArena(&arenas[lowtag]);
+            continue;
+        }
+
         if(!block)
             continue;
 
@@ -174,6 +360,27 @@ void Z_FreeTags(unsigned char lowtag, unsigned char hightag)
     }
 }
 
+//
+// Z_GetArenaSize
+// Returns how many bytes the arenas for the tags have allocated, and how many
+// of those have been handed out.
+//
+size_t Z_GetArenaSize(unsigned char lowtag, unsigned char hightag, size_t* used)
+{
+    size_t size = 0;
+
+    *used = 0;
+
+    for(; lowtag <= hightag; lowtag++)
+        for(arenachunk_t* chunk = arenas[lowtag].chunks; chunk; chunk = chunk->next)
+        {
+            size  += chunk->size;
+            *used += chunk->used;
+        }
+
+    return size;
+}
+
 void Z_ChangeTag(void* ptr, unsigned char tag)
 {
     memblock_t* block;
@@ -184,9 +391,13 @@ void Z_ChangeTag(void* ptr, unsigned char tag)
     block = (memblock_t*)((char*)ptr - headersize);
 
     // proff - do nothing if tag doesn't differ
-    if(tag == block->tag)
+    // Pooled blocks always keep their pool's tag
+    if(tag == block->tag || block->pool)
         return;
 
+    if(ISARENATAG(tag) || ISARENATAG(block->tag))
+        I_Error("Z_ChangeTag: Blocks can't be moved in or out of an arena");
+
     if(block == block->next)
         blockbytag[block->tag] = NULL;
     else if(blockbytag[block->tag] == block)
@@ -210,3 +421,58 @@ void Z_ChangeTag(void* ptr, unsigned char tag)
 
     block->tag = tag;
 }
+
+//
+// Z_PoolCalloc
+// Returns a zeroed block from the pool's free list, or carves a new one out
+// of its slabs, allocating another slab once they're all in use.
+//
+void* Z_PoolCalloc(zpool_t* pool)
+{
+    memblock_t* block;
+
+    if(!pool->blocksize)
+    {
+        pool->blocksize = headersize + ((pool->size + CHUNKSIZE - 1) & ~(CHUNKSIZE - 1));
+        pool->nextpool  = pools;
+        pools           = pool;
+    }
+
+    if((block = pool->freelist))
+        pool->freelist = block->next;
+    else
+    {
+        if(pool->carved == POOLSLABBLOCKS)
+        {
+            pool->slab++;
+            pool->carved = 0;
+        }
+
+        if(pool->slab == pool->numslabs)
+        {
+            pool->slabs                   = I_Realloc(pool->slabs, (pool->numslabs + 1) * sizeof(*pool->slabs));
+            pool->slabs[pool->numslabs++] = I_Malloc(POOLSLABBLOCKS * pool->blocksize);
+        }
+
+        block = (memblock_t*)(pool->slabs[pool->slab] + pool->carved++ * pool->blocksize);
+    }
+
+    block->next = block->prev = NULL;
+    block->size = pool->blocksize - headersize;
+    block->user = NULL;
+    block->pool = pool;
+    block->tag  = pool->tag;
+
+    if(++pool->used > pool->highwater)
+        pool->highwater = pool->used;
+
+    return memset((char*)block + headersize, 0, pool->size);
+}
+
+//
+// Z_GetPools
+//
+zpool_t* Z_GetPools(void)
+{
+    return pools;
+}
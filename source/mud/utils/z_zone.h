@@ -65,3 +65,35 @@ char* Z_StringDuplicate(const char*, unsigned char tag, void** user);
 void Z_Free(void* ptr);
 void Z_FreeTags(unsigned char lowtag, unsigned char hightag);
 void Z_ChangeTag(void* ptr, unsigned char tag);
+size_t Z_GetArenaSize(unsigned char lowtag, unsigned char hightag, size_t* used);
+
+//
+// POOLS
+// Blocks of one type, carved out of slabs and recycled through a free list
+// rather than allocated one at a time. Z_Free returns a block to its pool,
+// and Z_FreeTags resets the whole pool at once when its tag is freed. The
+// slabs themselves are kept for the next level.
+//
+#define POOLSLABBLOCKS  256
+
+typedef struct zpool_s
+{
+    const char*         name;
+    size_t              size;
+    unsigned char       tag;
+
+    size_t              blocksize;
+    void*               freelist;
+    byte**              slabs;
+    int                 numslabs;
+    int                 slab;
+    int                 carved;
+    int                 used;
+    int                 highwater;
+    struct zpool_s*     nextpool;
+} zpool_t;
+
+#define ZPOOL(name, type, tag)  { name, sizeof(type), tag }
+
+void* Z_PoolCalloc(zpool_t* pool);
+zpool_t* Z_GetPools(void);
@@ -48,8 +48,16 @@
 #include "wad/w_wad.h"
 #include "utils/z_zone.h"
 
+#include "thread.h"
+
 #define MAXWADS 16
 
+#define PK3MAGIC        "PK\3\4"
+
+// How much inflated PK3 lump data may be kept in memory, including lumps
+// still being used, before released ones start to be dropped
+#define PK3CACHESIZE    (32 * 1024 * 1024)
+
 #if defined(_MSC_VER) || defined(__GNUC__)
 #pragma pack(push, 1)
 #endif
@@ -82,6 +90,45 @@ char* wadsloaded;
 static int numwads;
 static wadfile_t* wadlist[MAXWADS];
 
+// The lumps from PK3s folded into each section of the lump directory
+typedef enum
+{
+    PK3_NORMAL,
+    PK3_FLATS,
+    PK3_SPRITES,
+    NUMPK3SECTIONS
+} pk3section_t;
+
+typedef struct
+{
+    lumpinfo_t* lumps;
+    int numlumps;
+    int maxlumps;
+} pk3lumps_t;
+
+// The folders of a PK3 mapped onto the sections of the lump directory
+static const struct
+{
+    const char* folder;
+    pk3section_t section;
+} pk3folders[] = {
+    { "flats",    PK3_FLATS   },
+    { "graphics", PK3_NORMAL  },
+    { "music",    PK3_NORMAL  },
+    { "patches",  PK3_NORMAL  },
+    { "sounds",   PK3_NORMAL  },
+    { "sprites",  PK3_SPRITES }
+};
+
+// Released PK3 lumps, from least to most recently used
+static lumpinfo_t* oldestcachedlump;
+static lumpinfo_t* newestcachedlump;
+static size_t pk3cachesize;
+
+// PK3 lumps may be cached by the threads building patches in the background
+static thread_mutex_t pk3lock;
+static bool pk3lockinitialized;
+
 static bool IsFreedoom(const char* iwadname)
 {
     fs_file* fp = FS_OpenFile(iwadname, FS_READ, FS_TRUE);
@@ -179,6 +226,216 @@ bool IsUltimateDOOM(const char* iwadname)
     return result;
 }
 
+//
+// PK3 BASED ROUTINES.
+//
+
+static void W_AddPK3Lump(pk3lumps_t* lumps, wadfile_t* wadfile, const char* path, const char* leaf,
+    const int size)
+{
+    lumpinfo_t* lump;
+
+    if(lumps->numlumps == lumps->maxlumps)
+    {
+        lumps->maxlumps = (lumps->maxlumps ? lumps->maxlumps * 2 : 64);
+        lumps->lumps    = I_Realloc(lumps->lumps, lumps->maxlumps * sizeof(lumpinfo_t));
+    }
+
+    lump = &lumps->lumps[lumps->numlumps++];
+    memset(lump, 0, sizeof(*lump));
+
+    // The lump's name is the file's, up to its extension
+    for(int i = 0; i < 8 && leaf[i] != '\0' && leaf[i] != '.'; i++)
+        lump->name[i] = toupper(leaf[i]);
+
+    lump->size    = size;
+    lump->wadfile = wadfile;
+    lump->path    = M_StringDuplicate(path);
+}
+
+static void W_AddPK3Folder(pk3lumps_t* lumps, wadfile_t* wadfile, const char* folder)
+{
+    for(fs_iterator* iter = fs_first(wadfile->wad_stream, folder, FS_READ); iter; iter = fs_next(iter))
+    {
+        char path[MAX_PATH];
+
+        M_snprintf(path, sizeof(path), "%s/%s", folder, iter->pName);
+
+        if(iter->info.directory)
+            W_AddPK3Folder(lumps, wadfile, path);
+        else if(iter->info.size <= INT_MAX)
+            W_AddPK3Lump(lumps, wadfile, path, iter->pName, (int)iter->info.size);
+    }
+}
+
+static void W_AddPK3Marker(lumpinfo_t* lump, wadfile_t* wadfile, const char* name)
+{
+    M_StringCopy(lump->name, name, sizeof(lump->name));
+    lump->wadfile = wadfile;
+}
+
+//
+// W_AddPK3Lumps
+// Adds the files in the root of a PK3 and its flats, graphics, music,
+// patches, sounds and sprites folders as lumps. Flats and sprites are put
+// between F_START/F_END and S_START/S_END markers so they're merged the same
+// way as those from a PWAD. Nothing is inflated until the lump is cached.
+//
+static void W_AddPK3Lumps(wadfile_t* wadfile)
+{
+    pk3lumps_t lumps[NUMPK3SECTIONS] = { 0 };
+    lumpinfo_t* filelumps;
+    int count;
+    int lump = 0;
+
+    if(!pk3lockinitialized)
+    {
+        thread_mutex_init(&pk3lock);
+        pk3lockinitialized = true;
+    }
+
+    for(fs_iterator* iter = fs_first(wadfile->wad_stream, "", FS_READ); iter; iter = fs_next(iter))
+        if(!iter->info.directory)
+        {
+            if(iter->info.size <= INT_MAX)
+                W_AddPK3Lump(&lumps[PK3_NORMAL], wadfile, iter->pName, iter->pName, (int)iter->info.size);
+        }
+        else
+        {
+            bool found = false;
+
+            for(int i = 0; i < arrlen(pk3folders); i++)
+                if(M_StringCompare(iter->pName, pk3folders[i].folder))
+                {
+                    W_AddPK3Folder(&lumps[pk3folders[i].section], wadfile, iter->pName);
+                    found = true;
+                    break;
+                }
+
+            if(!found)
+                C_Warning(1, "The " BOLD("%s") " folder in " BOLD("%s") " will be ignored.",
+                    iter->pName, leafname(wadfile->path));
+        }
+
+    count = lumps[PK3_NORMAL].numlumps
+        + (lumps[PK3_FLATS].numlumps ? lumps[PK3_FLATS].numlumps + 2 : 0)
+        + (lumps[PK3_SPRITES].numlumps ? lumps[PK3_SPRITES].numlumps + 2 : 0);
+
+    filelumps = calloc(count, sizeof(lumpinfo_t));
+
+    for(pk3section_t section = PK3_NORMAL; section < NUMPK3SECTIONS; section++)
+    {
+        const int numsectionlumps = lumps[section].numlumps;
+
+        if(!numsectionlumps)
+            continue;
+
+        if(section != PK3_NORMAL)
+            W_AddPK3Marker(&filelumps[lump++], wadfile, (section == PK3_FLATS ? "F_START" : "S_START"));
+
+        memcpy(&filelumps[lump], lumps[section].lumps, numsectionlumps * sizeof(lumpinfo_t));
+        lump += numsectionlumps;
+
+        if(section != PK3_NORMAL)
+            W_AddPK3Marker(&filelumps[lump++], wadfile, (section == PK3_FLATS ? "F_END" : "S_END"));
+
+        free(lumps[section].lumps);
+    }
+
+    lumpinfo = I_Realloc(lumpinfo, (numlumps + count) * sizeof(lumpinfo_t*));
+
+    for(int i = 0; i < count; i++)
+        lumpinfo[numlumps++] = &filelumps[i];
+}
+
+static void W_UnlinkCachedLump(lumpinfo_t* lump)
+{
+    if(lump->prevcached)
+        lump->prevcached->nextcached = lump->nextcached;
+    else
+        oldestcachedlump = lump->nextcached;
+
+    if(lump->nextcached)
+        lump->nextcached->prevcached = lump->prevcached;
+    else
+        newestcachedlump = lump->prevcached;
+
+    lump->prevcached = NULL;
+    lump->nextcached = NULL;
+}
+
+static void W_TrimPK3Cache(void)
+{
+    while(pk3cachesize > PK3CACHESIZE && oldestcachedlump)
+    {
+        lumpinfo_t* lump = oldestcachedlump;
+
+        W_UnlinkCachedLump(lump);
+        pk3cachesize -= lump->size;
+        free(lump->cache);
+        lump->cache = NULL;
+    }
+}
+
+//
+// W_CachePK3Lump
+// Inflates a PK3 lump the first time it's cached, or takes it back out of
+// the cache of released lumps.
+//
+static void* W_CachePK3Lump(lumpinfo_t* lump)
+{
+    void* cache;
+
+    thread_mutex_lock(&pk3lock);
+
+    if(lump->cache)
+    {
+        if(!lump->locks++)
+            W_UnlinkCachedLump(lump);
+    }
+    else
+    {
+        lump->cache = I_Malloc(MAX(lump->size, 1));
+
+        if(FS_ReadArchiveFile(lump->wadfile->wad_stream, lump->path, lump->cache, lump->size) != (size_t)lump->size)
+            I_Error("%s couldn't be read from %s.", lump->path, lump->wadfile->path);
+
+        lump->locks   = 1;
+        pk3cachesize += lump->size;
+        W_TrimPK3Cache();
+    }
+
+    cache = lump->cache;
+    thread_mutex_unlock(&pk3lock);
+
+    return cache;
+}
+
+//
+// W_ReleasePK3Lump
+// Once a PK3 lump is no longer being used, it's kept in the cache until it's
+// either used again or the least recently used when the cache is full.
+//
+static void W_ReleasePK3Lump(lumpinfo_t* lump)
+{
+    thread_mutex_lock(&pk3lock);
+
+    if(lump->cache && lump->locks && !--lump->locks)
+    {
+        lump->prevcached = newestcachedlump;
+
+        if(newestcachedlump)
+            newestcachedlump->nextcached = lump;
+        else
+            oldestcachedlump = lump;
+
+        newestcachedlump = lump;
+        W_TrimPK3Cache();
+    }
+
+    thread_mutex_unlock(&pk3lock);
+}
+
 //
 // LUMP BASED ROUTINES.
 //
@@ -213,52 +470,65 @@ bool W_AddFile(const char* filename, bool autoloaded)
 
     M_StringCopy(wadfile->path, filename, sizeof(wadfile->path));
 
-    wadfile->freedoom = IsFreedoom(filename);
-    if(wadfile->freedoom)
-        FREEDOOM = true;
-
     // WAD file
     FS_WADSeek(wadfile->wad_stream, 0, SEEK_SET);
     FS_WADRead(&header, sizeof(header), 1, wadfile->wad_stream);
 
-    // Homebrew levels?
-    if(strncmp(header.id, "IWAD", 4) && strncmp(header.id, "PWAD", 4))
-        I_Error("%s doesn't have an IWAD or PWAD id.", filename);
+    startlump = numlumps;
 
-    if(!strncmp(header.id, "IWAD", 4) || D_IsDOOMIWAD(file))
-        wadfile->type = IWAD;
-    else
+    if(!strncmp(header.id, PK3MAGIC, 4))
+    {
         wadfile->type = PWAD;
+        wadfile->pk3  = true;
+        W_AddPK3Lumps(wadfile);
+    }
+    else
+    {
+        wadfile->freedoom = IsFreedoom(filename);
+        if(wadfile->freedoom)
+            FREEDOOM = true;
 
-    header.numlumps     = LONG(header.numlumps);
-    header.infotableofs = LONG(header.infotableofs);
-    length              = header.numlumps * sizeof(filelump_t);
-    fileinfo            = malloc(length);
-    FS_WADSeek(wadfile->wad_stream, header.infotableofs, SEEK_SET);
-    FS_WADRead(fileinfo, length, 1, wadfile->wad_stream);
+        // Homebrew levels?
+        if(strncmp(header.id, "IWAD", 4) && strncmp(header.id, "PWAD", 4))
+            I_Error("%s doesn't have an IWAD or PWAD id.", filename);
 
-    // Increase size of numlumps array to accommodate the new file.
-    filelumps = calloc(header.numlumps, sizeof(lumpinfo_t));
+        if(!strncmp(header.id, "IWAD", 4) || D_IsDOOMIWAD(file))
+            wadfile->type = IWAD;
+        else
+            wadfile->type = PWAD;
 
-    startlump = numlumps;
-    numlumps += header.numlumps;
-    lumpinfo  = I_Realloc(lumpinfo, numlumps * sizeof(lumpinfo_t*));
-    filerover = fileinfo;
+        header.numlumps     = LONG(header.numlumps);
+        header.infotableofs = LONG(header.infotableofs);
+        length              = header.numlumps * sizeof(filelump_t);
+        fileinfo            = malloc(length);
+        FS_WADSeek(wadfile->wad_stream, header.infotableofs, SEEK_SET);
+        FS_WADRead(fileinfo, length, 1, wadfile->wad_stream);
 
-    for(int i = startlump; i < numlumps; i++)
-    {
-        lumpinfo_t* lump_p = &filelumps[i - startlump];
-
-        lump_p->wadfile  = wadfile;
-        lump_p->position = LONG(filerover->filepos);
-        lump_p->size     = LONG(filerover->size);
-        lump_p->cache    = NULL;
-        M_CopyLumpName(lump_p->name, filerover->name);
-        lumpinfo[i] = lump_p;
-        filerover++;
-    }
+        // Increase size of numlumps array to accommodate the new file.
+        filelumps = calloc(header.numlumps, sizeof(lumpinfo_t));
+
+        numlumps += header.numlumps;
+        lumpinfo  = I_Realloc(lumpinfo, numlumps * sizeof(lumpinfo_t*));
+        filerover = fileinfo;
+
+        for(int i = startlump; i < numlumps; i++)
+        {
+            lumpinfo_t* lump_p = &filelumps[i - startlump];
+
+            lump_p->wadfile  = wadfile;
+            lump_p->position = LONG(filerover->filepos);
+            lump_p->size     = LONG(filerover->size);
+
+            // The WAD is mapped into memory for as long as it's loaded, so
+            // its lumps are cached from the start and never change
+            lump_p->cache    = FS_GetRawLump(lump_p);
+            M_CopyLumpName(lump_p->name, filerover->name);
+            lumpinfo[i] = lump_p;
+            filerover++;
+        }
 
-    free(fileinfo);
+        free(fileinfo);
+    }
 
     if(!D_IsResourceWAD(file))
     {
@@ -280,13 +550,13 @@ bool W_AddFile(const char* filename, bool autoloaded)
             (wadcount++ ? "An additional " : ""), temp,
             (numlumps - startlump == 1 ? "lump has" : "lumps have"),
             (autoloaded ? "automatically added" : "added"),
-            (wadfile->type == IWAD ? "IWAD" : "PWAD"), wadfile->path);
+            (wadfile->type == IWAD ? "IWAD" : (wadfile->pk3 ? "PK3" : "PWAD")), wadfile->path);
         else
             C_Output("%s%s %s been %s from the %s " BOLD("%s") ".",
             (wadcount++ ? "An additional " : ""), temp,
             (numlumps - startlump == 1 ? "lump has" : "lumps have"),
             (autoloaded ? "automatically added" : "added"),
-            (wadfile->type == IWAD ? "IWAD" : "PWAD"), wadfile->path);
+            (wadfile->type == IWAD ? "IWAD" : (wadfile->pk3 ? "PK3" : "PWAD")), wadfile->path);
 
         free(temp);
 
@@ -325,7 +595,8 @@ bool W_AutoloadFiles(const char* folder)
             iter = fs_next(iter);
             continue;
         }
-        if(M_StringEndsWith(iter->pName, ".wad") || M_StringEndsWith(iter->pName, ".pwad"))
+        if(M_StringEndsWith(iter->pName, ".wad") || M_StringEndsWith(iter->pName, ".pwad") ||
+            M_StringEndsWith(iter->pName, ".pk3"))
             result = W_MergeFile(iter->pName, true);
         else if(M_StringEndsWith(iter->pName, ".deh") ||
             M_StringEndsWith(iter->pName, ".bex"))
@@ -404,7 +675,7 @@ bool HasDehackedLump(const char* pwadname)
         return false;
 
     // read IWAD header
-    if(FS_Read(&header, 1, sizeof(header), fp) == sizeof(header))
+    if(FS_Read(&header, 1, sizeof(header), fp) == sizeof(header) && strncmp(header.id, PK3MAGIC, 4))
     {
         const char* n = lump.name;
 
@@ -432,8 +703,12 @@ gamemission_t IWADRequiredByPWAD(char* pwadname)
     else
     {
         wadinfo_t header;
+        const bool headerread = (FS_Read(&header, 1, sizeof(header), fp) == sizeof(header));
 
-        if(FS_Read(&header, 1, sizeof(header), fp) != sizeof(header) ||
+        // Maps in a PK3 aren't loaded, so it doesn't need a particular IWAD
+        if(headerread && !strncmp(header.id, PK3MAGIC, 4))
+            FS_CloseFile(fp);
+        else if(!headerread ||
         (strncmp(header.id, "IWAD", 4) && strncmp(header.id, "PWAD", 4)))
         {
             FS_CloseFile(fp);
@@ -607,12 +882,26 @@ static bool W_IsPNGLump(const int lump)
 
     if(W_LumpLength(lump) >= 13)
     {
-        const unsigned char* patch = (const unsigned char*)W_CacheLumpNum(lump);
+        const lumpinfo_t* info = lumpinfo[lump];
 
-        if(patch[0] == 0x89 && patch[1] == 'P' && patch[2] == 'N' && patch[3] == 'G')
-            result = true;
+        // Only inflate as much of a PK3 lump as is needed to check
+        if(info->path && !info->cache)
+        {
+            unsigned char header[4];
 
-        W_ReleaseLumpNum(lump);
+            if(FS_ReadArchiveFile(info->wadfile->wad_stream, info->path, header, sizeof(header)) == sizeof(header)
+                && header[0] == 0x89 && header[1] == 'P' && header[2] == 'N' && header[3] == 'G')
+                result = true;
+        }
+        else
+        {
+            const unsigned char* patch = (const unsigned char*)W_CacheLumpNum(lump);
+
+            if(patch[0] == 0x89 && patch[1] == 'P' && patch[2] == 'N' && patch[3] == 'G')
+                result = true;
+
+            W_ReleaseLumpNum(lump);
+        }
     }
 
     return result;
@@ -706,17 +995,21 @@ void* W_CacheLumpNum(int lumpnum)
 {
     lumpinfo_t* lump = lumpinfo[lumpnum];
 
-    if(!lump->cache)
-        lump->cache = FS_GetRawLump(lump);
+    if(lump->path)
+        return W_CachePK3Lump(lump);
 
+    // Lumps in a WAD are never written to after it's added, so they can be
+    // cached by any thread without locking
     return lump->cache;
 }
 
 void W_ReleaseLumpNum(int lumpnum)
 {
-    // WADs are now cached in memory as a whole; just clear the pointer to the
-    // lump's beginning position instead of freeing anything
-    lumpinfo[lumpnum]->cache = NULL;
+    lumpinfo_t* lump = lumpinfo[lumpnum];
+
+    // WADs are mapped into memory as a whole, so there's nothing to free
+    if(lump->path)
+        W_ReleasePK3Lump(lump);
 }
 
 wadfile_t* W_OpenFile(const char* path)
@@ -52,10 +52,11 @@ typedef struct
 {
     struct fs* wad_stream;
     bool freedoom;
+    bool pk3;
     char path[MAX_PATH];
     int type;
 } wadfile_t;
-typedef struct
+typedef struct lumpinfo_s
 {
     char name[9];
     int size;
@@ -68,6 +69,13 @@ typedef struct
     int position;
 
     wadfile_t* wadfile;
+
+    // Where a lump from a PK3 is in it, and how its inflated data is held in
+    // the cache while it's not being used
+    char* path;
+    int locks;
+    struct lumpinfo_s* prevcached;
+    struct lumpinfo_s* nextcached;
 } lumpinfo_t;
 
 extern lumpinfo_t** lumpinfo;
@@ -0,0 +1,137 @@
+//
+// bench_drawers.c - Times the column and span drawers
+//
+// Fills the whole view with R_DrawColumn(), R_DrawWallColumn() and
+// R_DrawSpan() through a rendercontext_t, the way R_RenderPlayerView() does,
+// and prints the best time per frame of each. Takes the number of frames to
+// time as its only argument.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "doom/doomstat.h"
+#include "render/r_local.h"
+#include "render/r_simd.h"
+#include "system/i_config.h"
+#include "system/i_timer.h"
+#include "system/i_video.h"
+
+#define BENCHSCALE  3
+#define BENCHRUNS   7
+
+static byte source[64 * 64];
+static lighttable_t colormap[256];
+static lighttable_t sectorcolormap[256];
+
+static void FillColumns(rendercontext_t* rc)
+{
+    for(int x = 0; x < render.view_width; x++)
+    {
+        rc->dc_x           = x;
+        rc->dc_yl          = 0;
+        rc->dc_yh          = render.view_height - 1;
+        rc->dc_iscale      = FRACUNIT / 3 + x;
+        rc->dc_texturefrac = x << 10;
+        rc->dc_source      = source + (x & 63) * 64;
+        R_DrawColumn(rc);
+    }
+}
+
+static void FillWallColumns(rendercontext_t* rc)
+{
+    for(int x = 0; x < render.view_width; x++)
+    {
+        rc->dc_x          = x;
+        rc->dc_yl         = 0;
+        rc->dc_yh         = render.view_height - 1;
+        rc->dc_iscale     = FRACUNIT / 3 + x;
+        rc->dc_texturemid = x << 12;
+        rc->dc_texheight  = 64;
+        rc->dc_source     = source + (x & 63) * 64;
+        R_DrawWallColumn(rc);
+    }
+}
+
+static void FillSpans(rendercontext_t* rc)
+{
+    for(int y = 0; y < render.view_height; y++)
+    {
+        rc->ds_y     = y;
+        rc->ds_x1    = 0;
+        rc->ds_x2    = render.view_width - 1;
+        rc->ds_xfrac = y * 77 << 8;
+        rc->ds_yfrac = y * 91 << 8;
+        rc->ds_xstep = FRACUNIT / 2 + y;
+        rc->ds_ystep = -FRACUNIT / 5 - y;
+        R_DrawSpan(rc);
+
+        if(r_columnmajor)
+            R_TransposeSpan(rc);
+    }
+}
+
+static double TimeDrawer(void (*fill)(rendercontext_t*), rendercontext_t* rc, const int frames)
+{
+    uint64_t best = UINT64_MAX;
+
+    for(int run = 0; run < BENCHRUNS; run++)
+    {
+        const uint64_t start = I_GetTimeNS();
+        uint64_t time;
+
+        for(int frame = 0; frame < frames; frame++)
+            fill(rc);
+
+        if((time = I_GetTimeNS() - start) < best)
+            best = time;
+    }
+
+    return (best / 1e6 / frames);
+}
+
+int main(int argc, char* argv[])
+{
+    const int frames    = (argc > 1 ? atoi(argv[1]) : 100);
+    rendercontext_t rc  = { 0 };
+
+    if(frames < 1)
+        return EXIT_FAILURE;
+
+    I_TimeInit();
+
+    if(!R_ResizeRenderState(BENCHSCALE))
+        return EXIT_FAILURE;
+
+    render.view_width  = render.screen_width;
+    render.view_height = render.screen_height;
+    r_centery          = render.view_height / 2;
+
+    R_InitBuffer();
+    R_InitSIMD();
+    R_ResizeDrawStripBuffers();
+
+    srand(1);
+
+    for(int i = 0; i < 64 * 64; i++)
+        source[i] = rand() & 0xFF;
+
+    for(int i = 0; i < 256; i++)
+    {
+        colormap[i]       = rand() & 0xFF;
+        sectorcolormap[i] = rand() & 0xFF;
+    }
+
+    rc.dc_colormap[0]    = colormap;
+    rc.dc_sectorcolormap = sectorcolormap;
+    rc.ds_colormap[0]    = colormap;
+    rc.ds_source         = source;
+
+    printf("%ix%i, best of %i runs of %i frames, in ms per frame:\n",
+        render.view_width, render.view_height, BENCHRUNS, frames);
+    printf("R_DrawColumn     %.3f\n", TimeDrawer(&FillColumns, &rc, frames));
+    printf("R_DrawWallColumn %.3f\n", TimeDrawer(&FillWallColumns, &rc, frames));
+    printf("R_DrawSpan       %.3f\n", TimeDrawer(&FillSpans, &rc, frames));
+
+    return EXIT_SUCCESS;
+}
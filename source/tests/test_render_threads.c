@@ -0,0 +1,558 @@
+//
+// test_render_threads.c - Renders the same frame on one thread and on several
+//
+// Builds a small map and the graphics it needs in memory, then renders the
+// player's view with r_threads set to 1 and to each of a few higher counts,
+// and checks that every frame is identical to the single-threaded one. The
+// view takes in walls, a raised platform, a masked midtexture, the sky,
+// sprites, a spectre and the player's weapon, in both layouts of the view
+// buffer, and again with the player partially invisible.
+//
+// Given a number of frames as its only argument, it instead renders the view
+// at a higher resolution on 1, 4 and 8 threads and prints the best time per
+// frame of each.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "console/c_console.h"
+#include "doom/d_deh.h"
+#include "doom/doomstat.h"
+#include "playsim/p_local.h"
+#include "playsim/p_setup.h"
+#include "render/r_local.h"
+#include "render/r_sky.h"
+#include "render/v_video.h"
+#include "system/i_config.h"
+#include "system/i_timer.h"
+#include "system/i_video.h"
+#include "wad/w_wad.h"
+
+#include "sokol_args.h"
+
+#define TESTSCALE   2
+#define TIMESCALE   6
+#define TIMERUNS    5
+#define MAXLUMPS    64
+
+static player_t player;
+
+static lumpinfo_t lumps[MAXLUMPS];
+static lumpinfo_t* lumppointers[MAXLUMPS];
+static wadfile_t wadfile = { .type = IWAD, .path = "test_render_threads.wad" };
+
+static int failures;
+
+#define CHECK(x)                                                          \
+    do                                                                    \
+    {                                                                     \
+        if(!(x))                                                          \
+        {                                                                 \
+            fprintf(stderr, "%s:%i: %s failed\n", __FILE__, __LINE__, #x); \
+            failures++;                                                   \
+        }                                                                 \
+    } while(0)
+
+static void AddLump(const char* name, const void* data, const int size)
+{
+    lumpinfo_t* lump = &lumps[numlumps];
+    void* cache      = malloc(size ? size : 1);
+
+    memcpy(cache, data, size);
+    strncpy(lump->name, name, 8);
+    lump->size    = size;
+    lump->cache   = cache;
+    lump->wadfile = &wadfile;
+
+    lumppointers[numlumps++] = lump;
+}
+
+static void AddMarker(const char* name)
+{
+    AddLump(name, NULL, 0);
+}
+
+static void WriteShort(byte** p, const int value)
+{
+    *(*p)++ = (value & 0xFF);
+    *(*p)++ = ((value >> 8) & 0xFF);
+}
+
+static void WriteInt(byte** p, const int value)
+{
+    WriteShort(p, value & 0xFFFF);
+    WriteShort(p, (value >> 16) & 0xFFFF);
+}
+
+static void WriteName(byte** p, const char* name)
+{
+    strncpy((char*)*p, name, 8);
+    *p += 8;
+}
+
+//
+// AddPatch
+// Adds a patch of pseudorandom pixels. Every other run of rows in a column is
+// left out of it when it's to have holes in it.
+//
+static void AddPatch(const char* name, const int width, const int height,
+    const int leftoffset, const int topoffset, const bool holes)
+{
+    byte* data = calloc(1, 8 + width * 4 + width * (height * 2 + 64));
+    byte* p    = data;
+    byte* columnofs;
+
+    WriteShort(&p, width);
+    WriteShort(&p, height);
+    WriteShort(&p, leftoffset);
+    WriteShort(&p, topoffset);
+    columnofs = p;
+    p        += width * 4;
+
+    for(int x = 0; x < width; x++)
+    {
+        byte* ofs = columnofs + x * 4;
+
+        WriteInt(&ofs, (int)(p - data));
+
+        for(int top = 0; top < height; top += 16)
+        {
+            const int length = MIN(16, height - top);
+
+            if(holes && ((top >> 4) + (x >> 3)) % 2)
+                continue;
+
+            *p++ = top;
+            *p++ = length;
+            *p++ = 0;
+
+            for(int y = 0; y < length; y++)
+                *p++ = rand() & 0xFF;
+
+            *p++ = 0;
+        }
+
+        *p++ = 0xFF;
+    }
+
+    AddLump(name, data, (int)(p - data));
+    free(data);
+}
+
+static void AddFlat(const char* name)
+{
+    byte flat[64 * 64];
+
+    for(int i = 0; i < 64 * 64; i++)
+        flat[i] = rand() & 0xFF;
+
+    AddLump(name, flat, sizeof(flat));
+}
+
+static void AddPalettes(void)
+{
+    byte playpal[14 * 768];
+    byte colormap[34 * 256];
+
+    for(int i = 0; i < 14 * 768; i++)
+        playpal[i] = rand() & 0xFF;
+
+    AddLump("PLAYPAL", playpal, sizeof(playpal));
+
+    // Each light level darkens towards a different part of the palette, so
+    // any mix-up between them shows up in the frame
+    for(int level = 0; level < 34; level++)
+        for(int i = 0; i < 256; i++)
+            colormap[level * 256 + i] = (byte)(i * (32 - MIN(level, 32)) / 32 + level * 7);
+
+    AddLump("COLORMAP", colormap, sizeof(colormap));
+}
+
+static void AddTextures(void)
+{
+    static const struct
+    {
+        const char* name;
+        int width;
+        int height;
+        int patch;
+    } textures[] = {
+        { "AASTINKY",  64,  64, 0 },
+        { "WALL",      64, 128, 0 },
+        { "GRATE",     64,  64, 1 },
+        { "SKY1",     256, 128, 2 }
+    };
+
+    byte pnames[4 + 3 * 8];
+    byte texture1[4 + 4 * 4 + 4 * 32];
+    byte* p = pnames;
+
+    WriteInt(&p, 3);
+    WriteName(&p, "WALLP");
+    WriteName(&p, "GRATEP");
+    WriteName(&p, "SKYP");
+    AddLump("PNAMES", pnames, sizeof(pnames));
+
+    memset(texture1, 0, sizeof(texture1));
+    p = texture1;
+    WriteInt(&p, 4);
+
+    for(int i = 0; i < 4; i++)
+        WriteInt(&p, 4 + 4 * 4 + i * 32);
+
+    for(int i = 0; i < 4; i++)
+    {
+        WriteName(&p, textures[i].name);
+        WriteInt(&p, 0);
+        WriteShort(&p, textures[i].width);
+        WriteShort(&p, textures[i].height);
+        WriteInt(&p, 0);
+        WriteShort(&p, 1);
+        WriteShort(&p, 0);
+        WriteShort(&p, 0);
+        WriteShort(&p, textures[i].patch);
+        WriteShort(&p, 1);
+        WriteShort(&p, 0);
+    }
+
+    AddLump("TEXTURE1", texture1, sizeof(texture1));
+    AddPatch("WALLP", 64, 128, 0, 0, false);
+    AddPatch("GRATEP", 64, 64, 0, 0, true);
+    AddPatch("SKYP", 256, 128, 0, 0, false);
+}
+
+static void AddSprites(void)
+{
+    AddMarker("S_START");
+    AddPatch("BLD2A0", 8, 8, 4, 4, false);
+    AddPatch("TNT1A0", 1, 1, 0, 0, true);
+    AddPatch("TROOA0", 41, 57, 20, 52, true);
+    AddPatch("SARGA0", 60, 55, 30, 51, false);
+    AddPatch("PISGA0", 57, 62, -118, -106, false);
+    AddMarker("S_END");
+}
+
+static void AddFlats(void)
+{
+    AddMarker("F_START");
+    AddFlat("FLOOR0");
+    AddFlat("CEIL0");
+    AddFlat("F_SKY1");
+    AddFlat("-N0_TEX-");
+    AddMarker("F_END");
+}
+
+//
+// AddMap
+// A square room open to the sky, with a raised platform in the middle of it.
+// The side of the platform facing the player has a grate across it.
+//
+static void AddMap(void)
+{
+    static const short vertexes[][2] = {
+        { -512,  512 }, {  512,  512 }, {  512, -512 }, { -512, -512 },
+        {   64,  -64 }, {  192,  -64 }, {  192,   64 }, {   64,   64 }
+    };
+
+    static const struct
+    {
+        int v1, v2, flags, front, back;
+    } linedefs[] = {
+        { 0, 1, 1, 0, -1 }, { 1, 2, 1, 0, -1 }, { 2, 3, 1, 0, -1 }, { 3, 0, 1, 0, -1 },
+        { 4, 5, 4, 1,  2 }, { 5, 6, 4, 1,  2 }, { 6, 7, 4, 1,  2 }, { 7, 4, 4, 3,  2 }
+    };
+
+    static const struct
+    {
+        const char* top;
+        const char* bottom;
+        const char* mid;
+        int sector;
+    } sidedefs[] = {
+        { "-",    "-",    "WALL",  0 },
+        { "WALL", "WALL", "-",     0 },
+        { "-",    "-",    "-",     1 },
+        { "WALL", "WALL", "GRATE", 0 }
+    };
+
+    static const struct
+    {
+        int floorheight, ceilingheight;
+        const char* floorpic;
+        const char* ceilingpic;
+        int lightlevel;
+    } sectors[] = {
+        { 0,  256, "FLOOR0", "F_SKY1", 192 },
+        { 32, 160, "FLOOR0", "CEIL0",  144 }
+    };
+
+    static const short things[][4] = {
+        { -384,    0,   0,    1 },  // player 1 start
+        { -128, -160,  90, 3001 },  // imps
+        { -160,  120, 270, 3001 },
+        {  320,   32, 180, 3001 },
+        {  -64,   24,   0,   58 }   // spectre
+    };
+
+    byte data[1024];
+    byte* p;
+
+    AddMarker("MAP01");
+
+    p = data;
+
+    for(int i = 0; i < arrlen(things); i++)
+    {
+        for(int j = 0; j < 4; j++)
+            WriteShort(&p, things[i][j]);
+
+        WriteShort(&p, 7);
+    }
+
+    AddLump("THINGS", data, (int)(p - data));
+
+    p = data;
+
+    for(int i = 0; i < arrlen(linedefs); i++)
+    {
+        WriteShort(&p, linedefs[i].v1);
+        WriteShort(&p, linedefs[i].v2);
+        WriteShort(&p, linedefs[i].flags);
+        WriteShort(&p, 0);
+        WriteShort(&p, 0);
+        WriteShort(&p, linedefs[i].front);
+        WriteShort(&p, linedefs[i].back);
+    }
+
+    AddLump("LINEDEFS", data, (int)(p - data));
+
+    p = data;
+
+    for(int i = 0; i < arrlen(sidedefs); i++)
+    {
+        WriteShort(&p, 0);
+        WriteShort(&p, 0);
+        WriteName(&p, sidedefs[i].top);
+        WriteName(&p, sidedefs[i].bottom);
+        WriteName(&p, sidedefs[i].mid);
+        WriteShort(&p, sidedefs[i].sector);
+    }
+
+    AddLump("SIDEDEFS", data, (int)(p - data));
+
+    p = data;
+
+    for(int i = 0; i < arrlen(vertexes); i++)
+    {
+        WriteShort(&p, vertexes[i][0]);
+        WriteShort(&p, vertexes[i][1]);
+    }
+
+    AddLump("VERTEXES", data, (int)(p - data));
+
+    // The nodes are built when the map is loaded
+    AddMarker("SEGS");
+    AddMarker("SSECTORS");
+    AddMarker("NODES");
+
+    p = data;
+
+    for(int i = 0; i < arrlen(sectors); i++)
+    {
+        WriteShort(&p, sectors[i].floorheight);
+        WriteShort(&p, sectors[i].ceilingheight);
+        WriteName(&p, sectors[i].floorpic);
+        WriteName(&p, sectors[i].ceilingpic);
+        WriteShort(&p, sectors[i].lightlevel);
+        WriteShort(&p, 0);
+        WriteShort(&p, 0);
+    }
+
+    AddLump("SECTORS", data, (int)(p - data));
+    AddMarker("REJECT");
+    AddMarker("BLOCKMAP");
+}
+
+static void AddLumps(void)
+{
+    // Empty switch and animation tables, with only their terminators
+    static const byte switches[20] = { 0 };
+    static const byte animated[23] = { 0xFF };
+
+    srand(1);
+
+    lumpinfo = lumppointers;
+    numlumps = 0;
+
+    AddPalettes();
+    AddMarker("DRCOMPAT");
+    AddLump("SWITCHES", switches, sizeof(switches));
+    AddLump("ANIMATED", animated, sizeof(animated));
+    AddTextures();
+    AddSprites();
+    AddFlats();
+    AddMap();
+}
+
+//
+// RenderFrame
+// Renders the player's view on the given number of threads, from the same
+// fuzz seeds each time, and returns a copy of it.
+//
+static byte* RenderFrame(const int threads)
+{
+    const int size = render.screen_width * render.screen_height;
+    byte* frame    = malloc(size);
+
+    r_threads = threads;
+    M_Fuzz1Seed(1);
+    M_Fuzz2Seed(1);
+
+    memset(r_screens[0], 0, size);
+    R_RenderPlayerView();
+    memcpy(frame, r_screens[0], size);
+
+    return frame;
+}
+
+static unsigned int Checksum(const byte* frame)
+{
+    const int size     = render.screen_width * render.screen_height;
+    unsigned int check = 2166136261u;
+
+    for(int i = 0; i < size; i++)
+        check = (check ^ frame[i]) * 16777619u;
+
+    return check;
+}
+
+static void CheckFrames(const char* description)
+{
+    static const int threads[] = { 2, 3, 4, 7, 8 };
+    const int size             = render.screen_width * render.screen_height;
+    byte* frame                = RenderFrame(1);
+
+    printf("%-20s %i thread  %08x\n", description, 1, Checksum(frame));
+
+    for(int i = 0; i < arrlen(threads); i++)
+    {
+        byte* otherframe = RenderFrame(threads[i]);
+
+        printf("%-20s %i threads %08x\n", description, threads[i], Checksum(otherframe));
+        CHECK(!memcmp(frame, otherframe, size));
+        free(otherframe);
+    }
+
+    free(frame);
+}
+
+static void TimeFrames(const int frames)
+{
+    static const int threads[] = { 1, 4, 8 };
+
+    printf("%ix%i, best of %i runs of %i frames, in ms per frame:\n",
+        render.view_width, render.view_height, TIMERUNS, frames);
+
+    for(int i = 0; i < arrlen(threads); i++)
+    {
+        uint64_t best = UINT64_MAX;
+
+        r_threads = threads[i];
+
+        for(int run = 0; run < TIMERUNS; run++)
+        {
+            const uint64_t start = I_GetTimeNS();
+            uint64_t time;
+
+            for(int frame = 0; frame < frames; frame++)
+                R_RenderPlayerView();
+
+            if((time = I_GetTimeNS() - start) < best)
+                best = time;
+        }
+
+        printf("%i thread%s %.3f\n", threads[i], (threads[i] == 1 ? " " : "s"), best / 1e6 / frames);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int frames = (argc > 1 ? atoi(argv[1]) : 0);
+
+    sargs_setup(&(sargs_desc){ .argc = argc, .argv = argv });
+
+    game.mode    = commercial;
+    game.mission = doom2;
+    game.skill   = sk_medium;
+    game.episode = 1;
+    game.map     = 1;
+
+    I_TimeInit();
+    C_ClearConsole();
+    dsdh_InitTables();
+
+    AddLumps();
+    W_Init();
+
+    if(!R_ResizeRenderState(frames ? TIMESCALE : TESTSCALE))
+        return EXIT_FAILURE;
+
+    video.screen_width = V_NONWIDEWIDTH;
+    video.screen_area  = video.screen_width * video.screen_height;
+
+    V_Init();
+    PLAYPAL = W_CacheLumpName("PLAYPAL");
+    R_Init();
+    R_ExecuteSetViewSize();
+    P_Init();
+
+    // Sprite shadows are drawn through the tint tables, which aren't set up
+    r_shadows = false;
+
+    viewplayer              = &player;
+    viewplayer->playerstate = PST_REBORN;
+    r_buildnodes            = true;
+
+    P_SetupLevel(1, 1);
+    R_InitSkyMap();
+    R_InitColumnFunctions();
+
+    if(!viewplayer->mo)
+    {
+        fprintf(stderr, "The player wasn't spawned\n");
+        return EXIT_FAILURE;
+    }
+
+    viewplayer->viewz = viewplayer->mo->z + VIEWHEIGHT;
+
+    viewplayer->psprites[ps_weapon].state = &states[S_PISTOL];
+    viewplayer->psprites[ps_weapon].sx    = 0;
+    viewplayer->psprites[ps_weapon].sy    = WEAPONTOP;
+
+    if(frames)
+    {
+        TimeFrames(frames);
+        return EXIT_SUCCESS;
+    }
+
+    // Both layouts of the view buffer, with the player visible and then
+    // partially invisible
+    for(int i = 0; i < 2; i++)
+    {
+        r_columnmajor = i;
+        R_InitBuffer();
+
+        viewplayer->powers[pw_invisibility] = 0;
+        CheckFrames(r_columnmajor ? "Column-major" : "Row-major");
+
+        viewplayer->powers[pw_invisibility] = INVISTICS;
+        CheckFrames(r_columnmajor ? "Column-major, fuzz" : "Row-major, fuzz");
+    }
+
+    if(failures)
+        fprintf(stderr, "%i check%s failed\n", failures, (failures == 1 ? "" : "s"));
+
+    return (failures ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,127 @@
+//
+// test_savegame.c - Writes a savegame out and reads it back in
+//
+// P_WriteSaveGame() compresses everything after the header in the
+// background, so this checks that what P_OpenSaveGame() gives back is
+// unarchived exactly as it was archived, including the fields whose layout
+// depends on the version in the header.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "doom/doomstat.h"
+#include "playsim/p_local.h"
+#include "playsim/p_saveg.h"
+#include "playsim/p_tick.h"
+#include "render/r_main.h"
+#include "system/i_version.h"
+
+#define SAVEGAMEFILE     "./test_savegame.save"
+#define TEMPSAVEGAMEFILE "./test_savegame.save.tmp"
+
+static player_t player;
+
+static int failures;
+
+#define CHECK(x)                                                          \
+    do                                                                    \
+    {                                                                     \
+        if(!(x))                                                          \
+        {                                                                 \
+            fprintf(stderr, "%s:%i: %s failed\n", __FILE__, __LINE__, #x); \
+            failures++;                                                   \
+        }                                                                 \
+    } while(0)
+
+static void FillPlayer(void)
+{
+    memset(&player, 0, sizeof(player));
+
+    player.health           = 87;
+    player.armor            = 42;
+    player.ammo[am_clip]    = 123;
+    player.killcount        = 17;
+    player.distancetraveled = 12345.678;
+    player.gamessaved       = 3;
+    player.suicides         = 2;
+    player.shotsfired_calamityblade = 9;
+    player.itemspickedup_ammo_fuel  = 5;
+
+    for(int i = 0; i < NUMMOBJTYPES; i++)
+        player.monsterskilled[i] = i % 3;
+}
+
+int main(void)
+{
+    char description[SAVESTRINGSIZE];
+    char version[VERSIONSIZE] = "";
+    FILE* file;
+
+    P_InitThinkers();
+    viewplayer = &player;
+
+    // Archive the player along with enough padding for the savegame to be
+    // worth compressing
+    FillPlayer();
+    P_CreateSaveGame();
+    P_WriteSaveGameHeader("test savegame");
+
+    for(int i = 0; i < 16; i++)
+        P_ArchivePlayer();
+
+    P_WriteSaveGameEOF();
+
+    CHECK(P_WriteSaveGame(SAVEGAMEFILE, TEMPSAVEGAMEFILE));
+    P_FinishSaveGame();
+
+    // The savegame should have been written compressed
+    CHECK((file = fopen(SAVEGAMEFILE, "rb")) != NULL);
+
+    if(file)
+    {
+        CHECK(fseek(file, SAVESTRINGSIZE, SEEK_SET) == 0);
+        CHECK(fread(version, 1, sizeof(version), file) == sizeof(version));
+        CHECK(!strncmp(version, DOOMRETRO_SAVEGAMEVERSION_LZ, VERSIONSIZE));
+        fclose(file);
+    }
+
+    // Read it back in over a cleared player
+    memset(&player, 0, sizeof(player));
+
+    CHECK(P_OpenSaveGame(SAVEGAMEFILE));
+    CHECK(P_ReadSaveGameHeader(description));
+    CHECK(!strcmp(description, "test savegame"));
+
+    for(int i = 0; i < 16; i++)
+        P_UnarchivePlayer();
+
+    CHECK(P_ReadSaveGameEOF());
+    P_CloseSaveGame();
+
+    CHECK(player.health == 87);
+    CHECK(player.armor == 42);
+    CHECK(player.ammo[am_clip] == 123);
+    CHECK(player.killcount == 17);
+    CHECK(player.distancetraveled == 12345.678);
+    CHECK(player.gamessaved == 3);
+    CHECK(player.suicides == 2);
+    CHECK(player.shotsfired_calamityblade == 9);
+    CHECK(player.itemspickedup_ammo_fuel == 5);
+
+    for(int i = 0; i < NUMMOBJTYPES; i++)
+        CHECK(player.monsterskilled[i] == i % 3);
+
+    remove(SAVEGAMEFILE);
+    remove(SAVEGAMEFILE ".bak");
+
+    if(failures)
+    {
+        fprintf(stderr, "%i check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    puts("savegame round trip passed");
+    return EXIT_SUCCESS;
+}